@@ -0,0 +1,79 @@
+#include "atm/Atmosphere.hpp"
+#include "atm/Epoch.hpp"
+
+namespace fmx::atm {
+
+static double kp_to_ap_int(int kp) {
+  // Rough mapping for integer Kp
+  static const int table[10] = {0,4,7,15,27,48,80,140,240,400};
+  if (kp < 0) kp = 0;
+  if (kp > 9) kp = 9;
+  return static_cast<double>(table[kp]);
+}
+
+Drivers resolve_drivers(const Indices& idx) {
+  Drivers d;
+  d.idx = idx;
+  d.f107a = idx.F10_7A > 0 ? idx.F10_7A : idx.F10_7;
+  d.f107 = idx.F10_7;
+  // MSIS Ap inputs (currently only daily and now are passed to the model)
+  if (idx.has_ap_array) {
+    d.ap_daily = idx.Ap[0]; d.ap_now = idx.Ap[1];
+  } else if (idx.Ap_daily > 0.0 || idx.Ap_now > 0.0) {
+    d.ap_daily = (idx.Ap_daily > 0.0) ? idx.Ap_daily : kp_to_ap_int(idx.Kp);
+    d.ap_now = (idx.Ap_now > 0.0) ? idx.Ap_now : d.ap_daily;
+  } else {
+    d.ap_daily = d.ap_now = kp_to_ap_int(idx.Kp);
+  }
+  // Choose ap3hr for wind
+  if (idx.has_ap_array) d.ap3hr = idx.Ap[1];
+  else if (idx.Ap_now > 0.0) d.ap3hr = idx.Ap_now;
+  else d.ap3hr = 10.0; // fallback
+  return d;
+}
+
+bool same_indices(const Indices& a, const Indices& b) {
+  if (a.F10_7 != b.F10_7 || a.F10_7A != b.F10_7A || a.Kp != b.Kp || a.has_ap_array != b.has_ap_array
+      || a.Ap_daily != b.Ap_daily || a.Ap_now != b.Ap_now) return false;
+  for (int i = 0; i < 7; ++i) if (a.Ap[i] != b.Ap[i]) return false;
+  return true;
+}
+
+AtmosphereState Atmosphere::evaluate_epoch(double alt_km, double lat_deg, double lon_deg,
+                                           double epoch_s, const Drivers& drv) const {
+  return evaluate(alt_km, lat_deg, lon_deg, format_iso_utc(epoch_s), drv.idx);
+}
+
+void StateBatch::resize(std::size_t n_points, std::size_t n_species) {
+  n = n_points;
+  T_K.assign(n, 0.0);
+  wind_x.assign(n, 0.0); wind_y.assign(n, 0.0); wind_z.assign(n, 0.0);
+  species_mass.assign(n_species, 0.0);
+  rho.assign(n * n_species, 0.0);
+}
+
+AtmosphereState StateBatch::state(std::size_t i) const {
+  AtmosphereState st{};
+  st.T_K = T_K[i];
+  st.wind_ms = {wind_x[i], wind_y[i], wind_z[i]};
+  st.species.reserve(species_mass.size());
+  for (std::size_t s = 0; s < species_mass.size(); ++s) st.species.push_back({rho[s * n + i], species_mass[s]});
+  return st;
+}
+
+void Atmosphere::evaluate_batch(const PointBatch& pts, const Indices& idx, StateBatch& out) const {
+  out.resize(pts.n, 0);
+  for (std::size_t i = 0; i < pts.n; ++i) {
+    const AtmosphereState st = evaluate(pts.alt_km[i], pts.lat_deg[i], pts.lon_deg[i], format_iso_utc(pts.epoch_s[i]), idx);
+    if (i == 0) {
+      out.species_mass.clear();
+      for (const auto& sp : st.species) out.species_mass.push_back(sp.mass);
+      out.rho.assign(pts.n * out.species_mass.size(), 0.0);
+    }
+    out.T_K[i] = st.T_K;
+    out.wind_x[i] = st.wind_ms.x; out.wind_y[i] = st.wind_ms.y; out.wind_z[i] = st.wind_ms.z;
+    for (std::size_t s = 0; s < st.species.size() && s < out.species_mass.size(); ++s) out.rho[s * pts.n + i] = st.species[s].rho;
+  }
+}
+
+} // namespace fmx::atm
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 #include "core/types.hpp"
 
@@ -17,6 +18,19 @@ struct Indices {
   double Ap_now{0.0};
 };
 
+// Model drivers resolved from Indices once (Kp -> Ap fallbacks, Ap selection per model)
+struct Drivers {
+  Indices idx;        // source indices
+  double f107{120.0};
+  double f107a{120.0};
+  double ap_daily{0.0}; // NRLMSIS daily Ap
+  double ap_now{0.0};   // NRLMSIS current 3-hour Ap
+  double ap3hr{10.0};   // HWM14 3-hour ap
+};
+Drivers resolve_drivers(const Indices& idx);
+// Field-wise equality, used to reuse resolved drivers across calls
+bool same_indices(const Indices& a, const Indices& b);
+
 struct SpeciesState {
   double rho;   // mass density [kg/m^3]
   double mass;  // molecular mass [kg]
@@ -28,18 +42,53 @@ struct AtmosphereState {
   std::vector<SpeciesState> species; // species list
 };
 
+// Structure-of-arrays space-time points; epochs are UTC seconds since 1970 (atm/Epoch.hpp)
+struct PointBatch {
+  std::size_t n{0};
+  const double* alt_km{nullptr};
+  const double* lat_deg{nullptr};
+  const double* lon_deg{nullptr};
+  const double* epoch_s{nullptr};
+};
+
+// Structure-of-arrays results of a batch evaluation. Species mass densities are stored
+// species-major (rho[s * n + i]) with the species masses listed once in species_mass.
+struct StateBatch {
+  std::size_t n{0};
+  std::vector<double> T_K;
+  std::vector<double> wind_x, wind_y, wind_z; // components of AtmosphereState::wind_ms
+  std::vector<double> species_mass;
+  std::vector<double> rho;
+
+  void resize(std::size_t n_points, std::size_t n_species);
+  std::size_t species_count() const { return species_mass.size(); }
+  const double* rho_of(std::size_t s) const { return rho.data() + s * n; }
+  double* rho_of(std::size_t s) { return rho.data() + s * n; }
+  // Point i in the single-point representation
+  AtmosphereState state(std::size_t i) const;
+};
+
 class Atmosphere {
 public:
   virtual ~Atmosphere() = default;
   virtual AtmosphereState evaluate(double alt_km, double lat_deg, double lon_deg,
                                    const std::string& utc_iso,
                                    const Indices& idx) const = 0;
+  // Numeric-epoch evaluation with pre-resolved drivers (no UTC string parsing). The default
+  // formats the epoch and calls evaluate().
+  virtual AtmosphereState evaluate_epoch(double alt_km, double lat_deg, double lon_deg,
+                                         double epoch_s, const Drivers& drv) const;
+  // Evaluate many points with shared indices. The default formats each epoch and calls
+  // evaluate(); the built-in models override it with array kernels parallel over points.
+  virtual void evaluate_batch(const PointBatch& pts, const Indices& idx, StateBatch& out) const;
 };
 
 class StubAtmosphere : public Atmosphere {
 public:
   AtmosphereState evaluate(double alt_km, double, double,
                            const std::string&, const Indices& idx) const override;
+  AtmosphereState evaluate_epoch(double alt_km, double, double, double, const Drivers& drv) const override;
+  void evaluate_batch(const PointBatch& pts, const Indices& idx, StateBatch& out) const override;
 };
 
 } // namespace fmx::atm
@@ -0,0 +1,261 @@
+#include "atm/AtmosphereGrid.hpp"
+#include "atm/Epoch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace fmx::atm {
+
+namespace {
+
+constexpr char kMagic[8] = {'F','M','X','A','T','G','1','\0'};
+constexpr std::uint32_t kVersion = 2;
+// Densities below this are stored as its logarithm (zero densities have no log)
+constexpr double kTinyRho = 1e-300;
+
+struct GridHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t n_species;
+  std::uint32_t dims[4];
+  double start[4];
+  double step[4];
+  // Indices the grid was sampled with
+  double f107, f107a, ap_daily, ap_now;
+  double ap[7];
+  std::int32_t kp;
+  std::uint32_t has_ap_array;
+};
+static_assert(sizeof(GridHeader) == 192, "atmosphere grid header must be 192 bytes");
+
+// Bracketing nodes and weight of the upper node along one axis
+struct Lerp {
+  std::size_t i0, i1;
+  double w;
+};
+
+// Clamped axis
+inline Lerp locate(const GridAxisSpec& a, double x) {
+  if (a.n < 2) return {0, 0, 0.0};
+  const double u = std::clamp((x - a.start) / a.step, 0.0, static_cast<double>(a.n - 1));
+  const std::size_t i = std::min(static_cast<std::size_t>(u), static_cast<std::size_t>(a.n - 2));
+  return {i, i + 1, u - static_cast<double>(i)};
+}
+
+// Periodic axis over [0, n * step)
+inline Lerp locate_periodic(const GridAxisSpec& a, double x) {
+  if (a.n < 2) return {0, 0, 0.0};
+  const double u = x / a.step;
+  std::size_t i = static_cast<std::size_t>(u);
+  const double w = u - static_cast<double>(i);
+  i %= a.n;
+  return {i, (i + 1) % a.n, w};
+}
+
+} // namespace
+
+double AtmosphereGrid::local_solar_time(double lon_deg, double epoch_s) {
+  double h = std::fmod(epoch_s / 3600.0 + lon_deg / 15.0, 24.0);
+  if (h < 0.0) h += 24.0;
+  return h >= 24.0 ? 0.0 : h;
+}
+
+std::size_t AtmosphereGrid::node_count() const {
+  std::size_t total = 1;
+  for (const auto& a : m_spec) total *= a.n;
+  return valid() ? total : 0;
+}
+
+std::optional<AtmosphereGrid> AtmosphereGrid::sample(const Atmosphere& model, GridSpec spec, const Indices& idx,
+                                                     std::string* err) {
+  for (int d = 0; d < 4; ++d) {
+    if (spec[d].n == 0 || (spec[d].n > 1 && d != kGridLst && !(spec[d].step > 0.0))) {
+      if (err) *err = "Grid axes need at least one node and a positive step";
+      return std::nullopt;
+    }
+  }
+  spec[kGridLst].start = 0.0;
+  spec[kGridLst].step = 24.0 / static_cast<double>(spec[kGridLst].n);
+
+  AtmosphereGrid g;
+  g.m_spec = spec;
+  g.m_drivers = resolve_drivers(idx);
+  const std::size_t NA = spec[kGridAlt].n, NL = spec[kGridLat].n, NS = spec[kGridLst].n;
+  const std::size_t slab = NA * NL * NS;
+  std::vector<double> alt(slab), lat(slab), lon(slab), ep(slab);
+  StateBatch b;
+  for (std::uint32_t k = 0; k < spec[kGridEpoch].n; ++k) {
+    const double epoch = spec[kGridEpoch].start + spec[kGridEpoch].step * k;
+    const double ut_h = day_time(epoch).utsec / 3600.0;
+    // Slab points in storage order; longitude chosen so the point sits at the node's LST
+    for (std::size_t l = 0; l < NS; ++l) {
+      double lon_l = std::fmod(15.0 * (spec[kGridLst].step * l - ut_h), 360.0);
+      if (lon_l < -180.0) lon_l += 360.0;
+      if (lon_l >= 180.0) lon_l -= 360.0;
+      for (std::size_t j = 0; j < NL; ++j) {
+        for (std::size_t i = 0; i < NA; ++i) {
+          const std::size_t p = (l * NL + j) * NA + i;
+          alt[p] = spec[kGridAlt].start + spec[kGridAlt].step * i;
+          lat[p] = spec[kGridLat].start + spec[kGridLat].step * j;
+          lon[p] = lon_l;
+          ep[p] = epoch;
+        }
+      }
+    }
+    model.evaluate_batch(PointBatch{slab, alt.data(), lat.data(), lon.data(), ep.data()}, idx, b);
+    if (k == 0) {
+      if (b.species_count() > kMaxSpecies) {
+        if (err) *err = "Too many species for an atmosphere grid";
+        return std::nullopt;
+      }
+      g.m_species_mass = b.species_mass;
+      g.m_owned.resize(static_cast<std::size_t>(spec[kGridEpoch].n) * slab * g.fields());
+    } else if (b.species_mass != g.m_species_mass) {
+      if (err) *err = "Model species changed between epochs";
+      return std::nullopt;
+    }
+    const std::size_t F = g.fields(), ns = b.species_count();
+    float* dst = g.m_owned.data() + k * slab * F;
+    // Serial: the copy is negligible next to the model calls, and an OpenMP team started here
+    // would make every process-pooled model constructed afterwards run in-process
+    for (std::size_t p = 0; p < slab; ++p) {
+      float* f = dst + p * F;
+      f[0] = static_cast<float>(b.T_K[p]);
+      f[1] = static_cast<float>(b.wind_x[p]);
+      f[2] = static_cast<float>(b.wind_y[p]);
+      f[3] = static_cast<float>(b.wind_z[p]);
+      for (std::size_t s = 0; s < ns; ++s) f[4 + s] = static_cast<float>(std::log(std::max(b.rho_of(s)[p], kTinyRho)));
+    }
+  }
+  return g;
+}
+
+bool AtmosphereGrid::is_grid_file(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  char magic[8] = {};
+  in.read(magic, sizeof(magic));
+  return in.gcount() == sizeof(magic) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool AtmosphereGrid::load(const std::string& path, std::string* err) {
+  fmx::MappedFile mf = fmx::MappedFile::open(path, err);
+  if (!mf.valid()) return false;
+  GridHeader h{};
+  if (mf.size() < sizeof(h)) { if (err) *err = "Truncated atmosphere grid: " + path; return false; }
+  std::memcpy(&h, mf.data(), sizeof(h));
+  if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion) {
+    if (err) *err = "Not an atmosphere grid (or unsupported version): " + path;
+    return false;
+  }
+  std::size_t total = 1;
+  for (int d = 0; d < 4; ++d) {
+    if (h.dims[d] == 0) { if (err) *err = "Empty grid axis in " + path; return false; }
+    total *= h.dims[d];
+  }
+  if (h.n_species > kMaxSpecies) { if (err) *err = "Too many species in " + path; return false; }
+  const std::size_t F = 4 + h.n_species;
+  const std::size_t mass_bytes = h.n_species * sizeof(double);
+  if (mf.size() < sizeof(h) + mass_bytes + total * F * sizeof(float)) {
+    if (err) *err = "Truncated atmosphere grid: " + path;
+    return false;
+  }
+  for (int d = 0; d < 4; ++d) m_spec[d] = GridAxisSpec{h.start[d], h.step[d], h.dims[d]};
+  m_species_mass.resize(h.n_species);
+  std::memcpy(m_species_mass.data(), mf.data() + sizeof(h), mass_bytes);
+  Indices idx;
+  idx.F10_7 = h.f107; idx.F10_7A = h.f107a; idx.Ap_daily = h.ap_daily; idx.Ap_now = h.ap_now;
+  idx.Kp = h.kp;
+  idx.has_ap_array = h.has_ap_array != 0;
+  std::copy(h.ap, h.ap + 7, idx.Ap);
+  m_drivers = resolve_drivers(idx);
+  m_owned.clear();
+  m_map_offset = sizeof(h) + mass_bytes;
+  m_map = std::move(mf);
+  return true;
+}
+
+bool AtmosphereGrid::save(const std::string& path) const {
+  if (!valid()) return false;
+  std::ofstream out(path, std::ios::binary);
+  if (!out) return false;
+  GridHeader h{};
+  std::memcpy(h.magic, kMagic, sizeof(kMagic));
+  h.version = kVersion;
+  h.n_species = static_cast<std::uint32_t>(m_species_mass.size());
+  for (int d = 0; d < 4; ++d) {
+    h.dims[d] = m_spec[d].n; h.start[d] = m_spec[d].start; h.step[d] = m_spec[d].step;
+  }
+  const Indices& idx = m_drivers.idx;
+  h.f107 = idx.F10_7; h.f107a = idx.F10_7A; h.ap_daily = idx.Ap_daily; h.ap_now = idx.Ap_now;
+  std::copy(idx.Ap, idx.Ap + 7, h.ap);
+  h.kp = idx.Kp;
+  h.has_ap_array = idx.has_ap_array ? 1u : 0u;
+  out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+  out.write(reinterpret_cast<const char*>(m_species_mass.data()), m_species_mass.size() * sizeof(double));
+  out.write(reinterpret_cast<const char*>(nodes()), node_count() * fields() * sizeof(float));
+  return static_cast<bool>(out);
+}
+
+void AtmosphereGrid::interpolate(double alt_km, double lat_deg, double lst_h, double epoch_s, double* f) const {
+  const Lerp L[4] = {locate(m_spec[kGridAlt], alt_km), locate(m_spec[kGridLat], lat_deg),
+                     locate_periodic(m_spec[kGridLst], lst_h), locate(m_spec[kGridEpoch], epoch_s)};
+  const std::size_t stride[4] = {1, m_spec[kGridAlt].n, std::size_t(m_spec[kGridAlt].n) * m_spec[kGridLat].n,
+                                 std::size_t(m_spec[kGridAlt].n) * m_spec[kGridLat].n * m_spec[kGridLst].n};
+  const std::size_t F = fields();
+  const float* data = nodes();
+  std::fill(f, f + F, 0.0);
+  for (int c = 0; c < 16; ++c) {
+    double w = 1.0;
+    std::size_t node = 0;
+    for (int d = 0; d < 4; ++d) {
+      const bool hi = (c >> d) & 1;
+      w *= hi ? L[d].w : 1.0 - L[d].w;
+      node += (hi ? L[d].i1 : L[d].i0) * stride[d];
+    }
+    if (w == 0.0) continue;
+    const float* p = data + node * F;
+    for (std::size_t k = 0; k < F; ++k) f[k] += w * p[k];
+  }
+}
+
+AtmosphereState AtmosphereGrid::evaluate(double alt_km, double lat_deg, double lon_deg,
+                                         const std::string& utc_iso, const Indices& idx) const {
+  (void)idx;
+  // Unparseable epochs fall back to the start of the grid
+  double epoch = m_spec[kGridEpoch].start;
+  parse_iso_utc(utc_iso, epoch);
+  return evaluate_epoch(alt_km, lat_deg, lon_deg, epoch, m_drivers);
+}
+
+AtmosphereState AtmosphereGrid::evaluate_epoch(double alt_km, double lat_deg, double lon_deg,
+                                               double epoch_s, const Drivers& drv) const {
+  (void)drv;
+  double f[4 + kMaxSpecies];
+  interpolate(alt_km, lat_deg, local_solar_time(lon_deg, epoch_s), epoch_s, f);
+  AtmosphereState st{};
+  st.T_K = f[0];
+  st.wind_ms = {f[1], f[2], f[3]};
+  st.species.reserve(m_species_mass.size());
+  for (std::size_t s = 0; s < m_species_mass.size(); ++s) st.species.push_back({std::exp(f[4 + s]), m_species_mass[s]});
+  return st;
+}
+
+void AtmosphereGrid::evaluate_batch(const PointBatch& pts, const Indices& idx, StateBatch& out) const {
+  (void)idx;
+  const std::size_t ns = m_species_mass.size();
+  out.resize(pts.n, ns);
+  out.species_mass = m_species_mass;
+#if defined(FMX_USE_OPENMP)
+  #pragma omp parallel for schedule(static)
+#endif
+  for (long long i = 0; i < static_cast<long long>(pts.n); ++i) {
+    double f[4 + kMaxSpecies];
+    interpolate(pts.alt_km[i], pts.lat_deg[i], local_solar_time(pts.lon_deg[i], pts.epoch_s[i]), pts.epoch_s[i], f);
+    out.T_K[i] = f[0];
+    out.wind_x[i] = f[1]; out.wind_y[i] = f[2]; out.wind_z[i] = f[3];
+    for (std::size_t s = 0; s < ns; ++s) out.rho_of(s)[i] = std::exp(f[4 + s]);
+  }
+}
+
+} // namespace fmx::atm
@@ -0,0 +1,89 @@
+// Precomputed atmosphere on a regular (altitude, latitude, local solar time, epoch) grid
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "atm/Atmosphere.hpp"
+#include "core/MappedFile.hpp"
+
+namespace fmx::atm {
+
+// Uniform axis: nodes start + k * step, k = 0..n-1
+struct GridAxisSpec {
+  double start{0.0};
+  double step{1.0};
+  std::uint32_t n{1};
+  double end() const { return start + step * static_cast<double>(n > 0 ? n - 1 : 0); }
+};
+
+// Axes in storage order (altitude fastest). The local solar time axis is periodic over
+// 24 h with n nodes at k * 24/n; its start/step are set by AtmosphereGrid::sample.
+enum GridAxis : int { kGridAlt = 0, kGridLat = 1, kGridLst = 2, kGridEpoch = 3 };
+using GridSpec = std::array<GridAxisSpec, 4>; // alt [km], lat [deg], LST [h], epoch [s]
+
+// Thermosphere fields are nearly fixed with respect to the Sun, so the grid is indexed by
+// local solar time instead of longitude. Each node stores T, the wind components and the
+// natural log of every species mass density (float32), so densities are interpolated in
+// log space. Queries are multilinear over the 16 surrounding nodes; coordinates outside
+// the altitude, latitude and epoch ranges are clamped.
+//
+// The space-weather indices are fixed when the grid is sampled; the Indices/Drivers passed
+// to evaluate() are ignored (drivers() reports the ones used). Files keep the full Indices,
+// so load() resolves the same drivers.
+//
+// File format (native byte order, memory-mapped on load):
+//   header (192 bytes): char magic[8] = "FMXATG1", u32 version = 2, u32 n_species, u32 dims[4],
+//                       double start[4], double step[4], double F10.7, F10.7A, Ap daily,
+//                       Ap now, Ap[7], i32 Kp, u32 has_ap_array
+//   double species_mass[n_species]
+//   float nodes[dims0 * dims1 * dims2 * dims3][4 + n_species]: T, wind x/y/z, ln rho_s
+class AtmosphereGrid : public Atmosphere {
+public:
+  static constexpr std::size_t kMaxSpecies = 12;
+
+  // Evaluate `model` at every node with fixed indices. Each epoch slab is one batch call,
+  // so the model's batch kernel (OpenMP or worker processes) parallelizes generation.
+  static std::optional<AtmosphereGrid> sample(const Atmosphere& model, GridSpec spec, const Indices& idx,
+                                              std::string* err = nullptr);
+
+  bool load(const std::string& path, std::string* err = nullptr);
+  bool save(const std::string& path) const;
+  static bool is_grid_file(const std::string& path);
+
+  AtmosphereState evaluate(double alt_km, double lat_deg, double lon_deg,
+                           const std::string& utc_iso, const Indices& idx) const override;
+  AtmosphereState evaluate_epoch(double alt_km, double lat_deg, double lon_deg,
+                                 double epoch_s, const Drivers& drv) const override;
+  void evaluate_batch(const PointBatch& pts, const Indices& idx, StateBatch& out) const override;
+
+  // Local solar time [h, 0..24) of a longitude at a UTC epoch
+  static double local_solar_time(double lon_deg, double epoch_s);
+
+  bool valid() const { return m_map.valid() || !m_owned.empty(); }
+  const GridSpec& spec() const { return m_spec; }
+  const std::vector<double>& species_mass() const { return m_species_mass; }
+  const Drivers& drivers() const { return m_drivers; }
+  std::size_t node_count() const;
+  std::size_t bytes() const { return node_count() * fields() * sizeof(float); }
+
+private:
+  GridSpec m_spec{};
+  std::vector<double> m_species_mass;
+  Drivers m_drivers;
+  std::vector<float> m_owned;  // nodes of a sampled grid
+  fmx::MappedFile m_map;       // backing store of a loaded grid
+  std::size_t m_map_offset{0}; // byte offset of the nodes inside m_map
+
+  // Node storage: the mapped file if present, else m_owned (copy-safe)
+  const float* nodes() const {
+    return m_map.valid() ? reinterpret_cast<const float*>(m_map.data() + m_map_offset) : m_owned.data();
+  }
+  std::size_t fields() const { return 4 + m_species_mass.size(); }
+  // Interpolated node fields (T, wind, ln rho) at grid coordinates
+  void interpolate(double alt_km, double lat_deg, double lst_h, double epoch_s, double* f) const;
+};
+
+} // namespace fmx::atm
@@ -0,0 +1,107 @@
+#include "atm/AtmosphereSession.hpp"
+#include "atm/AtmosphereGrid.hpp"
+#include "atm/Combined.hpp"
+#include "atm/HWM14.hpp"
+#include "atm/NRLMSIS2.hpp"
+#include "atm/SpaceWeather.hpp"
+#include "core/Trace.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <vector>
+
+namespace fmx::atm {
+
+// Configured directory, else the first default location that contains `probe`
+static std::string data_dir(const std::string& configured, const char* in_tree, const char* probe) {
+  if (!configured.empty()) return configured;
+  if (std::ifstream(std::string(in_tree) + "/" + probe, std::ios::binary).good()) return in_tree;
+  return ".";
+}
+
+std::optional<AtmosphereSession> AtmosphereSession::open(const SessionConfig& cfg, std::string* err) {
+  FMX_TRACE_SCOPE("atm.open", "atmosphere");
+  AtmosphereSession s;
+  s.m_name = cfg.model;
+  if (cfg.model == "Stub") {
+    s.m_model = std::make_shared<StubAtmosphere>();
+  } else if (cfg.model == "NRLMSIS2") {
+    if (!NRLMSIS2Atmosphere::initialize(data_dir(cfg.msis_parm_dir, "atm/models/NRLMSIS2.1", "msis21.parm"), err)) return std::nullopt;
+    s.m_model = std::make_shared<NRLMSIS2Atmosphere>(cfg.model_workers);
+  } else if (cfg.model == "NRLMSIS2+HWM14") {
+    if (!NRLMSIS2Atmosphere::initialize(data_dir(cfg.msis_parm_dir, "atm/models/NRLMSIS2.1", "msis21.parm"), err)) return std::nullopt;
+    if (!HWM14::initialize(data_dir(cfg.hwm_data_dir, "atm/models/hwm14/data", "hwm123114.bin"), err)) return std::nullopt;
+    s.m_model = std::make_shared<CombinedAtmosphere>(cfg.model_workers);
+  } else if (cfg.model == "Grid") {
+    auto g = std::make_shared<AtmosphereGrid>();
+    if (!g->load(cfg.grid_path, err)) return std::nullopt;
+    s.m_model = std::move(g);
+  } else {
+    if (err) *err = "Unknown atmosphere model: " + cfg.model;
+    return std::nullopt;
+  }
+  return s;
+}
+
+const Drivers& AtmosphereSession::drivers(const Indices& idx) {
+  if (!m_have_drivers || !same_indices(idx, m_drivers.idx)) {
+    m_drivers = resolve_drivers(idx);
+    m_have_drivers = true;
+  }
+  return m_drivers;
+}
+
+AtmosphereState AtmosphereSession::evaluate(double alt_km, double lat_deg, double lon_deg, double epoch_s,
+                                            const Indices& idx) {
+  FMX_TRACE_SCOPE("atm.evaluate", "atmosphere");
+  return m_model->evaluate_epoch(alt_km, lat_deg, lon_deg, epoch_s, drivers(idx));
+}
+
+void AtmosphereSession::evaluate_batch(const PointBatch& pts, const Indices& idx, StateBatch& out) const {
+  FMX_TRACE_SCOPE("atm.batch", "atmosphere", static_cast<std::int64_t>(pts.n));
+  m_model->evaluate_batch(pts, idx, out);
+}
+
+AtmosphereState AtmosphereSession::evaluate(double alt_km, double lat_deg, double lon_deg, double epoch_s,
+                                            const SpaceWeatherTable& sw) {
+  return evaluate(alt_km, lat_deg, lon_deg, epoch_s, sw.indices(epoch_s));
+}
+
+void AtmosphereSession::evaluate_batch(const PointBatch& pts, const SpaceWeatherTable& sw, StateBatch& out) const {
+  FMX_TRACE_SCOPE("atm.batch", "atmosphere", static_cast<std::int64_t>(pts.n));
+  std::vector<std::int64_t> key(pts.n);
+  for (std::size_t i = 0; i < pts.n; ++i) key[i] = SpaceWeatherTable::slot(pts.epoch_s[i]);
+  if (pts.n == 0 || std::all_of(key.begin(), key.end(), [&](std::int64_t k){ return k == key[0]; })) {
+    m_model->evaluate_batch(pts, sw.indices(pts.n ? pts.epoch_s[0] : 0.0), out);
+    return;
+  }
+  // Points ordered by slot (stable, so each group keeps the caller's order)
+  std::vector<std::size_t> order(pts.n);
+  std::iota(order.begin(), order.end(), std::size_t{0});
+  std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b){ return key[a] < key[b]; });
+  std::vector<double> alt, lat, lon, ep;
+  StateBatch part;
+  bool first = true;
+  for (std::size_t g0 = 0; g0 < pts.n; ) {
+    std::size_t g1 = g0;
+    while (g1 < pts.n && key[order[g1]] == key[order[g0]]) ++g1;
+    const std::size_t m = g1 - g0;
+    alt.resize(m); lat.resize(m); lon.resize(m); ep.resize(m);
+    for (std::size_t j = 0; j < m; ++j) {
+      const std::size_t i = order[g0 + j];
+      alt[j] = pts.alt_km[i]; lat[j] = pts.lat_deg[i]; lon[j] = pts.lon_deg[i]; ep[j] = pts.epoch_s[i];
+    }
+    m_model->evaluate_batch(PointBatch{m, alt.data(), lat.data(), lon.data(), ep.data()}, sw.indices(ep[0]), part);
+    if (first) { out.resize(pts.n, part.species_count()); out.species_mass = part.species_mass; first = false; }
+    for (std::size_t j = 0; j < m; ++j) {
+      const std::size_t i = order[g0 + j];
+      out.T_K[i] = part.T_K[j];
+      out.wind_x[i] = part.wind_x[j]; out.wind_y[i] = part.wind_y[j]; out.wind_z[i] = part.wind_z[j];
+      for (std::size_t s = 0; s < out.species_count() && s < part.species_count(); ++s) out.rho_of(s)[i] = part.rho_of(s)[j];
+    }
+    g0 = g1;
+  }
+}
+
+} // namespace fmx::atm
@@ -0,0 +1,50 @@
+// Long-lived atmosphere context: models initialized once, numeric epochs, cached drivers
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include "atm/Atmosphere.hpp"
+
+namespace fmx::atm {
+
+class SpaceWeatherTable;
+
+struct SessionConfig {
+  std::string model{"Stub"};                          // Stub | NRLMSIS2 | NRLMSIS2+HWM14 | Grid
+  // Data directories; empty: atm/models/<model>/... if present, else the working directory
+  std::string msis_parm_dir;                            // directory holding msis21.parm
+  std::string hwm_data_dir;                             // directory holding the HWM14 data files
+  std::string grid_path;                                // model "Grid": file written by gen_atm_grid
+  int model_workers{1};                                 // worker processes for batches (ModelPool, forked by open(); 0: one per core)
+};
+
+// Resolves data paths and initializes the Fortran models once at open(), so evaluations
+// skip the per-call file checks and CWD copies of the sessionless models. Epochs are
+// numeric (atm/Epoch.hpp) and the drivers resolved from the last Indices are reused while
+// the indices do not change. With model_workers != 1 the model's worker processes are forked
+// by open(), so open the session before starting any thread.
+class AtmosphereSession {
+public:
+  static std::optional<AtmosphereSession> open(const SessionConfig& cfg, std::string* err = nullptr);
+
+  AtmosphereState evaluate(double alt_km, double lat_deg, double lon_deg, double epoch_s, const Indices& idx);
+  void evaluate_batch(const PointBatch& pts, const Indices& idx, StateBatch& out) const;
+  // Indices looked up per epoch. Batches are grouped by 3-hour index slot and each group is
+  // one model batch call, so a single batch may span any number of days.
+  AtmosphereState evaluate(double alt_km, double lat_deg, double lon_deg, double epoch_s, const SpaceWeatherTable& sw);
+  void evaluate_batch(const PointBatch& pts, const SpaceWeatherTable& sw, StateBatch& out) const;
+
+  const Atmosphere& model() const { return *m_model; }
+  const std::string& model_name() const { return m_name; }
+
+private:
+  std::shared_ptr<const Atmosphere> m_model;
+  std::string m_name;
+  Drivers m_drivers;
+  bool m_have_drivers{false};
+
+  const Drivers& drivers(const Indices& idx);
+};
+
+} // namespace fmx::atm
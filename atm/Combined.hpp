@@ -3,25 +3,41 @@
 #include "atm/Atmosphere.hpp"
 #include "atm/NRLMSIS2.hpp"
 #include "atm/HWM14.hpp"
+#include "atm/ModelPool.hpp"
 
 namespace fmx::atm {
 
 // Combines NRLMSIS2 (T, species) with HWM14 (wind)
 class CombinedAtmosphere : public Atmosphere {
 public:
+  // model_workers != 1: batches run both Fortran models in one set of worker processes
+  // (ModelPool), forked here; construct before starting threads
+  explicit CombinedAtmosphere(int model_workers = 1) : m_pool(make_model_pool(model_workers)), m_msis(m_pool) {}
+
   AtmosphereState evaluate(double alt_km, double lat_deg, double lon_deg,
                            const std::string& utc_iso,
                            const Indices& idx) const override {
-    NRLMSIS2Atmosphere msis;
-    AtmosphereState st = msis.evaluate(alt_km, lat_deg, lon_deg, utc_iso, idx);
-    // Choose ap3hr for wind
-    double ap3hr = 0.0;
-    if (idx.has_ap_array) ap3hr = idx.Ap[1];
-    else if (idx.Ap_now > 0.0) ap3hr = idx.Ap_now;
-    else ap3hr = 10.0; // fallback
-    st.wind_ms = HWM14::evaluate_wind(alt_km, lat_deg, lon_deg, utc_iso, ap3hr);
+    AtmosphereState st = m_msis.evaluate(alt_km, lat_deg, lon_deg, utc_iso, idx);
+    st.wind_ms = HWM14::evaluate_wind(alt_km, lat_deg, lon_deg, utc_iso, resolve_drivers(idx).ap3hr);
+    return st;
+  }
+
+  AtmosphereState evaluate_epoch(double alt_km, double lat_deg, double lon_deg,
+                                 double epoch_s, const Drivers& drv) const override {
+    AtmosphereState st = m_msis.evaluate_epoch(alt_km, lat_deg, lon_deg, epoch_s, drv);
+    st.wind_ms = HWM14::evaluate_wind_epoch(alt_km, lat_deg, lon_deg, epoch_s, drv.ap3hr);
     return st;
   }
+
+  void evaluate_batch(const PointBatch& pts, const Indices& idx, StateBatch& out) const override {
+    m_msis.evaluate_batch(pts, idx, out);
+    HWM14::evaluate_wind_batch(pts.n, pts.alt_km, pts.lat_deg, pts.lon_deg, pts.epoch_s, resolve_drivers(idx).ap3hr,
+                               out.wind_x.data(), out.wind_y.data(), out.wind_z.data(), m_pool.get());
+  }
+
+private:
+  std::shared_ptr<ModelPool> m_pool;
+  NRLMSIS2Atmosphere m_msis;
 };
 
 } // namespace fmx::atm
@@ -0,0 +1,75 @@
+#include "atm/Epoch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace fmx::atm {
+
+namespace {
+
+// Days since 1970-01-01 of a proleptic Gregorian date (H. Hinnant's algorithm)
+long long days_from_civil(long long y, unsigned m, unsigned d) {
+  y -= m <= 2;
+  const long long era = (y >= 0 ? y : y - 399) / 400;
+  const unsigned yoe = static_cast<unsigned>(y - era * 400);
+  const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + static_cast<long long>(doe) - 719468;
+}
+
+void civil_from_days(long long z, int& y, unsigned& m, unsigned& d) {
+  z += 719468;
+  const long long era = (z >= 0 ? z : z - 146096) / 146097;
+  const unsigned doe = static_cast<unsigned>(z - era * 146097);
+  const unsigned yoe = (doe - doe/1460 + doe/36524 - doe/146096) / 365;
+  const unsigned doy = doe - (365*yoe + yoe/4 - yoe/100);
+  const unsigned mp = (5*doy + 2) / 153;
+  d = doy - (153*mp + 2)/5 + 1;
+  m = mp < 10 ? mp + 3 : mp - 9;
+  y = static_cast<int>(static_cast<long long>(yoe) + era * 400 + (m <= 2));
+}
+
+} // namespace
+
+bool parse_iso_utc(const std::string& s, double& epoch_s) {
+  // Fixed positions: YYYY-MM-DDThh:mm:ss, seconds may carry a fraction and a trailing Z
+  if (s.size() < 19 || s[4] != '-' || s[7] != '-' || s[13] != ':' || s[16] != ':') return false;
+  try {
+    const int year = std::stoi(s.substr(0,4));
+    const int mon  = std::stoi(s.substr(5,2));
+    const int mday = std::stoi(s.substr(8,2));
+    const int hour = std::stoi(s.substr(11,2));
+    const int min  = std::stoi(s.substr(14,2));
+    const size_t p = 17; const size_t end = s.find_first_of("Zz ", p);
+    const double sec = std::stod(s.substr(p, end==std::string::npos ? std::string::npos : (end-p)));
+    if (mon < 1 || mon > 12 || mday < 1 || mday > 31) return false;
+    epoch_s = static_cast<double>(days_from_civil(year, static_cast<unsigned>(mon), static_cast<unsigned>(mday))) * 86400.0
+            + hour*3600.0 + min*60.0 + sec;
+    return true;
+  } catch (...) { return false; }
+}
+
+DayTime day_time(double epoch_s) {
+  const double days = std::floor(epoch_s / 86400.0);
+  DayTime t;
+  t.utsec = epoch_s - days * 86400.0;
+  int y; unsigned m, d;
+  civil_from_days(static_cast<long long>(days), y, m, d);
+  t.year = y;
+  t.doy = static_cast<int>(static_cast<long long>(days) - days_from_civil(y, 1, 1)) + 1;
+  return t;
+}
+
+std::string format_iso_utc(double epoch_s) {
+  const double days = std::floor(epoch_s / 86400.0);
+  int y; unsigned m, d;
+  civil_from_days(static_cast<long long>(days), y, m, d);
+  const long long ms = std::clamp(std::llround((epoch_s - days * 86400.0) * 1000.0), 0LL, 86399999LL);
+  const int msec = static_cast<int>(ms % 1000), sec = static_cast<int>((ms / 1000) % 60);
+  const int min = static_cast<int>((ms / 60000) % 60), hour = static_cast<int>(ms / 3600000);
+  char buf[64]; // room for any int year; the time fields are clamped to their widths
+  std::snprintf(buf, sizeof(buf), "%04d-%02u-%02uT%02d:%02d:%02d.%03dZ", y, m, d, hour, min, sec, msec);
+  return buf;
+}
+
+} // namespace fmx::atm
@@ -0,0 +1,26 @@
+// UTC epochs: ISO-8601 parsing and numeric time shared by the atmosphere models
+#pragma once
+
+#include <string>
+
+namespace fmx::atm {
+
+// Numeric epochs are UTC seconds since 1970-01-01T00:00:00Z (POSIX time, no leap seconds)
+
+// Parse "YYYY-MM-DDThh:mm:ss[.fff][Z]"; false on malformed input
+bool parse_iso_utc(const std::string& s, double& epoch_s);
+// Inverse of parse_iso_utc (millisecond resolution)
+std::string format_iso_utc(double epoch_s);
+
+// Calendar quantities used by NRLMSIS/HWM: day of year (1-based) and UT seconds of day
+struct DayTime {
+  int year{1970};
+  int doy{1};
+  double utsec{0.0};
+};
+DayTime day_time(double epoch_s);
+
+// Fallback used by the models when a UTC string cannot be parsed (day 100, noon)
+inline constexpr DayTime kFallbackDayTime{2000, 100, 43200.0};
+
+} // namespace fmx::atm
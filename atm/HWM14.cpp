@@ -1,77 +1,140 @@
 #include "atm/HWM14.hpp"
+#include "atm/Epoch.hpp"
+#include "atm/ModelPool.hpp"
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <vector>
 
 extern "C" {
 #if defined(FMX_WITH_HWM14_LOCAL)
 void hwm14_eval_c(int doy, double utsec, double alt_km, double lat_deg, double lon_deg, double ap3hr,
                   double& w_meridional, double& w_zonal);
+void hwm14_eval_batch_c(int n, const int* doy, const double* utsec, const double* alt_km,
+                        const double* lat_deg, const double* lon_deg, double ap3hr,
+                        double* w_meridional, double* w_zonal);
 #endif
 }
 
 namespace fmx::atm {
 
-static bool parse_iso_utc_hw(const std::string& s, int& year, int& mon, int& mday, int& hour, int& min, double& sec) {
-  year=0;mon=0;mday=0;hour=0;min=0;sec=0.0;
-  if (s.size() < 20) return false;
-  try {
-    year = std::stoi(s.substr(0,4));
-    mon  = std::stoi(s.substr(5,2));
-    mday = std::stoi(s.substr(8,2));
-    hour = std::stoi(s.substr(11,2));
-    min  = std::stoi(s.substr(14,2));
-    size_t p = 17; size_t end = s.find_first_of("Zz ", p);
-    std::string ssec = s.substr(p, end==std::string::npos ? std::string::npos : (end-p));
-    sec = std::stod(ssec);
-    return true;
-  } catch (...) { return false; }
+// Set once the data directory has been configured via initialize()
+static std::atomic<bool> g_hwm_initialized{false};
+
+#if defined(FMX_WITH_HWM14_LOCAL)
+static const char* kHwmFiles[3] = {"hwm123114.bin", "dwm07b104i.dat", "gd2qd.dat"};
+
+// Ensure HWM14 binary climatology present in CWD (sessionless use only)
+static void ensure_hwm_files() {
+  if (g_hwm_initialized.load(std::memory_order_relaxed)) return;
+  auto ensure_file = [](const char* fname){
+    std::ifstream t(fname, std::ios::binary);
+    if (t.good()) return;
+    std::string srcp = std::string("atm/models/hwm14/data/") + fname;
+    std::ifstream src(srcp, std::ios::binary);
+    if (src.good()) { std::ofstream dst(fname, std::ios::binary); dst << src.rdbuf(); }
+  };
+  for (const char* f : kHwmFiles) ensure_file(f);
 }
 
-static int doy_from_ymd_hw(int y, int m, int d) {
-  static const int mdays[12] = {31,28,31,30,31,30,31,31,30,31,30,31};
-  auto is_leap = [](int yy){ return (yy%4==0 && (yy%100!=0 || yy%400==0)); };
-  int doy = 0; for (int i=1;i<m;i++) doy += (i==2 && is_leap(y)) ? 29 : mdays[i-1];
-  return doy + d;
+// Pool kernel: in = {doy, utsec, alt, lat, lon}, out = {meridional, zonal}, args = {ap3hr}
+static void hwm_kernel(std::size_t m, const double* const* in, double* const* out, const double* args) {
+  std::vector<int> doy(m);
+  for (std::size_t i = 0; i < m; ++i) doy[i] = static_cast<int>(in[0][i]);
+  hwm14_eval_batch_c(static_cast<int>(m), doy.data(), in[1], in[2], in[3], in[4], args[0], out[0], out[1]);
+}
+#else
+static void warn_synthetic() {
+  static bool warned = false;
+  if (!warned) {
+    std::cerr << "[HWM14] Library not linked; using synthesized wind field.\n";
+    warned = true;
+  }
 }
 
-fmx::Vec3 HWM14::evaluate_wind(double alt_km, double lat_deg, double lon_deg,
-                                const std::string& utc_iso, double ap3hr) {
-  (void)lon_deg; (void)utc_iso;
+// Simple lat/alt-dependent synthetic wind: zonal winds ~ 50-150 m/s
+static inline double synthetic_zonal(double alt_km, double lat_deg) {
+  double phi = lat_deg * M_PI/180.0;
+  return 100.0 * std::cos(phi) * std::exp(-(alt_km-100.0)/400.0);
+}
+#endif
+
+bool HWM14::initialize(const std::string& data_dir, std::string* err) {
+  std::string dir = data_dir.empty() ? std::string(".") : data_dir;
+  if (dir.back() != '/') dir += '/';
 #if defined(FMX_WITH_HWM14_LOCAL)
-  // Ensure HWM14 binary climatology present in CWD
-  {
-    auto ensure_file = [](const char* fname){
-      std::ifstream t(fname, std::ios::binary);
-      if (t.good()) return;
-      std::string srcp = std::string("atm/models/hwm14/data/") + fname;
-      std::ifstream src(srcp, std::ios::binary);
-      if (src.good()) { std::ofstream dst(fname, std::ios::binary); dst << src.rdbuf(); }
-    };
-    ensure_file("hwm123114.bin");
-    ensure_file("dwm07b104i.dat");
-    ensure_file("gd2qd.dat");
-  }
-  // Parse UTC to get day-of-year and UT seconds
-  int y, mo, md, hh, mm; double ss;
-  int doy = 100; double utsec = 43200.0;
-  if (parse_iso_utc_hw(utc_iso, y, mo, md, hh, mm, ss)) {
-    doy = doy_from_ymd_hw(y, mo, md);
-    utsec = hh*3600.0 + mm*60.0 + ss;
+  for (const char* f : kHwmFiles) {
+    if (!std::ifstream(dir + f, std::ios::binary).good()) {
+      if (err) *err = std::string(f) + " not found in " + dir;
+      return false;
+    }
   }
+  ::setenv("HWMPATH", dir.c_str(), 1);
+#else
+  (void)err;
+#endif
+  g_hwm_initialized = true;
+  return true;
+}
+
+static fmx::Vec3 wind_point(double alt_km, double lat_deg, double lon_deg, const DayTime& t, double ap3hr) {
+  (void)lon_deg; (void)t; (void)ap3hr;
+#if defined(FMX_WITH_HWM14_LOCAL)
+  ensure_hwm_files();
   double wm=0.0, wz=0.0;
-  hwm14_eval_c(doy, utsec, alt_km, lat_deg, lon_deg, ap3hr, wm, wz);
+  hwm14_eval_c(t.doy, t.utsec, alt_km, lat_deg, lon_deg, ap3hr, wm, wz);
   return {0.0, wz, wm};
+#else
+  warn_synthetic();
+  return {0.0, synthetic_zonal(alt_km, lat_deg), 0.0};
 #endif
-  static bool warned = false;
-  if (!warned) {
-    std::cerr << "[HWM14] Library not linked; using synthesized wind field.\n";
-    warned = true;
+}
+
+fmx::Vec3 HWM14::evaluate_wind(double alt_km, double lat_deg, double lon_deg,
+                                const std::string& utc_iso, double ap3hr) {
+  // Parse UTC to get day-of-year and UT seconds
+  double epoch = 0.0;
+  const DayTime t = parse_iso_utc(utc_iso, epoch) ? day_time(epoch) : kFallbackDayTime;
+  return wind_point(alt_km, lat_deg, lon_deg, t, ap3hr);
+}
+
+fmx::Vec3 HWM14::evaluate_wind_epoch(double alt_km, double lat_deg, double lon_deg,
+                                      double epoch_s, double ap3hr) {
+  return wind_point(alt_km, lat_deg, lon_deg, day_time(epoch_s), ap3hr);
+}
+
+void HWM14::evaluate_wind_batch(std::size_t n, const double* alt_km, const double* lat_deg,
+                                const double* lon_deg, const double* epoch_s, double ap3hr,
+                                double* wind_x, double* wind_y, double* wind_z, ModelPool* pool) {
+  const long long nn = static_cast<long long>(n);
+#if defined(FMX_WITH_HWM14_LOCAL)
+  ensure_hwm_files();
+  std::vector<double> doy(n), utsec(n);
+  // Serial when pooled: the workers carry the load and the caller starts no OpenMP team
+  // (a later pool constructed in this process could not fork)
+#if defined(FMX_USE_OPENMP)
+  #pragma omp parallel for schedule(static) if(!pool)
+#endif
+  for (long long i = 0; i < nn; ++i) { const DayTime t = day_time(epoch_s[i]); doy[i] = t.doy; utsec[i] = t.utsec; }
+  // One boundary crossing per batch (or per worker chunk); the Fortran model is not reentrant,
+  // so concurrency comes from worker processes with private module state
+  const std::vector<const double*> in = {doy.data(), utsec.data(), alt_km, lat_deg, lon_deg};
+  if (n > 0 && !(pool && pool->run(hwm_kernel, n, in, {{wind_z, 1}, {wind_y, 1}}, {ap3hr}))) {
+    double* o[2] = {wind_z, wind_y};
+    hwm_kernel(n, in.data(), o, &ap3hr);
   }
-  // Simple lat/alt-dependent synthetic wind: zonal winds ~ 50-150 m/s
-  double phi = lat_deg * M_PI/180.0;
-  double zonal = 100.0 * std::cos(phi) * std::exp(-(alt_km-100.0)/400.0);
-  return {0.0, zonal, 0.0};
+  for (long long i = 0; i < nn; ++i) wind_x[i] = 0.0;
+#else
+  (void)lon_deg; (void)epoch_s; (void)ap3hr; (void)pool;
+  warn_synthetic();
+#if defined(FMX_USE_OPENMP)
+  #pragma omp parallel for schedule(static)
+#endif
+  for (long long i = 0; i < nn; ++i) { wind_x[i] = 0.0; wind_y[i] = synthetic_zonal(alt_km[i], lat_deg[i]); wind_z[i] = 0.0; }
+#endif
 }
 
 } // namespace fmx::atm
@@ -1,15 +1,29 @@
 #pragma once
 
 #include "core/types.hpp"
+#include <cstddef>
 #include <string>
 
 namespace fmx::atm {
 
+class ModelPool;
+
 // Thin wind-only wrapper for HWM14.
 struct HWM14 {
   // Returns neutral wind vector [m/s] at given state.
   static fmx::Vec3 evaluate_wind(double alt_km, double lat_deg, double lon_deg,
                                  const std::string& utc_iso, double ap3hr);
+  // Same at a numeric epoch (UTC seconds since 1970)
+  static fmx::Vec3 evaluate_wind_epoch(double alt_km, double lat_deg, double lon_deg,
+                                       double epoch_s, double ap3hr);
+  // One-time setup: point the model at the directory holding hwm123114.bin, dwm07b104i.dat
+  // and gd2qd.dat (HWMPATH). Afterwards no per-call file checks or CWD copies are made.
+  static bool initialize(const std::string& data_dir, std::string* err = nullptr);
+  // Winds at n points (epochs in UTC seconds since 1970), written as Vec3 components.
+  // With a running pool the linked model runs in its worker processes, else in-process.
+  static void evaluate_wind_batch(std::size_t n, const double* alt_km, const double* lat_deg,
+                                  const double* lon_deg, const double* epoch_s, double ap3hr,
+                                  double* wind_x, double* wind_y, double* wind_z, ModelPool* pool = nullptr);
 };
 
 } // namespace fmx::atm
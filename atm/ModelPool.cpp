@@ -0,0 +1,175 @@
+#include "atm/ModelPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <dirent.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace fmx::atm {
+
+namespace {
+
+// One chunk of a slice; pointers are into the slab, which workers map at the same address
+struct Job {
+  PoolKernel kernel;
+  std::size_t m;
+  const double* in[ModelPool::kMaxArrays];
+  double* out[ModelPool::kMaxArrays];
+  double args[ModelPool::kMaxArgs];
+};
+
+bool send_all(int fd, const void* p, std::size_t n) {
+  const char* c = static_cast<const char*>(p);
+  while (n > 0) {
+    const ssize_t k = ::send(fd, c, n, MSG_NOSIGNAL);
+    if (k < 0 && errno == EINTR) continue;
+    if (k <= 0) return false;
+    c += k; n -= static_cast<std::size_t>(k);
+  }
+  return true;
+}
+
+bool recv_all(int fd, void* p, std::size_t n) {
+  char* c = static_cast<char*>(p);
+  while (n > 0) {
+    const ssize_t k = ::recv(fd, c, n, 0);
+    if (k < 0 && errno == EINTR) continue;
+    if (k <= 0) return false;
+    c += k; n -= static_cast<std::size_t>(k);
+  }
+  return true;
+}
+
+// Worker: run jobs until the parent closes its end (or exits)
+[[noreturn]] void worker_loop(int fd) {
+  Job j;
+  while (recv_all(fd, &j, sizeof(j))) {
+    char status = 0;
+    try { j.kernel(j.m, j.in, j.out, j.args); } catch (...) { status = 1; }
+    if (!send_all(fd, &status, 1)) break;
+  }
+  ::_exit(0);
+}
+
+} // namespace
+
+ModelPool::ModelPool(int workers, std::size_t min_chunk, std::size_t slab_doubles)
+  : m_workers(workers > 0 ? workers : std::max(1, static_cast<int>(std::thread::hardware_concurrency()))),
+    m_min_chunk(std::max<std::size_t>(1, min_chunk)) {
+  if (!can_fork()) {
+    std::cerr << "[ModelPool] Process already runs other threads; model batches run in-process.\n";
+    return;
+  }
+  m_slab = SharedArray<double>(slab_doubles);
+  if (!m_slab.valid()) return;
+  for (int w = 0; w < m_workers; ++w) {
+    int sv[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) != 0) break;
+    const pid_t pid = ::fork();
+    if (pid == 0) {
+      // Drop the parent ends, so every worker sees EOF once the parent is gone
+      for (int fd : m_fds) ::close(fd);
+      ::close(sv[0]);
+      worker_loop(sv[1]);
+    }
+    ::close(sv[1]);
+    if (pid < 0) { ::close(sv[0]); break; }
+    m_pids.push_back(pid);
+    m_fds.push_back(sv[0]);
+  }
+  m_alive = !m_pids.empty();
+}
+
+ModelPool::~ModelPool() {
+  for (int fd : m_fds) ::close(fd);
+  for (pid_t pid : m_pids) {
+    int status = 0;
+    while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+  }
+}
+
+bool ModelPool::running() const {
+  std::lock_guard<std::mutex> lk(m_mu);
+  return m_alive;
+}
+
+bool ModelPool::can_fork() {
+  DIR* dir = ::opendir("/proc/self/task");
+  if (!dir) return true;
+  int threads = 0;
+  while (const dirent* ent = ::readdir(dir)) {
+    if (std::strcmp(ent->d_name, ".") != 0 && std::strcmp(ent->d_name, "..") != 0) ++threads;
+  }
+  ::closedir(dir);
+  return threads <= 1;
+}
+
+bool ModelPool::run(PoolKernel kernel, std::size_t n, const std::vector<const double*>& in,
+                    const std::vector<PoolOutput>& out, const std::vector<double>& args) {
+  std::lock_guard<std::mutex> lk(m_mu);
+  if (!m_alive || in.size() > kMaxArrays || out.size() > kMaxArrays || args.size() > kMaxArgs) return false;
+  if (n == 0) return true;
+  std::size_t per_point = in.size();
+  for (const auto& o : out) per_point += o.width;
+  const std::size_t slice = per_point ? m_slab.size() / per_point : n;
+  if (slice == 0) return false;
+  const std::size_t live = m_fds.size();
+
+  Job job{};
+  job.kernel = kernel;
+  std::copy(args.begin(), args.end(), job.args);
+  for (std::size_t s0 = 0; s0 < n; s0 += slice) {
+    const std::size_t m = std::min(slice, n - s0);
+    // Slice layout: input columns, then output columns, each m points long
+    double* p = m_slab.data();
+    std::vector<double*> in_col(in.size()), out_col(out.size());
+    for (std::size_t k = 0; k < in.size(); ++k) {
+      in_col[k] = p; std::copy(in[k] + s0, in[k] + s0 + m, p); p += m;
+    }
+    for (std::size_t k = 0; k < out.size(); ++k) { out_col[k] = p; p += out[k].width * m; }
+
+    const std::size_t chunks = std::min(live, std::max<std::size_t>(1, (m + m_min_chunk - 1) / m_min_chunk));
+    const std::size_t step = (m + chunks - 1) / chunks;
+    std::size_t sent = 0;
+    bool ok = true;
+    for (std::size_t c = 0; c < chunks; ++c) {
+      const std::size_t b = c * step, e = std::min(m, b + step);
+      if (b >= e) break;
+      job.m = e - b;
+      for (std::size_t k = 0; k < in.size(); ++k) job.in[k] = in_col[k] + b;
+      for (std::size_t k = 0; k < out.size(); ++k) job.out[k] = out_col[k] + out[k].width * b;
+      if (!send_all(m_fds[c], &job, sizeof(job))) { m_alive = false; ok = false; break; }
+      ++sent;
+    }
+    // Every dispatched chunk answers before the slab is reused
+    for (std::size_t c = 0; c < sent; ++c) {
+      char status = 1;
+      if (!recv_all(m_fds[c], &status, 1)) m_alive = false;
+      if (status != 0) ok = false;
+    }
+    if (!ok) return false;
+    for (std::size_t k = 0; k < out.size(); ++k) {
+      const std::size_t w = out[k].width;
+      std::copy(out_col[k], out_col[k] + w * m, out[k].data + w * s0);
+    }
+  }
+  return true;
+}
+
+std::shared_ptr<ModelPool> make_model_pool(int workers) {
+#if defined(FMX_WITH_NRLMSIS2_LOCAL) || defined(FMX_WITH_HWM14_LOCAL)
+  if (workers == 1) return nullptr;
+  auto pool = std::make_shared<ModelPool>(workers);
+  return pool->running() ? pool : nullptr;
+#else
+  (void)workers;
+  return nullptr;
+#endif
+}
+
+} // namespace fmx::atm
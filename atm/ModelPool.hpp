@@ -0,0 +1,97 @@
+// Process pool isolating non-reentrant Fortran models (NRLMSIS2, HWM14) per worker
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/types.h>
+
+namespace fmx::atm {
+
+// Anonymous MAP_SHARED array: writes from forked workers are visible to the parent
+template <typename T>
+class SharedArray {
+  static_assert(std::is_trivially_copyable_v<T>, "SharedArray holds trivially copyable values");
+public:
+  SharedArray() = default;
+  explicit SharedArray(std::size_t n) : m_size(n) {
+    if (n == 0) return;
+    void* p = ::mmap(nullptr, n * sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) { m_size = 0; return; }
+    const std::size_t bytes = n * sizeof(T);
+    m_base = std::shared_ptr<T>(static_cast<T*>(p), [bytes](T* q){ ::munmap(q, bytes); });
+  }
+  bool valid() const { return m_base != nullptr; }
+  T* data() const { return m_base.get(); }
+  std::size_t size() const { return m_size; }
+  T& operator[](std::size_t i) const { return m_base.get()[i]; }
+
+private:
+  std::shared_ptr<T> m_base;
+  std::size_t m_size{0};
+};
+
+// Pooled model evaluation over m points: in[k] holds one double per point, out[k] the
+// declared width per point (point-major), args the batch's scalar arguments. Kernels are
+// plain functions, so their addresses are valid in workers forked from the same image.
+using PoolKernel = void (*)(std::size_t m, const double* const* in, double* const* out, const double* args);
+
+struct PoolOutput {
+  double* data{nullptr};
+  std::size_t width{1}; // doubles per point
+};
+
+// Persistent worker processes, forked once at construction. Every worker starts from a
+// copy-on-write snapshot of the parent, so module-level model state (loaded parameters,
+// cached terms) is private per worker and kept between batches; nothing is shared except a
+// MAP_SHARED slab mapped before the fork. run() copies a batch through the slab slice by
+// slice and splits each slice into contiguous chunks, one per worker, so results are
+// bitwise identical to calling the kernel in-process.
+//
+// Ordering constraint: fork() only copies the calling thread, so a lock held by any other
+// thread (allocator, stdio, Fortran runtime, OpenMP or Executor workers) would stay locked
+// in the child forever. Construct the pool (open the atmosphere session) before starting
+// threads; threads started afterwards do not matter. A pool constructed in a threaded
+// process starts no workers (and says so once on stderr); run() then returns false and
+// callers evaluate in-process.
+class ModelPool {
+public:
+  static constexpr int kMaxArrays = 8; // inputs, and outputs, per run
+  static constexpr int kMaxArgs = 8;
+
+  // workers <= 0: one per hardware thread. slab_doubles bounds the points per slice.
+  explicit ModelPool(int workers = 0, std::size_t min_chunk = 1024, std::size_t slab_doubles = std::size_t(1) << 22);
+  ~ModelPool(); // closes the command sockets and reaps the workers
+  ModelPool(const ModelPool&) = delete;
+  ModelPool& operator=(const ModelPool&) = delete;
+
+  int workers() const { return m_workers; }
+  // Workers started and none lost since
+  bool running() const;
+  // True while the calling process runs a single thread (Linux: /proc/self/task); true
+  // where the thread count cannot be read
+  static bool can_fork();
+  // kernel over n points in the workers (calls are serialized). Returns false, with out
+  // unspecified, when the pool is not running, the arrays exceed the limits, a kernel
+  // threw or a worker died; a dead worker stops the pool.
+  bool run(PoolKernel kernel, std::size_t n, const std::vector<const double*>& in,
+           const std::vector<PoolOutput>& out, const std::vector<double>& args = {});
+
+private:
+  int m_workers{1};
+  std::size_t m_min_chunk{1024};
+  SharedArray<double> m_slab;
+  std::vector<pid_t> m_pids;
+  std::vector<int> m_fds; // parent end of each worker's socket
+  bool m_alive{false};
+  mutable std::mutex m_mu;
+};
+
+// Pool for the linked Fortran models: nullptr when workers == 1, when no model is linked
+// or when no worker could be started (batches then run in-process)
+std::shared_ptr<ModelPool> make_model_pool(int workers);
+
+} // namespace fmx::atm
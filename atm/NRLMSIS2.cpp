@@ -1,9 +1,13 @@
 #include "atm/NRLMSIS2.hpp"
+#include "atm/Epoch.hpp"
+#include "atm/ModelPool.hpp"
 #include "core/units.hpp"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <atomic>
 #include <fstream>
+#include <vector>
 
 extern "C" {
 #if defined(FMX_WITH_NRLMSIS2_LOCAL)
@@ -11,124 +15,177 @@ void msis_eval_c(double day, double utsec, double z_km, double lat_deg, double l
                  double f107a, double f107, double ap_daily, double ap_now,
                  double& Tn, double& dn_tot, double& dn_n2, double& dn_o2, double& dn_o, double& dn_he,
                  double& dn_h, double& dn_ar, double& dn_n, double& dn_ao, double& dn_no);
+// Array form: dn holds the 10 MSIS densities of each point contiguously (dn[10*i + k])
+void msis_eval_batch_c(int n, const double* day, const double* utsec, const double* z_km,
+                       const double* lat_deg, const double* lon_deg,
+                       double f107a, double f107, double ap_daily, double ap_now,
+                       double* Tn, double* dn);
+// msisinit with an explicit parameter directory (path of n chars, trailing separator)
+void msis_init_c(const char* parmpath, int n);
 #endif
 }
 
 namespace fmx::atm {
 
-static bool parse_iso_utc(const std::string& s, int& year, int& mon, int& mday, int& hour, int& min, double& sec) {
-  // Expect formats like YYYY-MM-DDThh:mm:ssZ or with fractional seconds
-  // Minimal, robust-ish parsing without locale.
-  year=0; mon=0; mday=0; hour=0; min=0; sec=0.0;
-  if (s.size() < 20) return false;
-  if (s[4] != '-' || s[7] != 'T' || (s[10] != ':' && s[13] != ':')) {
-    // Try YYYY-MM-DDThh:mm:ssZ exact positions (allow 'Z' optional)
+// Set once the model has been initialized from an explicit parameter directory
+static std::atomic<bool> g_msis_initialized{false};
+
+#if defined(FMX_WITH_NRLMSIS2_LOCAL)
+// Ensure parameter file is present in CWD for MSIS (sessionless use only)
+static void ensure_parm_file() {
+  if (g_msis_initialized.load(std::memory_order_relaxed)) return;
+  std::ifstream test("msis21.parm");
+  if (!test.good()) {
+    std::ifstream src("atm/models/NRLMSIS2.1/msis21.parm", std::ios::binary);
+    if (src.good()) {
+      std::ofstream dst("msis21.parm", std::ios::binary);
+      dst << src.rdbuf();
+    }
   }
-  try {
-    year = std::stoi(s.substr(0,4));
-    mon  = std::stoi(s.substr(5,2));
-    mday = std::stoi(s.substr(8,2));
-    hour = std::stoi(s.substr(11,2));
-    min  = std::stoi(s.substr(14,2));
-    size_t p = 17;
-    // seconds may have fractional and optional trailing Z
-    size_t end = s.find_first_of("Zz ", p);
-    std::string ssec = s.substr(p, end==std::string::npos ? std::string::npos : (end-p));
-    sec = std::stod(ssec);
-    return true;
-  } catch (...) { return false; }
 }
 
-static int doy_from_ymd(int y, int m, int d) {
-  static const int mdays[12] = {31,28,31,30,31,30,31,31,30,31,30,31};
-  auto is_leap = [](int yy){ return (yy%4==0 && (yy%100!=0 || yy%400==0)); };
-  int doy = 0;
-  for (int i=1;i<m;i++) doy += (i==2 && is_leap(y)) ? 29 : mdays[i-1];
-  doy += d;
-  return doy;
+// MSIS day argument: day of year plus fraction of the UT day
+static void msis_day(const DayTime& t, double& day, double& UTsec) {
+  day = static_cast<double>(t.doy) + t.utsec / 86400.0;
+  UTsec = t.utsec;
 }
 
-static double kp_to_ap_int(int kp) {
-  // Rough mapping for integer Kp
-  static const int table[10] = {0,4,7,15,27,48,80,140,240,400};
-  if (kp < 0) kp = 0; if (kp > 9) kp = 9;
-  return static_cast<double>(table[kp]);
+// Species reported by the linked model, in output order
+static const double kMsisMass[5] = {fmx::units::m_O, fmx::units::m_N2, fmx::units::m_O2, fmx::units::m_He, fmx::units::m_H};
+// Index of each reported species in the MSIS density vector (tot, N2, O2, O, He, H, Ar, N, anomalous O, NO)
+static const int kMsisSlot[5] = {3, 1, 2, 4, 5};
+
+// Pool kernel: in = {day, UTsec, alt, lat, lon}, out = {Tn, dn (10 per point)},
+// args = {f107a, f107, ap_daily, ap_now}
+static void msis_kernel(std::size_t m, const double* const* in, double* const* out, const double* args) {
+  msis_eval_batch_c(static_cast<int>(m), in[0], in[1], in[2], in[3], in[4], args[0], args[1], args[2], args[3],
+                    out[0], out[1]);
+}
+#else
+static void warn_placeholder() {
+  static bool warned = false;
+  if (!warned) {
+    std::cerr << "[NRLMSIS2] Library not linked; using placeholder densities.\n";
+    warned = true;
+  }
 }
 
-AtmosphereState NRLMSIS2Atmosphere::evaluate(double alt_km, double lat_deg, double lon_deg,
-                                              const std::string& utc_iso,
-                                              const Indices& idx) const {
+// Simple parametric thermosphere temperature and O/He/H densities
+static inline void placeholder_point(double alt_km, double& T_K, double rho[3]) {
+  double h = std::clamp(alt_km, 100.0, 800.0);
+  T_K = 700.0 + 0.8 * (h - 100.0); // crude trend
+  rho[0] = 5e-11 * std::exp(-(h - 200.0)/60.0);
+  rho[1] = 2e-12 * std::exp(-(h - 300.0)/80.0);
+  rho[2] = 1e-12 * std::exp(-(h - 400.0)/120.0);
+}
+#endif
+
+NRLMSIS2Atmosphere::NRLMSIS2Atmosphere(int model_workers) : m_pool(make_model_pool(model_workers)) {}
+
+bool NRLMSIS2Atmosphere::initialize(const std::string& parm_dir, std::string* err) {
 #if defined(FMX_WITH_NRLMSIS2_LOCAL)
-  AtmosphereState st{};
-  // Ensure parameter file is present in CWD for MSIS
-  {
-    std::ifstream test("msis21.parm");
-    if (!test.good()) {
-      std::ifstream src("atm/models/NRLMSIS2.1/msis21.parm", std::ios::binary);
-      if (src.good()) {
-        std::ofstream dst("msis21.parm", std::ios::binary);
-        dst << src.rdbuf();
-      }
-    }
+  std::string dir = parm_dir.empty() ? std::string(".") : parm_dir;
+  if (dir.back() != '/') dir += '/';
+  if (!std::ifstream(dir + "msis21.parm").good()) {
+    if (err) *err = "msis21.parm not found in " + dir;
+    return false;
   }
-  // Convert UTC to day-of-year and UT seconds is left as input provided (UTC seconds of day recommended).
-  // Parse utc string; on failure fallback to noon day 100
-  int y, mo, md, hh, mm; double ss;
-  double day = 100.0;
-  double UTsec = 43200.0;
-  if (parse_iso_utc(utc_iso, y, mo, md, hh, mm, ss)) {
-    int doy = doy_from_ymd(y, mo, md);
-    double frac = (hh*3600.0 + mm*60.0 + ss) / 86400.0;
-    day = static_cast<double>(doy) + frac;
-    UTsec = hh*3600.0 + mm*60.0 + ss;
-  }
-  double Tn, dn_tot, dn_n2, dn_o2, dn_o, dn_he, dn_h, dn_ar, dn_n, dn_ao, dn_no;
-  double f107a = idx.F10_7A > 0 ? idx.F10_7A : idx.F10_7;
-  double f107 = idx.F10_7;
-  // Build Ap inputs
-  double ap7[7] = {0,0,0,0,0,0,0};
-  if (idx.has_ap_array) {
-    for (int i=0;i<7;i++) ap7[i] = idx.Ap[i];
-  } else if (idx.Ap_daily > 0.0 || idx.Ap_now > 0.0) {
-    ap7[0] = (idx.Ap_daily > 0.0) ? idx.Ap_daily : kp_to_ap_int(idx.Kp);
-    ap7[1] = (idx.Ap_now > 0.0) ? idx.Ap_now : ap7[0];
-  } else {
-    double ap = kp_to_ap_int(idx.Kp);
-    ap7[0] = ap; ap7[1] = ap;
-  }
-  // Call Fortran wrapper: currently only daily and now are used
-  msis_eval_c(day, UTsec, alt_km, lat_deg, lon_deg, f107a, f107, ap7[0], ap7[1],
-              Tn, dn_tot, dn_n2, dn_o2, dn_o, dn_he, dn_h, dn_ar, dn_n, dn_ao, dn_no);
+  msis_init_c(dir.data(), static_cast<int>(dir.size()));
+#else
+  (void)parm_dir; (void)err;
+#endif
+  g_msis_initialized = true;
+  return true;
+}
+
+// One point at a resolved day/time with resolved drivers (shared by string and epoch entry points)
+static AtmosphereState msis_point(double alt_km, double lat_deg, double lon_deg, const DayTime& t, const Drivers& drv) {
+#if defined(FMX_WITH_NRLMSIS2_LOCAL)
+  AtmosphereState st{};
+  ensure_parm_file();
+  double day, UTsec;
+  msis_day(t, day, UTsec);
+  double Tn, dn[10];
+  msis_eval_c(day, UTsec, alt_km, lat_deg, lon_deg, drv.f107a, drv.f107, drv.ap_daily, drv.ap_now,
+              Tn, dn[0], dn[1], dn[2], dn[3], dn[4], dn[5], dn[6], dn[7], dn[8], dn[9]);
   st.T_K = Tn;
   st.wind_ms = {0.0, 0.0, 0.0};
   // Convert number densities [m^-3] to mass densities [kg/m^3]
-  auto n2rho = [](double n, double m)->double{ return n * m; };
-  st.species.clear();
-  st.species.push_back({n2rho(dn_o,  fmx::units::m_O),  fmx::units::m_O});
-  st.species.push_back({n2rho(dn_n2, fmx::units::m_N2), fmx::units::m_N2});
-  st.species.push_back({n2rho(dn_o2, fmx::units::m_O2), fmx::units::m_O2});
-  st.species.push_back({n2rho(dn_he, fmx::units::m_He), fmx::units::m_He});
-  st.species.push_back({n2rho(dn_h,  fmx::units::m_H),  fmx::units::m_H});
+  st.species.reserve(5);
+  for (int s = 0; s < 5; ++s) st.species.push_back({dn[kMsisSlot[s]] * kMsisMass[s], kMsisMass[s]});
   return st;
 #else
-  static bool warned = false;
-  if (!warned) {
-    std::cerr << "[NRLMSIS2] Library not linked; using placeholder densities.\n";
-    warned = true;
-  }
+  (void)lat_deg; (void)lon_deg; (void)t; (void)drv;
+  warn_placeholder();
   AtmosphereState st{};
-  // Simple parametric thermosphere temperature and densities
-  double h = std::clamp(alt_km, 100.0, 800.0);
-  st.T_K = 700.0 + 0.8 * (h - 100.0); // crude trend
+  double rho[3];
+  placeholder_point(alt_km, st.T_K, rho);
   st.wind_ms = {0.0, 0.0, 0.0};
-  double rho_O  = 5e-11 * std::exp(-(h - 200.0)/60.0);
-  double rho_He = 2e-12 * std::exp(-(h - 300.0)/80.0);
-  double rho_H  = 1e-12 * std::exp(-(h - 400.0)/120.0);
-  st.species.push_back({rho_O,  fmx::units::m_O});
-  st.species.push_back({rho_He, fmx::units::m_He});
-  st.species.push_back({rho_H,  fmx::units::m_H});
+  st.species.reserve(3);
+  st.species.push_back({rho[0], fmx::units::m_O});
+  st.species.push_back({rho[1], fmx::units::m_He});
+  st.species.push_back({rho[2], fmx::units::m_H});
   return st;
 #endif
 }
 
+AtmosphereState NRLMSIS2Atmosphere::evaluate(double alt_km, double lat_deg, double lon_deg,
+                                              const std::string& utc_iso,
+                                              const Indices& idx) const {
+  // Parse utc string; on failure fallback to noon day 100
+  double epoch = 0.0;
+  const DayTime t = parse_iso_utc(utc_iso, epoch) ? day_time(epoch) : kFallbackDayTime;
+  return msis_point(alt_km, lat_deg, lon_deg, t, resolve_drivers(idx));
+}
+
+AtmosphereState NRLMSIS2Atmosphere::evaluate_epoch(double alt_km, double lat_deg, double lon_deg,
+                                                    double epoch_s, const Drivers& drv) const {
+  return msis_point(alt_km, lat_deg, lon_deg, day_time(epoch_s), drv);
+}
+
+void NRLMSIS2Atmosphere::evaluate_batch(const PointBatch& pts, const Indices& idx, StateBatch& out) const {
+  const long long n = static_cast<long long>(pts.n);
+#if defined(FMX_WITH_NRLMSIS2_LOCAL)
+  ensure_parm_file();
+  out.resize(pts.n, 5);
+  out.species_mass.assign(kMsisMass, kMsisMass + 5);
+  std::vector<double> day(pts.n), UTsec(pts.n), dn(10 * pts.n);
+  // Serial when pooled: the workers carry the load and the caller starts no OpenMP team
+  // (a later pool constructed in this process could not fork)
+  const bool pooled = m_pool != nullptr;
+#if defined(FMX_USE_OPENMP)
+  #pragma omp parallel for schedule(static) if(!pooled)
+#endif
+  for (long long i = 0; i < n; ++i) msis_day(day_time(pts.epoch_s[i]), day[i], UTsec[i]);
+  const Drivers drv = resolve_drivers(idx);
+  // One boundary crossing per batch (or per worker chunk); the Fortran model is not reentrant,
+  // so concurrency comes from worker processes with private module state
+  const std::vector<const double*> in = {day.data(), UTsec.data(), pts.alt_km, pts.lat_deg, pts.lon_deg};
+  const std::vector<double> args = {drv.f107a, drv.f107, drv.ap_daily, drv.ap_now};
+  if (n > 0 && !(pooled && m_pool->run(msis_kernel, pts.n, in, {{out.T_K.data(), 1}, {dn.data(), 10}}, args))) {
+    double* o[2] = {out.T_K.data(), dn.data()};
+    msis_kernel(pts.n, in.data(), o, args.data());
+  }
+#if defined(FMX_USE_OPENMP)
+  #pragma omp parallel for schedule(static) if(!pooled)
+#endif
+  for (long long i = 0; i < n; ++i)
+    for (int s = 0; s < 5; ++s) out.rho_of(s)[i] = dn[10*i + kMsisSlot[s]] * kMsisMass[s];
+#else
+  (void)idx;
+  warn_placeholder();
+  out.resize(pts.n, 3);
+  out.species_mass = {fmx::units::m_O, fmx::units::m_He, fmx::units::m_H};
+  double* rO = out.rho_of(0); double* rHe = out.rho_of(1); double* rH = out.rho_of(2);
+#if defined(FMX_USE_OPENMP)
+  #pragma omp parallel for schedule(static)
+#endif
+  for (long long i = 0; i < n; ++i) {
+    double rho[3];
+    placeholder_point(pts.alt_km[i], out.T_K[i], rho);
+    rO[i] = rho[0]; rHe[i] = rho[1]; rH[i] = rho[2];
+  }
+#endif
+}
+
 } // namespace fmx::atm
@@ -1,16 +1,37 @@
 #pragma once
 
+#include <memory>
 #include "atm/Atmosphere.hpp"
 
 namespace fmx::atm {
 
+class ModelPool;
+
 // Thin wrapper around NRLMSIS 2.0. If FMX_WITH_NRLMSIS2 is not defined,
 // falls back to a plausible stub and warns once.
 class NRLMSIS2Atmosphere : public Atmosphere {
 public:
+  // model_workers != 1: batches of the linked model run in that many worker processes
+  // (ModelPool), each with private Fortran module state, forked here; construct before
+  // starting threads, otherwise batches run in-process
+  explicit NRLMSIS2Atmosphere(int model_workers = 1);
+  // Batches run on pool (may be null: in-process), e.g. one pool shared with HWM14
+  explicit NRLMSIS2Atmosphere(std::shared_ptr<ModelPool> pool) : m_pool(std::move(pool)) {}
+
+  // One-time model initialization from the directory holding msis21.parm. Afterwards no
+  // per-call file checks or CWD copies are made. No-op without the linked model.
+  static bool initialize(const std::string& parm_dir, std::string* err = nullptr);
+
   AtmosphereState evaluate(double alt_km, double lat_deg, double lon_deg,
                            const std::string& utc_iso,
                            const Indices& idx) const override;
+  AtmosphereState evaluate_epoch(double alt_km, double lat_deg, double lon_deg,
+                                 double epoch_s, const Drivers& drv) const override;
+  // Array kernel: one msis_eval_batch_c call per batch, conversions parallel over points
+  void evaluate_batch(const PointBatch& pts, const Indices& idx, StateBatch& out) const override;
+
+private:
+  std::shared_ptr<ModelPool> m_pool;
 };
 
 } // namespace fmx::atm
@@ -0,0 +1,130 @@
+#include "atm/SpaceWeather.hpp"
+#include "atm/Epoch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace fmx::atm {
+
+namespace {
+
+void split_csv(const std::string& line, std::vector<std::string>& out) {
+  out.clear();
+  std::string tok;
+  std::istringstream ss(line);
+  while (std::getline(ss, tok, ',')) {
+    while (!tok.empty() && (tok.back() == '\r' || tok.back() == ' ')) tok.pop_back();
+    out.push_back(tok);
+  }
+}
+
+bool to_double(const std::string& s, double& v) {
+  if (s.empty()) return false;
+  try { v = std::stod(s); } catch (...) { return false; }
+  return std::isfinite(v);
+}
+
+} // namespace
+
+bool SpaceWeatherTable::load(const std::string& path, std::string* err) {
+  std::ifstream in(path);
+  if (!in) { if (err) *err = "Failed to open: " + path; return false; }
+  if (!load_csv(in, err)) {
+    if (err) *err += " (" + path + ")";
+    return false;
+  }
+  return true;
+}
+
+bool SpaceWeatherTable::load_csv(std::istream& in, std::string* err) {
+  *this = SpaceWeatherTable{};
+  std::string line;
+  std::vector<std::string> tok;
+  if (!std::getline(in, line)) { if (err) *err = "Empty space-weather file"; return false; }
+  split_csv(line, tok);
+  auto col = [&](const std::string& name) {
+    auto it = std::find(tok.begin(), tok.end(), name);
+    return it == tok.end() ? -1 : static_cast<int>(it - tok.begin());
+  };
+  const int c_date = col("DATE"), c_apavg = col("AP_AVG"), c_f107 = col("F10.7_OBS"), c_f107a = col("F10.7_OBS_CENTER81");
+  int c_ap[8], c_kp[8];
+  for (int k = 0; k < 8; ++k) { c_ap[k] = col("AP" + std::to_string(k + 1)); c_kp[k] = col("KP" + std::to_string(k + 1)); }
+  if (c_date < 0 || c_apavg < 0 || c_f107 < 0 || c_f107a < 0 || std::count(c_ap, c_ap + 8, -1) || std::count(c_kp, c_kp + 8, -1)) {
+    if (err) *err = "Space-weather CSV lacks DATE/AP1..8/KP1..8/AP_AVG/F10.7_OBS/F10.7_OBS_CENTER81 columns";
+    return false;
+  }
+
+  struct Day { std::int64_t day; double f107, f107a, ap_daily, ap[8], kp[8]; };
+  std::vector<Day> rows;
+  while (std::getline(in, line)) {
+    split_csv(line, tok);
+    if (static_cast<int>(tok.size()) <= c_date) continue;
+    double epoch = 0.0;
+    if (!parse_iso_utc(tok[c_date] + "T00:00:00Z", epoch)) continue;
+    auto field = [&](int c, double& v) { return c < static_cast<int>(tok.size()) && to_double(tok[c], v); };
+    Day d{static_cast<std::int64_t>(std::floor(epoch / 86400.0)), 0.0, 0.0, 0.0, {}, {}};
+    // Rows without the daily indices (e.g. far predictions) are skipped
+    if (!field(c_f107, d.f107) || !field(c_f107a, d.f107a) || !field(c_apavg, d.ap_daily)) continue;
+    bool ok = true;
+    for (int k = 0; k < 8 && ok; ++k) {
+      ok = field(c_ap[k], d.ap[k]) && field(c_kp[k], d.kp[k]);
+      d.kp[k] /= 10.0;
+    }
+    if (ok) rows.push_back(d);
+  }
+  if (rows.empty()) { if (err) *err = "No complete space-weather records"; return false; }
+  std::stable_sort(rows.begin(), rows.end(), [](const Day& a, const Day& b){ return a.day < b.day; });
+
+  // Dense daily arrays; gaps repeat the previous record
+  m_day0 = rows.front().day;
+  const std::size_t n = static_cast<std::size_t>(rows.back().day - m_day0 + 1);
+  m_f107.resize(n); m_f107a.resize(n); m_ap_daily.resize(n); m_ap3.resize(8 * n); m_kp3.resize(8 * n);
+  std::size_t r = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    while (r + 1 < rows.size() && rows[r + 1].day <= m_day0 + static_cast<std::int64_t>(i)) ++r;
+    const Day& d = rows[r];
+    m_f107[i] = d.f107; m_f107a[i] = d.f107a; m_ap_daily[i] = d.ap_daily;
+    std::copy(d.ap, d.ap + 8, m_ap3.begin() + 8 * i);
+    std::copy(d.kp, d.kp + 8, m_kp3.begin() + 8 * i);
+  }
+  return true;
+}
+
+std::int64_t SpaceWeatherTable::slot(double epoch_s) {
+  return static_cast<std::int64_t>(std::floor(epoch_s / kSlotSeconds));
+}
+
+std::size_t SpaceWeatherTable::day_index(std::int64_t day) const {
+  return static_cast<std::size_t>(std::clamp<std::int64_t>(day - m_day0, 0, static_cast<std::int64_t>(days()) - 1));
+}
+
+double SpaceWeatherTable::ap_slot(std::int64_t s) const {
+  const std::int64_t s0 = 8 * m_day0;
+  return m_ap3[static_cast<std::size_t>(std::clamp<std::int64_t>(s - s0, 0, static_cast<std::int64_t>(m_ap3.size()) - 1))];
+}
+
+Indices SpaceWeatherTable::indices(double epoch_s) const {
+  Indices idx;
+  if (!valid()) return idx;
+  // Clamp to the covered range so the day and its 3-hour slot stay consistent
+  const std::int64_t s = std::clamp(slot(epoch_s), 8 * m_day0, 8 * (m_day0 + static_cast<std::int64_t>(days())) - 1);
+  const std::int64_t day = s >= 0 ? s / 8 : (s - 7) / 8;
+  const std::size_t i = day_index(day);
+  idx.F10_7 = m_f107[day_index(day - 1)];
+  idx.F10_7A = m_f107a[i];
+  idx.has_ap_array = true;
+  idx.Ap[0] = m_ap_daily[i];
+  for (int k = 0; k < 4; ++k) idx.Ap[1 + k] = ap_slot(s - k);
+  double a = 0.0, b = 0.0;
+  for (int k = 4; k < 12; ++k) a += ap_slot(s - k);
+  for (int k = 12; k < 20; ++k) b += ap_slot(s - k);
+  idx.Ap[5] = a / 8.0;
+  idx.Ap[6] = b / 8.0;
+  idx.Ap_daily = idx.Ap[0];
+  idx.Ap_now = idx.Ap[1];
+  idx.Kp = static_cast<int>(std::lround(m_kp3[8 * i + static_cast<std::size_t>(s - 8 * day)]));
+  return idx;
+}
+
+} // namespace fmx::atm
@@ -0,0 +1,55 @@
+// Space-weather index time series (F10.7, 3-hour ap/Kp) with O(1) epoch lookup
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "atm/Atmosphere.hpp"
+
+namespace fmx::atm {
+
+// Daily records stored densely from the first to the last day of the file, so an epoch maps
+// to its record by index arithmetic. Days missing from the file repeat the previous day.
+//
+// Input: CelesTrak space-weather CSV (SW-All.csv / SW-Last5Years.csv); columns are found by
+// header name: DATE, KP1..KP8 (tenths), AP1..AP8, AP_AVG, F10.7_OBS, F10.7_OBS_CENTER81.
+//
+// indices(epoch) follows the NRLMSIS 2.x conventions:
+//   F10_7  observed F10.7 of the previous day, F10_7A 81-day centred average of the day
+//   Ap[7]  daily Ap; 3-hour ap at t, t-3h, t-6h, t-9h; mean of the eight 3-hour values
+//          from t-12h to t-33h and from t-36h to t-57h (has_ap_array is set)
+//   Kp     3-hour Kp at t (rounded), Ap_daily/Ap_now = Ap[0]/Ap[1]
+// Epochs outside the table are clamped to its first/last day.
+class SpaceWeatherTable {
+public:
+  static constexpr double kSlotSeconds = 10800.0; // 3-hour index interval
+
+  bool load(const std::string& path, std::string* err = nullptr);
+  bool load_csv(std::istream& in, std::string* err = nullptr);
+
+  bool valid() const { return !m_ap_daily.empty(); }
+  std::size_t days() const { return m_ap_daily.size(); }
+  // First/last covered epoch [s since 1970]
+  double first_epoch() const { return 86400.0 * static_cast<double>(m_day0); }
+  double last_epoch() const { return 86400.0 * static_cast<double>(m_day0 + static_cast<std::int64_t>(days())) - 1e-3; }
+  bool covers(double epoch_s) const { return valid() && epoch_s >= first_epoch() && epoch_s <= last_epoch(); }
+
+  Indices indices(double epoch_s) const;
+  // Index of the 3-hour interval containing the epoch; indices() is constant within a slot
+  static std::int64_t slot(double epoch_s);
+
+private:
+  std::int64_t m_day0{0};        // days since 1970 of the first record
+  std::vector<double> m_f107;    // observed F10.7 per day
+  std::vector<double> m_f107a;   // 81-day centred average per day
+  std::vector<double> m_ap_daily;
+  std::vector<double> m_ap3;     // eight 3-hour ap per day (day-major)
+  std::vector<double> m_kp3;     // eight 3-hour Kp per day
+
+  // 3-hour ap at a global slot index (clamped to the table)
+  double ap_slot(std::int64_t s) const;
+  std::size_t day_index(std::int64_t day) const;
+};
+
+} // namespace fmx::atm
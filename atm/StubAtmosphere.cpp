@@ -1,18 +1,17 @@
 #include "atm/Atmosphere.hpp"
 #include "core/units.hpp"
 #include <algorithm>
+#include <cmath>
 
 namespace fmx::atm {
 
 static inline double clamp(double x, double lo, double hi) { return std::max(lo, std::min(hi, x)); }
 
-AtmosphereState StubAtmosphere::evaluate(double alt_km, double, double,
-                                         const std::string&, const Indices& idx) const {
-  AtmosphereState st{};
+// Temperature and O/He/H mass densities at one altitude (shared by scalar and batch paths)
+static inline void stub_point(double alt_km, const Indices& idx, double& T_K, double rho[3]) {
   // Simple parametric temperature model: 700–1000 K in thermosphere
   double baseT = 700.0 + 3.0 * clamp(idx.F10_7 - 70.0, 0.0, 200.0);
-  st.T_K = clamp(baseT, 600.0, 1200.0);
-  st.wind_ms = {0.0, 0.0, 0.0};
+  T_K = clamp(baseT, 600.0, 1200.0);
 
   // Crude species mass densities vs altitude: O dominates ~200–500 km, with
   // exponential decay; small fractions of He and H at high altitudes.
@@ -22,12 +21,37 @@ AtmosphereState StubAtmosphere::evaluate(double alt_km, double, double,
   double rho_H  = 1e-12 * std::exp(-(h - 400.0)/120.0);
   if (h < 180.0) { rho_O *= 2.0; }
   if (idx.Kp >= 5) { rho_O *= 1.5; }
+  rho[0] = rho_O; rho[1] = rho_He; rho[2] = rho_H;
+}
 
-  st.species.push_back({rho_O,  fmx::units::m_O});
-  st.species.push_back({rho_He, fmx::units::m_He});
-  st.species.push_back({rho_H,  fmx::units::m_H});
+AtmosphereState StubAtmosphere::evaluate(double alt_km, double, double,
+                                         const std::string&, const Indices& idx) const {
+  AtmosphereState st{};
+  double rho[3];
+  stub_point(alt_km, idx, st.T_K, rho);
+  st.wind_ms = {0.0, 0.0, 0.0};
+  st.species.push_back({rho[0], fmx::units::m_O});
+  st.species.push_back({rho[1], fmx::units::m_He});
+  st.species.push_back({rho[2], fmx::units::m_H});
   return st;
 }
 
-} // namespace fmx::atm
+AtmosphereState StubAtmosphere::evaluate_epoch(double alt_km, double, double, double, const Drivers& drv) const {
+  return evaluate(alt_km, 0.0, 0.0, std::string(), drv.idx);
+}
 
+void StubAtmosphere::evaluate_batch(const PointBatch& pts, const Indices& idx, StateBatch& out) const {
+  out.resize(pts.n, 3);
+  out.species_mass = {fmx::units::m_O, fmx::units::m_He, fmx::units::m_H};
+  double* rO = out.rho_of(0); double* rHe = out.rho_of(1); double* rH = out.rho_of(2);
+#if defined(FMX_USE_OPENMP)
+  #pragma omp parallel for schedule(static)
+#endif
+  for (long long i = 0; i < static_cast<long long>(pts.n); ++i) {
+    double rho[3];
+    stub_point(pts.alt_km[i], idx, out.T_K[i], rho);
+    rO[i] = rho[0]; rHe[i] = rho[1]; rH[i] = rho[2];
+  }
+}
+
+} // namespace fmx::atm
@@ -12,4 +12,22 @@ contains
     w_meridional = wm
     w_zonal = wz
   end subroutine hwm14_eval_c
+
+  ! Array form of hwm14_eval_c: one call per batch
+  subroutine hwm14_eval_batch_c(n, doy, utsec, alt_km, lat_deg, lon_deg, ap3hr, w_meridional, w_zonal) &
+      bind(C, name="hwm14_eval_batch_c")
+    implicit none
+    integer(c_int), value :: n
+    integer(c_int), intent(in) :: doy(n)
+    real(c_double), intent(in) :: utsec(n), alt_km(n), lat_deg(n), lon_deg(n)
+    real(c_double), value :: ap3hr
+    real(c_double), intent(out) :: w_meridional(n), w_zonal(n)
+    real(8) :: wm, wz
+    integer :: i
+    do i = 1, n
+      call hwm_14(doy(i), utsec(i), alt_km(i), lat_deg(i), lon_deg(i), ap3hr, wm, wz)
+      w_meridional(i) = wm
+      w_zonal(i) = wz
+    end do
+  end subroutine hwm14_eval_batch_c
 end module hwm14_cwrap
@@ -4,6 +4,20 @@ module nrlmsis_cwrap
   use msis_constants, only: rp
 contains
 
+  ! One-time initialization with an explicit parameter directory (path includes trailing '/')
+  subroutine msis_init_c(parmpath, n) bind(C, name="msis_init_c")
+    use msis_init, only: msisinit
+    implicit none
+    integer(c_int), value :: n
+    character(kind=c_char), intent(in) :: parmpath(n)
+    character(len=n) :: path
+    integer :: i
+    do i = 1, n
+      path(i:i) = parmpath(i)
+    end do
+    call msisinit(parmpath=path, parmfile='msis21.parm')
+  end subroutine msis_init_c
+
   subroutine msis_eval_c(day, utsec, z_km, lat_deg, lon_deg, f107a, f107, ap_daily, ap_now, &
                          Tn, dn_tot, dn_n2, dn_o2, dn_o, dn_he, dn_h, dn_ar, dn_n, dn_ao, dn_no) bind(C, name="msis_eval_c")
     implicit none
@@ -38,4 +52,30 @@ contains
     dn_no  = real(dn_r(10), c_double)
   end subroutine msis_eval_c
 
+  ! Array form of msis_eval_c: one call per batch, densities of point i in dn(:, i)
+  subroutine msis_eval_batch_c(n, day, utsec, z_km, lat_deg, lon_deg, f107a, f107, ap_daily, ap_now, &
+                               Tn, dn) bind(C, name="msis_eval_batch_c")
+    implicit none
+    integer(c_int), value :: n
+    real(c_double), intent(in) :: day(n), utsec(n), z_km(n), lat_deg(n), lon_deg(n)
+    real(c_double), value :: f107a, f107, ap_daily, ap_now
+    real(c_double), intent(out) :: Tn(n), dn(10, n)
+    real(kind=rp) :: f107a_r, f107_r, ap_r(7)
+    real(kind=rp) :: Tn_r, dn_r(10)
+    integer :: i
+
+    f107a_r = real(f107a, kind=rp)
+    f107_r  = real(f107,  kind=rp)
+    ap_r    = 0.0_rp
+    ap_r(1) = real(ap_daily, kind=rp)
+    ap_r(2) = real(ap_now,   kind=rp)
+
+    do i = 1, n
+      call msiscalc(real(day(i), kind=rp), real(utsec(i), kind=rp), real(z_km(i), kind=rp), &
+                    real(lat_deg(i), kind=rp), real(lon_deg(i), kind=rp), f107a_r, f107_r, ap_r, Tn_r, dn_r)
+      Tn(i) = real(Tn_r, c_double)
+      dn(:, i) = real(dn_r, c_double)
+    end do
+  end subroutine msis_eval_batch_c
+
 end module nrlmsis_cwrap
@@ -0,0 +1,149 @@
+! Fortran bindings for the FMX C API (capi/fmx.h). Link with -lfmx.
+!
+!   use fmx_capi
+!   type(c_ptr) :: scene
+!   type(fmx_state) :: st
+!   real(c_double), target :: rho(5), mass(5)
+!   real(c_double) :: F(3), M(3)
+!   if (fmx_scene_load_f('sat.obj', scene) /= FMX_OK) stop 1
+!   st%rho_kgm3 = c_loc(rho); st%mass_kg = c_loc(mass); st%n_species = 5
+!   st%T_K = 900d0; st%V_sat_ms = [7600d0, 0d0, 0d0]; st%wind_ms = 0d0
+!   if (fmx_solve(scene, st, F, M) /= FMX_OK) stop 1
+!   call fmx_scene_destroy(scene)
+module fmx_capi
+  use iso_c_binding
+  implicit none
+
+  integer(c_int), parameter :: FMX_OK = 0, FMX_E_INVALID_ARG = 1, FMX_E_IO = 2, &
+                               FMX_E_NO_MEMORY = 3, FMX_E_INTERNAL = 4
+  integer(c_int), parameter :: FMX_GSI_SENTMAN = 0, FMX_GSI_CLL = 1
+
+  type, bind(C) :: fmx_material
+    real(c_double) :: alpha_n = 1d0, alpha_t = 1d0, alpha_E = 1d0, Tw_K = 300d0
+  end type
+
+  type, bind(C) :: fmx_state
+    type(c_ptr) :: rho_kgm3 = c_null_ptr
+    type(c_ptr) :: mass_kg = c_null_ptr
+    integer(c_size_t) :: n_species = 0
+    real(c_double) :: T_K = 0d0
+    real(c_double) :: V_sat_ms(3) = 0d0
+    real(c_double) :: wind_ms(3) = 0d0
+  end type
+
+  interface
+    integer(c_int) function fmx_api_version() bind(C, name='fmx_api_version')
+      import :: c_int
+    end function
+
+    type(c_ptr) function fmx_last_error_c() bind(C, name='fmx_last_error')
+      import :: c_ptr
+    end function
+
+    integer(c_int) function fmx_scene_load(mesh_path, scene) bind(C, name='fmx_scene_load')
+      import :: c_int, c_char, c_ptr
+      character(kind=c_char), intent(in) :: mesh_path(*)
+      type(c_ptr), intent(out) :: scene
+    end function
+
+    ! vertices(3, n_vertices), indices(3, n_triangles) are 0-based vertex numbers
+    integer(c_int) function fmx_scene_from_arrays(vertices, n_vertices, indices, n_triangles, &
+                                                  material_ids, scene) bind(C, name='fmx_scene_from_arrays')
+      import :: c_int, c_double, c_size_t, c_int32_t, c_ptr
+      real(c_double), intent(in) :: vertices(*)
+      integer(c_size_t), value :: n_vertices
+      integer(c_int32_t), intent(in) :: indices(*)
+      integer(c_size_t), value :: n_triangles
+      type(c_ptr), value :: material_ids
+      type(c_ptr), intent(out) :: scene
+    end function
+
+    subroutine fmx_scene_destroy(scene) bind(C, name='fmx_scene_destroy')
+      import :: c_ptr
+      type(c_ptr), value :: scene
+    end subroutine
+
+    integer(c_size_t) function fmx_scene_facet_count(scene) bind(C, name='fmx_scene_facet_count')
+      import :: c_size_t, c_ptr
+      type(c_ptr), value :: scene
+    end function
+
+    integer(c_int) function fmx_scene_set_material(scene, material_id, m) bind(C, name='fmx_scene_set_material')
+      import :: c_int, c_int32_t, c_ptr, fmx_material
+      type(c_ptr), value :: scene
+      integer(c_int32_t), value :: material_id
+      type(fmx_material), intent(in) :: m
+    end function
+
+    integer(c_int) function fmx_scene_set_cg(scene, cg) bind(C, name='fmx_scene_set_cg')
+      import :: c_int, c_double, c_ptr
+      type(c_ptr), value :: scene
+      real(c_double), intent(in) :: cg(3)
+    end function
+
+    integer(c_int) function fmx_scene_set_occlusion(scene, enabled) bind(C, name='fmx_scene_set_occlusion')
+      import :: c_int, c_ptr
+      type(c_ptr), value :: scene
+      integer(c_int), value :: enabled
+    end function
+
+    ! model: FMX_GSI_SENTMAN or FMX_GSI_CLL; cll_table_path: NUL-terminated path or c_null_ptr
+    integer(c_int) function fmx_scene_set_gsi(scene, model, cll_table_path) bind(C, name='fmx_scene_set_gsi')
+      import :: c_int, c_ptr
+      type(c_ptr), value :: scene
+      integer(c_int), value :: model
+      type(c_ptr), value :: cll_table_path
+    end function
+
+    integer(c_int) function fmx_solve(scene, state, F_N, M_Nm) bind(C, name='fmx_solve')
+      import :: c_int, c_double, c_ptr, fmx_state
+      type(c_ptr), value :: scene
+      type(fmx_state), intent(in) :: state
+      real(c_double), intent(out) :: F_N(3), M_Nm(3)
+    end function
+  end interface
+
+contains
+
+  ! fmx_scene_load with a Fortran string
+  integer(c_int) function fmx_scene_load_f(path, scene)
+    character(*), intent(in) :: path
+    type(c_ptr), intent(out) :: scene
+    fmx_scene_load_f = fmx_scene_load(trim(path) // c_null_char, scene)
+  end function
+
+  ! fmx_scene_set_gsi with an optional Fortran string table path (absent: analytic CLL)
+  integer(c_int) function fmx_scene_set_gsi_f(scene, model, table_path)
+    type(c_ptr), intent(in) :: scene
+    integer(c_int), intent(in) :: model
+    character(*), intent(in), optional :: table_path
+    character(kind=c_char), allocatable, target :: buf(:)
+    if (present(table_path)) then
+      allocate(buf(len_trim(table_path) + 1))
+      buf = transfer(trim(table_path) // c_null_char, buf)
+      fmx_scene_set_gsi_f = fmx_scene_set_gsi(scene, model, c_loc(buf))
+    else
+      fmx_scene_set_gsi_f = fmx_scene_set_gsi(scene, model, c_null_ptr)
+    end if
+  end function
+
+  ! Last error message of the calling thread as a Fortran string
+  function fmx_last_error() result(msg)
+    character(:), allocatable :: msg
+    character(kind=c_char), pointer :: p(:)
+    integer :: n
+    interface
+      integer(c_size_t) function strlen(s) bind(C, name='strlen')
+        import :: c_size_t, c_ptr
+        type(c_ptr), value :: s
+      end function
+    end interface
+    type(c_ptr) :: cp
+    cp = fmx_last_error_c()
+    n = int(strlen(cp))
+    call c_f_pointer(cp, p, [n])
+    allocate(character(n) :: msg)
+    msg = transfer(p(1:n), msg)
+  end function
+
+end module fmx_capi
@@ -0,0 +1,107 @@
+/* FMX C API (libfmx): prepared scenes and panel solves for embedding in C/Fortran codes.
+ *
+ * A scene holds the facets, BVH occluder, materials and GSI model of one spacecraft. Scenes
+ * are created once and then solved any number of times with caller-provided atmosphere
+ * states; fmx_solve may be called concurrently on the same scene from several threads.
+ * fmx_scene_set_* calls may run concurrently with solves (they wait for them to finish).
+ *
+ * No C++ exceptions cross this interface: every call returns an fmx_status and, on
+ * failure, fmx_last_error() describes the error of the calling thread's last failed call.
+ * Vectors are body-frame components (x, y, z), SI units.
+ */
+#ifndef FMX_CAPI_FMX_H
+#define FMX_CAPI_FMX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(FMX_BUILDING_LIBRARY)
+#    define FMX_API __declspec(dllexport)
+#  else
+#    define FMX_API __declspec(dllimport)
+#  endif
+#else
+#  define FMX_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FMX_API_VERSION 1
+
+typedef enum fmx_status {
+  FMX_OK = 0,
+  FMX_E_INVALID_ARG = 1, /* null pointer, out-of-range index, non-finite value */
+  FMX_E_IO = 2,          /* mesh or table file could not be read */
+  FMX_E_NO_MEMORY = 3,
+  FMX_E_INTERNAL = 4
+} fmx_status;
+
+typedef enum fmx_gsi_model {
+  FMX_GSI_SENTMAN = 0,   /* closed-form Sentman with energy accommodation */
+  FMX_GSI_CLL = 1        /* Cercignani-Lampis-Lord (analytic, or a kernel table) */
+} fmx_gsi_model;
+
+typedef struct fmx_material {
+  double alpha_n;        /* normal accommodation (CLL) */
+  double alpha_t;        /* tangential accommodation (CLL) */
+  double alpha_E;        /* energy accommodation (Sentman) */
+  double Tw_K;           /* wall temperature */
+} fmx_material;
+
+/* Free-stream state for one solve. rho_kgm3/mass_kg point to n_species caller-owned values
+ * (read during the call only). */
+typedef struct fmx_state {
+  const double* rho_kgm3; /* species mass densities [kg/m^3] */
+  const double* mass_kg;  /* species molecular masses [kg] */
+  size_t n_species;
+  double T_K;             /* ambient temperature */
+  double V_sat_ms[3];     /* spacecraft velocity */
+  double wind_ms[3];      /* atmospheric wind */
+} fmx_state;
+
+typedef struct fmx_scene fmx_scene;
+
+FMX_API int fmx_api_version(void);
+
+/* Message for the calling thread's last failed call ("" if none) */
+FMX_API const char* fmx_last_error(void);
+
+/* Scene from an OBJ or STL file; all facets use material 0 */
+FMX_API fmx_status fmx_scene_load(const char* mesh_path, fmx_scene** out);
+
+/* Scene from caller-owned arrays: vertices[3*n_vertices] (x,y,z) [m], indices[3*n_triangles]
+ * (counter-clockwise seen from outside), optional material_ids[n_triangles]. The arrays are
+ * read in place during the call and not retained; the caller may free them afterwards. */
+FMX_API fmx_status fmx_scene_from_arrays(const double* vertices, size_t n_vertices,
+                                         const uint32_t* indices, size_t n_triangles,
+                                         const uint32_t* material_ids, fmx_scene** out);
+
+/* Null is ignored. No solve may be running on the scene. */
+FMX_API void fmx_scene_destroy(fmx_scene* scene);
+
+FMX_API size_t fmx_scene_facet_count(const fmx_scene* scene);
+
+/* Material table entry (the table grows as needed; unset entries use the defaults
+ * alpha_n = alpha_t = alpha_E = 1, Tw = 300 K) */
+FMX_API fmx_status fmx_scene_set_material(fmx_scene* scene, uint32_t material_id, const fmx_material* m);
+
+/* Centre of gravity for moments [m] (default origin) */
+FMX_API fmx_status fmx_scene_set_cg(fmx_scene* scene, const double cg[3]);
+
+/* Self-shadowing via the scene BVH (default on) */
+FMX_API fmx_status fmx_scene_set_occlusion(fmx_scene* scene, int enabled);
+
+/* GSI model; for FMX_GSI_CLL an optional kernel table (gen_gsi_table output, null: analytic) */
+FMX_API fmx_status fmx_scene_set_gsi(fmx_scene* scene, fmx_gsi_model model, const char* cll_table_path);
+
+/* Total force [N] and moment about the CG [N*m], written to caller buffers */
+FMX_API fmx_status fmx_solve(const fmx_scene* scene, const fmx_state* state, double F_N[3], double M_Nm[3]);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* FMX_CAPI_FMX_H */
@@ -0,0 +1,191 @@
+// C API implementation: scenes wrap prepared solver inputs; every entry point catches
+#include "capi/fmx.h"
+
+#include <cmath>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+#include "geom/BVH.hpp"
+#include "geom/Mesh.hpp"
+#include "gsi/KernelSet.hpp"
+#include "solver/PanelSolver.hpp"
+
+struct fmx_scene {
+  std::vector<fmx::Facet> facets;
+  std::unique_ptr<fmx::geom::BVHOccluder> bvh;
+  std::vector<fmx::solver::Material> materials{fmx::solver::Material{}};
+  fmx::Vec3 cg;
+  bool occlusion{true};
+  fmx::solver::GsiModel gsi{fmx::solver::GsiModel::Sentman};
+  std::unique_ptr<fmx::gsi::KernelSet> cll_table;
+  // Solves share the scene; setters take it exclusively
+  mutable std::shared_mutex mu;
+};
+
+namespace {
+
+thread_local std::string t_last_error;
+
+fmx_status fail(fmx_status s, std::string msg) {
+  t_last_error = std::move(msg);
+  return s;
+}
+
+template <typename F>
+fmx_status guarded(F&& f) noexcept {
+  try {
+    return f();
+  } catch (const std::bad_alloc&) {
+    return fail(FMX_E_NO_MEMORY, "out of memory");
+  } catch (const std::exception& e) {
+    return fail(FMX_E_INTERNAL, e.what());
+  } catch (...) {
+    return fail(FMX_E_INTERNAL, "unknown error");
+  }
+}
+
+bool finite3(const double v[3]) { return std::isfinite(v[0]) && std::isfinite(v[1]) && std::isfinite(v[2]); }
+
+// Facets and BVH from triangles; the scene takes the triangle list
+fmx_scene* make_scene(fmx::geom::Mesh&& mesh) {
+  auto s = std::make_unique<fmx_scene>();
+  s->facets = mesh.to_facets(0);
+  s->bvh = std::make_unique<fmx::geom::BVHOccluder>(mesh.tris);
+  return s.release();
+}
+
+} // namespace
+
+extern "C" {
+
+int fmx_api_version(void) { return FMX_API_VERSION; }
+
+const char* fmx_last_error(void) { return t_last_error.c_str(); }
+
+fmx_status fmx_scene_load(const char* mesh_path, fmx_scene** out) {
+  return guarded([&] {
+    if (!mesh_path || !out) return fail(FMX_E_INVALID_ARG, "fmx_scene_load: null argument");
+    std::string err;
+    auto mesh = fmx::geom::Mesh::load(mesh_path, &err);
+    if (!mesh) return fail(FMX_E_IO, err.empty() ? std::string("failed to load mesh: ") + mesh_path : err);
+    if (mesh->tris.empty()) return fail(FMX_E_IO, std::string("mesh has no triangles: ") + mesh_path);
+    *out = make_scene(std::move(*mesh));
+    return FMX_OK;
+  });
+}
+
+fmx_status fmx_scene_from_arrays(const double* vertices, size_t n_vertices, const uint32_t* indices,
+                                 size_t n_triangles, const uint32_t* material_ids, fmx_scene** out) {
+  return guarded([&] {
+    if (!vertices || !indices || !out) return fail(FMX_E_INVALID_ARG, "fmx_scene_from_arrays: null argument");
+    if (n_triangles == 0) return fail(FMX_E_INVALID_ARG, "fmx_scene_from_arrays: no triangles");
+    for (size_t i = 0; i < 3 * n_vertices; i += 3) {
+      if (!finite3(vertices + i)) return fail(FMX_E_INVALID_ARG, "vertex " + std::to_string(i / 3) + " is not finite");
+    }
+    fmx::geom::Mesh mesh;
+    mesh.tris.reserve(n_triangles);
+    for (size_t t = 0; t < n_triangles; ++t) {
+      const uint32_t* ix = indices + 3 * t;
+      if (ix[0] >= n_vertices || ix[1] >= n_vertices || ix[2] >= n_vertices) {
+        return fail(FMX_E_INVALID_ARG, "triangle " + std::to_string(t) + " indexes past n_vertices");
+      }
+      auto v = [&](uint32_t k) { return fmx::Vec3{vertices[3*k], vertices[3*k + 1], vertices[3*k + 2]}; };
+      mesh.tris.push_back({v(ix[0]), v(ix[1]), v(ix[2])});
+    }
+    fmx_scene* s = make_scene(std::move(mesh));
+    if (material_ids) {
+      for (size_t t = 0; t < n_triangles; ++t) s->facets[t].material_id = material_ids[t];
+    }
+    *out = s;
+    return FMX_OK;
+  });
+}
+
+void fmx_scene_destroy(fmx_scene* scene) { delete scene; }
+
+size_t fmx_scene_facet_count(const fmx_scene* scene) { return scene ? scene->facets.size() : 0; }
+
+fmx_status fmx_scene_set_material(fmx_scene* scene, uint32_t material_id, const fmx_material* m) {
+  return guarded([&] {
+    if (!scene || !m) return fail(FMX_E_INVALID_ARG, "fmx_scene_set_material: null argument");
+    if (!(m->alpha_n >= 0.0 && m->alpha_n <= 1.0 && m->alpha_t >= 0.0 && m->alpha_t <= 1.0
+          && m->alpha_E >= 0.0 && m->alpha_E <= 1.0 && m->Tw_K >= 0.0 && std::isfinite(m->Tw_K))) {
+      return fail(FMX_E_INVALID_ARG, "fmx_scene_set_material: accommodation outside [0,1] or invalid Tw_K");
+    }
+    std::unique_lock lk(scene->mu);
+    if (material_id >= scene->materials.size()) scene->materials.resize(size_t{material_id} + 1);
+    scene->materials[material_id] = {m->alpha_n, m->alpha_t, m->alpha_E, m->Tw_K};
+    return FMX_OK;
+  });
+}
+
+fmx_status fmx_scene_set_cg(fmx_scene* scene, const double cg[3]) {
+  return guarded([&] {
+    if (!scene || !cg) return fail(FMX_E_INVALID_ARG, "fmx_scene_set_cg: null argument");
+    if (!finite3(cg)) return fail(FMX_E_INVALID_ARG, "fmx_scene_set_cg: not finite");
+    std::unique_lock lk(scene->mu);
+    scene->cg = {cg[0], cg[1], cg[2]};
+    return FMX_OK;
+  });
+}
+
+fmx_status fmx_scene_set_occlusion(fmx_scene* scene, int enabled) {
+  return guarded([&] {
+    if (!scene) return fail(FMX_E_INVALID_ARG, "fmx_scene_set_occlusion: null scene");
+    std::unique_lock lk(scene->mu);
+    scene->occlusion = (enabled != 0);
+    return FMX_OK;
+  });
+}
+
+fmx_status fmx_scene_set_gsi(fmx_scene* scene, fmx_gsi_model model, const char* cll_table_path) {
+  return guarded([&] {
+    if (!scene) return fail(FMX_E_INVALID_ARG, "fmx_scene_set_gsi: null scene");
+    if (model != FMX_GSI_SENTMAN && model != FMX_GSI_CLL) return fail(FMX_E_INVALID_ARG, "fmx_scene_set_gsi: unknown model");
+    std::unique_ptr<fmx::gsi::KernelSet> table;
+    if (model == FMX_GSI_CLL && cll_table_path) {
+      table = std::make_unique<fmx::gsi::KernelSet>();
+      if (!table->load(cll_table_path)) return fail(FMX_E_IO, std::string("failed to load CLL table: ") + cll_table_path);
+    }
+    std::unique_lock lk(scene->mu);
+    scene->gsi = (model == FMX_GSI_CLL) ? fmx::solver::GsiModel::CLL : fmx::solver::GsiModel::Sentman;
+    scene->cll_table = std::move(table);
+    return FMX_OK;
+  });
+}
+
+fmx_status fmx_solve(const fmx_scene* scene, const fmx_state* state, double F_N[3], double M_Nm[3]) {
+  return guarded([&] {
+    if (!scene || !state || !F_N || !M_Nm) return fail(FMX_E_INVALID_ARG, "fmx_solve: null argument");
+    if (state->n_species > 0 && (!state->rho_kgm3 || !state->mass_kg)) return fail(FMX_E_INVALID_ARG, "fmx_solve: null species arrays");
+    if (!std::isfinite(state->T_K) || !(state->T_K > 0.0) || !finite3(state->V_sat_ms) || !finite3(state->wind_ms)) {
+      return fail(FMX_E_INVALID_ARG, "fmx_solve: invalid temperature or velocity");
+    }
+    fmx::solver::Input in;
+    in.species.reserve(state->n_species);
+    for (size_t s = 0; s < state->n_species; ++s) {
+      if (!(state->rho_kgm3[s] >= 0.0) || !(state->mass_kg[s] > 0.0)) return fail(FMX_E_INVALID_ARG, "fmx_solve: invalid species " + std::to_string(s));
+      in.species.push_back({state->rho_kgm3[s], state->mass_kg[s]});
+    }
+    in.T_K = state->T_K;
+    in.V_sat_ms = {state->V_sat_ms[0], state->V_sat_ms[1], state->V_sat_ms[2]};
+    in.wind_ms = {state->wind_ms[0], state->wind_ms[1], state->wind_ms[2]};
+    std::shared_lock lk(scene->mu);
+    in.facets_view = &scene->facets;
+    in.materials = scene->materials;
+    in.r_CG = scene->cg;
+    in.occluder = scene->occlusion ? scene->bvh.get() : nullptr;
+    in.gsi_model = scene->gsi;
+    in.cll_kernel = scene->cll_table.get();
+    const fmx::solver::Output o = fmx::solver::solve(in);
+    F_N[0] = o.F.x; F_N[1] = o.F.y; F_N[2] = o.F.z;
+    M_Nm[0] = o.M.x; M_Nm[1] = o.M.y; M_Nm[2] = o.M.z;
+    return FMX_OK;
+  });
+}
+
+} // extern "C"
@@ -0,0 +1,345 @@
+#include "cli/Batch.hpp"
+#include "cli/JsonScan.hpp"
+#include "atm/Epoch.hpp"
+#include "core/Trace.hpp"
+#include "geom/BVH.hpp"
+#include "geom/Mesh.hpp"
+#include "solver/Executor.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace fmx::cli {
+
+namespace {
+
+constexpr char kMagic[8] = {'F','M','X','B','A','T','1','\0'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kCols = 10;
+constexpr char kColNames[kCols][16] = {"id", "status", "Fx", "Fy", "Fz", "Mx", "My", "Mz", "rho_kgm3", "T_K"};
+
+enum : int { kCaseOk = 0, kCaseBadLine = 1, kCaseBadGeometry = 2 };
+
+struct BatchHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t n_cols;
+  std::uint64_t n_rows;
+  std::uint32_t reserved[10];
+};
+static_assert(sizeof(BatchHeader) == 64, "batch header must be 64 bytes");
+
+using Clock = std::chrono::steady_clock;
+double seconds_since(Clock::time_point t) { return std::chrono::duration<double>(Clock::now() - t).count(); }
+
+// A prepared geometry shared by all cases that name it
+struct Scene {
+  std::vector<fmx::Facet> facets;
+  std::unique_ptr<fmx::geom::BVHOccluder> occ;
+  bool ok{true};
+};
+
+Vec3 rotate_z(const Vec3& v, double c, double s) { return {v.x*c - v.y*s, v.x*s + v.y*c, v.z}; }
+
+// Exact-match key for grouping cases by their index set
+std::array<double, 13> indices_key(const fmx::atm::Indices& x) {
+  return {x.F10_7, x.F10_7A, static_cast<double>(x.Kp), x.has_ap_array ? 1.0 : 0.0,
+          x.Ap[0], x.Ap[1], x.Ap[2], x.Ap[3], x.Ap[4], x.Ap[5], x.Ap[6], x.Ap_daily, x.Ap_now};
+}
+
+} // namespace
+
+bool parse_batch_case(std::string_view line, const BatchCase& defaults, BatchCase& c, std::string* err) {
+  c = defaults;
+  std::string bad;
+  auto num = [&](std::string_view k, std::string_view v, double& out) {
+    if (!to_number(v, out) && bad.empty()) bad = "bad number for " + std::string(k);
+  };
+  auto idx_num = [&](std::string_view k, std::string_view v, double& out) { num(k, v, out); c.has_indices = true; };
+  const bool well_formed = scan_members(line, [&](std::string_view k, std::string_view v) {
+    double d = 0.0;
+    if (k == "id") { if (!to_uint64(v, c.id) && bad.empty()) bad = "bad number for id"; }
+    else if (k == "geometry") c.geometry = std::string(v);
+    else if (k == "alt_km") num(k, v, c.alt_km);
+    else if (k == "lat_deg") num(k, v, c.lat_deg);
+    else if (k == "lon_deg") num(k, v, c.lon_deg);
+    else if (k == "epoch_s") num(k, v, c.epoch_s);
+    else if (k == "utc") { if (!fmx::atm::parse_iso_utc(std::string(v), c.epoch_s) && bad.empty()) bad = "bad utc"; }
+    else if (k == "V_sat_mps") { if (!to_array3(v, c.V_sat_ms) && bad.empty()) bad = "bad V_sat_mps"; }
+    else if (k == "wind_mps") { c.has_wind = to_array3(v, c.wind_ms); if (!c.has_wind && bad.empty()) bad = "bad wind_mps"; }
+    else if (k == "theta_deg") num(k, v, c.theta_deg);
+    else if (k == "alpha_E") num(k, v, c.material.alpha_E);
+    else if (k == "alpha_n") num(k, v, c.material.alpha_n);
+    else if (k == "alpha_t") num(k, v, c.material.alpha_t);
+    else if (k == "Tw_K") num(k, v, c.material.Tw_K);
+    else if (k == "F10_7") idx_num(k, v, c.idx.F10_7);
+    else if (k == "F10_7A") idx_num(k, v, c.idx.F10_7A);
+    else if (k == "Kp") {
+      idx_num(k, v, d);
+      if (d == std::trunc(d) && d >= std::numeric_limits<int>::min() && d <= std::numeric_limits<int>::max()) c.idx.Kp = static_cast<int>(d);
+      else if (bad.empty()) bad = "bad number for Kp";
+    }
+    else if (k == "Ap_daily") { idx_num(k, v, c.idx.Ap_daily); c.idx.has_ap_array = false; }
+    else if (k == "Ap_now") { idx_num(k, v, c.idx.Ap_now); c.idx.has_ap_array = false; }
+    else if (bad.empty()) bad = "unknown key " + std::string(k);
+  });
+  if (!well_formed) bad = "not a JSON object";
+  if (bad.empty()) {
+    const bool finite = std::isfinite(c.alt_km) && std::isfinite(c.lat_deg) && std::isfinite(c.lon_deg)
+        && std::isfinite(c.epoch_s) && std::isfinite(c.theta_deg)
+        && std::isfinite(c.V_sat_ms.x) && std::isfinite(c.V_sat_ms.y) && std::isfinite(c.V_sat_ms.z);
+    const auto& m = c.material;
+    if (!finite) bad = "non-finite state";
+    else if (!(m.alpha_E >= 0.0 && m.alpha_E <= 1.0 && m.alpha_n >= 0.0 && m.alpha_n <= 1.0
+               && m.alpha_t >= 0.0 && m.alpha_t <= 1.0 && m.Tw_K >= 0.0)) bad = "accommodation outside [0,1] or negative Tw_K";
+  }
+  if (!bad.empty()) { if (err) *err = bad; return false; }
+  return true;
+}
+
+bool run_batch(const BatchOptions& opt, const BatchCase& defaults, const fmx::atm::AtmosphereSession& session,
+               const fmx::atm::SpaceWeatherTable& sw, const fmx::atm::Indices& idx,
+               const fmx::solver::Input& base, BatchStats* stats, std::string* err) {
+  BatchStats st;
+  const auto t_start = Clock::now();
+  std::ifstream in(opt.cases_path, std::ios::binary);
+  if (!in) { if (err) *err = "Failed to open cases: " + opt.cases_path; return false; }
+  std::ofstream out(opt.out_path, opt.binary ? std::ios::binary : std::ios::out);
+  if (!out) { if (err) *err = "Failed to open output: " + opt.out_path; return false; }
+  std::unique_ptr<fmx::solver::Executor> own_exec;
+  if (!opt.executor) own_exec = std::make_unique<fmx::solver::Executor>(opt.threads);
+  fmx::solver::Executor& exec = opt.executor ? *opt.executor : *own_exec;
+  st.threads = exec.threads();
+  const std::size_t grain = std::max<std::size_t>(opt.grain, 1);
+
+  // Cases: split into lines, then parse the lines in parallel
+  auto t = Clock::now();
+  fmx::trace::Scope sp_parse("batch.parse", "batch");
+  std::string text;
+  {
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    text = ss.str();
+  }
+  std::vector<std::string_view> lines;
+  for (std::size_t b = 0; b < text.size();) {
+    const char* nl = static_cast<const char*>(std::memchr(text.data() + b, '\n', text.size() - b));
+    const std::size_t e = nl ? static_cast<std::size_t>(nl - text.data()) : text.size();
+    std::string_view l(text.data() + b, e - b);
+    while (!l.empty() && (l.back() == '\r' || l.back() == ' ' || l.back() == '\t')) l.remove_suffix(1);
+    while (!l.empty() && (l.front() == ' ' || l.front() == '\t')) l.remove_prefix(1);
+    if (!l.empty() && l.front() != '#') lines.push_back(l);
+    b = e + 1;
+  }
+  const std::size_t n = lines.size();
+  std::vector<BatchCase> cases(n);
+  std::vector<int> status(n, kCaseOk);
+  std::vector<std::string> reasons(n);
+  exec.parallel_for(n, 256, [&](std::size_t b, std::size_t e) {
+    BatchCase d = defaults;
+    for (std::size_t i = b; i < e; ++i) {
+      d.id = static_cast<std::uint64_t>(i);
+      if (!parse_batch_case(lines[i], d, cases[i], &reasons[i])) {
+        status[i] = kCaseBadLine;
+        cases[i].id = d.id;
+      }
+    }
+  });
+  for (std::size_t i = 0; i < n; ++i) {
+    if (status[i] == kCaseBadLine) std::fprintf(stderr, "batch: case %zu rejected: %s\n", i + 1, reasons[i].c_str());
+  }
+  st.parse_s = seconds_since(t);
+  sp_parse.end();
+
+  // Geometries: each distinct path is loaded and its BVH built once ("" is the CLI's mesh)
+  t = Clock::now();
+  fmx::trace::Scope sp_setup("batch.setup", "batch");
+  std::map<std::string, std::size_t> scene_of;
+  std::vector<Scene> scenes;
+  std::vector<std::size_t> case_scene(n, 0);
+  for (std::size_t i = 0; i < n; ++i) {
+    if (status[i] != kCaseOk) continue;
+    auto [it, inserted] = scene_of.emplace(cases[i].geometry, scenes.size());
+    if (inserted) {
+      Scene sc;
+      if (!cases[i].geometry.empty()) {
+        std::string merr;
+        auto mesh = fmx::geom::Mesh::load(cases[i].geometry, &merr);
+        if (mesh) {
+          sc.facets = mesh->to_facets(0);
+          sc.occ = std::make_unique<fmx::geom::BVHOccluder>(mesh->tris);
+        } else {
+          std::fprintf(stderr, "batch: failed to load geometry %s: %s\n", cases[i].geometry.c_str(), merr.c_str());
+          sc.ok = false;
+        }
+      }
+      scenes.push_back(std::move(sc));
+    }
+    case_scene[i] = it->second;
+    if (!scenes[it->second].ok) status[i] = kCaseBadGeometry;
+  }
+  st.geometries = scenes.size();
+  st.setup_s = seconds_since(t);
+  sp_setup.end();
+
+  // Atmosphere: one batch per distinct index set; cases without indices share the table
+  // lookup (or the CLI indices)
+  t = Clock::now();
+  fmx::trace::Scope sp_atm("batch.atmosphere", "batch");
+  std::map<std::array<double, 13>, std::vector<std::size_t>> by_indices;
+  std::vector<std::size_t> table_group;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (status[i] != kCaseOk) continue;
+    if (cases[i].has_indices) by_indices[indices_key(cases[i].idx)].push_back(i);
+    else table_group.push_back(i);
+  }
+  std::vector<double> T_K(n, 0.0), wind(3 * n, 0.0), rho;
+  std::vector<double> species_mass;
+  std::vector<double> alt, lat, lon, ep;
+  fmx::atm::StateBatch atm;
+  auto evaluate_group = [&](const std::vector<std::size_t>& members, const fmx::atm::Indices* gidx) {
+    if (members.empty()) return true;
+    alt.clear(); lat.clear(); lon.clear(); ep.clear();
+    for (std::size_t i : members) {
+      alt.push_back(cases[i].alt_km); lat.push_back(cases[i].lat_deg);
+      lon.push_back(cases[i].lon_deg); ep.push_back(cases[i].epoch_s);
+    }
+    const fmx::atm::PointBatch pts{members.size(), alt.data(), lat.data(), lon.data(), ep.data()};
+    if (gidx) session.evaluate_batch(pts, *gidx, atm);
+    else session.evaluate_batch(pts, sw, atm);
+    ++st.atm_groups;
+    if (species_mass.empty()) {
+      species_mass = atm.species_mass;
+      rho.assign(n * species_mass.size(), 0.0);
+    } else if (atm.species_mass != species_mass) {
+      if (err) *err = "atmosphere returned a different species set between batches";
+      return false;
+    }
+    const std::size_t S = species_mass.size();
+    for (std::size_t k = 0; k < members.size(); ++k) {
+      const std::size_t i = members[k];
+      T_K[i] = atm.T_K[k];
+      wind[3*i] = atm.wind_x[k]; wind[3*i+1] = atm.wind_y[k]; wind[3*i+2] = atm.wind_z[k];
+      for (std::size_t s = 0; s < S; ++s) rho[i*S + s] = atm.rho_of(s)[k];
+    }
+    return true;
+  };
+  if (!evaluate_group(table_group, sw.valid() ? nullptr : &idx)) return false;
+  for (const auto& [key, members] : by_indices) {
+    if (!evaluate_group(members, &cases[members.front()].idx)) return false;
+  }
+  st.atm_s = seconds_since(t);
+  sp_atm.end();
+
+  // Solve: cases ordered by geometry so a chunk mostly reuses one scene. Cases are
+  // independent, so parallelism is across cases and each solve runs serially.
+  t = Clock::now();
+  fmx::trace::Scope sp_solve("batch.solve", "batch", static_cast<std::int64_t>(n));
+  std::vector<std::size_t> order;
+  order.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) if (status[i] == kCaseOk) order.push_back(i);
+  std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return case_scene[a] < case_scene[b]; });
+  const std::size_t S = species_mass.size();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  std::vector<double> cols(kCols * n, nan); // column-major, as written
+  auto col = [&](std::size_t c) { return cols.data() + c * n; };
+  exec.parallel_for(order.size(), grain, [&](std::size_t b, std::size_t e) {
+    fmx::solver::Input cin = base.view();
+    std::size_t cur = static_cast<std::size_t>(-1);
+    for (std::size_t k = b; k < e; ++k) {
+      const std::size_t i = order[k];
+      const BatchCase& c = cases[i];
+      if (case_scene[i] != cur) {
+        cur = case_scene[i];
+        const Scene& sc = scenes[cur];
+        if (c.geometry.empty()) {
+          cin.facets_view = &base.facet_list();
+          cin.occluder = base.occluder;
+          cin.facet_tris = base.facet_tris;
+        } else {
+          cin.facets_view = &sc.facets;
+          cin.occluder = sc.occ.get();
+          cin.facet_tris = &sc.occ->triangles(); // the BVH keeps the mesh's triangles in facet order
+        }
+      }
+      cin.materials.assign(1, c.material);
+      cin.species.clear();
+      double rho_sum = 0.0;
+      for (std::size_t s = 0; s < S; ++s) {
+        cin.species.push_back({rho[i*S + s], species_mass[s]});
+        rho_sum += rho[i*S + s];
+      }
+      cin.T_K = T_K[i];
+      const Vec3 w = c.has_wind ? c.wind_ms : Vec3{wind[3*i], wind[3*i+1], wind[3*i+2]};
+      // Mesh rotated by theta about z == flow, wind and CG rotated by -theta; loads rotate back
+      double cs = 1.0, sn = 0.0;
+      if (c.theta_deg != 0.0) {
+        const double th = c.theta_deg * M_PI / 180.0;
+        cs = std::cos(th); sn = std::sin(th);
+      }
+      cin.V_sat_ms = rotate_z(c.V_sat_ms, cs, -sn);
+      cin.wind_ms = rotate_z(w, cs, -sn);
+      cin.r_CG = rotate_z(base.r_CG, cs, -sn);
+      const fmx::solver::Output o = fmx::solver::solve_serial(cin);
+      const Vec3 F = rotate_z(o.F, cs, sn), M = rotate_z(o.M, cs, sn);
+      col(2)[i] = F.x; col(3)[i] = F.y; col(4)[i] = F.z;
+      col(5)[i] = M.x; col(6)[i] = M.y; col(7)[i] = M.z;
+      col(8)[i] = rho_sum;
+      col(9)[i] = T_K[i];
+    }
+  });
+  for (std::size_t i = 0; i < n; ++i) {
+    col(0)[i] = static_cast<double>(cases[i].id);
+    col(1)[i] = static_cast<double>(status[i]);
+    if (status[i] != kCaseOk) ++st.errors;
+  }
+  st.cases = n;
+  st.solve_s = seconds_since(t);
+  sp_solve.end();
+
+  // Output in input order
+  t = Clock::now();
+  FMX_TRACE_SCOPE("batch.write", "batch");
+  if (opt.binary) {
+    BatchHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.n_cols = static_cast<std::uint32_t>(kCols);
+    h.n_rows = n;
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(&kColNames[0][0], sizeof(kColNames));
+    out.write(reinterpret_cast<const char*>(cols.data()), static_cast<std::streamsize>(cols.size() * sizeof(double)));
+  } else {
+    std::string csv = "id,status,Fx,Fy,Fz,Mx,My,Mz,rho_kgm3,T_K\n";
+    csv.reserve(csv.size() + n * kCols * 16);
+    char buf[32];
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::size_t c = 0; c < kCols; ++c) {
+        const double v = col(c)[i];
+        const auto r = c < 2 ? std::to_chars(buf, buf + sizeof(buf), static_cast<std::uint64_t>(v))
+                             : std::to_chars(buf, buf + sizeof(buf), v, std::chars_format::general, 9);
+        csv.append(buf, r.ptr);
+        csv.push_back(c + 1 == kCols ? '\n' : ',');
+      }
+    }
+    out.write(csv.data(), static_cast<std::streamsize>(csv.size()));
+  }
+  out.flush();
+  st.write_s = seconds_since(t);
+  st.wall_s = seconds_since(t_start);
+  if (stats) *stats = st;
+  if (!out) { if (err) *err = "Write failed: " + opt.out_path; return false; }
+  return true;
+}
+
+} // namespace fmx::cli
@@ -0,0 +1,72 @@
+// Batch mode: many independent cases per process (JSON-lines in, columnar results out)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "atm/AtmosphereSession.hpp"
+#include "atm/SpaceWeather.hpp"
+#include "solver/PanelSolver.hpp"
+
+namespace fmx::cli {
+
+// One case: a geodetic point with a body-frame velocity as in the config's state block, an
+// optional attitude rotation about body z, a material and optional solar/geomagnetic indices.
+// Keys missing from a case line keep the values of the defaults passed to the parser:
+//   {"id":17, "geometry":"sat.obj", "alt_km":350, "lat_deg":0, "lon_deg":0,
+//    "utc":"2025-09-12T12:00:00Z" | "epoch_s":1757678400, "V_sat_mps":[7600,0,0],
+//    "wind_mps":[0,0,0], "theta_deg":10, "alpha_E":0.9, "alpha_n":1, "alpha_t":1, "Tw_K":300,
+//    "F10_7":150, "F10_7A":140, "Kp":3, "Ap_daily":15, "Ap_now":12}
+// An empty geometry is the CLI's mesh. theta_deg rotates the mesh about z like --theta_deg.
+struct BatchCase {
+  std::uint64_t id{0};
+  std::string geometry;
+  double alt_km{400.0}, lat_deg{0.0}, lon_deg{0.0};
+  double epoch_s{0.0};
+  Vec3 V_sat_ms{7500.0, 0.0, 0.0};
+  bool has_wind{false};
+  Vec3 wind_ms;                     // body-frame wind (default: model wind as-is)
+  double theta_deg{0.0};
+  fmx::solver::Material material;
+  bool has_indices{false};          // any index key given: `idx` replaces the table lookup
+  fmx::atm::Indices idx;
+};
+
+// Parses one case line on top of `defaults` (id defaults to the line's position). False
+// with `err` set for malformed lines and unknown or mistyped keys.
+bool parse_batch_case(std::string_view line, const BatchCase& defaults, BatchCase& c, std::string* err = nullptr);
+
+// Result file. CSV has a header line; the binary form is column-major (native byte order):
+//   header (64 bytes): char magic[8] = "FMXBAT1", u32 version, u32 n_cols, u64 n_rows, u32 reserved[10]
+//   n_cols column names (char[16], NUL-padded), then each column as n_rows doubles
+// Columns: id, status (0 ok, 1 bad case line, 2 geometry failed to load), Fx, Fy, Fz,
+// Mx, My, Mz (body frame), rho_kgm3, T_K. Rows follow the input order; failed cases are NaN.
+struct BatchOptions {
+  std::string cases_path;
+  std::string out_path;
+  bool binary{false};
+  fmx::solver::Executor* executor{nullptr}; // shared pool; null: a pool of `threads` for this run
+  unsigned threads{0};              // solver threads without a shared pool; 0: hardware concurrency
+  std::size_t grain{64};            // cases per scheduling chunk
+};
+
+struct BatchStats {
+  std::size_t cases{0};
+  std::size_t errors{0};
+  std::size_t geometries{0};        // distinct meshes prepared
+  std::size_t atm_groups{0};        // atmosphere batch calls
+  unsigned threads{1};
+  double wall_s{0.0};
+  double parse_s{0.0}, setup_s{0.0}, atm_s{0.0}, solve_s{0.0}, write_s{0.0};
+};
+
+// Reads all cases, prepares each distinct geometry (facets + BVH) once, evaluates the
+// atmosphere in one batch per distinct index set (or through `sw` for cases without indices
+// when it is valid, else `idx`), solves the cases in parallel on a work-stealing executor and
+// writes the results. `base` carries the CLI's mesh, occluder, CG and GSI setup.
+bool run_batch(const BatchOptions& opt, const BatchCase& defaults, const fmx::atm::AtmosphereSession& session,
+               const fmx::atm::SpaceWeatherTable& sw, const fmx::atm::Indices& idx,
+               const fmx::solver::Input& base, BatchStats* stats = nullptr, std::string* err = nullptr);
+
+} // namespace fmx::cli
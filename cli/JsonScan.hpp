@@ -0,0 +1,168 @@
+// Minimal key lookup in flat JSON text (config files, serve/batch request lines)
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "core/types.hpp"
+
+namespace fmx::cli {
+
+inline bool find_string(const std::string& s, const std::string& key, std::string& out) {
+  auto pos = s.find("\"" + key + "\""); if (pos == std::string::npos) return false;
+  pos = s.find(':', pos); if (pos == std::string::npos) return false;
+  pos = s.find('"', pos); if (pos == std::string::npos) return false;
+  auto end = s.find('"', pos+1); if (end == std::string::npos) return false;
+  out = s.substr(pos+1, end-pos-1); return true;
+}
+
+inline bool find_number(const std::string& s, const std::string& key, double& out) {
+  auto pos = s.find("\"" + key + "\""); if (pos == std::string::npos) return false;
+  pos = s.find(':', pos); if (pos == std::string::npos) return false;
+  auto end = s.find_first_of(",}\n\r", pos+1);
+  std::string t = s.substr(pos+1, end-pos-1);
+  try { out = std::stod(t); return true; } catch (...) { return false; }
+}
+
+// Raw scalar text of key (up to the next ',' or '}'), blanks trimmed
+inline bool find_token(const std::string& s, const std::string& key, std::string_view& out) {
+  auto pos = s.find("\"" + key + "\""); if (pos == std::string::npos) return false;
+  pos = s.find(':', pos); if (pos == std::string::npos) return false;
+  auto end = std::min(s.find_first_of(",}\n\r", pos+1), s.size());
+  std::string_view t(s.data() + pos + 1, end - pos - 1);
+  while (!t.empty() && (t.front() == ' ' || t.front() == '\t')) t.remove_prefix(1);
+  while (!t.empty() && (t.back() == ' ' || t.back() == '\t')) t.remove_suffix(1);
+  out = t; return true;
+}
+
+inline bool find_int(const std::string& s, const std::string& key, int& out) {
+  double d; if (!find_number(s, key, d)) return false; out = static_cast<int>(d); return true;
+}
+
+inline bool find_arrayD(const std::string& s, const std::string& key, std::vector<double>& out) {
+  auto pos = s.find("\"" + key + "\""); if (pos == std::string::npos) return false;
+  pos = s.find('[', pos); if (pos == std::string::npos) return false;
+  auto end = s.find(']', pos); if (end == std::string::npos) return false;
+  std::string arr = s.substr(pos+1, end-pos-1);
+  out.clear();
+  std::istringstream ss(arr);
+  std::string tok;
+  while (std::getline(ss, tok, ',')) {
+    try { out.push_back(std::stod(tok)); } catch (...) {}
+  }
+  return !out.empty();
+}
+
+inline bool find_array3(const std::string& s, const std::string& key, Vec3& out) {
+  auto pos = s.find("\"" + key + "\""); if (pos == std::string::npos) return false;
+  pos = s.find('[', pos); if (pos == std::string::npos) return false;
+  auto end = s.find(']', pos); if (end == std::string::npos) return false;
+  std::string arr = s.substr(pos+1, end-pos-1);
+  std::replace(arr.begin(), arr.end(), ',', ' ');
+  std::istringstream ss(arr);
+  if (!(ss >> out.x >> out.y >> out.z)) return false;
+  return true;
+}
+
+// Single pass over the members of one flat JSON object, for per-line inputs where repeated
+// find_* searches would dominate. fn(key, value) gets string values without their quotes,
+// arrays and nested objects as raw text including the brackets, and other values trimmed.
+// Escapes inside strings are not decoded. False if the text is not a well-formed object.
+template <class Fn>
+bool scan_members(std::string_view s, Fn&& fn) {
+  std::size_t i = 0;
+  auto skip_ws = [&] { while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\r' || s[i] == '\n')) ++i; };
+  auto string_end = [&](std::size_t b) { // index of the closing quote of a string opened at b
+    for (std::size_t k = b + 1; k < s.size(); ++k) {
+      if (s[k] == '\\') ++k;
+      else if (s[k] == '"') return k;
+    }
+    return std::string_view::npos;
+  };
+  skip_ws();
+  if (i >= s.size() || s[i] != '{') return false;
+  ++i;
+  skip_ws();
+  if (i < s.size() && s[i] == '}') return true;
+  while (i < s.size()) {
+    skip_ws();
+    if (i >= s.size() || s[i] != '"') return false;
+    const std::size_t ke = string_end(i);
+    if (ke == std::string_view::npos) return false;
+    const std::string_view key = s.substr(i + 1, ke - i - 1);
+    i = ke + 1;
+    skip_ws();
+    if (i >= s.size() || s[i] != ':') return false;
+    ++i;
+    skip_ws();
+    if (i >= s.size()) return false;
+    std::string_view value;
+    if (s[i] == '"') {
+      const std::size_t ve = string_end(i);
+      if (ve == std::string_view::npos) return false;
+      value = s.substr(i + 1, ve - i - 1);
+      i = ve + 1;
+    } else if (s[i] == '[' || s[i] == '{') {
+      const std::size_t b = i;
+      int depth = 0;
+      for (; i < s.size(); ++i) {
+        if (s[i] == '"') { i = string_end(i); if (i == std::string_view::npos) return false; }
+        else if (s[i] == '[' || s[i] == '{') ++depth;
+        else if ((s[i] == ']' || s[i] == '}') && --depth == 0) break;
+      }
+      if (i >= s.size()) return false;
+      value = s.substr(b, ++i - b);
+    } else {
+      const std::size_t b = i;
+      while (i < s.size() && s[i] != ',' && s[i] != '}') ++i;
+      std::size_t e = i;
+      while (e > b && (s[e-1] == ' ' || s[e-1] == '\t' || s[e-1] == '\r' || s[e-1] == '\n')) --e;
+      value = s.substr(b, e - b);
+    }
+    fn(key, value);
+    skip_ws();
+    if (i >= s.size()) return false;
+    if (s[i] == '}') return true;
+    if (s[i] != ',') return false;
+    ++i;
+  }
+  return false;
+}
+
+// Whole-token number conversion (no locale, no allocation)
+inline bool to_number(std::string_view v, double& out) {
+  if (!v.empty() && v.front() == '+') v.remove_prefix(1);
+  const auto r = std::from_chars(v.data(), v.data() + v.size(), out);
+  return r.ec == std::errc() && r.ptr == v.data() + v.size();
+}
+
+// Whole-token unsigned integer (request ids): digits only, false on a sign, fraction,
+// exponent or a value of 2^64 and above
+inline bool to_uint64(std::string_view v, std::uint64_t& out) {
+  const auto r = std::from_chars(v.data(), v.data() + v.size(), out);
+  return !v.empty() && r.ec == std::errc() && r.ptr == v.data() + v.size();
+}
+
+// "[x, y, z]" as produced by scan_members
+inline bool to_array3(std::string_view v, Vec3& out) {
+  if (v.size() < 2 || v.front() != '[' || v.back() != ']') return false;
+  v = v.substr(1, v.size() - 2);
+  double c[3];
+  for (int k = 0; k < 3; ++k) {
+    const std::size_t comma = v.find(',');
+    if ((k < 2) == (comma == std::string_view::npos)) return false;
+    std::string_view t = v.substr(0, comma);
+    while (!t.empty() && (t.front() == ' ' || t.front() == '\t')) t.remove_prefix(1);
+    while (!t.empty() && (t.back() == ' ' || t.back() == '\t')) t.remove_suffix(1);
+    if (!to_number(t, c[k])) return false;
+    v = k < 2 ? v.substr(comma + 1) : std::string_view{};
+  }
+  out = {c[0], c[1], c[2]};
+  return true;
+}
+
+} // namespace fmx::cli
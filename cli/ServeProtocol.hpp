@@ -0,0 +1,43 @@
+// Wire format of fmx_cli --serve (shared with the fmx_client benchmark tool)
+//
+// Binary frames (native byte order): u32 payload_bytes, then the payload. A request payload
+// is ServeBinRequest (96 bytes); a zero-length frame asks the server to shut down. Every
+// request is answered with one ServeBinReply frame (88 bytes) carrying the same id.
+// q_body_to_ecef all zero selects the ram-pointing body frame (see cli/Trajectory.hpp).
+//
+// JSON lines: one object per line, one reply line per request.
+//   {"id":1, "epoch_s":1757678400 | "utc":"2025-09-12T12:00:00Z",
+//    "r_ecef_m":[x,y,z], "v_ecef_ms":[vx,vy,vz][, "q_body_to_ecef":[w,x,y,z]]}
+//   {"id":2, "utc":..., "alt_km":400, "lat_deg":0, "lon_deg":0, "V_sat_mps":[7500,0,0][, "wind_mps":[..]]}
+//   {"cmd":"shutdown"}
+// Replies: {"id":1,"F":[..],"M":[..],"rho_kgm3":..,"T_K":..,"us":..} or {"id":1,"error":"..."}
+#pragma once
+
+#include <cstdint>
+
+namespace fmx::cli {
+
+enum ServeStatus : std::int32_t { kServeOk = 0, kServeBadRequest = 1 };
+
+struct ServeBinRequest {
+  std::uint64_t id;
+  double epoch_s;           // seconds since 1970 (UTC)
+  double r_ecef_m[3];
+  double v_ecef_ms[3];
+  double q_body_to_ecef[4]; // w, x, y, z
+};
+static_assert(sizeof(ServeBinRequest) == 96, "serve request must be 96 bytes");
+
+struct ServeBinReply {
+  std::uint64_t id;
+  std::int32_t status;      // ServeStatus
+  std::uint32_t reserved;
+  double F[3];              // body frame [N]
+  double M[3];              // about the CG [N*m]
+  double rho_kgm3;
+  double T_K;
+  double solve_us;          // server-side time from decoded request to reply
+};
+static_assert(sizeof(ServeBinReply) == 88, "serve reply must be 88 bytes");
+
+} // namespace fmx::cli
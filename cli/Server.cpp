@@ -0,0 +1,347 @@
+#include "cli/Server.hpp"
+#include "cli/JsonScan.hpp"
+#include "atm/Epoch.hpp"
+#include "core/Trace.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace fmx::cli {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::uint32_t kMaxFrameBytes = 1u << 20; // larger frames are a framing error
+
+// Buffered reads from a descriptor (pipe, file or socket)
+class FdReader {
+public:
+  explicit FdReader(int fd) : m_fd(fd), m_buf(1 << 16) {}
+
+  // Next line without its '\n'; false at end of input
+  bool line(std::string& out) {
+    out.clear();
+    for (;;) {
+      const char* b = m_buf.data() + m_beg;
+      const char* nl = static_cast<const char*>(std::memchr(b, '\n', m_end - m_beg));
+      if (nl) {
+        out.append(b, static_cast<std::size_t>(nl - b));
+        m_beg += static_cast<std::size_t>(nl - b) + 1;
+        return true;
+      }
+      out.append(b, m_end - m_beg);
+      m_beg = m_end;
+      if (!fill()) return !out.empty();
+    }
+  }
+
+  bool exact(void* dst, std::size_t n) {
+    char* d = static_cast<char*>(dst);
+    while (n > 0) {
+      if (m_beg == m_end && !fill()) return false;
+      const std::size_t k = std::min(n, m_end - m_beg);
+      std::memcpy(d, m_buf.data() + m_beg, k);
+      m_beg += k; d += k; n -= k;
+    }
+    return true;
+  }
+
+  // Whether another complete request is already buffered (replies are then batched)
+  bool has_line() const { return std::memchr(m_buf.data() + m_beg, '\n', m_end - m_beg) != nullptr; }
+  bool has_frame() const {
+    if (m_end - m_beg < sizeof(std::uint32_t)) return false;
+    std::uint32_t len;
+    std::memcpy(&len, m_buf.data() + m_beg, sizeof(len));
+    return m_end - m_beg >= sizeof(len) + len;
+  }
+  bool error() const { return m_error; }
+
+private:
+  // Refills an empty buffer; false at end of input or on error
+  bool fill() {
+    m_beg = m_end = 0;
+    for (;;) {
+      const ssize_t k = ::read(m_fd, m_buf.data(), m_buf.size());
+      if (k > 0) { m_end = static_cast<std::size_t>(k); return true; }
+      if (k == 0) return false;
+      if (errno == EINTR) continue;
+      m_error = true;
+      return false;
+    }
+  }
+
+  int m_fd;
+  std::vector<char> m_buf;
+  std::size_t m_beg{0}, m_end{0};
+  bool m_error{false};
+};
+
+bool is_socket(int fd) {
+  struct stat sb;
+  return ::fstat(fd, &sb) == 0 && S_ISSOCK(sb.st_mode);
+}
+
+// Sockets use MSG_NOSIGNAL so a client hanging up ends its connection, not the server
+bool write_all(int fd, bool sock, const void* data, std::size_t n) {
+  const char* p = static_cast<const char*>(data);
+  while (n > 0) {
+    const ssize_t k = sock ? ::send(fd, p, n, MSG_NOSIGNAL) : ::write(fd, p, n);
+    if (k < 0) { if (errno == EINTR) continue; return false; }
+    p += k; n -= static_cast<std::size_t>(k);
+  }
+  return true;
+}
+
+bool finite3(const Vec3& v) { return std::isfinite(v.x) && std::isfinite(v.y) && std::isfinite(v.z); }
+
+} // namespace
+
+bool parse_request_json(const std::string& line, ServeRequest& rq, bool& shutdown, std::string* err) {
+  rq = ServeRequest{};
+  shutdown = false;
+  auto fail = [&](const char* msg) { if (err) *err = msg; return false; };
+  std::string cmd;
+  if (find_string(line, "cmd", cmd)) {
+    if (cmd != "shutdown") return fail("unknown cmd");
+    shutdown = true;
+    return true;
+  }
+  std::string_view id;
+  if (find_token(line, "id", id) && !to_uint64(id, rq.id)) return fail("id must be an integer in [0, 2^64)");
+  if (!find_number(line, "epoch_s", rq.row.epoch_s)) {
+    std::string utc;
+    if (!find_string(line, "utc", utc) || !fmx::atm::parse_iso_utc(utc, rq.row.epoch_s)) return fail("missing epoch_s or utc");
+  }
+  if (find_array3(line, "r_ecef_m", rq.row.r_ecef_m)) {
+    if (!find_array3(line, "v_ecef_ms", rq.row.v_ecef_ms)) return fail("missing v_ecef_ms");
+    std::vector<double> q;
+    if (find_arrayD(line, "q_body_to_ecef", q)) {
+      if (q.size() != 4) return fail("q_body_to_ecef needs 4 components");
+      rq.row.has_attitude = (q[0] != 0.0 || q[1] != 0.0 || q[2] != 0.0 || q[3] != 0.0);
+      rq.row.q_body_to_ecef = Quat{q[0], q[1], q[2], q[3]}.normalized();
+    }
+    rq.ecef = true;
+    return true;
+  }
+  if (find_number(line, "alt_km", rq.alt_km) && find_number(line, "lat_deg", rq.lat_deg)
+      && find_number(line, "lon_deg", rq.lon_deg) && find_array3(line, "V_sat_mps", rq.V_sat_ms)) {
+    rq.has_wind = find_array3(line, "wind_mps", rq.wind_ms);
+    rq.ecef = false;
+    return true;
+  }
+  return fail("need r_ecef_m/v_ecef_ms or alt_km/lat_deg/lon_deg/V_sat_mps");
+}
+
+std::string format_reply_json(const ServeReply& r) {
+  char buf[512];
+  int n;
+  if (r.status != kServeOk) {
+    n = std::snprintf(buf, sizeof(buf), "{\"id\":%llu,\"error\":\"%s\"}",
+                      static_cast<unsigned long long>(r.id), r.error.empty() ? "bad request" : r.error.c_str());
+  } else {
+    n = std::snprintf(buf, sizeof(buf),
+                      "{\"id\":%llu,\"F\":[%.17g,%.17g,%.17g],\"M\":[%.17g,%.17g,%.17g],\"rho_kgm3\":%.17g,\"T_K\":%.17g,\"us\":%.3f}",
+                      static_cast<unsigned long long>(r.id), r.F.x, r.F.y, r.F.z, r.M.x, r.M.y, r.M.z,
+                      r.rho_kgm3, r.T_K, r.solve_us);
+  }
+  return std::string(buf, static_cast<std::size_t>(std::min<int>(n, sizeof(buf) - 1)));
+}
+
+ServeRequest from_binary(const ServeBinRequest& b) {
+  ServeRequest rq;
+  rq.id = b.id;
+  rq.ecef = true;
+  rq.row.epoch_s = b.epoch_s;
+  rq.row.r_ecef_m = {b.r_ecef_m[0], b.r_ecef_m[1], b.r_ecef_m[2]};
+  rq.row.v_ecef_ms = {b.v_ecef_ms[0], b.v_ecef_ms[1], b.v_ecef_ms[2]};
+  const double* q = b.q_body_to_ecef;
+  rq.row.has_attitude = (q[0] != 0.0 || q[1] != 0.0 || q[2] != 0.0 || q[3] != 0.0);
+  rq.row.q_body_to_ecef = Quat{q[0], q[1], q[2], q[3]}.normalized();
+  return rq;
+}
+
+ServeBinReply to_binary(const ServeReply& r) {
+  ServeBinReply b{};
+  b.id = r.id;
+  b.status = r.status;
+  b.F[0] = r.F.x; b.F[1] = r.F.y; b.F[2] = r.F.z;
+  b.M[0] = r.M.x; b.M[1] = r.M.y; b.M[2] = r.M.z;
+  b.rho_kgm3 = r.rho_kgm3;
+  b.T_K = r.T_K;
+  b.solve_us = r.solve_us;
+  return b;
+}
+
+Server::Server(fmx::atm::AtmosphereSession& session, const fmx::atm::SpaceWeatherTable& sw,
+               const fmx::atm::Indices& idx, const fmx::solver::Input& base)
+    : m_session(session), m_sw(sw), m_idx(idx), m_in(base) {}
+
+ServeReply Server::handle(const ServeRequest& rq) {
+  FMX_TRACE_SCOPE("serve.request", "server");
+  const auto t0 = Clock::now();
+  ServeReply r;
+  r.id = rq.id;
+  ++m_stats.requests;
+  const EphemerisRow& row = rq.row;
+  const bool ok = std::isfinite(row.epoch_s)
+      && (rq.ecef ? (finite3(row.r_ecef_m) && finite3(row.v_ecef_ms) && row.r_ecef_m.norm() > 0.0)
+                  : (std::isfinite(rq.alt_km) && std::isfinite(rq.lat_deg) && std::isfinite(rq.lon_deg) && finite3(rq.V_sat_ms)));
+  if (!ok) {
+    r.status = kServeBadRequest;
+    r.error = "non-finite or empty state";
+    ++m_stats.errors;
+    return r;
+  }
+  double alt = rq.alt_km, lat = rq.lat_deg, lon = rq.lon_deg;
+  if (rq.ecef) {
+    const Geodetic g = ecef_to_geodetic(row.r_ecef_m);
+    alt = g.alt_km; lat = g.lat_deg; lon = g.lon_deg;
+  }
+  const fmx::atm::AtmosphereState st = m_sw.valid() ? m_session.evaluate(alt, lat, lon, row.epoch_s, m_sw)
+                                                    : m_session.evaluate(alt, lat, lon, row.epoch_s, m_idx);
+  m_in.species.clear();
+  for (const auto& sp : st.species) {
+    m_in.species.push_back({sp.rho, sp.mass});
+    r.rho_kgm3 += sp.rho;
+  }
+  m_in.T_K = st.T_K;
+  if (rq.ecef) {
+    // AtmosphereState wind components are (vertical, zonal/east, meridional/north)
+    m_in.V_sat_ms = ecef_to_body(row, row.v_ecef_ms);
+    m_in.wind_ms = ecef_to_body(row, enu_to_ecef(lat, lon, {st.wind_ms.y, st.wind_ms.z, st.wind_ms.x}));
+  } else {
+    m_in.V_sat_ms = rq.V_sat_ms;
+    m_in.wind_ms = rq.has_wind ? rq.wind_ms : st.wind_ms;
+  }
+  const fmx::solver::Output o = fmx::solver::solve(m_in);
+  r.F = o.F;
+  r.M = o.M;
+  r.T_K = st.T_K;
+  r.solve_us = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+  m_stats.busy_s += r.solve_us * 1e-6;
+  return r;
+}
+
+bool Server::serve_fd(int in_fd, int out_fd, ServeFormat fmt, std::string* err) {
+  return fmt == ServeFormat::Binary ? serve_binary(in_fd, out_fd, err) : serve_json(in_fd, out_fd, err);
+}
+
+bool Server::serve_json(int in_fd, int out_fd, std::string* err) {
+  FdReader rd(in_fd);
+  const bool sock = is_socket(out_fd);
+  std::string line, out, perr;
+  ServeRequest rq;
+  bool shutdown = false;
+  while (rd.line(line)) {
+    while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+    if (line.empty()) continue;
+    ServeReply r;
+    if (!parse_request_json(line, rq, shutdown, &perr)) {
+      r.id = rq.id;
+      r.status = kServeBadRequest;
+      r.error = perr;
+      ++m_stats.requests;
+      ++m_stats.errors;
+    } else if (shutdown) {
+      m_shutdown = true;
+      break;
+    } else {
+      r = handle(rq);
+    }
+    out += format_reply_json(r);
+    out += '\n';
+    if (!rd.has_line()) {
+      if (!write_all(out_fd, sock, out.data(), out.size())) { if (err) *err = "write failed"; return false; }
+      out.clear();
+    }
+  }
+  if (!out.empty() && !write_all(out_fd, sock, out.data(), out.size())) { if (err) *err = "write failed"; return false; }
+  if (rd.error()) { if (err) *err = "read failed"; return false; }
+  return true;
+}
+
+bool Server::serve_binary(int in_fd, int out_fd, std::string* err) {
+  FdReader rd(in_fd);
+  const bool sock = is_socket(out_fd);
+  std::vector<char> out, skip;
+  for (;;) {
+    std::uint32_t len = 0;
+    if (!rd.exact(&len, sizeof(len))) break;
+    if (len == 0) { m_shutdown = true; break; }
+    ServeReply r;
+    if (len == sizeof(ServeBinRequest)) {
+      ServeBinRequest b;
+      if (!rd.exact(&b, sizeof(b))) { if (err) *err = "truncated frame"; return false; }
+      r = handle(from_binary(b));
+    } else if (len <= kMaxFrameBytes) {
+      skip.resize(len);
+      if (!rd.exact(skip.data(), len)) { if (err) *err = "truncated frame"; return false; }
+      r.status = kServeBadRequest;
+      ++m_stats.requests;
+      ++m_stats.errors;
+    } else {
+      if (err) *err = "frame too large: " + std::to_string(len);
+      return false;
+    }
+    const ServeBinReply b = to_binary(r);
+    const std::uint32_t rlen = sizeof(b);
+    const char* lp = reinterpret_cast<const char*>(&rlen);
+    const char* bp = reinterpret_cast<const char*>(&b);
+    out.insert(out.end(), lp, lp + sizeof(rlen));
+    out.insert(out.end(), bp, bp + sizeof(b));
+    if (!rd.has_frame()) {
+      if (!write_all(out_fd, sock, out.data(), out.size())) { if (err) *err = "write failed"; return false; }
+      out.clear();
+    }
+  }
+  if (!out.empty() && !write_all(out_fd, sock, out.data(), out.size())) { if (err) *err = "write failed"; return false; }
+  if (rd.error()) { if (err) *err = "read failed"; return false; }
+  return true;
+}
+
+bool Server::serve_unix(const std::string& path, ServeFormat fmt, std::string* err) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(addr.sun_path)) { if (err) *err = "invalid socket path: " + path; return false; }
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+  struct stat sb;
+  if (::stat(path.c_str(), &sb) == 0) {
+    if (!S_ISSOCK(sb.st_mode)) { if (err) *err = "not a socket, refusing to replace: " + path; return false; }
+    ::unlink(path.c_str());
+  }
+  const int lfd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (lfd < 0) { if (err) *err = std::string("socket: ") + std::strerror(errno); return false; }
+  if (::bind(lfd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(lfd, 8) != 0) {
+    if (err) *err = "bind/listen " + path + ": " + std::strerror(errno);
+    ::close(lfd);
+    return false;
+  }
+  bool ok = true;
+  m_shutdown = false;
+  while (!m_shutdown) {
+    const int cfd = ::accept(lfd, nullptr, nullptr);
+    if (cfd < 0) {
+      if (errno == EINTR) continue;
+      if (err) *err = std::string("accept: ") + std::strerror(errno);
+      ok = false;
+      break;
+    }
+    // A broken connection ends that client only
+    serve_fd(cfd, cfd, fmt, nullptr);
+    ::close(cfd);
+  }
+  ::close(lfd);
+  ::unlink(path.c_str());
+  return ok;
+}
+
+} // namespace fmx::cli
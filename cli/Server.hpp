@@ -0,0 +1,81 @@
+// Solver server: prepared scene, atmosphere session and GSI caches stay resident across requests
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "cli/ServeProtocol.hpp"
+#include "cli/Trajectory.hpp"
+
+namespace fmx::cli {
+
+enum class ServeFormat { Json, Binary };
+
+// Decoded request: an ECEF state (as in trajectory rows), or a geodetic point with a
+// body-frame velocity as in the single-state config.
+struct ServeRequest {
+  std::uint64_t id{0};
+  bool ecef{true};
+  EphemerisRow row;                 // ecef: epoch, position, velocity, optional attitude
+  double alt_km{0.0}, lat_deg{0.0}, lon_deg{0.0};
+  Vec3 V_sat_ms;                    // geodetic form: body-frame velocity
+  bool has_wind{false};
+  Vec3 wind_ms;                     // geodetic form: body-frame wind (default: model wind as-is)
+};
+
+struct ServeReply {
+  std::uint64_t id{0};
+  ServeStatus status{kServeOk};
+  std::string error;
+  Vec3 F, M;
+  double rho_kgm3{0.0}, T_K{0.0};
+  double solve_us{0.0};
+};
+
+struct ServeStats {
+  std::size_t requests{0};
+  std::size_t errors{0};
+  double busy_s{0.0};               // sum of per-request solve time
+};
+
+// JSON request line -> request. False with `err` set for malformed lines; `shutdown` is set
+// (and true returned) for {"cmd":"shutdown"}.
+bool parse_request_json(const std::string& line, ServeRequest& rq, bool& shutdown, std::string* err = nullptr);
+std::string format_reply_json(const ServeReply& r);
+ServeRequest from_binary(const ServeBinRequest& b);
+ServeBinReply to_binary(const ServeReply& r);
+
+class Server {
+public:
+  // `base` is the prepared solver input (facets, occluder, materials, GSI setup); the
+  // referenced session, tables and occluder must outlive the server. Indices come from `sw`
+  // when it is valid, else `idx` is used for every request.
+  Server(fmx::atm::AtmosphereSession& session, const fmx::atm::SpaceWeatherTable& sw,
+         const fmx::atm::Indices& idx, const fmx::solver::Input& base);
+
+  // Atmosphere at the request point, then the panel solve
+  ServeReply handle(const ServeRequest& rq);
+
+  // Serves requests read from `in_fd` with replies on `out_fd` until end of input or a
+  // shutdown request. False on I/O errors or an unrecoverable framing error.
+  bool serve_fd(int in_fd, int out_fd, ServeFormat fmt, std::string* err = nullptr);
+
+  // Listens on a Unix domain socket and serves one connection at a time until a shutdown
+  // request. An existing socket file at `path` is replaced; it is removed on return.
+  bool serve_unix(const std::string& path, ServeFormat fmt, std::string* err = nullptr);
+
+  const ServeStats& stats() const { return m_stats; }
+
+private:
+  bool serve_json(int in_fd, int out_fd, std::string* err);
+  bool serve_binary(int in_fd, int out_fd, std::string* err);
+
+  fmx::atm::AtmosphereSession& m_session;
+  const fmx::atm::SpaceWeatherTable& m_sw;
+  fmx::atm::Indices m_idx;
+  fmx::solver::Input m_in;          // reused per request: only species, T and velocities change
+  ServeStats m_stats;
+  bool m_shutdown{false};
+};
+
+} // namespace fmx::cli
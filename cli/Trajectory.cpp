@@ -0,0 +1,224 @@
+#include "cli/Trajectory.hpp"
+#include "atm/Epoch.hpp"
+#include "core/BoundedQueue.hpp"
+#include "core/Trace.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace fmx::cli {
+
+namespace {
+
+constexpr char kMagic[8] = {'F','M','X','T','R','J','1','\0'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kFields = 12;
+
+struct TrajHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t n_fields;
+  std::uint32_t reserved[12];
+};
+static_assert(sizeof(TrajHeader) == 64, "trajectory header must be 64 bytes");
+
+// Pipeline item: parsed rows with their geodetic points and, after stage 2, the atmosphere
+struct Block {
+  std::vector<EphemerisRow> rows;
+  std::vector<double> alt, lat, lon, ep;
+  fmx::atm::StateBatch atm;
+};
+
+using Clock = std::chrono::steady_clock;
+double seconds_since(Clock::time_point t) { return std::chrono::duration<double>(Clock::now() - t).count(); }
+
+// Full-token numeric parse
+bool to_double(const char* b, const char* e, double& v) {
+  while (b < e && (*b == ' ' || *b == '\t')) ++b;
+  while (e > b && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\r')) --e;
+  if (b == e) return false;
+  char buf[64];
+  const std::size_t n = static_cast<std::size_t>(e - b);
+  if (n >= sizeof(buf)) return false;
+  std::memcpy(buf, b, n); buf[n] = '\0';
+  char* end = nullptr;
+  v = std::strtod(buf, &end);
+  return end == buf + n;
+}
+
+} // namespace
+
+bool parse_ephemeris_row(const std::string& line, EphemerisRow& row) {
+  const char* tok[12];
+  const char* end[12];
+  int n = 0;
+  const char* p = line.data();
+  const char* const stop = p + line.size();
+  while (p < stop && (*p == ' ' || *p == '\t')) ++p;
+  if (p == stop || *p == '#') return false;
+  for (const char* b = p; n < 12; ) {
+    const char* c = static_cast<const char*>(std::memchr(b, ',', static_cast<std::size_t>(stop - b)));
+    tok[n] = b; end[n] = c ? c : stop; ++n;
+    if (!c) break;
+    b = c + 1;
+  }
+  if (n != 7 && n != 11) return false;
+  // Epoch: ISO-8601 if it looks like a date, else seconds
+  const std::string ep(tok[0], end[0]);
+  if (ep.find('T') != std::string::npos) {
+    if (!fmx::atm::parse_iso_utc(ep, row.epoch_s)) return false;
+  } else if (!to_double(tok[0], end[0], row.epoch_s)) {
+    return false;
+  }
+  double v[10];
+  for (int k = 1; k < n; ++k) if (!to_double(tok[k], end[k], v[k - 1])) return false;
+  row.r_ecef_m = {v[0], v[1], v[2]};
+  row.v_ecef_ms = {v[3], v[4], v[5]};
+  row.has_attitude = (n == 11);
+  row.q_body_to_ecef = row.has_attitude ? Quat{v[6], v[7], v[8], v[9]}.normalized() : Quat{};
+  return true;
+}
+
+Vec3 ecef_to_body(const EphemerisRow& row, const Vec3& v_ecef) {
+  if (row.has_attitude) return row.q_body_to_ecef.conj().rotate(v_ecef);
+  // Ram-pointing frame: x along velocity, z toward nadir (orthogonalized), y completes it
+  const double vn = row.v_ecef_ms.norm();
+  const Vec3 x = vn > 0.0 ? row.v_ecef_ms / vn : Vec3{1, 0, 0};
+  const Vec3 rhat = row.r_ecef_m.normalized();
+  Vec3 z = -(rhat - Vec3::dot(rhat, x) * x);
+  z = (z.norm() > 1e-12) ? z.normalized() : (std::abs(x.z) < 0.9 ? Vec3::cross(x, {0, 0, 1}) : Vec3::cross(x, {1, 0, 0})).normalized();
+  const Vec3 y = Vec3::cross(z, x);
+  return {Vec3::dot(v_ecef, x), Vec3::dot(v_ecef, y), Vec3::dot(v_ecef, z)};
+}
+
+bool run_trajectory(const TrajectoryOptions& opt, const fmx::atm::AtmosphereSession& session,
+                    const fmx::atm::SpaceWeatherTable& sw, const fmx::atm::Indices& idx,
+                    const fmx::solver::Input& base, TrajectoryStats* stats, std::string* err) {
+  std::ifstream in(opt.ephemeris_path);
+  if (!in) { if (err) *err = "Failed to open ephemeris: " + opt.ephemeris_path; return false; }
+  std::ofstream out(opt.out_path, opt.binary ? std::ios::binary : std::ios::out);
+  if (!out) { if (err) *err = "Failed to open output: " + opt.out_path; return false; }
+  if (opt.binary) {
+    TrajHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.n_fields = kFields;
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+  } else {
+    out << "epoch_s,Fx,Fy,Fz,Mx,My,Mz,alt_km,lat_deg,lon_deg,rho_kgm3,T_K\n";
+  }
+
+  TrajectoryStats st;
+  const auto t_start = Clock::now();
+  const std::size_t block_rows = opt.block_rows > 0 ? opt.block_rows : 1;
+  fmx::BoundedQueue<Block> q_atm(opt.queue_blocks), q_solve(opt.queue_blocks);
+
+  // Stage 1: read and parse rows, geodetic coordinates per row
+  std::thread parser([&]{
+    fmx::trace::set_thread_name("traj.parse");
+    FMX_TRACE_SCOPE("traj.parse", "trajectory");
+    Block b;
+    std::string line;
+    for (;;) {
+      auto t = Clock::now();
+      bool have = static_cast<bool>(std::getline(in, line));
+      EphemerisRow r;
+      if (have && parse_ephemeris_row(line, r)) {
+        const Geodetic g = ecef_to_geodetic(r.r_ecef_m);
+        b.rows.push_back(r);
+        b.alt.push_back(g.alt_km); b.lat.push_back(g.lat_deg); b.lon.push_back(g.lon_deg); b.ep.push_back(r.epoch_s);
+      } else if (have) {
+        ++st.skipped;
+      }
+      st.parse_s += seconds_since(t);
+      if (b.rows.size() == block_rows || (!have && !b.rows.empty())) {
+        FMX_TRACE_SCOPE("traj.queue_push", "trajectory");
+        if (!q_atm.push(std::move(b))) break;
+        b = Block{};
+      }
+      if (!have) break;
+    }
+    q_atm.close();
+  });
+
+  // Stage 2: one atmosphere batch per block
+  std::thread atmosphere([&]{
+    fmx::trace::set_thread_name("traj.atmosphere");
+    while (auto b = q_atm.pop()) {
+      FMX_TRACE_SCOPE("traj.atm_block", "trajectory", static_cast<std::int64_t>(b->rows.size()));
+      auto t = Clock::now();
+      const fmx::atm::PointBatch pts{b->rows.size(), b->alt.data(), b->lat.data(), b->lon.data(), b->ep.data()};
+      if (sw.valid()) session.evaluate_batch(pts, sw, b->atm);
+      else session.evaluate_batch(pts, idx, b->atm);
+      st.atm_s += seconds_since(t);
+      if (!q_solve.push(std::move(*b))) break;
+    }
+    q_solve.close();
+  });
+
+  // Stage 3 (this thread): panel solve per row and streamed output
+  fmx::solver::Input row_in = base.view();
+  std::vector<double> rec;
+  std::string text;
+  bool ok = true;
+  while (auto b = q_solve.pop()) {
+    FMX_TRACE_SCOPE("traj.solve_block", "trajectory", static_cast<std::int64_t>(b->rows.size()));
+    auto t = Clock::now();
+    const auto& a = b->atm;
+    rec.assign(b->rows.size() * kFields, 0.0);
+    for (std::size_t i = 0; i < b->rows.size(); ++i) {
+      const EphemerisRow& r = b->rows[i];
+      row_in.species.clear();
+      double rho = 0.0;
+      for (std::size_t s = 0; s < a.species_count(); ++s) {
+        row_in.species.push_back({a.rho_of(s)[i], a.species_mass[s]});
+        rho += a.rho_of(s)[i];
+      }
+      row_in.T_K = a.T_K[i];
+      // AtmosphereState wind components are (vertical, zonal/east, meridional/north)
+      const Vec3 wind = enu_to_ecef(b->lat[i], b->lon[i], {a.wind_y[i], a.wind_z[i], a.wind_x[i]});
+      row_in.V_sat_ms = ecef_to_body(r, r.v_ecef_ms);
+      row_in.wind_ms = ecef_to_body(r, wind);
+      const fmx::solver::Output o = fmx::solver::solve(row_in);
+      double* f = rec.data() + i * kFields;
+      f[0] = r.epoch_s;
+      f[1] = o.F.x; f[2] = o.F.y; f[3] = o.F.z;
+      f[4] = o.M.x; f[5] = o.M.y; f[6] = o.M.z;
+      f[7] = b->alt[i]; f[8] = b->lat[i]; f[9] = b->lon[i];
+      f[10] = rho; f[11] = a.T_K[i];
+    }
+    if (opt.binary) {
+      out.write(reinterpret_cast<const char*>(rec.data()), static_cast<std::streamsize>(rec.size() * sizeof(double)));
+    } else {
+      text.clear();
+      char buf[32];
+      for (std::size_t i = 0; i < rec.size(); ++i) {
+        const int len = std::snprintf(buf, sizeof(buf), (i % kFields == 0) ? "%.3f" : "%.9g", rec[i]);
+        text.append(buf, static_cast<std::size_t>(len));
+        text.push_back((i % kFields == kFields - 1) ? '\n' : ',');
+      }
+      out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+    st.rows += b->rows.size();
+    st.solve_s += seconds_since(t);
+    if (!out) {
+      if (err) *err = "Write failed: " + opt.out_path;
+      ok = false;
+      q_atm.close(); q_solve.close();
+      break;
+    }
+  }
+  parser.join();
+  atmosphere.join();
+  out.flush();
+  st.wall_s = seconds_since(t_start);
+  if (stats) *stats = st;
+  return ok && static_cast<bool>(out);
+}
+
+} // namespace fmx::cli
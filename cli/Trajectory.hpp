@@ -0,0 +1,58 @@
+// Trajectory mode: ephemeris rows -> atmosphere -> panel solve, pipelined over threads
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "atm/AtmosphereSession.hpp"
+#include "atm/SpaceWeather.hpp"
+#include "core/Frames.hpp"
+#include "solver/PanelSolver.hpp"
+
+namespace fmx::cli {
+
+// One ephemeris row. Position/velocity are Earth-fixed (ECEF), so the velocity is already
+// relative to the co-rotating atmosphere. q_body_to_ecef rotates body (mesh) vectors into
+// ECEF; rows without attitude use a ram-pointing frame (+x along v, +z toward nadir).
+struct EphemerisRow {
+  double epoch_s{0.0};
+  Vec3 r_ecef_m;
+  Vec3 v_ecef_ms;
+  Quat q_body_to_ecef;
+  bool has_attitude{false};
+};
+
+// CSV row: epoch (ISO-8601 UTC or seconds since 1970), x, y, z [m], vx, vy, vz [m/s],
+// optionally qw, qx, qy, qz. False for headers, comments and malformed rows.
+bool parse_ephemeris_row(const std::string& line, EphemerisRow& row);
+
+// Body-frame components of an ECEF vector for a row (attitude or ram-pointing default)
+Vec3 ecef_to_body(const EphemerisRow& row, const Vec3& v_ecef);
+
+// Output time series: CSV text or fixed-size binary records (native byte order):
+//   header (64 bytes): char magic[8] = "FMXTRJ1", u32 version, u32 n_fields, u32 reserved[12]
+//   per row: double epoch_s, F[3], M[3] (body frame), alt_km, lat_deg, lon_deg, rho, T_K
+struct TrajectoryOptions {
+  std::string ephemeris_path;
+  std::string out_path;
+  bool binary{false};
+  std::size_t block_rows{256};  // rows per pipeline item (one atmosphere batch)
+  std::size_t queue_blocks{4};  // capacity of each inter-stage queue
+};
+
+struct TrajectoryStats {
+  std::size_t rows{0};
+  std::size_t skipped{0};       // lines that were not ephemeris rows
+  double wall_s{0.0};
+  double parse_s{0.0}, atm_s{0.0}, solve_s{0.0}; // busy time per stage
+};
+
+// Runs parse, atmosphere and solve stages on separate threads connected by bounded queues.
+// `base` carries the prepared mesh, occluder, materials and GSI setup; per row only the
+// species, temperature and body-frame velocity/wind are replaced. Indices come from `sw`
+// when it is valid, else `idx` is used for every row.
+bool run_trajectory(const TrajectoryOptions& opt, const fmx::atm::AtmosphereSession& session,
+                    const fmx::atm::SpaceWeatherTable& sw, const fmx::atm::Indices& idx,
+                    const fmx::solver::Input& base, TrajectoryStats* stats = nullptr,
+                    std::string* err = nullptr);
+
+} // namespace fmx::cli
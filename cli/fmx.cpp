@@ -7,6 +7,8 @@
 #include <algorithm>
 #include <random>
 #include <chrono>
+#include <cmath>
+#include "core/Trace.hpp"
 #include "core/types.hpp"
 #include "gsi/Sentman.hpp"
 #include "geom/Mesh.hpp"
@@ -17,12 +19,26 @@
 #include "atm/NRLMSIS2.hpp"
 #include "atm/HWM14.hpp"
 #include "atm/Combined.hpp"
+#include "atm/AtmosphereSession.hpp"
+#include "atm/SpaceWeather.hpp"
+#include "atm/Epoch.hpp"
 #include "gsi/KernelSet.hpp"
+#include "gsi/SurrogateKernel.hpp"
 #include "gsi/CLLRuntime.hpp"
 #include "solver/RegimeAdapter.hpp"
+#include "solver/TestParticle.hpp"
+#include "cli/JsonScan.hpp"
+#include "cli/Trajectory.hpp"
+#include "cli/Server.hpp"
+#include "cli/Batch.hpp"
 
 namespace {
 using fmx::Vec3;
+using fmx::cli::find_string;
+using fmx::cli::find_number;
+using fmx::cli::find_int;
+using fmx::cli::find_arrayD;
+using fmx::cli::find_array3;
 
 struct CliConfig {
   std::string geometry;
@@ -40,19 +56,27 @@ struct CliConfig {
   double F10_7A{120.0};
   int Kp{3};
   std::string atm_model{"Stub"};
+  std::string msis_parm_dir; // empty: atm/models/... if present, else CWD
+  std::string hwm_data_dir;
+  std::string atm_grid_path; // model "Grid": precomputed grid (gen_atm_grid)
+  std::string space_weather_path; // index time series (CelesTrak CSV); overrides the static indices
+  int atm_model_workers{1}; // worker processes for Fortran model batches (0: one per core)
   bool has_ap7{false};
   double Ap7[7] = {0,0,0,0,0,0,0};
   double Ap_daily{0.0};
   double Ap_now{0.0};
   std::string gsi_model{"Sentman"};
   std::string gsi_table_path;
+  std::string gsi_surrogate_path; // MLP weights (fit_gsi_surrogate)
+  std::string gsi_point_interp{"nearest"}; // point-list tables: nearest|idw
+  int gsi_point_k{8};
   // CLL runtime
   double rt_theta_deg_step{2.0};
   double rt_tau_step{0.1};
   double rt_alpha_step{0.25};
   std::vector<double> rt_Ma_anchors{0.5,1.0,2.0,4.0,8.0,12.0,16.0};
   int rt_sample_count{4000};
-  int rt_workers{1};
+  int rt_workers{0}; // 0: misses computed on the solver's threads
   // Regime adapter
   bool regime_enabled{false};
   double regime_L_char_m{0.0}; // 0 -> auto bbox
@@ -60,6 +84,9 @@ struct CliConfig {
   std::string regime_corr_mode{"none"};
   double regime_corr_a{0.0};
   double regime_corr_b{1.0};
+  // Solver
+  std::string reduction{"fast"}; // fast|deterministic|compensated
+  int occlusion_level{0};        // sub-facet occlusion sampling depth (0: centroid ray)
   // UQ
   int uq_samples{0};
   double uq_sigma_rho{0.3}; // log-normal sigma for densities
@@ -79,51 +106,6 @@ static std::vector<double> parse_list(const std::string& s) {
   } return v;
 }
 
-static bool find_string(const std::string& s, const std::string& key, std::string& out) {
-  auto pos = s.find("\"" + key + "\""); if (pos == std::string::npos) return false;
-  pos = s.find(':', pos); if (pos == std::string::npos) return false;
-  pos = s.find('"', pos); if (pos == std::string::npos) return false;
-  auto end = s.find('"', pos+1); if (end == std::string::npos) return false;
-  out = s.substr(pos+1, end-pos-1); return true;
-}
-
-static bool find_number(const std::string& s, const std::string& key, double& out) {
-  auto pos = s.find("\"" + key + "\""); if (pos == std::string::npos) return false;
-  pos = s.find(':', pos); if (pos == std::string::npos) return false;
-  auto end = s.find_first_of(",}\n\r", pos+1);
-  std::string t = s.substr(pos+1, end-pos-1);
-  try { out = std::stod(t); return true; } catch (...) { return false; }
-}
-
-static bool find_int(const std::string& s, const std::string& key, int& out) {
-  double d; if (!find_number(s, key, d)) return false; out = static_cast<int>(d); return true;
-}
-
-static bool find_arrayD(const std::string& s, const std::string& key, std::vector<double>& out) {
-  auto pos = s.find("\"" + key + "\""); if (pos == std::string::npos) return false;
-  pos = s.find('[', pos); if (pos == std::string::npos) return false;
-  auto end = s.find(']', pos); if (end == std::string::npos) return false;
-  std::string arr = s.substr(pos+1, end-pos-1);
-  out.clear();
-  std::istringstream ss(arr);
-  std::string tok;
-  while (std::getline(ss, tok, ',')) {
-    try { out.push_back(std::stod(tok)); } catch (...) {}
-  }
-  return !out.empty();
-}
-
-static bool find_array3(const std::string& s, const std::string& key, Vec3& out) {
-  auto pos = s.find("\"" + key + "\""); if (pos == std::string::npos) return false;
-  pos = s.find('[', pos); if (pos == std::string::npos) return false;
-  auto end = s.find(']', pos); if (end == std::string::npos) return false;
-  std::string arr = s.substr(pos+1, end-pos-1);
-  std::replace(arr.begin(), arr.end(), ',', ' ');
-  std::istringstream ss(arr);
-  if (!(ss >> out.x >> out.y >> out.z)) return false;
-  return true;
-}
-
 static CliConfig parse_config(const std::string& json) {
   CliConfig c;
   // Simple top-level keys
@@ -146,6 +128,11 @@ static CliConfig parse_config(const std::string& json) {
   if (apos != std::string::npos) {
     std::string sub = json.substr(apos, std::min<size_t>(json.size()-apos, 2000));
     std::string model; if (find_string(sub, "model", model)) c.atm_model = model;
+    std::string mdir; if (find_string(sub, "msis_parm_dir", mdir)) c.msis_parm_dir = mdir;
+    std::string hdir; if (find_string(sub, "hwm_data_dir", hdir)) c.hwm_data_dir = hdir;
+    std::string gpath; if (find_string(sub, "grid_path", gpath)) c.atm_grid_path = gpath;
+    std::string swpath; if (find_string(sub, "space_weather", swpath)) c.space_weather_path = swpath;
+    int mw; if (find_int(sub, "model_workers", mw)) c.atm_model_workers = mw;
     double F10; if (find_number(sub, "F10_7", F10)) c.F10_7 = F10;
     double F10A; if (find_number(sub, "F10_7A", F10A)) c.F10_7A = F10A;
     double apd; if (find_number(sub, "Ap_daily", apd)) c.Ap_daily = apd;
@@ -173,6 +160,9 @@ static CliConfig parse_config(const std::string& json) {
     std::string sub = json.substr(gpos, std::min<size_t>(json.size()-gpos, 1000));
     std::string model; if (find_string(sub, "model", model)) c.gsi_model = model;
     std::string table; if (find_string(sub, "table_path", table)) c.gsi_table_path = table;
+    std::string sur; if (find_string(sub, "surrogate_path", sur)) c.gsi_surrogate_path = sur;
+    std::string pim; if (find_string(sub, "point_interp", pim)) c.gsi_point_interp = pim;
+    int pk; if (find_int(sub, "point_k", pk)) c.gsi_point_k = pk;
     // runtime block
     auto rpos = sub.find("\"runtime\"");
     if (rpos != std::string::npos) {
@@ -198,6 +188,13 @@ static CliConfig parse_config(const std::string& json) {
     if (find_number(sub, "corr_a", v)) c.regime_corr_a = v;
     if (find_number(sub, "corr_b", v)) c.regime_corr_b = v;
   }
+  // Solver
+  auto svpos = json.find("\"solver\"");
+  if (svpos != std::string::npos) {
+    std::string sub = json.substr(svpos, std::min<size_t>(json.size()-svpos, 500));
+    std::string red; if (find_string(sub, "reduction", red)) c.reduction = red;
+    int lv; if (find_int(sub, "occlusion_level", lv)) c.occlusion_level = lv;
+  }
   // UQ
   auto upos = json.find("\"uq\"");
   if (upos != std::string::npos) {
@@ -254,14 +251,41 @@ static void write_json_result(const std::string& path, const fmx::solver::Output
 }
 } // namespace
 
+// Records trace spans for --trace and writes them as Chrome trace JSON when main returns
+// (declared before the solver objects, so their worker threads have stopped by then)
+struct TraceOutput {
+  std::string path;
+  explicit TraceOutput(std::string p) : path(std::move(p)) {
+    if (path.empty()) return;
+    fmx::trace::Recorder::instance().start();
+    fmx::trace::set_thread_name("main");
+  }
+  ~TraceOutput() {
+    if (path.empty()) return;
+    auto& rec = fmx::trace::Recorder::instance();
+    rec.stop();
+    std::string err;
+    if (rec.write(path, &err)) std::cerr << "trace: " << rec.event_count() << " spans -> " << path << "\n";
+    else std::cerr << err << "\n";
+    if (rec.dropped()) std::cerr << "trace: " << rec.dropped() << " spans dropped (per-thread buffers full)\n";
+  }
+};
+
 int main(int argc, char** argv) {
-  std::cout << "fmx CLI\n";
   std::string config_path;
   std::string validate_case;
   std::string mesh_override;
   std::string out_path;
+  std::string trajectory_path;
+  std::size_t traj_block = 256;
+  std::string serve_target;
+  std::string serve_format = "json";
+  std::string batch_path;
+  unsigned threads = 0;
   double theta_deg = 0.0;
   int bench_iters = 0;
+  std::uint64_t tpmc_particles = 0;
+  std::string trace_path;
   for (int i=1;i<argc;++i) {
     std::string a = argv[i];
     if (a == "--config" && i+1<argc) config_path = argv[++i];
@@ -270,8 +294,32 @@ int main(int argc, char** argv) {
     else if (a == "--out" && i+1<argc) out_path = argv[++i];
     else if (a == "--theta_deg" && i+1<argc) theta_deg = std::stod(argv[++i]);
     else if (a == "--bench" && i+1<argc) bench_iters = std::stoi(argv[++i]);
-    else if (a == "--help") { std::cout << "Usage: fmx_cli [--config file.json] [--validate plate|two-plates|cube|torque-plate] [--mesh path] [--theta_deg deg] [--bench iters] [--out result.json]\n"; return 0; }
+    else if (a == "--tpmc" && i+1<argc) tpmc_particles = std::stoull(argv[++i]);
+    else if (a == "--trajectory" && i+1<argc) trajectory_path = argv[++i];
+    else if (a == "--traj_block" && i+1<argc) traj_block = static_cast<std::size_t>(std::stoul(argv[++i]));
+    else if (a == "--serve" && i+1<argc) serve_target = argv[++i];
+    else if (a == "--serve_format" && i+1<argc) serve_format = argv[++i];
+    else if (a == "--batch" && i+1<argc) batch_path = argv[++i];
+    else if (a == "--threads" && i+1<argc) threads = static_cast<unsigned>(std::stoul(argv[++i]));
+    else if (a == "--trace" && i+1<argc) trace_path = argv[++i];
+    else if (a == "--help") {
+      std::cout << "Usage: fmx_cli [--config file.json] [--validate plate|two-plates|cube|torque-plate] [--mesh path] [--theta_deg deg] [--bench iters] [--out result.json]\n"
+                   "  --tpmc N: also run a test-particle Monte Carlo solve with N particles (multiple reflections)\n"
+                   "  --threads N (any mode): worker threads shared by the facet loop, UQ samples and batch cases (0: all cores)\n"
+                   "       fmx_cli --trajectory ephem.csv [--out series.csv|series.bin] [--traj_block 256] [--config ...] [--mesh ...]\n"
+                   "  ephem.csv rows: epoch (ISO or s), x,y,z [m], vx,vy,vz [m/s] (ECEF)[, qw,qx,qy,qz body->ECEF]\n"
+                   "       fmx_cli --serve -|socket_path [--serve_format json|binary] [--config ...] [--mesh ...]\n"
+                   "  '-' serves stdin/stdout; request/reply formats: cli/ServeProtocol.hpp\n"
+                   "       fmx_cli --batch cases.jsonl [--out results.csv|results.bin] [--threads N] [--config ...] [--mesh ...]\n"
+                   "  one JSON case per line; keys and output columns: cli/Batch.hpp\n"
+                   "  --trace trace.json (any mode): write stage spans per thread as Chrome trace-event JSON\n";
+      return 0;
+    }
   }
+  if (serve_format != "json" && serve_format != "binary") { std::cerr << "Unknown --serve_format: " << serve_format << "\n"; return 1; }
+  const TraceOutput trace(trace_path);
+  // stdout carries the replies when serving stdin
+  if (serve_target != "-") std::cout << "fmx CLI\n";
 
   CliConfig cfg;
   if (!config_path.empty()) {
@@ -279,6 +327,26 @@ int main(int argc, char** argv) {
     catch (...) { std::cerr << "Failed to parse config; using defaults\n"; }
   }
 
+  // The atmosphere session opens before any thread starts (Executor, OpenMP in the mesh and
+  // BVH stages): it forks the model worker processes (atm/ModelPool.hpp)
+  fmx::atm::SessionConfig scfg;
+  scfg.model = cfg.atm_model;
+  scfg.msis_parm_dir = cfg.msis_parm_dir;
+  scfg.hwm_data_dir = cfg.hwm_data_dir;
+  scfg.grid_path = cfg.atm_grid_path;
+  if (scfg.model != "Stub" && scfg.model != "NRLMSIS2" && scfg.model != "NRLMSIS2+HWM14" && scfg.model != "Grid") {
+    std::cerr << "Atmosphere model '" << cfg.atm_model << "' not linked; using Stub.\n";
+    scfg.model = "Stub";
+  }
+  scfg.model_workers = cfg.atm_model_workers;
+  std::string atm_err;
+  auto atm_session = fmx::atm::AtmosphereSession::open(scfg, &atm_err);
+  if (!atm_session) { std::cerr << "Atmosphere initialization failed: " << atm_err << "\n"; return 1; }
+
+  // One pool for every parallel stage; nested stages (a solve inside a batch case or UQ
+  // sample) run inline on the thread that reached them
+  fmx::solver::Executor exec(threads);
+
   // Construct mesh
   fmx::geom::Mesh mesh;
   if (!validate_case.empty()) {
@@ -299,36 +367,34 @@ int main(int argc, char** argv) {
     mesh = make_plate();
   }
 
-  auto facets = mesh.to_facets(0);
+  std::vector<fmx::Facet> facets;
+  {
+    FMX_TRACE_SCOPE("to_facets", "geometry", static_cast<std::int64_t>(mesh.tris.size()));
+    facets = mesh.to_facets(0);
+  }
   fmx::geom::BVHOccluder occ(mesh.tris);
 
   // Atmosphere
+  fmx::atm::Indices idx; idx.F10_7 = cfg.F10_7; idx.F10_7A = cfg.F10_7A; idx.Kp = cfg.Kp;
+  if (cfg.has_ap7) { idx.has_ap_array = true; for (int i=0;i<7;i++) idx.Ap[i] = cfg.Ap7[i]; }
+  idx.Ap_daily = cfg.Ap_daily; idx.Ap_now = cfg.Ap_now;
+  fmx::atm::SpaceWeatherTable sw;
+  if (!cfg.space_weather_path.empty() && !sw.load(cfg.space_weather_path, &atm_err)) {
+    std::cerr << "Failed to load space-weather indices: " << atm_err << "\n"; return 1;
+  }
   fmx::atm::AtmosphereState st{};
-  if (cfg.atm_model == "Stub") {
-    fmx::atm::StubAtmosphere atm;
-    fmx::atm::Indices idx; idx.F10_7 = cfg.F10_7; idx.F10_7A = cfg.F10_7A; idx.Kp = cfg.Kp;
-    if (cfg.has_ap7) { idx.has_ap_array = true; for (int i=0;i<7;i++) idx.Ap[i] = cfg.Ap7[i]; }
-    idx.Ap_daily = cfg.Ap_daily; idx.Ap_now = cfg.Ap_now;
-    st = atm.evaluate(cfg.alt_km, cfg.lat_deg, cfg.lon_deg, cfg.utc, idx);
-  } else if (cfg.atm_model == "NRLMSIS2") {
-    fmx::atm::NRLMSIS2Atmosphere atm;
-    fmx::atm::Indices idx; idx.F10_7 = cfg.F10_7; idx.F10_7A = cfg.F10_7A; idx.Kp = cfg.Kp;
-    if (cfg.has_ap7) { idx.has_ap_array = true; for (int i=0;i<7;i++) idx.Ap[i] = cfg.Ap7[i]; }
-    idx.Ap_daily = cfg.Ap_daily; idx.Ap_now = cfg.Ap_now;
-    st = atm.evaluate(cfg.alt_km, cfg.lat_deg, cfg.lon_deg, cfg.utc, idx);
-  } else if (cfg.atm_model == "NRLMSIS2+HWM14") {
-    fmx::atm::CombinedAtmosphere atm;
-    fmx::atm::Indices idx; idx.F10_7 = cfg.F10_7; idx.F10_7A = cfg.F10_7A; idx.Kp = cfg.Kp;
-    if (cfg.has_ap7) { idx.has_ap_array = true; for (int i=0;i<7;i++) idx.Ap[i] = cfg.Ap7[i]; }
-    idx.Ap_daily = cfg.Ap_daily; idx.Ap_now = cfg.Ap_now;
-    st = atm.evaluate(cfg.alt_km, cfg.lat_deg, cfg.lon_deg, cfg.utc, idx);
+  double epoch_s = 0.0;
+  if (!trajectory_path.empty() || !serve_target.empty() || !batch_path.empty()) {
+    // Per-row/per-request/per-case states are evaluated by the trajectory pipeline, the server or the batch runner
+  } else if (fmx::atm::parse_iso_utc(cfg.utc, epoch_s)) {
+    if (sw.valid()) {
+      if (!sw.covers(epoch_s)) std::cerr << "state.utc outside the space-weather table; using its nearest day.\n";
+      idx = sw.indices(epoch_s);
+    }
+    st = atm_session->evaluate(cfg.alt_km, cfg.lat_deg, cfg.lon_deg, epoch_s, idx);
   } else {
-    std::cerr << "Atmosphere model '" << cfg.atm_model << "' not linked; using Stub.\n";
-    fmx::atm::StubAtmosphere atm;
-    fmx::atm::Indices idx; idx.F10_7 = cfg.F10_7; idx.F10_7A = cfg.F10_7A; idx.Kp = cfg.Kp;
-    if (cfg.has_ap7) { idx.has_ap_array = true; for (int i=0;i<7;i++) idx.Ap[i] = cfg.Ap7[i]; }
-    idx.Ap_daily = cfg.Ap_daily; idx.Ap_now = cfg.Ap_now;
-    st = atm.evaluate(cfg.alt_km, cfg.lat_deg, cfg.lon_deg, cfg.utc, idx);
+    std::cerr << "Could not parse state.utc '" << cfg.utc << "'; models use their default epoch.\n";
+    st = atm_session->model().evaluate(cfg.alt_km, cfg.lat_deg, cfg.lon_deg, cfg.utc, idx);
   }
 
   fmx::solver::Input in;
@@ -346,9 +412,21 @@ int main(int argc, char** argv) {
     in.r_CG = cfg.cg;
   }
   in.occluder = &occ;
+  in.executor = &exec;
+  if (cfg.reduction == "deterministic") in.reduction = fmx::solver::Reduction::Deterministic;
+  else if (cfg.reduction == "compensated") in.reduction = fmx::solver::Reduction::Compensated;
+  else if (cfg.reduction != "fast") std::cerr << "Unknown solver.reduction '" << cfg.reduction << "'; using fast.\n";
+  if (cfg.occlusion_level < 0 || cfg.occlusion_level > fmx::solver::kMaxOcclusionLevel) {
+    std::cerr << "solver.occlusion_level must be 0.." << fmx::solver::kMaxOcclusionLevel << "; using centroid rays.\n";
+  } else if (cfg.occlusion_level > 0 && theta_deg != 0.0 && batch_path.empty()) {
+    std::cerr << "solver.occlusion_level ignored with --theta_deg; using centroid rays.\n";
+  } else {
+    in.occlusion_level = cfg.occlusion_level;
+    in.facet_tris = &mesh.tris;
+  }
 
-  // Optional mesh rotation about Z
-  if (theta_deg != 0.0) {
+  // Optional mesh rotation about Z (batch cases rotate per case, with --theta_deg as the default)
+  if (theta_deg != 0.0 && batch_path.empty()) {
     double th = theta_deg * M_PI/180.0, c=std::cos(th), s=std::sin(th);
     for (auto& f : in.facets) {
       auto rotv = [&](fmx::Vec3 v){ return fmx::Vec3{ v.x*c - v.y*s, v.x*s + v.y*c, v.z }; };
@@ -363,6 +441,8 @@ int main(int argc, char** argv) {
 
   // Optional CLL kernel table
   fmx::gsi::KernelSet cll_table;
+  if (cfg.gsi_point_interp == "idw")
+    cll_table.set_point_interpolation(fmx::gsi::PointInterp::InverseDistance, cfg.gsi_point_k);
   fmx::gsi::CLLQuantization qcfg;
   qcfg.theta_deg_step = cfg.rt_theta_deg_step;
   qcfg.tau_step = cfg.rt_tau_step;
@@ -372,15 +452,77 @@ int main(int argc, char** argv) {
   qcfg.workers = cfg.rt_workers;
   fmx::gsi::CLLRuntime cll_runtime(qcfg);
   if (in.gsi_model == fmx::solver::GsiModel::CLL && !cfg.gsi_table_path.empty()) {
-    if (cll_table.load_csv(cfg.gsi_table_path)) in.cll_kernel = &cll_table;
+    if (cll_table.load(cfg.gsi_table_path)) in.cll_kernel = &cll_table;
     else std::cerr << "Failed to load CLL table at: " << cfg.gsi_table_path << " (falling back)\n";
   }
-  if (in.gsi_model == fmx::solver::GsiModel::CLL) {
+  fmx::gsi::SurrogateKernel cll_surrogate;
+  if (in.gsi_model == fmx::solver::GsiModel::CLL && !cfg.gsi_surrogate_path.empty()) {
+    if (cll_surrogate.load(cfg.gsi_surrogate_path)) in.cll_surrogate = &cll_surrogate;
+    else std::cerr << "Failed to load CLL surrogate at: " << cfg.gsi_surrogate_path << " (falling back)\n";
+  }
+  // The runtime service is the fallback when no table or surrogate is loaded (both are batch-evaluated)
+  if (in.gsi_model == fmx::solver::GsiModel::CLL && !in.cll_kernel && !in.cll_surrogate) {
     in.cll_runtime = &cll_runtime;
   }
 
+  if (!trajectory_path.empty()) {
+    fmx::cli::TrajectoryOptions topt;
+    topt.ephemeris_path = trajectory_path;
+    topt.out_path = out_path.empty() ? std::string("trajectory.csv") : out_path;
+    topt.binary = topt.out_path.size() >= 4 && topt.out_path.substr(topt.out_path.size()-4) == ".bin";
+    topt.block_rows = traj_block;
+    fmx::cli::TrajectoryStats ts;
+    std::string terr;
+    if (!fmx::cli::run_trajectory(topt, *atm_session, sw, idx, in, &ts, &terr)) {
+      std::cerr << "Trajectory failed: " << terr << "\n"; return 1;
+    }
+    std::cout << "trajectory rows=" << ts.rows << " (skipped lines=" << ts.skipped << ") -> " << topt.out_path << "\n";
+    std::cout << "wall_s=" << ts.wall_s << ", rows_per_s=" << (ts.wall_s > 0 ? ts.rows / ts.wall_s : 0.0)
+              << ", busy_s parse/atm/solve=" << ts.parse_s << "/" << ts.atm_s << "/" << ts.solve_s << "\n";
+    return 0;
+  }
+
+  if (!batch_path.empty()) {
+    fmx::cli::BatchCase defaults;
+    defaults.alt_km = cfg.alt_km; defaults.lat_deg = cfg.lat_deg; defaults.lon_deg = cfg.lon_deg;
+    if (!fmx::atm::parse_iso_utc(cfg.utc, defaults.epoch_s)) { std::cerr << "Could not parse state.utc '" << cfg.utc << "'\n"; return 1; }
+    defaults.V_sat_ms = cfg.V_sat;
+    defaults.theta_deg = theta_deg;
+    defaults.material = in.materials.front();
+    defaults.idx = idx;
+    fmx::cli::BatchOptions bopt;
+    bopt.cases_path = batch_path;
+    bopt.out_path = out_path.empty() ? std::string("batch.csv") : out_path;
+    bopt.binary = bopt.out_path.size() >= 4 && bopt.out_path.substr(bopt.out_path.size()-4) == ".bin";
+    bopt.executor = &exec;
+    fmx::cli::BatchStats bs;
+    std::string berr;
+    if (!fmx::cli::run_batch(bopt, defaults, *atm_session, sw, idx, in, &bs, &berr)) {
+      std::cerr << "Batch failed: " << berr << "\n"; return 1;
+    }
+    std::cout << "batch cases=" << bs.cases << " (errors=" << bs.errors << "), geometries=" << bs.geometries
+              << ", atmosphere batches=" << bs.atm_groups << ", threads=" << bs.threads << " -> " << bopt.out_path << "\n";
+    std::cout << "wall_s=" << bs.wall_s << ", cases_per_s=" << (bs.wall_s > 0 ? bs.cases / bs.wall_s : 0.0)
+              << ", parse/setup/atm/solve/write_s=" << bs.parse_s << "/" << bs.setup_s << "/" << bs.atm_s
+              << "/" << bs.solve_s << "/" << bs.write_s << "\n";
+    return 0;
+  }
+
+  if (!serve_target.empty()) {
+    fmx::cli::Server server(*atm_session, sw, idx, in);
+    const auto fmt = serve_format == "binary" ? fmx::cli::ServeFormat::Binary : fmx::cli::ServeFormat::Json;
+    std::string serr;
+    const bool ok = (serve_target == "-") ? server.serve_fd(0, 1, fmt, &serr) : server.serve_unix(serve_target, fmt, &serr);
+    const auto& ss = server.stats();
+    std::cerr << "served requests=" << ss.requests << ", errors=" << ss.errors
+              << ", mean_us=" << (ss.requests ? 1e6 * ss.busy_s / ss.requests : 0.0) << "\n";
+    if (!ok) { std::cerr << "Serve failed: " << serr << "\n"; return 1; }
+    return 0;
+  }
+
   auto solve_once = [&](const fmx::solver::Input& in_local){ return fmx::solver::solve(in_local); };
-  auto out = solve_once(in);
+  fmx::solver::SolveStats sstats;
+  auto out = fmx::solver::solve(in, &sstats);
   // Regime adapter (optional)
   fmx::solver::RegimeDiagnostics rdiag{};
   if (cfg.regime_enabled) {
@@ -405,17 +547,9 @@ int main(int argc, char** argv) {
     in.regime_Kn = rdiag.Kn;
     in.regime_beta = rdiag.beta;
   }
-  // Diagnostics
-  // Compute occluded facet count (front-facing only)
-  std::size_t occluded = 0, front = 0;
-  Vec3 crel = in.V_sat_ms - in.wind_ms; double cn = crel.norm(); Vec3 chat = (cn>0)?(crel/cn):Vec3{1,0,0};
-  for (const auto& f : in.facets) {
-    double mu = -fmx::Vec3::dot(chat, f.n);
-    if (mu <= 0.0) continue; // backface or grazing
-    front++;
-    fmx::geom::Ray ray{f.r_center, (-chat)};
-    if (occ.any_hit(ray, 1e9)) occluded++;
-  }
+  // Diagnostics: front-facing and shadowed counts come from the solve itself
+  const std::uint64_t front = sstats.front, occluded = sstats.occluded;
+  Vec3 crel = in.V_sat_ms - in.wind_ms; double cn = crel.norm();
   // Species Mach range
   double Ma_min = 1e300, Ma_max = 0.0;
   for (const auto& sp : in.species) {
@@ -433,8 +567,45 @@ int main(int argc, char** argv) {
   if (cfg.regime_enabled) {
     std::cout << "Kn=" << rdiag.Kn << ", beta=" << rdiag.beta << "\n";
   }
+  {
+    const auto& r = sstats.rays;
+    const double per_ray = r.rays ? 1.0 / static_cast<double>(r.rays) : 0.0;
+    std::cout << "solver: rays=" << r.rays << ", bvh nodes/ray=" << r.nodes * per_ray << ", tris/ray=" << r.tris * per_ray
+              << ", gsi sentman/cll/table/surrogate/runtime=" << sstats.gsi_sentman << "/" << sstats.gsi_cll_closed_form
+              << "/" << sstats.gsi_table << "/" << sstats.gsi_surrogate << "/" << sstats.gsi_runtime << "\n";
+    if (sstats.gsi_runtime > 0) {
+      std::cout << "cll_runtime: hits=" << sstats.runtime.hits << ", misses=" << sstats.runtime.misses
+                << ", waits=" << sstats.runtime.waits << ", wait_ms=" << 1e3 * sstats.runtime.wait_s << "\n";
+    }
+    std::cout << "solve_ms prepass/facets/total=" << 1e3 * sstats.prepass_s << "/" << 1e3 * sstats.facets_s
+              << "/" << 1e3 * sstats.total_s << "\n";
+  }
+  // Test-particle Monte Carlo on the same geometry, with reflections between facets
+  std::optional<fmx::solver::TpmcResult> tpmc;
+  if (tpmc_particles > 0) {
+    if (theta_deg != 0.0) {
+      std::cerr << "--tpmc ignored with --theta_deg (the BVH holds the unrotated mesh).\n";
+    } else {
+      fmx::solver::TpmcOptions topt;
+      topt.particles = tpmc_particles;
+      std::string terr;
+      tpmc = fmx::solver::solve_tpmc(in, occ, topt, &terr);
+      if (!tpmc) {
+        std::cerr << "TPMC failed: " << terr << "\n";
+      } else {
+        const auto& t = *tpmc;
+        std::cout << "TPMC F = [" << t.out.F.x << ", " << t.out.F.y << ", " << t.out.F.z << "] +- [" << t.F_stderr.x << ", "
+                  << t.F_stderr.y << ", " << t.F_stderr.z << "] N\n";
+        std::cout << "TPMC M = [" << t.out.M.x << ", " << t.out.M.y << ", " << t.out.M.z << "] +- [" << t.M_stderr.x << ", "
+                  << t.M_stderr.y << ", " << t.M_stderr.z << "] N*m\n";
+        std::cout << "TPMC particles=" << t.particles << ", struck=" << t.struck << ", multi=" << t.multi << ", hits=" << t.hits
+                  << ", dropped=" << t.dropped << ", ms=" << 1e3 * t.seconds << "\n";
+      }
+    }
+  }
   // Bench
   if (bench_iters > 0) {
+    FMX_TRACE_SCOPE("bench", "cli", bench_iters);
     auto t0 = std::chrono::high_resolution_clock::now();
     fmx::solver::Output tmp{};
     for (int i=0;i<bench_iters;++i) {
@@ -446,30 +617,42 @@ int main(int argc, char** argv) {
   }
   // UQ
   if (cfg.uq_samples > 0) {
+    FMX_TRACE_SCOPE("uq", "cli", cfg.uq_samples);
     std::mt19937_64 rng(12345);
     std::normal_distribution<double> z(0.0, 1.0);
     std::uniform_real_distribution<double> u(-1.0, 1.0);
-    auto in_base = in;
-    std::vector<double> Fx, Fy, Fz, Mx, My, Mz; Fx.reserve(cfg.uq_samples);
-    for (int s=0;s<cfg.uq_samples;++s) {
-      auto in_s = in_base;
+    // Perturbations are drawn serially (same stream for any thread count), then the samples
+    // are solved on the pool; each sample's solve runs on the thread that picked it up
+    const std::size_t ns = static_cast<std::size_t>(cfg.uq_samples);
+    std::vector<std::vector<fmx::solver::Species>> species_s(ns, in.species);
+    std::vector<std::vector<fmx::solver::Material>> materials_s(ns, in.materials);
+    for (std::size_t s=0;s<ns;++s) {
       // Perturb densities (log-normal)
-      for (auto& sp : in_s.species) {
+      for (auto& sp : species_s[s]) {
         double factor = std::exp(cfg.uq_sigma_rho * z(rng));
         sp.rho = std::max(0.0, sp.rho * factor);
       }
       // Perturb material
-      for (auto& m : in_s.materials) {
+      for (auto& m : materials_s[s]) {
         double da = cfg.uq_alpha_spread * u(rng);
         m.alpha_n = std::clamp(m.alpha_n + da, 0.0, 1.0);
         da = cfg.uq_alpha_spread * u(rng);
         m.alpha_t = std::clamp(m.alpha_t + da, 0.0, 1.0);
         m.Tw_K = std::max(0.0, m.Tw_K + cfg.uq_Tw_spread * u(rng));
       }
-      auto out_s = solve_once(in_s);
-      Fx.push_back(out_s.F.x); Fy.push_back(out_s.F.y); Fz.push_back(out_s.F.z);
-      Mx.push_back(out_s.M.x); My.push_back(out_s.M.y); Mz.push_back(out_s.M.z);
     }
+    const fmx::solver::Input uq_base = in.view();
+    std::vector<double> Fx(ns), Fy(ns), Fz(ns), Mx(ns), My(ns), Mz(ns);
+    exec.parallel_for(ns, 1, [&](std::size_t b, std::size_t e) {
+      fmx::solver::Input in_s = uq_base;
+      for (std::size_t s = b; s < e; ++s) {
+        in_s.species = species_s[s];
+        in_s.materials = materials_s[s];
+        const auto out_s = solve_once(in_s);
+        Fx[s] = out_s.F.x; Fy[s] = out_s.F.y; Fz[s] = out_s.F.z;
+        Mx[s] = out_s.M.x; My[s] = out_s.M.y; Mz[s] = out_s.M.z;
+      }
+    });
     auto pct = [](std::vector<double>& v, double p){ std::sort(v.begin(), v.end()); double idx = p * (v.size()-1); size_t i = (size_t)idx; double frac = idx - i; if (i+1<v.size()) return v[i]*(1-frac)+v[i+1]*frac; else return v[i]; };
     double Fx5=pct(Fx,0.05), Fx50=pct(Fx,0.50), Fx95=pct(Fx,0.95);
     double Fy5=pct(Fy,0.05), Fy50=pct(Fy,0.50), Fy95=pct(Fy,0.95);
@@ -485,6 +668,7 @@ int main(int argc, char** argv) {
     std::cout << "UQ M.z P5/50/95 = "<<Mz5<<", "<<Mz50<<", "<<Mz95<<"\n";
   }
   if (!out_path.empty()) {
+    FMX_TRACE_SCOPE("write_output", "cli");
     std::ofstream of(out_path);
     of << "{\n";
     of << "  \"F\": [" << out.F.x << ", " << out.F.y << ", " << out.F.z << "],\n";
@@ -493,7 +677,37 @@ int main(int argc, char** argv) {
     of << "    \"facets\": " << in.facets.size() << ", \"front\": " << front << ", \"shadowed\": " << occluded << ",\n";
     of << "    \"alt_km\": " << cfg.alt_km << ", \"T_K\": " << in.T_K << ", \"Tw_K\": " << cfg.Tw_K << ", \"tau\": " << tau << ",\n";
     of << "    \"Ma_min\": " << Ma_min << ", \"Ma_max\": " << Ma_max << "\n";
-    of << "  }\n";
+    of << "  },\n";
+    of << "  \"solver_stats\": {\n";
+    of << "    \"rays\": " << sstats.rays.rays << ", \"bvh_nodes\": " << sstats.rays.nodes << ", \"bvh_tris\": " << sstats.rays.tris
+       << ", \"ray_packets\": " << sstats.rays.packets << ", \"partial\": " << sstats.partial << ",\n";
+    of << "    \"back\": " << sstats.back << ", \"gsi_sentman\": " << sstats.gsi_sentman << ", \"gsi_cll_closed_form\": " << sstats.gsi_cll_closed_form
+       << ", \"gsi_table\": " << sstats.gsi_table << ", \"gsi_surrogate\": " << sstats.gsi_surrogate << ", \"gsi_runtime\": " << sstats.gsi_runtime << ",\n";
+    of << "    \"runtime_hits\": " << sstats.runtime.hits << ", \"runtime_misses\": " << sstats.runtime.misses
+       << ", \"runtime_waits\": " << sstats.runtime.waits << ", \"runtime_wait_s\": " << sstats.runtime.wait_s << ",\n";
+    of << "    \"prepass_s\": " << sstats.prepass_s << ", \"facets_s\": " << sstats.facets_s << ", \"total_s\": " << sstats.total_s << "\n";
+    of << "  }" << (tpmc ? "," : "") << "\n";
+    if (tpmc) {
+      const auto& t = *tpmc;
+      of << "  \"tpmc\": {\n";
+      // Errors are NaN for a single batch; JSON has no NaN
+      auto err3 = [](const fmx::Vec3& e) {
+        std::ostringstream os;
+        os << "[";
+        const double c[3] = {e.x, e.y, e.z};
+        for (int j = 0; j < 3; ++j) {
+          if (j) os << ", ";
+          if (std::isfinite(c[j])) os << c[j]; else os << "null";
+        }
+        os << "]";
+        return os.str();
+      };
+      of << "    \"F\": [" << t.out.F.x << ", " << t.out.F.y << ", " << t.out.F.z << "], \"F_stderr\": " << err3(t.F_stderr) << ",\n";
+      of << "    \"M\": [" << t.out.M.x << ", " << t.out.M.y << ", " << t.out.M.z << "], \"M_stderr\": " << err3(t.M_stderr) << ",\n";
+      of << "    \"particles\": " << t.particles << ", \"struck\": " << t.struck << ", \"multi\": " << t.multi << ", \"hits\": " << t.hits
+         << ", \"dropped\": " << t.dropped << ", \"seconds\": " << t.seconds << "\n";
+      of << "  }\n";
+    }
     of << "}\n";
   }
   return 0;
@@ -0,0 +1,58 @@
+// Bounded blocking FIFO connecting pipeline stages (one or more producers/consumers)
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace fmx {
+
+template <typename T>
+class BoundedQueue {
+public:
+  explicit BoundedQueue(std::size_t capacity) : m_capacity(capacity > 0 ? capacity : 1) {}
+
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+  // Blocks while full; false if the queue was closed (the item is dropped)
+  bool push(T item) {
+    std::unique_lock<std::mutex> lk(m_mu);
+    m_not_full.wait(lk, [&]{ return m_closed || m_items.size() < m_capacity; });
+    if (m_closed) return false;
+    m_items.push_back(std::move(item));
+    m_not_empty.notify_one();
+    return true;
+  }
+
+  // Blocks while empty; nullopt once the queue is closed and drained
+  std::optional<T> pop() {
+    std::unique_lock<std::mutex> lk(m_mu);
+    m_not_empty.wait(lk, [&]{ return m_closed || !m_items.empty(); });
+    if (m_items.empty()) return std::nullopt;
+    T item = std::move(m_items.front());
+    m_items.pop_front();
+    m_not_full.notify_one();
+    return item;
+  }
+
+  // No further pushes; consumers drain the remaining items
+  void close() {
+    std::lock_guard<std::mutex> lk(m_mu);
+    m_closed = true;
+    m_not_empty.notify_all();
+    m_not_full.notify_all();
+  }
+
+private:
+  std::mutex m_mu;
+  std::condition_variable m_not_empty, m_not_full;
+  std::deque<T> m_items;
+  std::size_t m_capacity;
+  bool m_closed{false};
+};
+
+} // namespace fmx
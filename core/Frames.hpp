@@ -0,0 +1,77 @@
+// Earth-fixed frames: WGS84 geodetic conversion, local east/north/up axes, attitude quaternions
+#pragma once
+
+#include <cmath>
+#include "core/types.hpp"
+#include "core/units.hpp"
+
+namespace fmx {
+
+// Unit quaternion (w, x, y, z) rotating vectors from frame A into frame B
+struct Quat {
+  double w{1}, x{0}, y{0}, z{0};
+
+  Quat normalized() const {
+    const double n = std::sqrt(w*w + x*x + y*y + z*z);
+    return n > 0.0 ? Quat{w/n, x/n, y/n, z/n} : Quat{};
+  }
+  Quat conj() const { return {w, -x, -y, -z}; }
+  // v' = q v q*
+  Vec3 rotate(const Vec3& v) const {
+    const Vec3 u{x, y, z};
+    const Vec3 t = 2.0 * Vec3::cross(u, v);
+    return v + w * t + Vec3::cross(u, t);
+  }
+};
+
+struct Geodetic {
+  double lat_deg{0.0};
+  double lon_deg{0.0};
+  double alt_km{0.0};
+};
+
+namespace wgs84 {
+inline constexpr double a = 6378137.0;               // semi-major axis [m]
+inline constexpr double f = 1.0 / 298.257223563;     // flattening
+inline constexpr double b = a * (1.0 - f);
+inline constexpr double e2 = f * (2.0 - f);          // first eccentricity squared
+inline constexpr double ep2 = e2 / (1.0 - e2);       // second eccentricity squared
+} // namespace wgs84
+
+// ECEF position [m] -> geodetic latitude/longitude [deg] and height [km] (Bowring's
+// formula with one refinement; sub-millimetre in LEO)
+inline Geodetic ecef_to_geodetic(const Vec3& r) {
+  using namespace wgs84;
+  const double p = std::sqrt(r.x*r.x + r.y*r.y);
+  const double lon = std::atan2(r.y, r.x);
+  double beta = std::atan2(r.z * a, p * b);
+  double lat = 0.0;
+  for (int it = 0; it < 2; ++it) {
+    const double sb = std::sin(beta), cb = std::cos(beta);
+    lat = std::atan2(r.z + ep2 * b * sb*sb*sb, p - e2 * a * cb*cb*cb);
+    beta = std::atan2((1.0 - f) * std::sin(lat), std::cos(lat));
+  }
+  const double sl = std::sin(lat), cl = std::cos(lat);
+  const double N = a / std::sqrt(1.0 - e2 * sl*sl);
+  // Height from the dominant of the two projections (stable near the poles and the equator)
+  const double h = (std::abs(cl) > 1e-3) ? p / cl - N : r.z / sl - N * (1.0 - e2);
+  return {lat * 180.0 / units::pi, lon * 180.0 / units::pi, h * 1e-3};
+}
+
+inline Vec3 geodetic_to_ecef(const Geodetic& g) {
+  using namespace wgs84;
+  const double lat = g.lat_deg * units::pi / 180.0, lon = g.lon_deg * units::pi / 180.0, h = g.alt_km * 1e3;
+  const double sl = std::sin(lat), cl = std::cos(lat);
+  const double N = a / std::sqrt(1.0 - e2 * sl*sl);
+  return {(N + h) * cl * std::cos(lon), (N + h) * cl * std::sin(lon), (N * (1.0 - e2) + h) * sl};
+}
+
+// Local east/north/up components at a geodetic point -> ECEF components
+inline Vec3 enu_to_ecef(double lat_deg, double lon_deg, const Vec3& enu) {
+  const double lat = lat_deg * units::pi / 180.0, lon = lon_deg * units::pi / 180.0;
+  const double sl = std::sin(lat), cl = std::cos(lat), so = std::sin(lon), co = std::cos(lon);
+  const Vec3 e{-so, co, 0.0}, n{-sl * co, -sl * so, cl}, u{cl * co, cl * so, sl};
+  return enu.x * e + enu.y * n + enu.z * u;
+}
+
+} // namespace fmx
@@ -0,0 +1,45 @@
+// Read-only memory-mapped file (POSIX mmap), shared between copies
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fmx {
+
+class MappedFile {
+public:
+  MappedFile() = default;
+
+  // Map the whole file read-only. Returns an empty mapping on failure.
+  static MappedFile open(const std::string& path, std::string* err = nullptr) {
+    MappedFile mf;
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) { if (err) *err = "Failed to open: " + path; return mf; }
+    struct stat sb{};
+    if (::fstat(fd, &sb) != 0 || sb.st_size <= 0) {
+      ::close(fd); if (err) *err = "Empty or unreadable file: " + path; return mf;
+    }
+    const std::size_t size = static_cast<std::size_t>(sb.st_size);
+    void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) { if (err) *err = "mmap failed: " + path; return mf; }
+    mf.m_size = size;
+    mf.m_base = std::shared_ptr<const void>(p, [size](const void* q){ ::munmap(const_cast<void*>(q), size); });
+    return mf;
+  }
+
+  bool valid() const { return m_base != nullptr; }
+  const unsigned char* data() const { return static_cast<const unsigned char*>(m_base.get()); }
+  std::size_t size() const { return m_size; }
+
+private:
+  std::shared_ptr<const void> m_base;
+  std::size_t m_size{0};
+};
+
+} // namespace fmx
@@ -0,0 +1,19 @@
+// Range-parallel loop interface: lets lower layers (geometry) run on the shared
+// solver::Executor without depending on the solver library
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace fmx {
+
+class ParallelFor {
+public:
+  using RangeFn = std::function<void(std::size_t begin, std::size_t end)>;
+
+  virtual ~ParallelFor() = default;
+  // Blocks until fn has covered [0, n) in chunks of about `grain` indices (0: automatic)
+  virtual void parallel_for(std::size_t n, std::size_t grain, const RangeFn& fn) = 0;
+};
+
+} // namespace fmx
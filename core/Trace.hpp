@@ -0,0 +1,159 @@
+// Scoped trace spans written as Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev)
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fmx::trace {
+
+// Recording is off until start(); a disabled span costs one atomic load. Each thread
+// appends to its own buffer (registered on first use and owned by the recorder, so events of
+// threads that have exited are kept), holding at most capacity() events; later events are
+// counted in dropped(). Span names and categories must be string literals.
+class Recorder {
+public:
+  static constexpr std::size_t kDefaultCapacity = std::size_t(1) << 20; // events per thread
+
+  static Recorder& instance() { static Recorder r; return r; }
+
+  // Acquire pairs with start(): a thread that sees recording on also sees the new time origin
+  bool enabled() const { return m_on.load(std::memory_order_acquire); }
+
+  void start() {
+    std::lock_guard<std::mutex> lk(m_mu);
+    m_t0_ns.store(clock_ns(), std::memory_order_relaxed);
+    for (auto& b : m_buffers) { std::lock_guard<std::mutex> bl(b->mu); b->events.clear(); }
+    m_dropped.store(0, std::memory_order_relaxed);
+    m_on.store(true, std::memory_order_release);
+  }
+  void stop() { m_on.store(false, std::memory_order_relaxed); }
+
+  std::int64_t now_ns() const { return clock_ns() - m_t0_ns.load(std::memory_order_relaxed); }
+
+  // Per-thread event limit (applies to events recorded afterwards)
+  void set_capacity(std::size_t events_per_thread) { m_capacity.store(events_per_thread, std::memory_order_relaxed); }
+  std::size_t capacity() const { return m_capacity.load(std::memory_order_relaxed); }
+  // Events discarded since start() because a thread's buffer was full
+  std::size_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+  // Complete event [t0_ns, t1_ns] on the calling thread; arg < 0 means no argument
+  void record(const char* name, const char* cat, std::int64_t t0_ns, std::int64_t t1_ns, std::int64_t arg = -1) {
+    Buffer& b = buffer();
+    std::lock_guard<std::mutex> lk(b.mu);
+    if (b.events.size() >= capacity()) { m_dropped.fetch_add(1, std::memory_order_relaxed); return; }
+    b.events.push_back({name, cat, t0_ns, t1_ns - t0_ns, arg});
+  }
+
+  // Name shown for the calling thread's track (string literal or long-lived)
+  void set_thread_name(const char* name) {
+    Buffer& b = buffer();
+    std::lock_guard<std::mutex> lk(b.mu);
+    b.name = name;
+  }
+
+  std::size_t event_count() const {
+    std::lock_guard<std::mutex> lk(m_mu);
+    std::size_t n = 0;
+    for (const auto& b : m_buffers) { std::lock_guard<std::mutex> bl(b->mu); n += b->events.size(); }
+    return n;
+  }
+
+  // Write all recorded events; recording may continue on other threads meanwhile
+  bool write(const std::string& path, std::string* err = nullptr) const {
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) { if (err) *err = "Failed to open trace output: " + path; return false; }
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+    bool first = true;
+    auto sep = [&] { if (!first) std::fputs(",\n", f); first = false; };
+    std::lock_guard<std::mutex> lk(m_mu);
+    for (const auto& b : m_buffers) {
+      std::lock_guard<std::mutex> bl(b->mu);
+      if (b->name) {
+        sep();
+        std::fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                     b->tid, b->name);
+      }
+      for (const auto& e : b->events) {
+        sep();
+        std::fprintf(f, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+                     e.name, e.cat, b->tid, 1e-3 * static_cast<double>(e.t0_ns), 1e-3 * static_cast<double>(e.dur_ns));
+        if (e.arg >= 0) std::fprintf(f, ",\"args\":{\"n\":%lld}", static_cast<long long>(e.arg));
+        std::fputc('}', f);
+      }
+    }
+    std::fputs("\n]}\n", f);
+    const bool ok = std::fclose(f) == 0;
+    if (!ok && err) *err = "Failed to write trace output: " + path;
+    return ok;
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+  struct Event { const char* name; const char* cat; std::int64_t t0_ns, dur_ns, arg; };
+  struct Buffer {
+    std::mutex mu;  // uncontended except while writing
+    std::vector<Event> events;
+    const char* name{nullptr};
+    unsigned tid{0};
+  };
+
+  Buffer& buffer() {
+    thread_local Buffer* t_buf = nullptr;
+    if (!t_buf) {
+      std::lock_guard<std::mutex> lk(m_mu);
+      m_buffers.push_back(std::make_unique<Buffer>());
+      t_buf = m_buffers.back().get();
+      t_buf->tid = static_cast<unsigned>(m_buffers.size());
+      t_buf->events.reserve(1024);
+    }
+    return *t_buf;
+  }
+
+  static std::int64_t clock_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+  }
+
+  std::atomic<bool> m_on{false};
+  std::atomic<std::int64_t> m_t0_ns{clock_ns()};
+  std::atomic<std::size_t> m_capacity{kDefaultCapacity};
+  std::atomic<std::size_t> m_dropped{0};
+  mutable std::mutex m_mu;
+  std::vector<std::unique_ptr<Buffer>> m_buffers;
+};
+
+inline bool enabled() { return Recorder::instance().enabled(); }
+inline void set_thread_name(const char* name) { if (enabled()) Recorder::instance().set_thread_name(name); }
+
+// Records [construction, destruction] as one span when tracing is on at construction
+class Scope {
+public:
+  explicit Scope(const char* name, const char* cat = "fmx", std::int64_t arg = -1) {
+    if (enabled()) { m_name = name; m_cat = cat; m_arg = arg; m_t0 = Recorder::instance().now_ns(); }
+  }
+  ~Scope() { end(); }
+  // Close the span early (sequential stages in one function body)
+  void end() {
+    if (m_name) Recorder::instance().record(m_name, m_cat, m_t0, Recorder::instance().now_ns(), m_arg);
+    m_name = nullptr;
+  }
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+private:
+  const char* m_name{nullptr};
+  const char* m_cat{nullptr};
+  std::int64_t m_t0{0}, m_arg{-1};
+};
+
+} // namespace fmx::trace
+
+#define FMX_TRACE_CONCAT_(a, b) a##b
+#define FMX_TRACE_CONCAT(a, b) FMX_TRACE_CONCAT_(a, b)
+// Span over the enclosing scope: FMX_TRACE_SCOPE("solve.facets", "solver"[, item_count])
+#define FMX_TRACE_SCOPE(...) ::fmx::trace::Scope FMX_TRACE_CONCAT(fmx_trace_scope_, __LINE__)(__VA_ARGS__)
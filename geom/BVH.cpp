@@ -1,5 +1,7 @@
 #include "geom/BVH.hpp"
+#include "core/Trace.hpp"
 #include <algorithm>
+#include <bit>
 #include <stack>
 
 namespace fmx::geom {
@@ -10,21 +12,41 @@ Aabb BVHOccluder::tri_bounds(const Triangle& t) {
   Aabb b; b.expand(t.v0); b.expand(t.v1); b.expand(t.v2); return b;
 }
 
+// Subtrees below this depth are refit as independent tasks (up to 64)
+static constexpr int kRefitDepth = 6;
+
 BVHOccluder::BVHOccluder(const std::vector<Triangle>& tris) : m_tris(tris) {
+  FMX_TRACE_SCOPE("bvh.build", "geometry", static_cast<std::int64_t>(tris.size()));
   m_indices.resize(m_tris.size());
-  for (size_t i = 0; i < m_tris.size(); ++i) m_indices[i] = static_cast<int>(i);
   m_nodes.reserve(2 * m_tris.size());
-  if (!m_tris.empty()) build_node(0, static_cast<int>(m_tris.size()));
+  build();
+}
+
+// (Re)builds over m_tris into the existing buffers. The median split makes the tree shape a
+// function of the triangle count alone, so a rebuild of the same mesh does not allocate.
+void BVHOccluder::build() {
+  for (size_t i = 0; i < m_tris.size(); ++i) m_indices[i] = static_cast<int>(i);
+  m_nodes.clear();
+  m_refit_ranges.clear();
+  m_refit_top.clear();
+  if (!m_tris.empty()) build_node(0, static_cast<int>(m_tris.size()), 0);
+  m_refit_sah.resize(m_refit_ranges.size());
+  refit_nodes();
+  m_sah_build = m_sah;
 }
 
-int BVHOccluder::build_node(int start, int count) {
+int BVHOccluder::build_node(int start, int count, int depth) {
   BVHNode node; node.start = start; node.count = count; node.leaf = (count <= 8);
   // bounds
   Aabb box; for (int i = 0; i < count; ++i) box.expand(tri_bounds(m_tris[m_indices[start+i]]));
   node.box = box;
   int idx = static_cast<int>(m_nodes.size());
   m_nodes.push_back(node);
-  if (node.leaf) return idx;
+  if (depth < kRefitDepth && !node.leaf) m_refit_top.push_back(idx);
+  if (node.leaf) {
+    if (depth <= kRefitDepth) m_refit_ranges.push_back({idx, idx + 1});
+    return idx;
+  }
 
   // choose split axis by largest extent of centroids
   Aabb cb; for (int i = 0; i < count; ++i) {
@@ -44,43 +66,130 @@ int BVHOccluder::build_node(int start, int count) {
       return va < vb;
     });
 
-  int left = build_node(start, mid - start);
-  int right = build_node(mid, start + count - mid);
+  int left = build_node(start, mid - start, depth + 1);
+  int right = build_node(mid, start + count - mid, depth + 1);
   m_nodes[idx].left = left;
   m_nodes[idx].right = right;
+  // Preorder: the subtree rooted at depth kRefitDepth is everything pushed since idx
+  if (depth == kRefitDepth) m_refit_ranges.push_back({idx, static_cast<int>(m_nodes.size())});
   return idx;
 }
 
-bool BVHOccluder::ray_triangle(const fmx::Vec3& ro, const fmx::Vec3& rd, const Triangle& t, double t_max) {
-  // Möller–Trumbore
+// Bottom-up bounds and SAH. Children follow their parent in preorder, so a reverse sweep of a
+// subtree range sees children first; the cut subtrees run in parallel, then the top levels.
+void BVHOccluder::refit_nodes(fmx::ParallelFor* ex) {
+  auto refit_node = [&](BVHNode& n) {
+    if (n.leaf) {
+      n.box = Aabb{};
+      for (int i = 0; i < n.count; ++i) n.box.expand(tri_bounds(m_tris[m_indices[n.start + i]]));
+      return n.box.area() * n.count;
+    }
+    n.box = m_nodes[n.left].box;
+    n.box.expand(m_nodes[n.right].box);
+    return n.box.area();
+  };
+  auto refit_range = [&](std::size_t r) {
+    double sah = 0.0;
+    for (int i = m_refit_ranges[r].second - 1; i >= m_refit_ranges[r].first; --i) sah += refit_node(m_nodes[i]);
+    m_refit_sah[r] = sah;
+  };
+  if (ex) {
+    ex->parallel_for(m_refit_ranges.size(), 1, [&](std::size_t b, std::size_t e) { for (std::size_t r = b; r < e; ++r) refit_range(r); });
+  } else {
+    const long long nr = static_cast<long long>(m_refit_ranges.size());
+#if defined(FMX_USE_OPENMP)
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (long long r = 0; r < nr; ++r) refit_range(static_cast<std::size_t>(r));
+  }
+  // Summed in range order so the metric does not depend on the thread count
+  double sah = 0.0;
+  for (double s : m_refit_sah) sah += s;
+  for (auto it = m_refit_top.rbegin(); it != m_refit_top.rend(); ++it) sah += refit_node(m_nodes[*it]);
+  const double root = m_nodes.empty() ? 0.0 : m_nodes.front().box.area();
+  m_sah = root > 0.0 ? sah / root : 0.0;
+}
+
+bool BVHOccluder::refit(const std::vector<Triangle>& tris, std::string* err, fmx::ParallelFor* ex) {
+  if (tris.size() != m_tris.size()) {
+    if (err) *err = "BVH refit: " + std::to_string(tris.size()) + " triangles, tree built over " + std::to_string(m_tris.size());
+    return false;
+  }
+  FMX_TRACE_SCOPE("bvh.refit", "geometry", static_cast<std::int64_t>(tris.size()));
+  std::copy(tris.begin(), tris.end(), m_tris.begin());
+  refit_nodes(ex);
+  return true;
+}
+
+bool BVHOccluder::update(const std::vector<Triangle>& tris, double max_sah_ratio, bool* rebuilt, std::string* err,
+                         fmx::ParallelFor* ex) {
+  if (rebuilt) *rebuilt = false;
+  if (!refit(tris, err, ex)) return false;
+  if (m_sah > max_sah_ratio * m_sah_build) {
+    FMX_TRACE_SCOPE("bvh.build", "geometry", static_cast<std::int64_t>(tris.size()));
+    build();
+    if (rebuilt) *rebuilt = true;
+  }
+  return true;
+}
+
+// Möller–Trumbore, split so that rays sharing a direction share the per-triangle part
+namespace {
+struct TriSetup {
+  fmx::Vec3 v0v1, v0v2, pvec;
+  double invDet{0.0};
+  bool parallel{false};
+};
+
+inline TriSetup tri_setup(const fmx::Vec3& rd, const Triangle& t) {
   const double eps = 1e-7;
-  fmx::Vec3 v0v1 = t.v1 - t.v0;
-  fmx::Vec3 v0v2 = t.v2 - t.v0;
-  fmx::Vec3 pvec = fmx::Vec3::cross(rd, v0v2);
-  double det = fmx::Vec3::dot(v0v1, pvec);
-  if (std::abs(det) < eps) return false;
-  double invDet = 1.0 / det;
+  TriSetup s;
+  s.v0v1 = t.v1 - t.v0;
+  s.v0v2 = t.v2 - t.v0;
+  s.pvec = fmx::Vec3::cross(rd, s.v0v2);
+  double det = fmx::Vec3::dot(s.v0v1, s.pvec);
+  s.parallel = std::abs(det) < eps;
+  if (!s.parallel) s.invDet = 1.0 / det;
+  return s;
+}
+
+inline bool tri_hit(const TriSetup& s, const fmx::Vec3& ro, const fmx::Vec3& rd, const Triangle& t, double t_max,
+                    double* t_hit = nullptr) {
+  if (s.parallel) return false;
   fmx::Vec3 tvec = ro - t.v0;
-  double u = fmx::Vec3::dot(tvec, pvec) * invDet;
+  double u = fmx::Vec3::dot(tvec, s.pvec) * s.invDet;
   if (u < 0.0 || u > 1.0) return false;
-  fmx::Vec3 qvec = fmx::Vec3::cross(tvec, v0v1);
-  double v = fmx::Vec3::dot(rd, qvec) * invDet;
+  fmx::Vec3 qvec = fmx::Vec3::cross(tvec, s.v0v1);
+  double v = fmx::Vec3::dot(rd, qvec) * s.invDet;
   if (v < 0.0 || u + v > 1.0) return false;
-  double tparam = fmx::Vec3::dot(v0v2, qvec) * invDet;
+  double tparam = fmx::Vec3::dot(s.v0v2, qvec) * s.invDet;
+  if (t_hit) *t_hit = tparam;
   return (tparam > 1e-5 && tparam < t_max);
 }
+} // namespace
+
+bool BVHOccluder::ray_triangle(const fmx::Vec3& ro, const fmx::Vec3& rd, const Triangle& t, double t_max) {
+  return tri_hit(tri_setup(rd, t), ro, rd, t, t_max);
+}
 
-bool BVHOccluder::traverse_any(const fmx::Vec3& ro, const fmx::Vec3& rd, double t_max) const {
+template <bool Count>
+bool BVHOccluder::traverse_any(const fmx::Vec3& ro, const fmx::Vec3& rd, double t_max, RayStats* stats) const {
   if (m_nodes.empty()) return false;
   std::stack<int> st; st.push(0);
   while (!st.empty()) {
     int ni = st.top(); st.pop();
     const BVHNode& n = m_nodes[ni];
+    if constexpr (Count) ++stats->nodes;
     if (!n.box.intersect(ro, rd, t_max)) continue;
     if (n.leaf) {
+      if constexpr (Count) stats->tris += static_cast<std::uint64_t>(n.count);
       for (int i = 0; i < n.count; ++i) {
         int triIdx = m_indices[n.start + i];
-        if (ray_triangle(ro, rd, m_tris[triIdx], t_max)) return true;
+        if (ray_triangle(ro, rd, m_tris[triIdx], t_max)) {
+          // Triangles after the hit in this leaf were not tested
+          if constexpr (Count) stats->tris -= static_cast<std::uint64_t>(n.count - i - 1);
+          return true;
+        }
       }
     } else {
       st.push(n.left);
@@ -90,11 +199,119 @@ bool BVHOccluder::traverse_any(const fmx::Vec3& ro, const fmx::Vec3& rd, double
   return false;
 }
 
+template <bool Count>
+std::uint64_t BVHOccluder::traverse_packet(const RayPacket& p, double t_max, RayStats* stats) const {
+  if (m_nodes.empty() || p.n <= 0) return 0;
+  // Same origin offset and per-ray tests as any_hit, so every ray gets the single-ray answer
+  fmx::Vec3 ro[RayPacket::kMaxRays];
+  Aabb ob;
+  for (int i = 0; i < p.n; ++i) { ro[i] = p.o[i] + p.d * 1e-6; ob.expand(ro[i]); }
+  const fmx::Vec3 invd{1.0 / p.d.x, 1.0 / p.d.y, 1.0 / p.d.z};
+  // Packet cull: any ray reaching a box means the central ray reaches the box grown by the
+  // origins' half extent (padded against rounding), so one test rejects the whole packet
+  const fmx::Vec3 oc = (ob.lo + ob.hi) * 0.5, pad = ob.extent() * 0.5 + fmx::Vec3{1e-7, 1e-7, 1e-7};
+  const std::uint64_t all = (p.n >= 64) ? ~std::uint64_t{0} : ((std::uint64_t{1} << p.n) - 1);
+  std::uint64_t hit = 0;
+  // Median split: depth ~ log2(triangles), so a fixed stack is enough
+  int st[64];
+  int sp = 0;
+  st[sp++] = 0;
+  while (sp > 0) {
+    const BVHNode& n = m_nodes[st[--sp]];
+    if constexpr (Count) ++stats->nodes;
+    if (!Aabb{n.box.lo - pad, n.box.hi + pad}.intersect_inv(oc, invd, t_max)) continue;
+    // Inner nodes go on the packet test alone; the rays are sorted out at the leaves
+    if (!n.leaf) {
+      st[sp++] = n.left;
+      st[sp++] = n.right;
+      continue;
+    }
+    std::uint64_t live = 0;
+    for (std::uint64_t m = all & ~hit; m; m &= m - 1) {
+      const int i = std::countr_zero(m);
+      if (n.box.intersect_inv(ro[i], invd, t_max)) live |= std::uint64_t{1} << i;
+    }
+    for (int k = 0; k < n.count && live; ++k) {
+      const Triangle& t = m_tris[m_indices[n.start + k]];
+      const TriSetup ts = tri_setup(p.d, t);
+      if (ts.parallel) continue;
+      for (std::uint64_t m = live; m; m &= m - 1) {
+        const int i = std::countr_zero(m);
+        if constexpr (Count) ++stats->tris;
+        if (tri_hit(ts, ro[i], p.d, t, t_max)) {
+          hit |= std::uint64_t{1} << i;
+          live &= ~(std::uint64_t{1} << i);
+        }
+      }
+    }
+    if (hit == all) break;
+  }
+  return hit;
+}
+
+bool BVHOccluder::closest_hit(const Ray& r, double t_max, RayHit& hit) const {
+  if (m_nodes.empty()) return false;
+  const fmx::Vec3 ro = r.o + r.d * 1e-6;
+  const fmx::Vec3 invd{1.0 / r.d.x, 1.0 / r.d.y, 1.0 / r.d.z};
+  bool found = false;
+  int st[64];
+  int sp = 0;
+  st[sp++] = 0;
+  while (sp > 0) {
+    const BVHNode& n = m_nodes[st[--sp]];
+    // t_max shrinks to the nearest hit so far, pruning everything behind it
+    if (!n.box.intersect_inv(ro, invd, t_max)) continue;
+    if (n.leaf) {
+      for (int i = 0; i < n.count; ++i) {
+        const int ti = m_indices[n.start + i];
+        double t;
+        if (tri_hit(tri_setup(r.d, m_tris[ti]), ro, r.d, m_tris[ti], t_max, &t)) {
+          t_max = t;
+          hit.t = t + 1e-6; // from r.o
+          hit.tri = static_cast<std::size_t>(ti);
+          found = true;
+        }
+      }
+      continue;
+    }
+    // Near child (box centre along the ray) on top, so early hits shrink t_max for the far one
+    const BVHNode& a = m_nodes[n.left];
+    const BVHNode& b = m_nodes[n.right];
+    const double da = fmx::Vec3::dot((a.box.lo + a.box.hi) * 0.5, r.d), db = fmx::Vec3::dot((b.box.lo + b.box.hi) * 0.5, r.d);
+    if (da <= db) { st[sp++] = n.right; st[sp++] = n.left; }
+    else { st[sp++] = n.left; st[sp++] = n.right; }
+  }
+  return found;
+}
+
 bool BVHOccluder::any_hit(const Ray& r, double t_max) const {
   // Offset origin by small step along ray to avoid self-intersection
   fmx::Vec3 ro = r.o + r.d * 1e-6;
-  return traverse_any(ro, r.d, t_max);
+  return traverse_any<false>(ro, r.d, t_max, nullptr);
 }
 
-} // namespace fmx::geom
+bool BVHOccluder::any_hit(const Ray& r, double t_max, RayStats& stats) const {
+  ++stats.rays;
+  fmx::Vec3 ro = r.o + r.d * 1e-6;
+#if defined(FMX_USE_STATS)
+  return traverse_any<true>(ro, r.d, t_max, &stats);
+#else
+  return traverse_any<false>(ro, r.d, t_max, nullptr);
+#endif
+}
 
+std::uint64_t BVHOccluder::any_hit_packet(const RayPacket& p, double t_max) const {
+  return traverse_packet<false>(p, t_max, nullptr);
+}
+
+std::uint64_t BVHOccluder::any_hit_packet(const RayPacket& p, double t_max, RayStats& stats) const {
+  ++stats.packets;
+  stats.rays += static_cast<std::uint64_t>(p.n > 0 ? p.n : 0);
+#if defined(FMX_USE_STATS)
+  return traverse_packet<true>(p, t_max, &stats);
+#else
+  return traverse_packet<false>(p, t_max, nullptr);
+#endif
+}
+
+} // namespace fmx::geom
@@ -1,8 +1,11 @@
 // Simple median-split BVH occluder with ray-triangle any-hit
 #pragma once
 
+#include <string>
+#include <utility>
 #include <vector>
 #include <limits>
+#include "core/Parallel.hpp"
 #include "core/types.hpp"
 #include "geom/Mesh.hpp"
 #include "geom/Occluder.hpp"
@@ -18,6 +21,11 @@ struct Aabb {
   }
   void expand(const Aabb& b) { expand(b.lo); expand(b.hi); }
   fmx::Vec3 extent() const { return {hi.x - lo.x, hi.y - lo.y, hi.z - lo.z}; }
+  double area() const {
+    if (hi.x < lo.x) return 0.0;
+    const fmx::Vec3 e = extent();
+    return 2.0 * (e.x * e.y + e.y * e.z + e.z * e.x);
+  }
   bool intersect(const fmx::Vec3& ro, const fmx::Vec3& rd, double t_max) const {
     // Slab test
     double t0 = 0.0, t1 = t_max;
@@ -34,23 +42,77 @@ struct Aabb {
     }
     return t1 >= t0;
   }
+  // Same test with the reciprocal direction precomputed, for rays sharing a direction
+  bool intersect_inv(const fmx::Vec3& ro, const fmx::Vec3& invd, double t_max) const {
+    double t0 = 0.0, t1 = t_max;
+    auto slab = [&](double l, double h, double o, double inv) {
+      double tNear = (l - o) * inv, tFar = (h - o) * inv;
+      if (inv < 0.0) std::swap(tNear, tFar);
+      t0 = tNear > t0 ? tNear : t0;
+      t1 = tFar < t1 ? tFar : t1;
+      return t1 >= t0;
+    };
+    return slab(lo.x, hi.x, ro.x, invd.x) && slab(lo.y, hi.y, ro.y, invd.y) && slab(lo.z, hi.z, ro.z, invd.z);
+  }
 };
 
+// Nearest intersection: distance along the (unit) ray direction and triangle index
+struct RayHit { double t{0.0}; std::size_t tri{0}; };
+
 struct BVHNode { Aabb box; int left{-1}, right{-1}; int start{0}, count{0}; bool leaf{false}; };
 
 class BVHOccluder : public Occluder {
 public:
   explicit BVHOccluder(const std::vector<Triangle>& tris);
   bool any_hit(const Ray& r, double t_max) const override;
+  bool any_hit(const Ray& r, double t_max, RayStats& stats) const override;
+  // One traversal per packet: inner nodes are culled with a single test for all rays, and
+  // the per-triangle setup is shared; each ray gets the same answer as any_hit
+  std::uint64_t any_hit_packet(const RayPacket& p, double t_max) const override;
+  std::uint64_t any_hit_packet(const RayPacket& p, double t_max, RayStats& stats) const override;
+
+  // Nearest triangle hit before t_max (same origin offset and tolerance as any_hit); tri
+  // indexes triangles(), which keeps the order the tree was built from
+  bool closest_hit(const Ray& r, double t_max, RayHit& hit) const;
+
+  // Bounds of all triangles (empty box for an empty mesh)
+  Aabb bounds() const { return m_nodes.empty() ? Aabb{} : m_nodes.front().box; }
+  const std::vector<Triangle>& triangles() const { return m_tris; }
+
+  // Deforming geometry: tris are the build triangles with moved vertices (same count, same
+  // order). refit copies them in and recomputes node bounds bottom-up, in parallel over
+  // subtrees (on ex when given, e.g. the solver's Executor, else OpenMP), without allocating;
+  // the tree topology stays that of the last build. Returns false and leaves the tree
+  // unchanged when the triangle count differs.
+  bool refit(const std::vector<Triangle>& tris, std::string* err = nullptr, fmx::ParallelFor* ex = nullptr);
+  // refit, then rebuild in place (reusing the buffers) when sah_cost() has grown past
+  // max_sah_ratio times its value after the last build. *rebuilt tells which happened.
+  bool update(const std::vector<Triangle>& tris, double max_sah_ratio = 1.3, bool* rebuilt = nullptr,
+              std::string* err = nullptr, fmx::ParallelFor* ex = nullptr);
+  // Surface area heuristic cost relative to the root box: expected internal nodes visited plus
+  // triangles tested by a ray through the root
+  double sah_cost() const { return m_sah; }
+  double build_sah_cost() const { return m_sah_build; }
 
 private:
   std::vector<Triangle> m_tris;
   std::vector<int> m_indices;
   std::vector<BVHNode> m_nodes;
+  // Refit schedule fixed at build: subtrees cut at kRefitDepth are contiguous node ranges
+  // [first, second) in preorder; m_refit_top holds the nodes above the cut in preorder
+  std::vector<std::pair<int, int>> m_refit_ranges;
+  std::vector<double> m_refit_sah;
+  std::vector<int> m_refit_top;
+  double m_sah{0.0}, m_sah_build{0.0};
 
-  int build_node(int start, int count);
+  void build();
+  int build_node(int start, int count, int depth);
+  void refit_nodes(fmx::ParallelFor* ex = nullptr);
   static Aabb tri_bounds(const Triangle& t);
-  bool traverse_any(const fmx::Vec3& ro, const fmx::Vec3& rd, double t_max) const;
+  template <bool Count>
+  bool traverse_any(const fmx::Vec3& ro, const fmx::Vec3& rd, double t_max, RayStats* stats) const;
+  template <bool Count>
+  std::uint64_t traverse_packet(const RayPacket& p, double t_max, RayStats* stats) const;
   static bool ray_triangle(const fmx::Vec3& ro, const fmx::Vec3& rd, const Triangle& t, double t_max);
 };
 
@@ -1,8 +1,13 @@
 #include "geom/Mesh.hpp"
+#include "core/Trace.hpp"
 
+#include <charconv>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <cctype>
+#include <unordered_map>
 
 namespace fmx::geom {
 
@@ -14,6 +19,7 @@ static inline std::string to_lower(std::string s) {
 }
 
 std::optional<Mesh> Mesh::load(const std::string& path, std::string* err) {
+  FMX_TRACE_SCOPE("mesh.load", "geometry");
   auto lower = to_lower(path);
   if (lower.size() >= 4 && lower.substr(lower.size()-4) == ".obj")
     return loadOBJ(path, err);
@@ -23,44 +29,123 @@ std::optional<Mesh> Mesh::load(const std::string& path, std::string* err) {
   return std::nullopt;
 }
 
+namespace {
+
+bool read_file(const std::string& path, std::string& data) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return false;
+  in.seekg(0, std::ios::end);
+  const auto size = in.tellg();
+  if (size < 0) return false;
+  data.resize(static_cast<std::size_t>(size));
+  in.seekg(0, std::ios::beg);
+  return static_cast<bool>(in.read(data.data(), static_cast<std::streamsize>(data.size())));
+}
+
+inline void skip_blanks(const char*& p, const char* end) {
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+}
+
+inline bool parse_double(const char*& p, const char* end, double& v) {
+  skip_blanks(p, end);
+  if (p < end && *p == '+') ++p;
+  const auto r = std::from_chars(p, end, v);
+  if (r.ec != std::errc{}) return false;
+  p = r.ptr;
+  return true;
+}
+
+// Vertex index of an OBJ face token ("7", "7/2", "7//3", "-1"); the texture and normal
+// indices are ignored
+inline bool parse_face_index(const char*& p, const char* end, long& v) {
+  skip_blanks(p, end);
+  const auto r = std::from_chars(p, end, v);
+  if (r.ec != std::errc{}) return false;
+  p = r.ptr;
+  while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') ++p;
+  return true;
+}
+
+float read_f32(const char* p) { float f; std::memcpy(&f, p, 4); return f; }
+void put_f32(std::string& out, double v) {
+  const float f = static_cast<float>(v);
+  char b[4]; std::memcpy(b, &f, 4);
+  out.append(b, 4);
+}
+
+} // namespace
+
 std::optional<Mesh> Mesh::loadOBJ(const std::string& path, std::string* err) {
-  std::ifstream in(path);
-  if (!in) { if (err) *err = "Failed to open OBJ: " + path; return std::nullopt; }
+  std::string data;
+  if (!read_file(path, data)) { if (err) *err = "Failed to open OBJ: " + path; return std::nullopt; }
 
   std::vector<Vec3> verts;
   Mesh m;
-  std::string line;
-  while (std::getline(in, line)) {
-    if (line.empty() || line[0] == '#') continue;
-    std::istringstream ss(line);
-    std::string tok; ss >> tok;
-    if (tok == "v") {
-      double x,y,z; if (!(ss >> x >> y >> z)) continue; verts.emplace_back(x,y,z);
-    } else if (tok == "f") {
-      // Support simple faces: f i j k (1-based indices, no texture/normals)
-      int i1=0,i2=0,i3=0;
-      auto read_index = [&](const std::string& s)->int{
-        // Handle forms like "3", "3/..", "3/../.."
-        size_t pos = s.find('/');
-        return std::stoi(pos==std::string::npos ? s : s.substr(0,pos));
-      };
-      std::string s1,s2,s3; if (!(ss >> s1 >> s2 >> s3)) continue;
-      i1 = read_index(s1); i2 = read_index(s2); i3 = read_index(s3);
-      if (i1==0||i2==0||i3==0) continue;
-      auto v0 = verts[static_cast<size_t>(i1-1)];
-      auto v1 = verts[static_cast<size_t>(i2-1)];
-      auto v2 = verts[static_cast<size_t>(i3-1)];
-      m.tris.push_back({v0,v1,v2});
+  const char* p = data.data();
+  const char* const end = p + data.size();
+  std::size_t line_no = 0;
+  while (p < end) {
+    const char* eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+    if (!eol) eol = end;
+    ++line_no;
+    const char* q = p;
+    p = eol + (eol < end ? 1 : 0);
+    skip_blanks(q, eol);
+    if (eol - q < 2 || (q[1] != ' ' && q[1] != '\t')) continue;
+    if (q[0] == 'v') {
+      ++q;
+      Vec3 v;
+      if (!parse_double(q, eol, v.x) || !parse_double(q, eol, v.y) || !parse_double(q, eol, v.z)) continue;
+      verts.push_back(v);
+    } else if (q[0] == 'f') {
+      // Triangles only: further vertices of a polygon are ignored
+      ++q;
+      long idx[3];
+      if (!parse_face_index(q, eol, idx[0]) || !parse_face_index(q, eol, idx[1]) ||
+          !parse_face_index(q, eol, idx[2])) continue;
+      Vec3 v[3];
+      for (int k = 0; k < 3; ++k) {
+        // 1-based; negative indices count back from the latest vertex
+        const long n = static_cast<long>(verts.size());
+        const long i = idx[k] > 0 ? idx[k] - 1 : n + idx[k];
+        if (idx[k] == 0 || i < 0 || i >= n) {
+          if (err) *err = "OBJ face index out of range at line " + std::to_string(line_no) + ": " + path;
+          return std::nullopt;
+        }
+        v[k] = verts[static_cast<std::size_t>(i)];
+      }
+      m.tris.push_back({v[0], v[1], v[2]});
     }
   }
   return m;
 }
 
 std::optional<Mesh> Mesh::loadSTL(const std::string& path, std::string* err) {
-  std::ifstream in(path);
-  if (!in) { if (err) *err = "Failed to open STL: " + path; return std::nullopt; }
-  // Only ASCII STL supported in this minimal loader.
-  Mesh m; std::string tok;
+  std::string data;
+  if (!read_file(path, data)) { if (err) *err = "Failed to open STL: " + path; return std::nullopt; }
+  Mesh m;
+  // Binary STL: 80-byte header, u32 count, 50-byte records. Some exporters start the header
+  // with "solid", so the size check decides rather than the first word.
+  if (data.size() >= 84) {
+    std::uint32_t n = 0;
+    std::memcpy(&n, data.data() + 80, 4);
+    if (data.size() == 84 + 50 * static_cast<std::size_t>(n)) {
+      m.tris.reserve(n);
+      const char* r = data.data() + 84;
+      for (std::uint32_t i = 0; i < n; ++i, r += 50) {
+        Vec3 v[3];
+        for (int k = 0; k < 3; ++k) {
+          const char* c = r + 12 + 12 * k; // skip the stored normal
+          v[k] = {read_f32(c), read_f32(c + 4), read_f32(c + 8)};
+        }
+        m.tris.push_back({v[0], v[1], v[2]});
+      }
+      if (m.tris.empty() && err) *err = "No triangles in binary STL: " + path;
+      return m;
+    }
+  }
+  std::istringstream in(std::move(data));
+  std::string tok;
   while (in >> tok) {
     if (tok == "facet") {
       // skip normal header
@@ -77,10 +162,69 @@ std::optional<Mesh> Mesh::loadSTL(const std::string& path, std::string* err) {
       m.tris.push_back({v[0],v[1],v[2]});
     }
   }
-  if (m.tris.empty()) { if (err) *err = "No triangles parsed (ASCII STL expected): " + path; }
+  if (m.tris.empty()) { if (err) *err = "No triangles parsed from STL: " + path; }
   return m;
 }
 
+bool Mesh::save(const std::string& path, std::string* err) const {
+  const auto lower = to_lower(path);
+  const bool obj = lower.size() >= 4 && lower.substr(lower.size() - 4) == ".obj";
+  const bool stl = lower.size() >= 4 && lower.substr(lower.size() - 4) == ".stl";
+  if (!obj && !stl) { if (err) *err = "Unsupported mesh extension: " + path; return false; }
+  if (stl && tris.size() > 0xffffffffu) { if (err) *err = "Too many triangles for STL: " + path; return false; }
+
+  std::string out;
+  if (stl) {
+    // Binary STL; coordinates are single precision by format
+    out.reserve(84 + 50 * tris.size());
+    std::string header = "fmx binary STL";
+    header.resize(80, ' ');
+    out += header;
+    const auto n = static_cast<std::uint32_t>(tris.size());
+    char nb[4]; std::memcpy(nb, &n, 4);
+    out.append(nb, 4);
+    for (const auto& t : tris) {
+      const Vec3 nn = Vec3::cross(t.v1 - t.v0, t.v2 - t.v0);
+      const double len = nn.norm();
+      const Vec3 u = len > 0.0 ? nn / len : Vec3{0, 0, 0};
+      for (const Vec3& v : {u, t.v0, t.v1, t.v2}) { put_f32(out, v.x); put_f32(out, v.y); put_f32(out, v.z); }
+      out.append(2, '\0');
+    }
+  } else {
+    // OBJ with shared vertices; shortest round-trip formatting keeps coordinates exact
+    std::unordered_map<std::string, std::size_t> ids;
+    std::string vs, fs;
+    char buf[128];
+    auto vertex_id = [&](const Vec3& v) {
+      std::string key(reinterpret_cast<const char*>(&v), sizeof(Vec3));
+      auto [it, fresh] = ids.try_emplace(std::move(key), ids.size() + 1);
+      if (fresh) {
+        char* e = buf;
+        *e++ = 'v';
+        for (double c : {v.x, v.y, v.z}) { *e++ = ' '; e = std::to_chars(e, buf + sizeof(buf), c).ptr; }
+        *e++ = '\n';
+        vs.append(buf, e);
+      }
+      return it->second;
+    };
+    for (const auto& t : tris) {
+      const std::size_t a = vertex_id(t.v0), b = vertex_id(t.v1), c = vertex_id(t.v2);
+      char* e = buf;
+      *e++ = 'f';
+      for (std::size_t i : {a, b, c}) { *e++ = ' '; e = std::to_chars(e, buf + sizeof(buf), i).ptr; }
+      *e++ = '\n';
+      fs.append(buf, e);
+    }
+    out = "# fmx mesh\n" + vs + fs;
+  }
+  std::ofstream f(path, std::ios::binary);
+  if (!f || !f.write(out.data(), static_cast<std::streamsize>(out.size()))) {
+    if (err) *err = "Failed to write mesh: " + path;
+    return false;
+  }
+  return true;
+}
+
 std::vector<fmx::Facet> Mesh::to_facets(std::size_t material_id) const {
   std::vector<fmx::Facet> facets;
   facets.reserve(tris.size());
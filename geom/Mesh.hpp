@@ -1,4 +1,4 @@
-// Minimal OBJ/ASCII STL mesh loader and facet extraction
+// OBJ and ASCII/binary STL mesh I/O and facet extraction
 #pragma once
 
 #include <string>
@@ -17,6 +17,9 @@ struct Mesh {
   static std::optional<Mesh> loadOBJ(const std::string& path, std::string* err = nullptr);
   static std::optional<Mesh> loadSTL(const std::string& path, std::string* err = nullptr);
 
+  // Write binary STL (.stl, single precision) or OBJ (.obj, shared vertices, exact)
+  bool save(const std::string& path, std::string* err = nullptr) const;
+
   // Convert triangles to solver facets with centers, normals, and areas
   std::vector<fmx::Facet> to_facets(std::size_t material_id = 0) const;
 };
@@ -1,6 +1,7 @@
 // Occlusion interface (stub). Real BVH/Embree backends can implement this.
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include "core/types.hpp"
 #include "geom/Mesh.hpp"
@@ -9,15 +10,48 @@ namespace fmx::geom {
 
 struct Ray { fmx::Vec3 o, d; }; // origin, direction (normalized)
 
+// Up to kMaxRays rays sharing one direction (e.g. sample points of a facet toward the free
+// stream); results come back as a bit mask, bit i for ray i.
+struct RayPacket {
+  static constexpr int kMaxRays = 64;
+  fmx::Vec3 o[kMaxRays];
+  fmx::Vec3 d;
+  int n{0};
+};
+
+// Traversal work of any_hit calls. Node and triangle counts are only gathered in builds with
+// FMX_USE_STATS; rays are always counted.
+struct RayStats {
+  std::uint64_t rays{0}, nodes{0}, tris{0};
+  std::uint64_t packets{0}; // any_hit_packet calls; their rays are included in rays
+  void merge(const RayStats& o) { rays += o.rays; nodes += o.nodes; tris += o.tris; packets += o.packets; }
+};
+
 class Occluder {
 public:
   virtual ~Occluder() = default;
   virtual bool any_hit(const Ray& r, double t_max) const = 0;
+  // Same result as any_hit, adding the work done to stats
+  virtual bool any_hit(const Ray& r, double t_max, RayStats& stats) const { ++stats.rays; return any_hit(r, t_max); }
+  // Mask of the packet's rays blocked before t_max. The default traces them one by one;
+  // hierarchies override it to traverse once for the whole packet.
+  virtual std::uint64_t any_hit_packet(const RayPacket& p, double t_max) const {
+    std::uint64_t hit = 0;
+    for (int i = 0; i < p.n; ++i) if (any_hit(Ray{p.o[i], p.d}, t_max)) hit |= std::uint64_t{1} << i;
+    return hit;
+  }
+  virtual std::uint64_t any_hit_packet(const RayPacket& p, double t_max, RayStats& stats) const {
+    ++stats.packets;
+    std::uint64_t hit = 0;
+    for (int i = 0; i < p.n; ++i) if (any_hit(Ray{p.o[i], p.d}, t_max, stats)) hit |= std::uint64_t{1} << i;
+    return hit;
+  }
 };
 
 // No-occlusion implementation (always returns false)
 class NoneOccluder : public Occluder {
 public:
+  using Occluder::any_hit;
   bool any_hit(const Ray&, double) const override { return false; }
 };
 
@@ -0,0 +1,230 @@
+#include "geom/Scene.hpp"
+#include "core/Trace.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace fmx::geom {
+
+using fmx::Vec3;
+
+Transform Transform::rotation(const Vec3& axis, double angle_rad, const Vec3& pivot) {
+  // Rodrigues: R v = v cos + (k x v) sin + k (k . v) (1 - cos)
+  const Vec3 k = axis.normalized();
+  const double c = std::cos(angle_rad), s = std::sin(angle_rad);
+  auto rot = [&](const Vec3& v) { return v * c + Vec3::cross(k, v) * s + k * (Vec3::dot(k, v) * (1.0 - c)); };
+  Transform x;
+  x.ex = rot({1, 0, 0}); x.ey = rot({0, 1, 0}); x.ez = rot({0, 0, 1});
+  x.t = pivot - x.vector(pivot);
+  return x;
+}
+
+std::size_t Scene::add_geometry(const Mesh& mesh, std::size_t material_id) {
+  auto g = std::make_unique<Geometry>();
+  g->facets = mesh.to_facets(material_id);
+  g->bvh = std::make_unique<BVHOccluder>(mesh.tris);
+  m_geometries.push_back(std::move(g));
+  return m_geometries.size() - 1;
+}
+
+std::optional<std::size_t> Scene::add_instance(std::size_t geometry, const Transform& xf) {
+  if (geometry >= m_geometries.size()) return std::nullopt;
+  Instance inst;
+  inst.geometry = geometry;
+  inst.xf = xf;
+  inst.offset = m_facets.size();
+  m_facets.resize(m_facets.size() + m_geometries[geometry]->facets.size());
+  m_instances.push_back(inst);
+  place(m_instances.size() - 1);
+  return m_instances.size() - 1;
+}
+
+bool Scene::set_transform(std::size_t instance, const Transform& xf) {
+  if (instance >= m_instances.size()) return false;
+  m_instances[instance].xf = xf;
+  place(instance);
+  return true;
+}
+
+// World facets and bounds of one instance (areas are invariant under rigid motion)
+void Scene::place(std::size_t instance) {
+  Instance& inst = m_instances[instance];
+  const Geometry& g = *m_geometries[inst.geometry];
+  for (std::size_t i = 0; i < g.facets.size(); ++i) {
+    fmx::Facet f = g.facets[i];
+    f.n = inst.xf.vector(f.n);
+    f.r_center = inst.xf.point(f.r_center);
+    m_facets[inst.offset + i] = f;
+  }
+  inst.box = Aabb{};
+  const Aabb b = g.bvh->bounds();
+  if (!g.bvh->triangles().empty()) {
+    for (int c = 0; c < 8; ++c) {
+      inst.box.expand(inst.xf.point({(c & 1) ? b.hi.x : b.lo.x, (c & 2) ? b.hi.y : b.lo.y, (c & 4) ? b.hi.z : b.lo.z}));
+    }
+  }
+  m_dirty = true;
+}
+
+void Scene::commit() {
+  FMX_TRACE_SCOPE("scene.commit", "geometry", static_cast<std::int64_t>(m_instances.size()));
+  m_nodes.clear();
+  m_order.clear();
+  for (std::size_t i = 0; i < m_instances.size(); ++i) {
+    if (!m_geometries[m_instances[i].geometry]->bvh->triangles().empty()) m_order.push_back(static_cast<int>(i));
+  }
+  m_nodes.reserve(2 * m_order.size());
+  if (!m_order.empty()) build_node(0, static_cast<int>(m_order.size()));
+  m_dirty = false;
+}
+
+// Median split of instance box centres along the widest axis, one instance per leaf
+int Scene::build_node(int start, int count) {
+  BVHNode node;
+  node.start = start; node.count = count; node.leaf = (count == 1);
+  Aabb cb;
+  for (int i = 0; i < count; ++i) {
+    const Aabb& b = m_instances[m_order[start + i]].box;
+    node.box.expand(b);
+    cb.expand((b.lo + b.hi) * 0.5);
+  }
+  const int idx = static_cast<int>(m_nodes.size());
+  m_nodes.push_back(node);
+  if (node.leaf) return idx;
+
+  const Vec3 e = cb.extent();
+  const int axis = (e.y > e.x && e.y >= e.z) ? 1 : (e.z > e.x && e.z >= e.y) ? 2 : 0;
+  auto key = [&](int inst) {
+    const Aabb& b = m_instances[inst].box;
+    return axis == 0 ? b.lo.x + b.hi.x : axis == 1 ? b.lo.y + b.hi.y : b.lo.z + b.hi.z;
+  };
+  const int mid = start + count / 2;
+  std::nth_element(m_order.begin() + start, m_order.begin() + mid, m_order.begin() + start + count,
+                   [&](int a, int b) { return key(a) < key(b); });
+  const int left = build_node(start, mid - start);
+  const int right = build_node(mid, start + count - mid);
+  m_nodes[idx].left = left;
+  m_nodes[idx].right = right;
+  return idx;
+}
+
+template <bool Count>
+bool Scene::traverse_any(const Ray& r, double t_max, RayStats* stats) const {
+  if (m_nodes.empty()) return false;
+  // Depth is log2(instances): a fixed stack is enough for any realistic scene
+  int st[64];
+  int sp = 0;
+  st[sp++] = 0;
+  while (sp > 0) {
+    const BVHNode& n = m_nodes[st[--sp]];
+    if constexpr (Count) ++stats->nodes;
+    if (!n.box.intersect(r.o, r.d, t_max)) continue;
+    if (!n.leaf) {
+      st[sp++] = n.left;
+      st[sp++] = n.right;
+      continue;
+    }
+    // Rigid transforms keep lengths, so t_max carries over to the part frame
+    const Instance& inst = m_instances[m_order[n.start]];
+    const Ray local{inst.xf.inverse_point(r.o), inst.xf.inverse_vector(r.d)};
+    const BVHOccluder& bvh = *m_geometries[inst.geometry]->bvh;
+    bool hit;
+    if constexpr (Count) {
+      RayStats part;
+      hit = bvh.any_hit(local, t_max, part);
+      stats->nodes += part.nodes;
+      stats->tris += part.tris;
+    } else {
+      hit = bvh.any_hit(local, t_max);
+    }
+    if (hit) return true;
+  }
+  return false;
+}
+
+bool Scene::any_hit(const Ray& r, double t_max) const {
+  return traverse_any<false>(r, t_max, nullptr);
+}
+
+bool Scene::any_hit(const Ray& r, double t_max, RayStats& stats) const {
+  ++stats.rays;
+#if defined(FMX_USE_STATS)
+  return traverse_any<true>(r, t_max, &stats);
+#else
+  return traverse_any<false>(r, t_max, nullptr);
+#endif
+}
+
+template <bool Count>
+std::uint64_t Scene::traverse_packet(const RayPacket& p, double t_max, RayStats* stats) const {
+  if (m_nodes.empty() || p.n <= 0) return 0;
+  const Vec3 invd{1.0 / p.d.x, 1.0 / p.d.y, 1.0 / p.d.z};
+  const std::uint64_t all = (p.n >= 64) ? ~std::uint64_t{0} : ((std::uint64_t{1} << p.n) - 1);
+  std::uint64_t hit = 0;
+  int st[64];
+  int sp = 0;
+  st[sp++] = 0;
+  while (sp > 0) {
+    const BVHNode& n = m_nodes[st[--sp]];
+    if constexpr (Count) ++stats->nodes;
+    std::uint64_t live = 0;
+    for (std::uint64_t m = all & ~hit; m; m &= m - 1) {
+      const int i = std::countr_zero(m);
+      if (n.box.intersect_inv(p.o[i], invd, t_max)) live |= std::uint64_t{1} << i;
+    }
+    if (!live) continue;
+    if (!n.leaf) {
+      st[sp++] = n.left;
+      st[sp++] = n.right;
+      continue;
+    }
+    // The rays reaching this instance, moved to its part frame as one packet
+    const Instance& inst = m_instances[m_order[n.start]];
+    RayPacket local;
+    local.d = inst.xf.inverse_vector(p.d);
+    int map[RayPacket::kMaxRays];
+    for (std::uint64_t m = live; m; m &= m - 1) {
+      const int i = std::countr_zero(m);
+      map[local.n] = i;
+      local.o[local.n++] = inst.xf.inverse_point(p.o[i]);
+    }
+    const BVHOccluder& bvh = *m_geometries[inst.geometry]->bvh;
+    std::uint64_t part_hit;
+    if constexpr (Count) {
+      RayStats part;
+      part_hit = bvh.any_hit_packet(local, t_max, part);
+      stats->nodes += part.nodes;
+      stats->tris += part.tris;
+    } else {
+      part_hit = bvh.any_hit_packet(local, t_max);
+    }
+    for (; part_hit; part_hit &= part_hit - 1) hit |= std::uint64_t{1} << map[std::countr_zero(part_hit)];
+    if (hit == all) break;
+  }
+  return hit;
+}
+
+std::uint64_t Scene::any_hit_packet(const RayPacket& p, double t_max) const {
+  return traverse_packet<false>(p, t_max, nullptr);
+}
+
+std::uint64_t Scene::any_hit_packet(const RayPacket& p, double t_max, RayStats& stats) const {
+  ++stats.packets;
+  stats.rays += static_cast<std::uint64_t>(p.n > 0 ? p.n : 0);
+#if defined(FMX_USE_STATS)
+  return traverse_packet<true>(p, t_max, &stats);
+#else
+  return traverse_packet<false>(p, t_max, nullptr);
+#endif
+}
+
+Mesh Scene::to_mesh() const {
+  Mesh m;
+  for (const auto& inst : m_instances) {
+    for (const auto& t : m_geometries[inst.geometry]->bvh->triangles()) {
+      m.tris.push_back({inst.xf.point(t.v0), inst.xf.point(t.v1), inst.xf.point(t.v2)});
+    }
+  }
+  return m;
+}
+
+} // namespace fmx::geom
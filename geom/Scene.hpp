@@ -0,0 +1,93 @@
+// Two-level scene of rigid parts: shared part geometry under per-instance transforms
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "core/types.hpp"
+#include "geom/BVH.hpp"
+#include "geom/Mesh.hpp"
+#include "geom/Occluder.hpp"
+
+namespace fmx::geom {
+
+// Rigid placement: world = t + ex*x + ey*y + ez*z with orthonormal, right-handed ex, ey, ez
+struct Transform {
+  fmx::Vec3 ex{1, 0, 0}, ey{0, 1, 0}, ez{0, 0, 1};
+  fmx::Vec3 t;
+
+  fmx::Vec3 point(const fmx::Vec3& p) const { return t + ex * p.x + ey * p.y + ez * p.z; }
+  fmx::Vec3 vector(const fmx::Vec3& v) const { return ex * v.x + ey * v.y + ez * v.z; }
+  fmx::Vec3 inverse_point(const fmx::Vec3& p) const { return inverse_vector(p - t); }
+  fmx::Vec3 inverse_vector(const fmx::Vec3& v) const {
+    return {fmx::Vec3::dot(ex, v), fmx::Vec3::dot(ey, v), fmx::Vec3::dot(ez, v)};
+  }
+  // Composition: (a * b).point(p) == a.point(b.point(p))
+  Transform operator*(const Transform& b) const { return {vector(b.ex), vector(b.ey), vector(b.ez), point(b.t)}; }
+
+  static Transform translation(const fmx::Vec3& t) { Transform x; x.t = t; return x; }
+  // Right-handed rotation by angle_rad about the axis line through pivot
+  static Transform rotation(const fmx::Vec3& axis, double angle_rad, const fmx::Vec3& pivot = {});
+};
+
+// Parts (a bus, one solar panel, an antenna, a second spacecraft) are added once with
+// add_geometry, which extracts their local facets and builds their bottom-level BVH, and are
+// placed any number of times with add_instance; instances of one part share its geometry.
+// facets() holds the world-frame facets of all instances, grouped by instance in the order
+// they were added, for solver::Input::facets_view. set_transform re-places one instance's
+// facets; commit() then rebuilds only the top-level BVH over instance bounds. Occlusion
+// queries need a committed scene. Edits must not overlap solves that use the scene. Ids are
+// the values returned by add_geometry and add_instance; unknown ids are rejected (nullopt or
+// false) and leave the scene unchanged.
+class Scene : public Occluder {
+public:
+  std::size_t add_geometry(const Mesh& mesh, std::size_t material_id = 0);
+  std::optional<std::size_t> add_instance(std::size_t geometry, const Transform& xf = {});
+  bool set_transform(std::size_t instance, const Transform& xf);
+  void commit();
+
+  bool committed() const { return !m_dirty; }
+  const std::vector<fmx::Facet>& facets() const { return m_facets; }
+  const Transform& transform(std::size_t instance) const { return m_instances[instance].xf; }
+  std::size_t facet_offset(std::size_t instance) const { return m_instances[instance].offset; }
+  std::size_t geometries() const { return m_geometries.size(); }
+  std::size_t instances() const { return m_instances.size(); }
+
+  // All instances as one world-frame mesh (export, or a flat BVH for comparison)
+  Mesh to_mesh() const;
+
+  bool any_hit(const Ray& r, double t_max) const override;
+  bool any_hit(const Ray& r, double t_max, RayStats& stats) const override;
+  // A packet stays coherent in part space (rigid transforms map one direction to one direction)
+  std::uint64_t any_hit_packet(const RayPacket& p, double t_max) const override;
+  std::uint64_t any_hit_packet(const RayPacket& p, double t_max, RayStats& stats) const override;
+
+private:
+  struct Geometry {
+    std::vector<fmx::Facet> facets;   // local frame
+    std::unique_ptr<BVHOccluder> bvh; // local frame; owns the triangles
+  };
+  struct Instance {
+    std::size_t geometry{0};
+    Transform xf;
+    Aabb box;                         // world bounds
+    std::size_t offset{0};            // first facet in m_facets
+  };
+
+  void place(std::size_t instance);
+  int build_node(int start, int count);
+  template <bool Count>
+  bool traverse_any(const Ray& r, double t_max, RayStats* stats) const;
+  template <bool Count>
+  std::uint64_t traverse_packet(const RayPacket& p, double t_max, RayStats* stats) const;
+
+  std::vector<std::unique_ptr<Geometry>> m_geometries;
+  std::vector<Instance> m_instances;
+  std::vector<fmx::Facet> m_facets;
+  std::vector<BVHNode> m_nodes;       // top level; leaves hold one instance
+  std::vector<int> m_order;           // instance ids in leaf order
+  bool m_dirty{false};
+};
+
+} // namespace fmx::geom
@@ -0,0 +1,263 @@
+#include "geom/SyntheticMesh.hpp"
+#include "geom/Scene.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace fmx::geom {
+
+using fmx::Vec3;
+
+namespace {
+
+// Orthonormal, right-handed placement: world = o + ex*x + ey*y + ez*z
+struct Frame {
+  Vec3 o, ex{1, 0, 0}, ey{0, 1, 0}, ez{0, 0, 1};
+  Vec3 at(double x, double y, double z) const { return o + ex * x + ey * y + ez * z; }
+};
+
+// Emits triangles, or only counts them (tris == nullptr) while the density is calibrated
+class Builder {
+public:
+  Builder(double density, std::vector<Triangle>* tris) : m_d(density), m_tris(tris) {}
+
+  std::size_t count() const { return m_count; }
+  int divisions(double length, int min_div = 1) const {
+    return std::max(min_div, static_cast<int>(std::ceil(length * m_d - 1e-9)));
+  }
+
+  // Parallelogram o + s*u + t*v (s, t in [0,1]) split into nu x nv quads; normal along u x v
+  void patch(const Frame& f, Vec3 o, Vec3 u, Vec3 v) {
+    const int nu = divisions(u.norm()), nv = divisions(v.norm());
+    if (!m_tris) { m_count += 2 * static_cast<std::size_t>(nu) * static_cast<std::size_t>(nv); return; }
+    auto p = [&](int i, int j) {
+      const Vec3 q = o + u * (static_cast<double>(i) / nu) + v * (static_cast<double>(j) / nv);
+      return f.at(q.x, q.y, q.z);
+    };
+    for (int i = 0; i < nu; ++i) {
+      for (int j = 0; j < nv; ++j) {
+        const Vec3 a = p(i, j), b = p(i + 1, j), c = p(i + 1, j + 1), d = p(i, j + 1);
+        emit(a, b, c);
+        emit(a, c, d);
+      }
+    }
+  }
+
+  // Box with half extents h centred on the frame origin
+  void box(const Frame& f, Vec3 h) {
+    const Vec3 X{2 * h.x, 0, 0}, Y{0, 2 * h.y, 0}, Z{0, 0, 2 * h.z};
+    patch(f, {h.x, -h.y, -h.z}, Y, Z);
+    patch(f, {-h.x, -h.y, -h.z}, Z, Y);
+    patch(f, {-h.x, h.y, -h.z}, Z, X);
+    patch(f, {-h.x, -h.y, -h.z}, X, Z);
+    patch(f, {-h.x, -h.y, h.z}, X, Y);
+    patch(f, {-h.x, -h.y, -h.z}, Y, X);
+  }
+
+  // Capped cylinder of radius R along the frame z axis from z = 0 to z = L
+  void cylinder(const Frame& f, double R, double L) {
+    const int m = segments(R), nz = divisions(L);
+    const std::vector<double> zs = steps(0.0, L, nz);
+    surface_of_revolution(f, m, zs, [&](double) { return R; }, [](double z) { return z; });
+    disk(f, R, 0.0, m, false);
+    disk(f, R, L, m, true);
+  }
+
+  // Thin paraboloid shell z = r^2 / (4 F) over r <= R, opening toward +z, thickness t
+  void dish(const Frame& f, double R, double F, double t) {
+    const int m = segments(R), nr = divisions(R, 2);
+    auto zf = [&](double r) { return r * r / (4.0 * F); };
+    for (int q = 0; q < nr; ++q) {
+      const double r0 = R * q / nr, r1 = R * (q + 1) / nr;
+      ring(f, m, r0, zf(r0), r1, zf(r1), true);          // concave side, normals toward +z
+      ring(f, m, r0, zf(r0) - t, r1, zf(r1) - t, false); // back side
+    }
+    const std::vector<double> zs = {zf(R) - t, zf(R)};
+    surface_of_revolution(f, m, zs, [&](double) { return R; }, [](double z) { return z; }); // rim
+  }
+
+private:
+  int segments(double R) const { return std::max(12, static_cast<int>(std::ceil(2.0 * M_PI * R * m_d - 1e-9))); }
+
+  static std::vector<double> steps(double a, double b, int n) {
+    std::vector<double> v(static_cast<std::size_t>(n) + 1);
+    for (int i = 0; i <= n; ++i) v[static_cast<std::size_t>(i)] = a + (b - a) * i / n;
+    return v;
+  }
+
+  // Side surface through rings at heights zs (increasing) with radius radius(z); outward
+  template <class RFn, class ZFn>
+  void surface_of_revolution(const Frame& f, int m, const std::vector<double>& zs, RFn radius, ZFn height) {
+    if (!m_tris) { m_count += 2 * static_cast<std::size_t>(m) * (zs.size() - 1); return; }
+    auto p = [&](int j, double z) {
+      const double ph = 2.0 * M_PI * j / m, r = radius(z);
+      return f.at(r * std::cos(ph), r * std::sin(ph), height(z));
+    };
+    for (std::size_t i = 0; i + 1 < zs.size(); ++i) {
+      for (int j = 0; j < m; ++j) {
+        const Vec3 a = p(j, zs[i]), b = p(j + 1, zs[i]), c = p(j + 1, zs[i + 1]), d = p(j, zs[i + 1]);
+        emit(a, b, c);
+        emit(a, c, d);
+      }
+    }
+  }
+
+  // Annulus between radii r0 < r1 at heights z0, z1; normals toward +z if up, else -z.
+  // r0 == 0 degenerates to a fan.
+  void ring(const Frame& f, int m, double r0, double z0, double r1, double z1, bool up) {
+    if (!m_tris) { m_count += (r0 > 0.0 ? 2u : 1u) * static_cast<std::size_t>(m); return; }
+    auto p = [&](int j, double r, double z) {
+      const double ph = 2.0 * M_PI * j / m;
+      return f.at(r * std::cos(ph), r * std::sin(ph), z);
+    };
+    for (int j = 0; j < m; ++j) {
+      const Vec3 a = p(j, r0, z0), b = p(j, r1, z1), c = p(j + 1, r1, z1), d = p(j + 1, r0, z0);
+      if (up) { emit(a, b, c); if (r0 > 0.0) emit(a, c, d); }
+      else    { emit(a, c, b); if (r0 > 0.0) emit(a, d, c); }
+    }
+  }
+
+  void disk(const Frame& f, double R, double z, int m, bool up) {
+    const int nr = divisions(R);
+    for (int q = 0; q < nr; ++q) ring(f, m, R * q / nr, z, R * (q + 1) / nr, z, up);
+  }
+
+  void emit(const Vec3& a, const Vec3& b, const Vec3& c) { m_tris->push_back({a, b, c}); ++m_count; }
+
+  double m_d;
+  std::vector<Triangle>* m_tris;
+  std::size_t m_count{0};
+};
+
+constexpr double kPanelThickness = 0.03;
+
+Vec3 panel_half_extents(const SatelliteSpec& s) {
+  return {0.5 * s.panel_length_m, 0.5 * s.panel_width_m, 0.5 * kPanelThickness};
+}
+
+// Builds all parts at one density; counts only when tris is null. With panel_frames, the
+// solar panels are not emitted and their placements are returned instead.
+SatelliteParts build(const SatelliteSpec& s, double density, std::vector<Triangle>* tris,
+                     std::vector<Frame>* panel_frames = nullptr) {
+  Builder b(density, tris);
+  SatelliteParts parts;
+  parts.density_per_m = density;
+  const Vec3 h = s.bus_size * 0.5;
+  std::size_t mark = 0;
+  auto take = [&](std::size_t& part) { part = b.count() - mark; mark = b.count(); };
+
+  b.box(Frame{}, h);
+  take(parts.bus);
+
+  // Solar-array wings: yoke boom from the bus side, then canted thin panels with gaps
+  const double yoke = 0.4, gap = 0.08, th = s.panel_cant_deg * M_PI / 180.0;
+  for (int w = 0; w < std::min(s.wings, 2); ++w) {
+    const double sy = (w == 0) ? 1.0 : -1.0;
+    Frame yf;
+    yf.o = {0.0, sy * h.y, 0.0};
+    yf.ez = {0.0, sy, 0.0};
+    yf.ex = {0.0, 0.0, 1.0};
+    yf.ey = Vec3::cross(yf.ez, yf.ex);
+    b.cylinder(yf, 0.03, yoke);
+    for (int k = 0; k < s.panels_per_wing; ++k) {
+      Frame pf;
+      pf.o = {0.0, sy * (h.y + yoke + k * (s.panel_width_m + gap) + 0.5 * s.panel_width_m), 0.0};
+      pf.ex = {std::cos(th), 0.0, -std::sin(th)};
+      pf.ey = {0.0, 1.0, 0.0};
+      pf.ez = {std::sin(th), 0.0, std::cos(th)};
+      if (panel_frames) panel_frames->push_back(pf);
+      else b.box(pf, panel_half_extents(s));
+    }
+  }
+  take(parts.arrays);
+
+  // Dish on a mast ahead of the bus front face, opening away from the bus
+  if (s.dish) {
+    const double t = 0.02, F = 0.6 * s.dish_radius_m;
+    Frame mf;
+    mf.o = {-h.x, 0.0, 0.0};
+    mf.ez = {-1.0, 0.0, 0.0};
+    mf.ex = {0.0, 0.0, 1.0};
+    mf.ey = Vec3::cross(mf.ez, mf.ex);
+    b.cylinder(mf, 0.04, s.mast_length_m);
+    Frame df = mf;
+    df.o = {-h.x - s.mast_length_m - t, 0.0, 0.0};
+    b.dish(df, s.dish_radius_m, F, t);
+  }
+  take(parts.antenna);
+
+  // Instrument box on the top deck near the front edge; it shades the boom root
+  if (s.instrument) {
+    Frame f;
+    f.o = {-0.25 * h.x, 0.0, h.z + 0.2};
+    b.box(f, {0.2, 0.25, 0.2});
+  }
+  take(parts.instrument);
+
+  // Magnetometer boom from the top deck with a tip sensor
+  if (s.boom) {
+    Frame f;
+    f.o = {0.25 * h.x, 0.0, h.z};
+    b.cylinder(f, 0.025, s.boom_length_m);
+    Frame tip;
+    tip.o = {0.25 * h.x, 0.0, h.z + s.boom_length_m + 0.075};
+    b.box(tip, {0.075, 0.075, 0.075});
+  }
+  take(parts.boom);
+  return parts;
+}
+
+// Tessellation density for about spec.target_triangles triangles. The count grows ~quadratically
+// with density: a few counting passes find it without building the mesh.
+double satellite_density(const SatelliteSpec& spec) {
+  const double target = static_cast<double>(std::max<std::size_t>(spec.target_triangles, 1));
+  auto count_at = [&](double d) {
+    const SatelliteParts p = build(spec, d, nullptr);
+    return static_cast<double>(p.bus + p.arrays + p.antenna + p.boom + p.instrument);
+  };
+  double d = 4.0;
+  for (int it = 0; it < 4; ++it) d *= std::sqrt(target / count_at(d));
+  // Largest density not above the target, unless the minimum tessellation already exceeds it
+  double lo = 0.0, hi = d * 1.2;
+  while (count_at(hi) <= target) hi *= 1.5;
+  for (int it = 0; it < 30; ++it) {
+    const double mid = 0.5 * (lo + hi);
+    (count_at(mid) <= target ? lo : hi) = mid;
+  }
+  return lo > 0.0 ? lo : hi;
+}
+
+} // namespace
+
+Mesh make_satellite(const SatelliteSpec& spec, SatelliteParts* parts) {
+  const double d = satellite_density(spec);
+  const SatelliteParts n = build(spec, d, nullptr);
+  Mesh m;
+  m.tris.reserve(n.bus + n.arrays + n.antenna + n.boom + n.instrument);
+  const SatelliteParts p = build(spec, d, &m.tris);
+  if (parts) *parts = p;
+  return m;
+}
+
+Scene make_satellite_scene(const SatelliteSpec& spec, SatelliteParts* parts, std::vector<std::size_t>* panels) {
+  const double d = satellite_density(spec);
+  Mesh body, panel;
+  std::vector<Frame> frames;
+  SatelliteParts p = build(spec, d, &body.tris, &frames);
+  Builder(d, &panel.tris).box(Frame{}, panel_half_extents(spec));
+  p.arrays += frames.size() * panel.tris.size();
+  Scene sc;
+  sc.add_instance(sc.add_geometry(body));
+  if (!frames.empty()) {
+    const std::size_t g = sc.add_geometry(panel);
+    for (const Frame& f : frames) {
+      const auto id = sc.add_instance(g, Transform{f.ex, f.ey, f.ez, f.o});
+      if (panels && id) panels->push_back(*id);
+    }
+  }
+  sc.commit();
+  if (parts) *parts = p;
+  return sc;
+}
+
+} // namespace fmx::geom
@@ -0,0 +1,51 @@
+// Procedural spacecraft meshes for benchmarks and large-N tests
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "geom/Mesh.hpp"
+#include "geom/Scene.hpp"
+
+namespace fmx::geom {
+
+// A box bus with tessellated faces, deployable solar-array wings on yoke booms, a parabolic
+// dish on a mast in front of the bus (-x, facing the flow of a +x velocity), an instrument
+// box on the top deck and a magnetometer boom with a tip sensor. Every part is a closed,
+// outward-oriented surface. The dish shades the centre of the bus front face and the
+// instrument box shades the boom root, so occlusion matters at every resolution.
+// Dimensions are in metres; the bus is centred on the origin.
+struct SatelliteSpec {
+  std::size_t target_triangles{20000}; // resolution is scaled to approach this count
+  Vec3 bus_size{1.6, 1.2, 1.2};
+  int wings{2};                       // 0, 1 (+y) or 2 (+y and -y)
+  int panels_per_wing{3};
+  double panel_length_m{1.4};          // along x
+  double panel_width_m{1.0};           // along the wing (y)
+  double panel_cant_deg{20.0};         // rotation of the panels about the wing axis
+  bool dish{true};
+  double dish_radius_m{0.45};
+  double mast_length_m{0.6};
+  bool boom{true};
+  double boom_length_m{2.5};
+  bool instrument{true};
+};
+
+// Triangle counts per part of the last generated mesh
+struct SatelliteParts {
+  std::size_t bus{0}, arrays{0}, antenna{0}, boom{0}, instrument{0};
+  double density_per_m{0.0};           // tessellation density used (subdivisions per metre)
+};
+
+// Mesh with about spec.target_triangles triangles (exact count in parts, if given). Small
+// targets are bounded below by the minimum tessellation of the curved parts (~1k triangles).
+Mesh make_satellite(const SatelliteSpec& spec, SatelliteParts* parts = nullptr);
+
+// The same spacecraft as a committed two-level scene: instance 0 is the body (bus, yokes,
+// antenna, instrument, boom) and every solar panel is an instance of one shared panel
+// geometry, whose local y axis is the wing axis. Panel instance ids are appended to `panels`;
+// rotating a panel about its wing axis by a is set_transform(id, transform(id) *
+// Transform::rotation({0, 1, 0}, a)). At equal spec the world triangles match make_satellite.
+Scene make_satellite_scene(const SatelliteSpec& spec, SatelliteParts* parts = nullptr,
+                           std::vector<std::size_t>* panels = nullptr);
+
+} // namespace fmx::geom
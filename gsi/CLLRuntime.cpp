@@ -1,6 +1,8 @@
 #include "gsi/CLLRuntime.hpp"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include "core/Trace.hpp"
 
 namespace fmx::gsi {
 
@@ -21,8 +23,8 @@ static double nearest_in(const std::vector<double>& ax, double x) {
 }
 
 CLLRuntime::CLLRuntime(const CLLQuantization& q) : q_(q) {
-  int nw = std::max(1, q_.workers);
-  for (int i=0;i<nw;++i) {
+  // With workers == 0 the querying threads (e.g. a solver's executor) compute their own misses
+  for (int i=0;i<q_.workers;++i) {
     workers_.emplace_back([this]{ worker_loop(); });
   }
 }
@@ -43,34 +45,64 @@ CLLRuntime::Key CLLRuntime::quantize(double theta, double Ma, double tau, double
   return k;
 }
 
-std::pair<double,double> CLLRuntime::query(double theta, double Ma, double tau, double an, double at) const {
+std::pair<double,double> CLLRuntime::query(double theta, double Ma, double tau, double an, double at,
+                                           QueryStats* stats) const {
   Key k = quantize(theta, Ma, tau, an, at);
-  // Check cache
+  // Look up or insert the in-flight entry under one lock; the first caller for a key computes it
+  std::shared_ptr<Promise> prom;
+  Future fut;
   {
     std::lock_guard<std::mutex> lk(mtx_);
     auto it = cache_.find(k);
     if (it != cache_.end()) {
-      return it->second.fut.get();
+      fut = it->second.fut;
+    } else {
+      prom = std::make_shared<Promise>();
+      fut = prom->get_future().share();
+      cache_.insert({k, Entry{fut}});
     }
   }
-  // Insert in-flight entry
-  auto prom = std::make_shared<Promise>();
-  Future fut = prom->get_future().share();
-  {
-    std::lock_guard<std::mutex> lk(mtx_);
-    cache_.insert({k, Entry{fut}});
+  if (prom && workers_.empty()) {
+    if (stats) ++stats->misses;
+    FMX_TRACE_SCOPE("cll.compute", "gsi");
+    // Callers already waiting on this key get the failure instead of a broken promise
+    try {
+      const auto r = compute_cll(k.theta, k.Ma, k.tau, k.an, k.at, q_.gh_order);
+      prom->set_value(r);
+      return r;
+    } catch (...) {
+      prom->set_exception(std::current_exception());
+      throw;
+    }
   }
-  // Enqueue task
-  {
-    std::lock_guard<std::mutex> lk(q_mtx_);
-    queue_.emplace_back(k, prom);
+  if (prom) {
+    {
+      std::lock_guard<std::mutex> lk(q_mtx_);
+      queue_.emplace_back(k, prom);
+    }
+    q_cv_.notify_one();
+  }
+  const bool traced = fmx::trace::enabled();
+  if (!stats && !traced) return fut.get();
+  if (stats) ++(prom ? stats->misses : stats->hits);
+  if (fut.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    FMX_TRACE_SCOPE("cll.wait", "gsi");
+    const auto t0 = std::chrono::steady_clock::now();
+    fut.wait();
+#if defined(FMX_USE_STATS)
+    if (stats) {
+      ++stats->waits;
+      stats->wait_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+#else
+    (void)t0;
+#endif
   }
-  q_cv_.notify_one();
-  // Wait for result
   return fut.get();
 }
 
 void CLLRuntime::worker_loop() {
+  fmx::trace::set_thread_name("cll_worker");
   while (!stop_.load()) {
     std::pair<Key, std::shared_ptr<Promise>> task;
     {
@@ -81,8 +113,12 @@ void CLLRuntime::worker_loop() {
       queue_.pop_front();
     }
     // Compute
-    auto [CN, CT] = compute_cll(task.first.theta, task.first.Ma, task.first.tau, task.first.an, task.first.at, q_.gh_order);
-    task.second->set_value({CN, CT});
+    FMX_TRACE_SCOPE("cll.compute", "gsi");
+    try {
+      task.second->set_value(compute_cll(task.first.theta, task.first.Ma, task.first.tau, task.first.an, task.first.at, q_.gh_order));
+    } catch (...) {
+      task.second->set_exception(std::current_exception());
+    }
   }
 }
 
@@ -8,6 +8,7 @@
 #include <future>
 #include <thread>
 #include <atomic>
+#include <cstdint>
 #include <utility>
 #include "gsi/CLL.hpp"
 
@@ -19,7 +20,7 @@ struct CLLQuantization {
   double alpha_step{0.25};
   std::vector<double> Ma_anchors{0.5, 1.0, 2.0, 4.0, 8.0, 12.0, 16.0};
   int sample_count{4000};
-  int workers{1};
+  int workers{1};        // background compute threads; 0: misses are computed by the querying thread
   int gh_order{8};
 };
 
@@ -32,7 +33,17 @@ public:
   CLLRuntime(const CLLRuntime&) = delete;
   CLLRuntime& operator=(const CLLRuntime&) = delete;
 
-  std::pair<double,double> query(double theta, double Ma, double tau, double an, double at) const;
+  // Outcome of queries: hits found the quantized key cached (possibly still in flight), misses
+  // enqueued its computation. waits/wait_s cover queries that blocked on a result and are only
+  // measured in builds with FMX_USE_STATS.
+  struct QueryStats {
+    std::uint64_t hits{0}, misses{0}, waits{0};
+    double wait_s{0.0};
+    void merge(const QueryStats& o) { hits += o.hits; misses += o.misses; waits += o.waits; wait_s += o.wait_s; }
+  };
+
+  std::pair<double,double> query(double theta, double Ma, double tau, double an, double at,
+                                 QueryStats* stats = nullptr) const;
 
 private:
   struct Key {
@@ -1,13 +1,33 @@
 #include "gsi/KernelSet.hpp"
+#include "gsi/KernelTT.hpp"
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <limits>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 namespace fmx::gsi {
 
+namespace {
+
+constexpr char kMagic[8] = {'F','M','X','G','S','I','1','\0'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kFlagF32 = 1u;
+
+struct BinHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t flags;
+  std::uint32_t dims[5];
+  std::uint32_t spacing[5];
+  std::uint32_t reserved[2];
+};
+static_assert(sizeof(BinHeader) == 64, "binary table header must be 64 bytes");
+
+} // namespace
+
 static void split_csv_line(const std::string& s, std::vector<double>& out) {
   out.clear();
   std::istringstream ss(s);
@@ -17,12 +37,112 @@ static void split_csv_line(const std::string& s, std::vector<double>& out) {
   }
 }
 
+void KernelAxis::classify() {
+  spacing = AxisSpacing::Irregular; x0 = 0.0; inv_h = 0.0;
+  const size_t n = v.size();
+  if (n < 2) return;
+  // Tolerance is relative to the step: CSV tables carry ~6 significant digits,
+  // and lower() corrects the arithmetic guess against the actual nodes anyway.
+  auto uniform_in = [&](auto f, double& first, double& step) {
+    first = f(v[0]);
+    step = (f(v[n-1]) - first) / static_cast<double>(n - 1);
+    if (!(step > 0.0)) return false;
+    for (size_t i = 1; i < n; ++i) {
+      if (std::abs((f(v[i]) - f(v[i-1])) - step) > 1e-3 * step) return false;
+    }
+    return true;
+  };
+  double first = 0.0, step = 0.0;
+  if (uniform_in([](double x){ return x; }, first, step)) {
+    spacing = AxisSpacing::Uniform; x0 = first; inv_h = 1.0 / step; return;
+  }
+  if (v[0] > 0.0 && uniform_in([](double x){ return std::log(x); }, first, step)) {
+    spacing = AxisSpacing::LogUniform; x0 = first; inv_h = 1.0 / step; return;
+  }
+}
+
+std::size_t KernelAxis::lower(double x) const {
+  const size_t n = v.size();
+  if (n < 2 || x <= v.front()) return 0;
+  if (x >= v.back()) return n - 2;
+  if (spacing == AxisSpacing::Irregular) {
+    auto it = std::upper_bound(v.begin(), v.end(), x);
+    size_t i = (size_t)std::distance(v.begin(), it);
+    return i>0? i-1 : 0;
+  }
+  const double u = (spacing == AxisSpacing::Uniform) ? (x - x0) * inv_h : (std::log(x) - x0) * inv_h;
+  size_t i = static_cast<size_t>(std::clamp(u, 0.0, static_cast<double>(n - 2)));
+  // Guard against rounding in the stored nodes
+  while (i > 0 && x < v[i]) --i;
+  while (i + 2 < n && x >= v[i+1]) ++i;
+  return i;
+}
+
+void KernelSet::clear() {
+  rows.clear();
+  pts.clear();
+  split_dim.clear();
+  for (auto* ax : axes()) *ax = KernelAxis{};
+  grid_owned.clear();
+  grid_map = fmx::MappedFile{};
+  map_offset = 0;
+  is_grid = false;
+  grid_f32 = false;
+  tt.reset();
+}
+
+bool KernelSet::load(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return false;
+  char magic[8] = {};
+  in.read(magic, sizeof(magic));
+  if (in.gcount() == sizeof(magic) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0)
+    return load_binary(path);
+  if (KernelTT::is_tt_file(path)) return load_tt(path);
+  return load_csv(path);
+}
+
+bool KernelSet::load_tt(const std::string& path) {
+  KernelTT t;
+  if (!t.load(path)) return false;
+  set_compressed(std::make_shared<const KernelTT>(std::move(t)));
+  return true;
+}
+
+void KernelSet::set_compressed(std::shared_ptr<const KernelTT> t) {
+  clear();
+  tt = std::move(t);
+}
+
+std::vector<double> KernelSet::grid_values() const {
+  if (!is_grid) return {};
+  const size_t n = 2 * grid_size();
+  if (!grid_f32) {
+    const double* src = static_cast<const double*>(grid_data());
+    return std::vector<double>(src, src + n);
+  }
+  const float* src = static_cast<const float*>(grid_data());
+  return std::vector<double>(src, src + n);
+}
+
+bool KernelSet::set_grid(const std::array<std::vector<double>, 5>& ax, std::vector<double> cnct) {
+  clear();
+  auto dst = axes();
+  for (int d = 0; d < 5; ++d) {
+    if (ax[d].empty()) return false;
+    dst[d]->v = ax[d];
+    dst[d]->classify();
+  }
+  if (cnct.size() != 2 * grid_size()) { clear(); return false; }
+  grid_owned = std::move(cnct);
+  is_grid = true;
+  return true;
+}
+
 bool KernelSet::load_csv(const std::string& path) {
   std::ifstream in(path);
   if (!in) return false;
-  rows.clear();
-  ax_theta.clear(); ax_Ma.clear(); ax_tau.clear(); ax_an.clear(); ax_at.clear();
-  grid_CN.clear(); grid_CT.clear(); is_grid = false;
+  clear();
   std::string line;
   // Detect grid header: a line starting with "dims: Ntheta,NMa,Ntau,Nan,Nat"
   std::streampos start_pos = in.tellg();
@@ -30,32 +150,33 @@ bool KernelSet::load_csv(const std::string& path) {
     if (line.rfind("#", 0) == 0 || line.empty()) continue;
     if (line.rfind("dims:", 0) == 0) {
       // Grid format
-      is_grid = true;
       int NT=0,NM=0,NK=0,NA=0,NB=0;
       {
         auto s = line.substr(5);
         std::vector<double> tmp; split_csv_line(s, tmp);
         if (tmp.size() >= 5) { NT=(int)tmp[0]; NM=(int)tmp[1]; NK=(int)tmp[2]; NA=(int)tmp[3]; NB=(int)tmp[4]; }
       }
-      auto expect_axis = [&](const char* prefix, std::vector<double>& ax){
-        std::string l; if (!std::getline(in, l)) return false; auto pos = l.find(':'); if (pos==std::string::npos) return false; std::string vals = l.substr(pos+1); split_csv_line(vals, ax); return !ax.empty(); };
-      if (!expect_axis("theta:", ax_theta)) return false;
-      if (!expect_axis("Ma:", ax_Ma)) return false;
-      if (!expect_axis("tau:", ax_tau)) return false;
-      if (!expect_axis("alpha_n:", ax_an)) return false;
-      if (!expect_axis("alpha_t:", ax_at)) return false;
-      if ((int)ax_theta.size()!=NT || (int)ax_Ma.size()!=NM || (int)ax_tau.size()!=NK || (int)ax_an.size()!=NA || (int)ax_at.size()!=NB) return false;
+      std::array<std::vector<double>, 5> ax;
+      auto expect_axis = [&](const char* prefix, std::vector<double>& a){
+        std::string l; if (!std::getline(in, l)) return false; auto pos = l.find(':'); if (pos==std::string::npos) return false; std::string vals = l.substr(pos+1); split_csv_line(vals, a); return !a.empty(); };
+      if (!expect_axis("theta:", ax[0])) return false;
+      if (!expect_axis("Ma:", ax[1])) return false;
+      if (!expect_axis("tau:", ax[2])) return false;
+      if (!expect_axis("alpha_n:", ax[3])) return false;
+      if (!expect_axis("alpha_t:", ax[4])) return false;
+      if ((int)ax[0].size()!=NT || (int)ax[1].size()!=NM || (int)ax[2].size()!=NK || (int)ax[3].size()!=NA || (int)ax[4].size()!=NB) return false;
       size_t total = (size_t)NT*NM*NK*NA*NB;
-      grid_CN.resize(total);
-      grid_CT.resize(total);
+      std::vector<double> cnct(2*total);
       // Read CN and CT grids: one line per element: CN,CT
       size_t idx=0;
+      std::vector<double> vals;
       while (idx<total && std::getline(in, line)) {
         if (line.empty() || line[0]=='#') continue;
-        std::vector<double> vals; split_csv_line(line, vals);
-        if (vals.size()>=2) { grid_CN[idx]=vals[0]; grid_CT[idx]=vals[1]; ++idx; }
+        split_csv_line(line, vals);
+        if (vals.size()>=2) { cnct[2*idx]=vals[0]; cnct[2*idx+1]=vals[1]; ++idx; }
       }
-      return idx==total;
+      if (idx != total) return false;
+      return set_grid(ax, std::move(cnct));
     } else {
       // Not grid: rewind and parse as point CSV
       in.clear(); in.seekg(start_pos);
@@ -80,59 +201,262 @@ bool KernelSet::load_csv(const std::string& path) {
     if (!(ss >> r.CT)) continue;
     rows.push_back(r);
   }
-  return !rows.empty();
+  if (rows.empty()) return false;
+  build_point_index();
+  return true;
+}
+
+bool KernelSet::load_binary(const std::string& path) {
+  clear();
+  fmx::MappedFile mf = fmx::MappedFile::open(path);
+  if (!mf.valid() || mf.size() < sizeof(BinHeader)) return false;
+  BinHeader h{};
+  std::memcpy(&h, mf.data(), sizeof(h));
+  if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion) return false;
+  size_t naxis = 0, total = 1;
+  for (int d = 0; d < 5; ++d) {
+    if (h.dims[d] == 0) return false;
+    naxis += h.dims[d]; total *= h.dims[d];
+  }
+  const bool f32 = (h.flags & kFlagF32) != 0;
+  const size_t axis_bytes = naxis * sizeof(double);
+  const size_t node_bytes = 2 * total * (f32 ? sizeof(float) : sizeof(double));
+  if (mf.size() < sizeof(BinHeader) + axis_bytes + node_bytes) return false;
+  const unsigned char* p = mf.data() + sizeof(BinHeader);
+  auto dst = axes();
+  for (int d = 0; d < 5; ++d) {
+    dst[d]->v.resize(h.dims[d]);
+    std::memcpy(dst[d]->v.data(), p, h.dims[d] * sizeof(double));
+    p += h.dims[d] * sizeof(double);
+    dst[d]->classify();
+    // Trust the writer's spacing flag only if it agrees with the nodes
+    if (static_cast<AxisSpacing>(h.spacing[d]) == AxisSpacing::Irregular) dst[d]->spacing = AxisSpacing::Irregular;
+  }
+  map_offset = static_cast<size_t>(p - mf.data());
+  grid_map = std::move(mf);
+  is_grid = true;
+  grid_f32 = f32;
+  return true;
+}
+
+bool KernelSet::save_binary(const std::string& path, bool f32) const {
+  if (!is_grid_table()) return false;
+  std::ofstream out(path, std::ios::binary);
+  if (!out) return false;
+  BinHeader h{};
+  std::memcpy(h.magic, kMagic, sizeof(kMagic));
+  h.version = kVersion;
+  h.flags = f32 ? kFlagF32 : 0u;
+  const auto ax = axes();
+  for (int d = 0; d < 5; ++d) {
+    h.dims[d] = static_cast<std::uint32_t>(ax[d]->v.size());
+    h.spacing[d] = static_cast<std::uint32_t>(ax[d]->spacing);
+  }
+  out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+  for (int d = 0; d < 5; ++d)
+    out.write(reinterpret_cast<const char*>(ax[d]->v.data()), ax[d]->v.size() * sizeof(double));
+  const size_t n = 2 * grid_size();
+  if (f32 == grid_f32) {
+    out.write(static_cast<const char*>(grid_data()), n * (f32 ? sizeof(float) : sizeof(double)));
+  } else if (f32) {
+    const double* src = static_cast<const double*>(grid_data());
+    std::vector<float> buf(n);
+    for (size_t i = 0; i < n; ++i) buf[i] = static_cast<float>(src[i]);
+    out.write(reinterpret_cast<const char*>(buf.data()), n * sizeof(float));
+  } else {
+    const float* src = static_cast<const float*>(grid_data());
+    std::vector<double> buf(src, src + n);
+    out.write(reinterpret_cast<const char*>(buf.data()), n * sizeof(double));
+  }
+  return static_cast<bool>(out);
 }
 
 std::tuple<double,double> KernelSet::query(double theta, double Ma, double tau, double an, double at) const {
-  if (is_grid && !grid_CN.empty()) return query_grid(theta, Ma, tau, an, at);
+  if (is_grid_table()) return query_grid(theta, Ma, tau, an, at);
+  if (tt) return tt->query(theta, Ma, tau, an, at);
   if (rows.empty()) return {0.0, 0.0};
-  // Simple nearest neighbor in normalized space
+  return query_points(theta, Ma, tau, an, at);
+}
+
+void KernelSet::set_point_interpolation(PointInterp mode, int k, double power) {
+  point_mode = mode;
+  point_k = std::clamp(k, 1, 64);
+  point_power = power > 0.0 ? power : 2.0;
+}
+
+std::array<double, 5> KernelSet::normalize(double theta, double Ma, double tau, double an, double at) const {
   auto norm = [](double x, double lo, double hi){ return (hi>lo) ? ( (x-lo)/(hi-lo) ) : 0.0; };
-  double tmin=0.0, tmax=3.141592653589793/2.0; // 0..pi/2
-  // Scan to find rough bounds for normalization
-  double Ma_min=std::numeric_limits<double>::infinity(), Ma_max=0.0;
-  double tau_min=std::numeric_limits<double>::infinity(), tau_max=0.0;
-  for (const auto& r : rows) { Ma_min=std::min(Ma_min,r.Ma); Ma_max=std::max(Ma_max,r.Ma); tau_min=std::min(tau_min,r.tau); tau_max=std::max(tau_max,r.tau);} 
-  double bestd = std::numeric_limits<double>::infinity();
-  const KernelRow* best = &rows.front();
-  for (const auto& r : rows) {
-    double dtheta = norm(theta, tmin, tmax) - norm(r.theta, tmin, tmax);
-    double dMa    = norm(Ma, Ma_min, Ma_max) - norm(r.Ma, Ma_min, Ma_max);
-    double dtau   = norm(tau, tau_min, tau_max) - norm(r.tau, tau_min, tau_max);
-    double dan    = an - r.alpha_n;
-    double dat    = at - r.alpha_t;
-    double d = dtheta*dtheta + dMa*dMa + dtau*dtau + dan*dan + dat*dat;
-    if (d < bestd) { bestd = d; best = &r; }
-  }
-  return {best->CN, best->CT};
-}
-
-static size_t find_lower(const std::vector<double>& ax, double x) {
-  if (x <= ax.front()) return 0;
-  if (x >= ax.back()) return ax.size()-2;
-  auto it = std::upper_bound(ax.begin(), ax.end(), x);
-  size_t i = (size_t)std::distance(ax.begin(), it);
-  return i>0? i-1 : 0;
+  const double tmax = 3.141592653589793/2.0; // theta normalized over 0..pi/2
+  return { norm(theta, 0.0, tmax), norm(Ma, Ma_min, Ma_max), norm(tau, tau_min, tau_max), an, at };
+}
+
+void KernelSet::build_point_index() {
+  // Normalization bounds are fixed at load time
+  Ma_min=std::numeric_limits<double>::infinity(); Ma_max=0.0;
+  tau_min=std::numeric_limits<double>::infinity(); tau_max=0.0;
+  for (const auto& r : rows) { Ma_min=std::min(Ma_min,r.Ma); Ma_max=std::max(Ma_max,r.Ma); tau_min=std::min(tau_min,r.tau); tau_max=std::max(tau_max,r.tau);}
+  pts.resize(rows.size());
+  for (size_t i = 0; i < rows.size(); ++i)
+    pts[i] = normalize(rows[i].theta, rows[i].Ma, rows[i].tau, rows[i].alpha_n, rows[i].alpha_t);
+  split_dim.assign(rows.size(), 0);
+  std::vector<size_t> perm(rows.size());
+  for (size_t i = 0; i < perm.size(); ++i) perm[i] = i;
+  build_kd(0, perm.size(), perm);
+  // Store rows and coordinates in tree order
+  std::vector<KernelRow> rows_kd(rows.size());
+  std::vector<std::array<double, 5>> pts_kd(rows.size());
+  for (size_t i = 0; i < perm.size(); ++i) { rows_kd[i] = rows[perm[i]]; pts_kd[i] = pts[perm[i]]; }
+  rows.swap(rows_kd);
+  pts.swap(pts_kd);
+}
+
+void KernelSet::build_kd(size_t lo, size_t hi, std::vector<size_t>& perm) {
+  if (hi - lo <= 1) return;
+  // Split on the dimension with the largest spread
+  double mn[5], mx[5];
+  for (int d = 0; d < 5; ++d) { mn[d] = std::numeric_limits<double>::infinity(); mx[d] = -mn[d]; }
+  for (size_t i = lo; i < hi; ++i) {
+    for (int d = 0; d < 5; ++d) { mn[d] = std::min(mn[d], pts[perm[i]][d]); mx[d] = std::max(mx[d], pts[perm[i]][d]); }
+  }
+  int dim = 0;
+  for (int d = 1; d < 5; ++d) if (mx[d] - mn[d] > mx[dim] - mn[dim]) dim = d;
+  const size_t mid = lo + (hi - lo) / 2;
+  std::nth_element(perm.begin()+lo, perm.begin()+mid, perm.begin()+hi,
+    [&](size_t a, size_t b){ return pts[a][dim] < pts[b][dim]; });
+  split_dim[mid] = static_cast<std::uint8_t>(dim);
+  build_kd(lo, mid, perm);
+  build_kd(mid + 1, hi, perm);
+}
+
+namespace {
+
+// Bounded sorted list of the k best (squared distance, row) candidates
+struct KnnList {
+  int k{1}, n{0};
+  double d2[64];
+  size_t idx[64];
+  double worst() const { return n < k ? std::numeric_limits<double>::infinity() : d2[n-1]; }
+  void offer(double d, size_t i) {
+    if (d >= worst()) return;
+    int j = (n < k) ? n++ : n - 1;
+    while (j > 0 && d2[j-1] > d) { d2[j] = d2[j-1]; idx[j] = idx[j-1]; --j; }
+    d2[j] = d; idx[j] = i;
+  }
+};
+
+} // namespace
+
+std::tuple<double,double> KernelSet::query_points(double theta, double Ma, double tau, double an, double at) const {
+  const auto q = normalize(theta, Ma, tau, an, at);
+  KnnList best;
+  best.k = (point_mode == PointInterp::Nearest) ? 1 : std::min<int>(point_k, static_cast<int>(rows.size()));
+  // Depth-first descent of the implicit k-d tree, near side first
+  struct Range { size_t lo, hi; double bound; };
+  Range stack[128];
+  int sp = 0;
+  stack[sp++] = {0, rows.size(), 0.0};
+  while (sp > 0) {
+    const Range r = stack[--sp];
+    if (r.lo >= r.hi || r.bound >= best.worst()) continue;
+    const size_t mid = r.lo + (r.hi - r.lo) / 2;
+    const auto& p = pts[mid];
+    double d2 = 0.0;
+    for (int d = 0; d < 5; ++d) { double e = q[d] - p[d]; d2 += e*e; }
+    best.offer(d2, mid);
+    const int dim = split_dim[mid];
+    const double diff = q[dim] - p[dim];
+    const Range near_r = diff < 0.0 ? Range{r.lo, mid, r.bound} : Range{mid + 1, r.hi, r.bound};
+    const Range far_r  = diff < 0.0 ? Range{mid + 1, r.hi, diff*diff} : Range{r.lo, mid, diff*diff};
+    // Far side is pushed first (visited later) and re-checked against the bound when popped
+    if (diff*diff < best.worst() && sp < 127) stack[sp++] = far_r;
+    stack[sp++] = near_r;
+  }
+  if (best.n == 0) return {rows.front().CN, rows.front().CT};
+  if (best.k == 1 || best.d2[0] < 1e-24) return {rows[best.idx[0]].CN, rows[best.idx[0]].CT};
+  double wsum = 0.0, CN = 0.0, CT = 0.0;
+  for (int i = 0; i < best.n; ++i) {
+    const double w = 1.0 / std::pow(best.d2[i], 0.5 * point_power);
+    wsum += w; CN += w * rows[best.idx[i]].CN; CT += w * rows[best.idx[i]].CT;
+  }
+  return {CN / wsum, CT / wsum};
 }
 
 std::tuple<double,double> KernelSet::query_grid(double theta, double Ma, double tau, double an, double at) const {
-  // Clamp and find lower indices for each axis
-  auto clampv = [](double x,double lo,double hi){ return x<lo?lo:(x>hi?hi:x); };
-  theta = clampv(theta, ax_theta.front(), ax_theta.back());
-  Ma    = clampv(Ma,    ax_Ma.front(),    ax_Ma.back());
-  tau   = clampv(tau,   ax_tau.front(),   ax_tau.back());
-  an    = clampv(an,    ax_an.front(),    ax_an.back());
-  at    = clampv(at,    ax_at.front(),    ax_at.back());
-  size_t iT = find_lower(ax_theta, theta);
-  size_t iM = find_lower(ax_Ma,    Ma);
-  size_t iK = find_lower(ax_tau,   tau);
-  size_t iA = find_lower(ax_an,    an);
-  size_t iB = find_lower(ax_at,    at);
-  double t = (theta - ax_theta[iT]) / std::max(1e-12, ax_theta[iT+1]-ax_theta[iT]);
-  double m = (Ma    - ax_Ma[iM])   / std::max(1e-12, ax_Ma[iM+1]-ax_Ma[iM]);
-  double k = (tau   - ax_tau[iK])  / std::max(1e-12, ax_tau[iK+1]-ax_tau[iK]);
-  double a = (an    - ax_an[iA])   / std::max(1e-12, ax_an[iA+1]-ax_an[iA]);
-  double b = (at    - ax_at[iB])   / std::max(1e-12, ax_at[iB+1]-ax_at[iB]);
+  if (grid_f32) return interp_grid(static_cast<const float*>(grid_data()), theta, Ma, tau, an, at);
+  return interp_grid(static_cast<const double*>(grid_data()), theta, Ma, tau, an, at);
+}
+
+template <typename T>
+void KernelSet::slice_theta(const T* data, double Ma, double tau, double an, double at, std::vector<double>& strip) const {
+  auto locate = [](const KernelAxis& ax, double x, size_t& i, size_t& di, double& f) {
+    x = std::clamp(x, ax.v.front(), ax.v.back());
+    i = ax.lower(x);
+    di = (ax.v.size() > 1) ? 1 : 0;
+    f = di ? (x - ax.v[i]) / std::max(1e-12, ax.v[i+1]-ax.v[i]) : 0.0;
+  };
+  size_t iM, iK, iA, iB, sM, sK, sA, sB;
+  double m, k, a, b;
+  locate(ax_Ma,  Ma,  iM, sM, m);
+  locate(ax_tau, tau, iK, sK, k);
+  locate(ax_an,  an,  iA, sA, a);
+  locate(ax_at,  at,  iB, sB, b);
+  const size_t NT = ax_theta.v.size();
+  strip.assign(2*NT, 0.0);
+  double* s = strip.data();
+  // 4D multilinear blend of 16 contiguous theta lines (theta is the fastest axis)
+  for (int db=0; db<=1; ++db) {
+    for (int da=0; da<=1; ++da) {
+      for (int dk=0; dk<=1; ++dk) {
+        for (int dm=0; dm<=1; ++dm) {
+          const double w = (dm? m:1-m) * (dk? k:1-k) * (da? a:1-a) * (db? b:1-b);
+          if (w == 0.0) continue;
+          const T* line = data + 2*idx5(0, iM + dm*sM, iK + dk*sK, iA + da*sA, iB + db*sB);
+          for (size_t j = 0; j < 2*NT; ++j) s[j] += w * static_cast<double>(line[j]);
+        }
+      }
+    }
+  }
+}
+
+void KernelSet::query_theta_batch(std::span<const double> theta, double Ma, double tau, double an, double at,
+                                  double* CN, double* CT) const {
+  if (tt) { tt->query_theta_batch(theta, Ma, tau, an, at, CN, CT); return; }
+  if (!is_grid_table()) {
+    for (size_t i = 0; i < theta.size(); ++i) std::tie(CN[i], CT[i]) = query(theta[i], Ma, tau, an, at);
+    return;
+  }
+  std::vector<double> strip;
+  if (grid_f32) slice_theta(static_cast<const float*>(grid_data()), Ma, tau, an, at, strip);
+  else slice_theta(static_cast<const double*>(grid_data()), Ma, tau, an, at, strip);
+  const double* s = strip.data();
+  const double t0 = ax_theta.v.front(), t1 = ax_theta.v.back();
+  const bool single = ax_theta.v.size() < 2;
+  for (size_t i = 0; i < theta.size(); ++i) {
+    const double th = std::clamp(theta[i], t0, t1);
+    const size_t j = ax_theta.lower(th);
+    const double f = single ? 0.0 : (th - ax_theta.v[j]) / std::max(1e-12, ax_theta.v[j+1]-ax_theta.v[j]);
+    const size_t j1 = single ? j : j + 1;
+    CN[i] = (1.0 - f) * s[2*j]   + f * s[2*j1];
+    CT[i] = (1.0 - f) * s[2*j+1] + f * s[2*j1+1];
+  }
+}
+
+template <typename T>
+std::tuple<double,double> KernelSet::interp_grid(const T* data, double theta, double Ma, double tau, double an, double at) const {
+  // Clamp and find lower index and upper offset (0 for single-node axes) per axis
+  auto locate = [](const KernelAxis& ax, double x, size_t& i, size_t& di, double& f) {
+    x = std::clamp(x, ax.v.front(), ax.v.back());
+    i = ax.lower(x);
+    di = (ax.v.size() > 1) ? 1 : 0;
+    f = di ? (x - ax.v[i]) / std::max(1e-12, ax.v[i+1]-ax.v[i]) : 0.0;
+  };
+  size_t iT, iM, iK, iA, iB, sT, sM, sK, sA, sB;
+  double t, m, k, a, b;
+  locate(ax_theta, theta, iT, sT, t);
+  locate(ax_Ma,    Ma,    iM, sM, m);
+  locate(ax_tau,   tau,   iK, sK, k);
+  locate(ax_an,    an,    iA, sA, a);
+  locate(ax_at,    at,    iB, sB, b);
   // 5D multilinear interpolation (32 corners)
   double CN=0.0, CT=0.0;
   for (int db=0; db<=1; ++db) {
@@ -141,14 +465,10 @@ std::tuple<double,double> KernelSet::query_grid(double theta, double Ma, double
         for (int dm=0; dm<=1; ++dm) {
           for (int dt=0; dt<=1; ++dt) {
             double w = (dt? t:1-t) * (dm? m:1-m) * (dk? k:1-k) * (da? a:1-a) * (db? b:1-b);
-            size_t it = iT + dt;
-            size_t im = iM + dm;
-            size_t ik = iK + dk;
-            size_t ia = iA + da;
-            size_t ib = iB + db;
-            size_t idx = idx5(it, im, ik, ia, ib);
-            CN += w * grid_CN[idx];
-            CT += w * grid_CT[idx];
+            if (w == 0.0) continue;
+            size_t idx = idx5(iT + dt*sT, iM + dm*sM, iK + dk*sK, iA + da*sA, iB + db*sB);
+            CN += w * static_cast<double>(data[2*idx]);
+            CT += w * static_cast<double>(data[2*idx+1]);
           }
         }
       }
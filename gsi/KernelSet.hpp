@@ -1,12 +1,19 @@
 // GSI KernelSet: lookup for tabulated (theta, Ma, tau, alpha_n, alpha_t) -> (C_N, C_T)
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
 #include <vector>
 #include <tuple>
+#include "core/MappedFile.hpp"
 
 namespace fmx::gsi {
 
+class KernelTT;
+
 struct KernelRow {
   double theta;   // [rad]
   double Ma;      // speed ratio (|c|/sqrt(kT/m))
@@ -17,24 +24,105 @@ struct KernelRow {
   double CT;      // tangential coefficient
 };
 
+// Node spacing of a grid axis. Uniform/LogUniform axes are located in O(1).
+enum class AxisSpacing : std::uint32_t { Irregular = 0, Uniform = 1, LogUniform = 2 };
+
+struct KernelAxis {
+  std::vector<double> v;
+  AxisSpacing spacing{AxisSpacing::Irregular};
+  double x0{0.0};    // first node (log of it for LogUniform)
+  double inv_h{0.0}; // inverse node step (in log space for LogUniform)
+
+  // Detect spacing from the node values and set x0/inv_h accordingly
+  void classify();
+  // Lower cell index i such that v[i] <= x <= v[i+1] (x clamped to the axis)
+  std::size_t lower(double x) const;
+};
+
+// Interpolation over scattered point-list tables
+enum class PointInterp { Nearest, InverseDistance };
+
+// Binary grid table (native byte order, 8-byte aligned sections):
+//   header (64 bytes): char magic[8] = "FMXGSI1", u32 version, u32 flags (bit0: float32),
+//                      u32 dims[5], u32 spacing[5], u32 reserved[2]
+//   axes:  double theta[dims0], Ma[dims1], tau[dims2], alpha_n[dims3], alpha_t[dims4]
+//   nodes: interleaved (CN, CT) per node in idx5 order (theta fastest), double or float
 class KernelSet {
 public:
+  // Load a binary or TT-compressed table if the file carries its magic, else parse CSV
+  bool load(const std::string& path);
   bool load_csv(const std::string& path);
-  // Nearest-neighbor lookup (placeholder); later replaced by interpolation
+  // Memory-map a binary table; node data is read in place (no copy)
+  bool load_binary(const std::string& path);
+  // Tensor-train compressed grid (see KernelTT); queries contract the TT cores
+  bool load_tt(const std::string& path);
+  void set_compressed(std::shared_ptr<const KernelTT> t);
+  // Write the current grid as a binary table (optionally float32 node storage)
+  bool save_binary(const std::string& path, bool f32 = false) const;
+  // Install a grid from axes (theta, Ma, tau, alpha_n, alpha_t) and interleaved CN/CT nodes
+  bool set_grid(const std::array<std::vector<double>, 5>& axes, std::vector<double> cnct);
+
+  // Point lists: nearest neighbour (default) or inverse-distance weighting over the k nearest rows
+  void set_point_interpolation(PointInterp mode, int k = 8, double power = 2.0);
+
+  // k-d tree lookup for point lists; multilinear interpolation for grids
   std::tuple<double,double> query(double theta, double Ma, double tau, double an, double at) const;
-  bool valid() const { return !rows.empty(); }
+  // Batch lookup for many theta at fixed (Ma, tau, alpha_n, alpha_t), e.g. all facets of one
+  // material and species. Grids are pre-sliced once to a contiguous theta strip (16 corner
+  // lines streamed), then every theta is interpolated from the strip.
+  void query_theta_batch(std::span<const double> theta, double Ma, double tau, double an, double at,
+                         double* CN, double* CT) const;
+  bool valid() const { return !rows.empty() || is_grid || tt; }
+  bool is_grid_table() const { return is_grid; }
+  bool is_compressed() const { return tt != nullptr; }
+  const KernelAxis& grid_axis(int d) const { return *axes()[d]; }
+  // Dense grid nodes as interleaved CN,CT doubles in idx5 order (empty for non-grid tables)
+  std::vector<double> grid_values() const;
+
 private:
   std::vector<KernelRow> rows;
+  // Point-list index: normalized coordinates in k-d order (rows reordered to match),
+  // split dimension of the implicit tree node at the middle of each range
+  std::vector<std::array<double, 5>> pts;
+  std::vector<std::uint8_t> split_dim;
+  double Ma_min{0.0}, Ma_max{0.0}, tau_min{0.0}, tau_max{0.0};
+  PointInterp point_mode{PointInterp::Nearest};
+  int point_k{8};
+  double point_power{2.0};
   // Optional grid representation for multilinear interpolation
-  std::vector<double> ax_theta, ax_Ma, ax_tau, ax_an, ax_at;
-  std::vector<double> grid_CN; // size = NT * NM * Nk * Na * Nat
-  std::vector<double> grid_CT;
+  KernelAxis ax_theta, ax_Ma, ax_tau, ax_an, ax_at;
+  std::vector<double> grid_owned; // interleaved CN,CT (CSV / set_grid)
+  fmx::MappedFile grid_map;        // backing store of a mapped binary table
+  std::size_t map_offset{0};       // byte offset of the nodes inside grid_map
   bool is_grid{false};
+  bool grid_f32{false};
+  std::shared_ptr<const KernelTT> tt; // compressed backend (replaces the dense grid)
+
+  // Node storage: the mapped file if present, else grid_owned (copy-safe)
+  const void* grid_data() const {
+    return grid_map.valid() ? static_cast<const void*>(grid_map.data() + map_offset)
+                            : static_cast<const void*>(grid_owned.data());
+  }
+
+  std::array<const KernelAxis*, 5> axes() const { return {&ax_theta, &ax_Ma, &ax_tau, &ax_an, &ax_at}; }
+  std::array<KernelAxis*, 5> axes() { return {&ax_theta, &ax_Ma, &ax_tau, &ax_an, &ax_at}; }
+  std::size_t grid_size() const {
+    return ax_theta.v.size() * ax_Ma.v.size() * ax_tau.v.size() * ax_an.v.size() * ax_at.v.size();
+  }
+  void clear();
   inline size_t idx5(size_t it, size_t im, size_t ik, size_t ia, size_t ib) const {
-    size_t NT=ax_theta.size(), NM=ax_Ma.size(), NK=ax_tau.size(), NA=ax_an.size(), NB=ax_at.size();
+    size_t NT=ax_theta.v.size(), NM=ax_Ma.v.size(), NK=ax_tau.v.size(), NA=ax_an.v.size();
     return (((ib*NA + ia)*NK + ik)*NM + im)*NT + it;
   }
+  std::array<double, 5> normalize(double theta, double Ma, double tau, double an, double at) const;
+  void build_point_index();
+  void build_kd(std::size_t lo, std::size_t hi, std::vector<std::size_t>& perm);
+  std::tuple<double,double> query_points(double theta, double Ma, double tau, double an, double at) const;
   std::tuple<double,double> query_grid(double theta, double Ma, double tau, double an, double at) const;
+  template <typename T>
+  void slice_theta(const T* data, double Ma, double tau, double an, double at, std::vector<double>& strip) const;
+  template <typename T>
+  std::tuple<double,double> interp_grid(const T* data, double theta, double Ma, double tau, double an, double at) const;
 };
 
 } // namespace fmx::gsi
@@ -0,0 +1,391 @@
+#include "gsi/KernelTT.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <random>
+
+namespace fmx::gsi {
+
+namespace {
+
+constexpr char kMagic[8] = {'F','M','X','G','T','T','1','\0'};
+constexpr std::uint32_t kVersion = 1;
+
+struct TTHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t dims[6];
+  std::uint32_t ranks[7];
+};
+static_assert(sizeof(TTHeader) == 64, "TT header must be 64 bytes");
+
+constexpr std::size_t kRangeBlock = 8; // random samples per range-finder step
+
+// One-sided (Hestenes) Jacobi on the columns of the r x r row-major matrix X (overwritten):
+// on return X U has orthogonal columns, U (r x r, row-major) holds the rotations and the
+// column norms of X are the singular values, in no particular order.
+void hestenes(std::vector<double>& X, std::size_t r, std::vector<double>& U) {
+  U.assign(r*r, 0.0);
+  for (std::size_t i = 0; i < r; ++i) U[i*r + i] = 1.0;
+  for (int sweep = 0; sweep < 60; ++sweep) {
+    bool rotated = false;
+    for (std::size_t p = 0; p < r; ++p) {
+      for (std::size_t q = p+1; q < r; ++q) {
+        double alpha = 0.0, beta = 0.0, gamma = 0.0;
+        for (std::size_t i = 0; i < r; ++i) {
+          const double xp = X[i*r+p], xq = X[i*r+q];
+          alpha += xp*xp; beta += xq*xq; gamma += xp*xq;
+        }
+        if (gamma == 0.0 || std::abs(gamma) <= 1e-15 * std::sqrt(alpha * beta)) continue;
+        rotated = true;
+        const double zeta = (beta - alpha) / (2.0 * gamma);
+        const double t = (zeta >= 0.0 ? 1.0 : -1.0) / (std::abs(zeta) + std::sqrt(1.0 + zeta*zeta));
+        const double c = 1.0 / std::sqrt(1.0 + t*t), s = c * t;
+        for (std::size_t i = 0; i < r; ++i) {
+          const double xp = X[i*r+p], xq = X[i*r+q];
+          X[i*r+p] = c*xp - s*xq; X[i*r+q] = s*xp + c*xq;
+          const double up = U[i*r+p], uq = U[i*r+q];
+          U[i*r+p] = c*up - s*uq; U[i*r+q] = s*up + c*uq;
+        }
+      }
+    }
+    if (!rotated) break;
+  }
+}
+
+// Orthogonalize y (length m) against the first `cols` columns of Q (column j at Q[j*m]),
+// twice for stability; returns the remaining norm
+double orthogonalize(const std::vector<double>& Q, std::size_t cols, std::size_t m, double* y) {
+  for (int pass = 0; pass < 2; ++pass) {
+    for (std::size_t j = 0; j < cols; ++j) {
+      const double* q = &Q[j*m];
+      double d = 0.0;
+      for (std::size_t i = 0; i < m; ++i) d += q[i]*y[i];
+      for (std::size_t i = 0; i < m; ++i) y[i] -= d*q[i];
+    }
+  }
+  double n2 = 0.0;
+  for (std::size_t i = 0; i < m; ++i) n2 += y[i]*y[i];
+  return std::sqrt(n2);
+}
+
+// Truncated SVD of the m x M row-major unfolding C to squared error <= budget (or rank
+// max_rank): an adaptive randomized range finder grows an orthonormal basis Q from samples of
+// the explicit residual C - Q Q^T C until its norm is below half the budget, then the small
+// SVD of B = Q^T C (QR of B^T, Jacobi on R) is truncated within the rest. Cost O(m M r).
+// Returns the left factor (m x r), the remainder S V^T (r x M) and the squared error.
+struct Truncation {
+  std::vector<double> left, rest;
+  std::size_t rank{0};
+  double err2{0.0};
+};
+
+Truncation truncated_svd(const std::vector<double>& C, std::size_t m, std::size_t M, double budget,
+                         std::size_t max_rank, std::uint64_t seed) {
+  const std::size_t rmax = std::max<std::size_t>(1, std::min({m, M, max_rank}));
+  std::vector<double> R = C, Q, Y, omega, w(M);
+  double res2 = 0.0;
+  for (double x : R) res2 += x*x;
+  std::mt19937_64 rng(seed);
+  std::normal_distribution<double> gauss(0.0, 1.0);
+  std::size_t r = 0;
+  while (res2 > 0.5 * budget && r < rmax) {
+    const std::size_t p = std::min(kRangeBlock, rmax - r);
+    omega.resize(M * p);
+    for (double& x : omega) x = gauss(rng);
+    Y.assign(p * m, 0.0); // column j at Y[j*m]
+    for (std::size_t i = 0; i < m; ++i) {
+      const double* ri = &R[i*M];
+      for (std::size_t c = 0; c < M; ++c) {
+        const double v = ri[c];
+        if (v == 0.0) continue;
+        for (std::size_t j = 0; j < p; ++j) Y[j*m + i] += v * omega[c*p + j];
+      }
+    }
+    const std::size_t r0 = r;
+    for (std::size_t j = 0; j < p; ++j) {
+      double* y = &Y[j*m];
+      double n0 = 0.0;
+      for (std::size_t i = 0; i < m; ++i) n0 += y[i]*y[i];
+      Q.resize((r + 1) * m);
+      std::copy(y, y + m, &Q[r*m]);
+      const double nr = orthogonalize(Q, r, m, &Q[r*m]);
+      if (!(nr > 1e-10 * std::sqrt(n0))) continue; // sample already in the span
+      for (std::size_t i = 0; i < m; ++i) Q[r*m + i] /= nr;
+      ++r;
+    }
+    Q.resize(r * m);
+    if (r == r0) break; // residual below working precision
+    // Deflate the residual by the new directions and measure it exactly
+    for (std::size_t j = r0; j < r; ++j) {
+      const double* q = &Q[j*m];
+      std::fill(w.begin(), w.end(), 0.0);
+      for (std::size_t i = 0; i < m; ++i) {
+        const double* ri = &R[i*M];
+        for (std::size_t c = 0; c < M; ++c) w[c] += q[i] * ri[c];
+      }
+      for (std::size_t i = 0; i < m; ++i) {
+        double* ri = &R[i*M];
+        for (std::size_t c = 0; c < M; ++c) ri[c] -= q[i] * w[c];
+      }
+    }
+    res2 = 0.0;
+    for (double x : R) res2 += x*x;
+  }
+  if (r == 0) { Q.assign(m, 0.0); Q[0] = 1.0; r = 1; } // all-zero unfolding: any unit direction
+
+  // B = Q^T C (r x M)
+  std::vector<double> B(r * M, 0.0);
+  for (std::size_t j = 0; j < r; ++j) {
+    double* bj = &B[j*M];
+    for (std::size_t i = 0; i < m; ++i) {
+      const double q = Q[j*m + i];
+      if (q == 0.0) continue;
+      const double* ci = &C[i*M];
+      for (std::size_t c = 0; c < M; ++c) bj[c] += q * ci[c];
+    }
+  }
+  // B^T = Q2 T (Gram-Schmidt over the rows of B), B = T^T Q2^T; Jacobi on T gives T U = W S,
+  // so U holds the left singular vectors of B and S its singular values
+  std::vector<double> Q2 = B, T(r * r, 0.0);
+  for (std::size_t j = 0; j < r; ++j) {
+    double* bj = &Q2[j*M];
+    for (int pass = 0; pass < 2; ++pass) {
+      for (std::size_t i = 0; i < j; ++i) {
+        const double* qi = &Q2[i*M];
+        double d = 0.0;
+        for (std::size_t c = 0; c < M; ++c) d += qi[c]*bj[c];
+        for (std::size_t c = 0; c < M; ++c) bj[c] -= d*qi[c];
+        T[i*r + j] += d;
+      }
+    }
+    double n2 = 0.0;
+    for (std::size_t c = 0; c < M; ++c) n2 += bj[c]*bj[c];
+    const double nj = std::sqrt(n2);
+    T[j*r + j] = nj;
+    if (nj > 0.0) for (std::size_t c = 0; c < M; ++c) bj[c] /= nj;
+  }
+  std::vector<double> U;
+  hestenes(T, r, U);
+  std::vector<double> sigma2(r, 0.0);
+  for (std::size_t j = 0; j < r; ++j) for (std::size_t i = 0; i < r; ++i) sigma2[j] += T[i*r+j]*T[i*r+j];
+  std::vector<std::size_t> order(r);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b){ return sigma2[a] > sigma2[b]; });
+  // Drop trailing singular values within what the range finder left of the budget
+  std::size_t keep = r;
+  double tail = 0.0;
+  while (keep > 1 && res2 + tail + sigma2[order[keep-1]] <= budget) { tail += sigma2[order[keep-1]]; --keep; }
+
+  Truncation t;
+  t.rank = keep;
+  t.err2 = res2 + tail;
+  t.left.assign(m * keep, 0.0);
+  for (std::size_t row = 0; row < m; ++row)
+    for (std::size_t b = 0; b < keep; ++b) {
+      double s = 0.0;
+      for (std::size_t j = 0; j < r; ++j) s += Q[j*m + row] * U[j*r + order[b]];
+      t.left[row*keep + b] = s;
+    }
+  t.rest.assign(keep * M, 0.0);
+  for (std::size_t b = 0; b < keep; ++b) {
+    double* nb = &t.rest[b*M];
+    for (std::size_t j = 0; j < r; ++j) {
+      const double u = U[j*r + order[b]];
+      if (u == 0.0) continue;
+      const double* bj = &B[j*M];
+      for (std::size_t c = 0; c < M; ++c) nb[c] += u * bj[c];
+    }
+  }
+  return t;
+}
+
+inline void locate(const KernelAxis& ax, double x, std::size_t& i, std::size_t& di, double& f) {
+  x = std::clamp(x, ax.v.front(), ax.v.back());
+  i = ax.lower(x);
+  di = (ax.v.size() > 1) ? 1 : 0;
+  f = di ? (x - ax.v[i]) / std::max(1e-12, ax.v[i+1]-ax.v[i]) : 0.0;
+}
+
+} // namespace
+
+std::optional<KernelTT> KernelTT::fit(const KernelSet& dense, double rel_tol, std::string* err, std::size_t max_rank) {
+  if (!dense.is_grid_table()) { if (err) *err = "TT fit requires a dense grid table"; return std::nullopt; }
+  if (!(rel_tol >= 0.0) || max_rank == 0 || max_rank > kMaxRank) {
+    if (err) *err = "TT fit needs rel_tol >= 0 and max_rank in 1.." + std::to_string(kMaxRank);
+    return std::nullopt;
+  }
+  KernelTT tt;
+  std::size_t n[6];
+  for (int k = 0; k < 5; ++k) { tt.m_axes[k] = dense.grid_axis(k); n[k] = tt.m_axes[k].v.size(); }
+  n[5] = 2;
+  const std::vector<double> vals = dense.grid_values();
+  // Reorder to theta-most-significant so every left-to-right unfolding is a plain reshape
+  std::vector<double> C(vals.size());
+  for (std::size_t i4 = 0; i4 < n[4]; ++i4)
+    for (std::size_t i3 = 0; i3 < n[3]; ++i3)
+      for (std::size_t i2 = 0; i2 < n[2]; ++i2)
+        for (std::size_t i1 = 0; i1 < n[1]; ++i1)
+          for (std::size_t i0 = 0; i0 < n[0]; ++i0) {
+            const std::size_t src = i0 + n[0]*(i1 + n[1]*(i2 + n[2]*(i3 + n[3]*i4)));
+            const std::size_t dst = (((i0*n[1] + i1)*n[2] + i2)*n[3] + i3)*n[4] + i4;
+            C[2*dst] = vals[2*src]; C[2*dst+1] = vals[2*src+1];
+          }
+  double norm2 = 0.0;
+  for (double x : C) norm2 += x*x;
+  // Per-step truncation budget delta^2 = tol^2 ||A||^2 / (d-1); the squared step errors add
+  // up to a bound on ||A - A_tt||_F^2
+  const double delta2 = rel_tol * rel_tol * norm2 / 5.0;
+
+  tt.m_ranks[0] = 1;
+  double err2 = 0.0;
+  bool capped = false;
+  for (int k = 0; k < 5; ++k) {
+    const std::size_t m = tt.m_ranks[k] * n[k];
+    const std::size_t M = C.size() / m;
+    Truncation t = truncated_svd(C, m, M, delta2, max_rank, 0x9e3779b97f4a7c15ull + static_cast<std::uint64_t>(k));
+    capped = capped || (t.err2 > delta2);
+    err2 += t.err2;
+    tt.m_ranks[k+1] = t.rank;
+    tt.m_cores[k] = std::move(t.left);
+    C = std::move(t.rest); // next unfolding
+  }
+  tt.m_ranks[6] = 1;
+  tt.m_cores[5] = C; // r_5 x 2
+  tt.m_fit_error = norm2 > 0.0 ? std::sqrt(err2 / norm2) : 0.0;
+  if (capped && tt.m_fit_error > rel_tol) {
+    if (err) {
+      *err = "TT fit hit the rank cap " + std::to_string(max_rank) + ": relative error " + std::to_string(tt.m_fit_error) +
+             " exceeds tolerance " + std::to_string(rel_tol);
+    }
+    return std::nullopt;
+  }
+  return tt;
+}
+
+std::size_t KernelTT::bytes() const {
+  std::size_t b = 0;
+  for (const auto& c : m_cores) b += c.size() * sizeof(double);
+  for (const auto& a : m_axes) b += a.v.size() * sizeof(double);
+  return b;
+}
+
+bool KernelTT::is_tt_file(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  char magic[8] = {};
+  in.read(magic, sizeof(magic));
+  return in.gcount() == sizeof(magic) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool KernelTT::save(const std::string& path) const {
+  std::ofstream out(path, std::ios::binary);
+  if (!out) return false;
+  TTHeader h{};
+  std::memcpy(h.magic, kMagic, sizeof(kMagic));
+  h.version = kVersion;
+  for (int k = 0; k < 6; ++k) h.dims[k] = static_cast<std::uint32_t>(mode_size(k));
+  for (int k = 0; k < 7; ++k) h.ranks[k] = static_cast<std::uint32_t>(m_ranks[k]);
+  out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+  for (const auto& a : m_axes) out.write(reinterpret_cast<const char*>(a.v.data()), a.v.size() * sizeof(double));
+  for (const auto& c : m_cores) out.write(reinterpret_cast<const char*>(c.data()), c.size() * sizeof(double));
+  return static_cast<bool>(out);
+}
+
+bool KernelTT::load(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return false;
+  TTHeader h{};
+  in.read(reinterpret_cast<char*>(&h), sizeof(h));
+  if (!in || std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion) return false;
+  if (h.dims[5] != 2 || h.ranks[0] != 1 || h.ranks[6] != 1) return false;
+  for (int k = 0; k < 7; ++k) {
+    if (h.ranks[k] == 0 || h.ranks[k] > kMaxRank) return false;
+    m_ranks[k] = h.ranks[k];
+  }
+  for (int k = 0; k < 5; ++k) {
+    if (h.dims[k] == 0) return false;
+    m_axes[k].v.resize(h.dims[k]);
+    in.read(reinterpret_cast<char*>(m_axes[k].v.data()), h.dims[k] * sizeof(double));
+    m_axes[k].classify();
+  }
+  for (int k = 0; k < 6; ++k) {
+    m_cores[k].resize(m_ranks[k] * h.dims[k] * m_ranks[k+1]);
+    in.read(reinterpret_cast<char*>(m_cores[k].data()), m_cores[k].size() * sizeof(double));
+  }
+  return static_cast<bool>(in);
+}
+
+std::tuple<double,double> KernelTT::query(double theta, double Ma, double tau, double an, double at) const {
+  const double x[5] = {theta, Ma, tau, an, at};
+  double v[kMaxRank], w[kMaxRank];
+  v[0] = 1.0;
+  for (int k = 0; k < 5; ++k) {
+    std::size_t i, di; double f;
+    locate(m_axes[k], x[k], i, di, f);
+    const std::size_t r0 = m_ranks[k], r1 = m_ranks[k+1], nk = mode_size(k);
+    const double* G = m_cores[k].data();
+    std::fill(w, w + r1, 0.0);
+    for (std::size_t a = 0; a < r0; ++a) {
+      const double* g0 = G + (a*nk + i) * r1;
+      const double* g1 = G + (a*nk + i + di) * r1;
+      const double va0 = v[a] * (1.0 - f), va1 = v[a] * f;
+      for (std::size_t b = 0; b < r1; ++b) w[b] += va0 * g0[b] + va1 * g1[b];
+    }
+    std::copy(w, w + r1, v);
+  }
+  const double* G5 = m_cores[5].data();
+  double CN = 0.0, CT = 0.0;
+  for (std::size_t a = 0; a < m_ranks[5]; ++a) { CN += v[a] * G5[2*a]; CT += v[a] * G5[2*a+1]; }
+  return {CN, CT};
+}
+
+void KernelTT::slice(int k, double x, std::vector<double>& out) const {
+  std::size_t i, di; double f;
+  locate(m_axes[k], x, i, di, f);
+  const std::size_t r0 = m_ranks[k], r1 = m_ranks[k+1], nk = mode_size(k);
+  const double* G = m_cores[k].data();
+  out.resize(r0 * r1);
+  for (std::size_t a = 0; a < r0; ++a)
+    for (std::size_t b = 0; b < r1; ++b)
+      out[a*r1 + b] = (1.0 - f) * G[(a*nk + i)*r1 + b] + f * G[(a*nk + i + di)*r1 + b];
+}
+
+void KernelTT::contract_right(int k, const double* x, std::vector<double>& out) const {
+  out = m_cores[5]; // r_5 x 2
+  std::vector<double> M, next;
+  for (int j = 4; j >= k; --j) {
+    slice(j, x[j], M);
+    const std::size_t r0 = m_ranks[j], r1 = m_ranks[j+1];
+    next.assign(r0 * 2, 0.0);
+    for (std::size_t a = 0; a < r0; ++a)
+      for (std::size_t b = 0; b < r1; ++b) {
+        next[2*a]   += M[a*r1 + b] * out[2*b];
+        next[2*a+1] += M[a*r1 + b] * out[2*b+1];
+      }
+    out.swap(next);
+  }
+}
+
+void KernelTT::query_theta_batch(std::span<const double> theta, double Ma, double tau, double an, double at,
+                                 double* CN, double* CT) const {
+  const double x[5] = {0.0, Ma, tau, an, at};
+  std::vector<double> R; // r_1 x 2
+  contract_right(1, x, R);
+  // Project every theta node of core 0 onto R once, then interpolate the 2-vectors
+  const std::size_t n0 = mode_size(0), r1 = m_ranks[1];
+  const double* G = m_cores[0].data();
+  std::vector<double> line(2 * n0, 0.0);
+  for (std::size_t i = 0; i < n0; ++i)
+    for (std::size_t b = 0; b < r1; ++b) { line[2*i] += G[i*r1 + b] * R[2*b]; line[2*i+1] += G[i*r1 + b] * R[2*b+1]; }
+  for (std::size_t q = 0; q < theta.size(); ++q) {
+    std::size_t i, di; double f;
+    locate(m_axes[0], theta[q], i, di, f);
+    CN[q] = (1.0 - f) * line[2*i]   + f * line[2*(i+di)];
+    CT[q] = (1.0 - f) * line[2*i+1] + f * line[2*(i+di)+1];
+  }
+}
+
+} // namespace fmx::gsi
@@ -0,0 +1,59 @@
+// Tensor-train (TT) compressed GSI kernel: low-rank form of a dense KernelSet grid
+#pragma once
+
+#include <array>
+#include <optional>
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "gsi/KernelSet.hpp"
+
+namespace fmx::gsi {
+
+// The dense grid A(theta, Ma, tau, alpha_n, alpha_t, c) with c in {CN, CT} is stored as
+// six cores G_k of shape (r_{k-1}, n_k, r_k), r_0 = r_6 = 1. Multilinear interpolation of
+// A is exactly the contraction of the per-axis linearly interpolated core slices, so a
+// query costs five small (1 x r) * (r x r) products instead of 32 scattered reads.
+//
+// File format (native byte order): char magic[8] = "FMXGTT1", u32 version, u32 dims[6],
+// u32 ranks[7] (64 bytes); double axes[sum of dims 0..4]; double cores in order.
+class KernelTT {
+public:
+  // Largest TT rank fit() may use and load() accepts
+  static constexpr std::size_t kMaxRank = 256;
+  // TT-SVD of a dense grid with one randomized truncated SVD per unfolding; rel_tol bounds
+  // ||A - A_tt||_F / ||A||_F. Fails (err set, with the achieved error) when ranks capped at
+  // max_rank cannot reach rel_tol.
+  static std::optional<KernelTT> fit(const KernelSet& dense, double rel_tol, std::string* err = nullptr,
+                                     std::size_t max_rank = kMaxRank);
+
+  bool load(const std::string& path);
+  bool save(const std::string& path) const;
+  static bool is_tt_file(const std::string& path);
+
+  std::tuple<double,double> query(double theta, double Ma, double tau, double an, double at) const;
+  // Many theta at fixed remaining coordinates: the trailing cores are contracted once
+  void query_theta_batch(std::span<const double> theta, double Ma, double tau, double an, double at,
+                         double* CN, double* CT) const;
+
+  const std::array<std::size_t, 7>& ranks() const { return m_ranks; }
+  // Bound on ||A - A_tt||_F / ||A||_F from fit() (0 for tables read with load())
+  double fit_error() const { return m_fit_error; }
+  // Storage of the cores (plus axes) in bytes
+  std::size_t bytes() const;
+
+private:
+  std::array<KernelAxis, 5> m_axes;
+  std::array<std::size_t, 7> m_ranks{};
+  std::array<std::vector<double>, 6> m_cores; // core k: index (a * n_k + i) * r_k + b
+  double m_fit_error{0.0};
+
+  std::size_t mode_size(int k) const { return k < 5 ? m_axes[k].v.size() : 2; }
+  // Interpolated core slice (r_{k-1} x r_k) of axis k at coordinate x
+  void slice(int k, double x, std::vector<double>& out) const;
+  // Right-to-left contraction of cores k..5 at fixed coordinates: r_{k-1} x 2 matrix
+  void contract_right(int k, const double* x, std::vector<double>& out) const;
+};
+
+} // namespace fmx::gsi
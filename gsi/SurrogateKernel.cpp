@@ -0,0 +1,163 @@
+#include "gsi/SurrogateKernel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace fmx::gsi {
+
+namespace {
+
+constexpr char kMagic[8] = {'F','M','X','M','L','P','1','\0'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kBlock = 64; // samples per inference block
+
+struct MlpHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t n_layers;
+  std::uint32_t widths[SurrogateKernel::kMaxLayers + 1];
+  std::uint32_t reserved[3];
+};
+static_assert(sizeof(MlpHeader) == 64, "MLP header must be 64 bytes");
+
+} // namespace
+
+std::array<double, 5> SurrogateKernel::features(double theta, double Ma, double tau, double an, double at) {
+  return {theta, std::log(std::max(1e-6, Ma)), tau, an, at};
+}
+
+bool SurrogateKernel::set_network(std::vector<MlpLayer> layers,
+                                  const std::array<double, 5>& in_shift, const std::array<double, 5>& in_scale,
+                                  const std::array<double, 2>& out_shift, const std::array<double, 2>& out_scale) {
+  if (layers.empty() || layers.size() > kMaxLayers) return false;
+  if (layers.front().in != kInputs || layers.back().out != kOutputs) return false;
+  std::size_t wmax = kInputs;
+  for (std::size_t l = 0; l < layers.size(); ++l) {
+    const auto& L = layers[l];
+    if (L.in == 0 || L.out == 0) return false;
+    if (l > 0 && L.in != layers[l-1].out) return false;
+    if (L.W.size() != std::size_t(L.in) * L.out || L.b.size() != L.out) return false;
+    wmax = std::max<std::size_t>(wmax, L.out);
+  }
+  m_layers = std::move(layers);
+  m_in_shift = in_shift; m_in_scale = in_scale;
+  m_out_shift = out_shift; m_out_scale = out_scale;
+  m_max_width = wmax;
+  return true;
+}
+
+std::size_t SurrogateKernel::parameter_count() const {
+  std::size_t n = 0;
+  for (const auto& L : m_layers) n += L.W.size() + L.b.size();
+  return n;
+}
+
+bool SurrogateKernel::save(const std::string& path) const {
+  if (!valid()) return false;
+  std::ofstream out(path, std::ios::binary);
+  if (!out) return false;
+  MlpHeader h{};
+  std::memcpy(h.magic, kMagic, sizeof(kMagic));
+  h.version = kVersion;
+  h.n_layers = static_cast<std::uint32_t>(m_layers.size());
+  h.widths[0] = m_layers.front().in;
+  for (std::size_t l = 0; l < m_layers.size(); ++l) h.widths[l+1] = m_layers[l].out;
+  out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+  out.write(reinterpret_cast<const char*>(m_in_shift.data()), sizeof(m_in_shift));
+  out.write(reinterpret_cast<const char*>(m_in_scale.data()), sizeof(m_in_scale));
+  out.write(reinterpret_cast<const char*>(m_out_shift.data()), sizeof(m_out_shift));
+  out.write(reinterpret_cast<const char*>(m_out_scale.data()), sizeof(m_out_scale));
+  for (const auto& L : m_layers) {
+    out.write(reinterpret_cast<const char*>(L.W.data()), L.W.size() * sizeof(float));
+    out.write(reinterpret_cast<const char*>(L.b.data()), L.b.size() * sizeof(float));
+  }
+  return static_cast<bool>(out);
+}
+
+bool SurrogateKernel::load(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return false;
+  MlpHeader h{};
+  in.read(reinterpret_cast<char*>(&h), sizeof(h));
+  if (!in || std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion) return false;
+  if (h.n_layers == 0 || h.n_layers > kMaxLayers) return false;
+  std::array<double, 5> is{}, ic{};
+  std::array<double, 2> os{}, oc{};
+  in.read(reinterpret_cast<char*>(is.data()), sizeof(is));
+  in.read(reinterpret_cast<char*>(ic.data()), sizeof(ic));
+  in.read(reinterpret_cast<char*>(os.data()), sizeof(os));
+  in.read(reinterpret_cast<char*>(oc.data()), sizeof(oc));
+  std::vector<MlpLayer> layers(h.n_layers);
+  for (std::uint32_t l = 0; l < h.n_layers; ++l) {
+    auto& L = layers[l];
+    L.in = h.widths[l]; L.out = h.widths[l+1];
+    if (L.in == 0 || L.out == 0 || L.in > 4096 || L.out > 4096) return false;
+    L.W.resize(std::size_t(L.in) * L.out); L.b.resize(L.out);
+    in.read(reinterpret_cast<char*>(L.W.data()), L.W.size() * sizeof(float));
+    in.read(reinterpret_cast<char*>(L.b.data()), L.b.size() * sizeof(float));
+  }
+  if (!in) return false;
+  return set_network(std::move(layers), is, ic, os, oc);
+}
+
+template <typename Fill>
+void SurrogateKernel::run_blocks(std::size_t n, Fill fill, double* CN, double* CT) const {
+  if (!valid()) { std::fill(CN, CN + n, 0.0); std::fill(CT, CT + n, 0.0); return; }
+  std::vector<float> a(m_max_width * kBlock), b(m_max_width * kBlock);
+  for (std::size_t i0 = 0; i0 < n; i0 += kBlock) {
+    const std::size_t cnt = std::min(kBlock, n - i0);
+    fill(i0, cnt, a.data());
+    for (std::size_t l = 0; l < m_layers.size(); ++l) {
+      const auto& L = m_layers[l];
+      const bool hidden = (l + 1 < m_layers.size());
+      for (std::uint32_t o = 0; o < L.out; ++o) {
+        float* acc = &b[o * kBlock];
+        const float bias = L.b[o];
+        for (std::size_t s = 0; s < kBlock; ++s) acc[s] = bias;
+        const float* w = &L.W[std::size_t(o) * L.in];
+        for (std::uint32_t k = 0; k < L.in; ++k) {
+          const float wk = w[k];
+          const float* x = &a[k * kBlock];
+          for (std::size_t s = 0; s < kBlock; ++s) acc[s] += wk * x[s];
+        }
+        if (hidden) for (std::size_t s = 0; s < kBlock; ++s) acc[s] = mlp_activation(acc[s]);
+      }
+      a.swap(b);
+    }
+    for (std::size_t s = 0; s < cnt; ++s) {
+      CN[i0 + s] = a[s] * m_out_scale[0] + m_out_shift[0];
+      CT[i0 + s] = a[kBlock + s] * m_out_scale[1] + m_out_shift[1];
+    }
+  }
+}
+
+void SurrogateKernel::evaluate(std::size_t n, const double* theta, const double* Ma, const double* tau,
+                               const double* an, const double* at, double* CN, double* CT) const {
+  run_blocks(n, [&](std::size_t i0, std::size_t cnt, float* x) {
+    for (std::size_t s = 0; s < kBlock; ++s) {
+      const std::size_t i = i0 + std::min(s, cnt - 1); // pad the tail block with the last sample
+      const auto f = features(theta[i], Ma[i], tau[i], an[i], at[i]);
+      for (int k = 0; k < kInputs; ++k) x[k * kBlock + s] = static_cast<float>((f[k] - m_in_shift[k]) * m_in_scale[k]);
+    }
+  }, CN, CT);
+}
+
+void SurrogateKernel::query_theta_batch(std::span<const double> theta, double Ma, double tau, double an, double at,
+                                        double* CN, double* CT) const {
+  const auto f = features(0.0, Ma, tau, an, at);
+  run_blocks(theta.size(), [&](std::size_t i0, std::size_t cnt, float* x) {
+    for (std::size_t s = 0; s < kBlock; ++s) {
+      x[s] = static_cast<float>((theta[i0 + std::min(s, cnt - 1)] - m_in_shift[0]) * m_in_scale[0]);
+      for (int k = 1; k < kInputs; ++k) x[k * kBlock + s] = static_cast<float>((f[k] - m_in_shift[k]) * m_in_scale[k]);
+    }
+  }, CN, CT);
+}
+
+std::tuple<double,double> SurrogateKernel::query(double theta, double Ma, double tau, double an, double at) const {
+  double CN = 0.0, CT = 0.0;
+  evaluate(1, &theta, &Ma, &tau, &an, &at, &CN, &CT);
+  return {CN, CT};
+}
+
+} // namespace fmx::gsi
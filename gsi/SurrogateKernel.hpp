@@ -0,0 +1,92 @@
+// GSI SurrogateKernel: small dense network (theta, Ma, tau, alpha_n, alpha_t) -> (C_N, C_T)
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace fmx::gsi {
+
+// Hidden-layer activation: clamped [7/6] Pade form of tanh (within 1e-4 of tanh, exactly
+// saturating at |x| = 4.97). Branch-free so activation loops vectorize; the fitter trains
+// with this same function, so inference reproduces the trained network.
+template <typename T>
+inline T mlp_activation(T x) {
+  x = std::clamp(x, T(-4.97), T(4.97));
+  const T x2 = x * x;
+  const T p = x * (T(135135) + x2 * (T(17325) + x2 * (T(378) + x2)));
+  const T q = T(135135) + x2 * (T(62370) + x2 * (T(3150) + T(28) * x2));
+  return p / q;
+}
+// d(mlp_activation)/dx
+template <typename T>
+inline T mlp_activation_grad(T x) {
+  if (x <= T(-4.97) || x >= T(4.97)) return T(0);
+  const T x2 = x * x;
+  const T p = x * (T(135135) + x2 * (T(17325) + x2 * (T(378) + x2)));
+  const T dp = T(135135) + x2 * (T(51975) + x2 * (T(1890) + T(7) * x2));
+  const T q = T(135135) + x2 * (T(62370) + x2 * (T(3150) + T(28) * x2));
+  const T dq = x * (T(124740) + x2 * (T(12600) + T(168) * x2));
+  return (dp * q - p * dq) / (q * q);
+}
+
+// Fully connected layer, W row-major (out x in)
+struct MlpLayer {
+  std::uint32_t in{0}, out{0};
+  std::vector<float> W;
+  std::vector<float> b;
+};
+
+// Network input features are (theta, ln Ma, tau, alpha_n, alpha_t), standardized with
+// in_shift/in_scale (x' = (x - shift) * scale). Hidden layers use mlp_activation, the output layer
+// is linear and de-standardized with out_shift/out_scale (y = y' * scale + shift).
+//
+// Weight file (native byte order):
+//   header (64 bytes): char magic[8] = "FMXMLP1", u32 version, u32 n_layers,
+//                      u32 widths[kMaxLayers + 1], u32 reserved[3]
+//   double in_shift[5], in_scale[5], out_shift[2], out_scale[2]
+//   per layer: float W[out * in], float b[out]
+class SurrogateKernel {
+public:
+  static constexpr int kInputs = 5;
+  static constexpr int kOutputs = 2;
+  static constexpr std::size_t kMaxLayers = 8;
+
+  bool load(const std::string& path);
+  bool save(const std::string& path) const;
+  // Install a network; layer widths must chain from kInputs to kOutputs
+  bool set_network(std::vector<MlpLayer> layers,
+                   const std::array<double, 5>& in_shift, const std::array<double, 5>& in_scale,
+                   const std::array<double, 2>& out_shift, const std::array<double, 2>& out_scale);
+  bool valid() const { return !m_layers.empty(); }
+  std::size_t parameter_count() const;
+
+  // Raw (unstandardized) input features of one query
+  static std::array<double, 5> features(double theta, double Ma, double tau, double an, double at);
+
+  std::tuple<double,double> query(double theta, double Ma, double tau, double an, double at) const;
+  // Batched inference over n structure-of-arrays inputs. Samples are processed in blocks
+  // with activations stored neuron-major, so every layer is a sequence of contiguous
+  // multiply-adds over the block that the compiler vectorizes.
+  void evaluate(std::size_t n, const double* theta, const double* Ma, const double* tau,
+                const double* an, const double* at, double* CN, double* CT) const;
+  // Same interface as KernelSet::query_theta_batch
+  void query_theta_batch(std::span<const double> theta, double Ma, double tau, double an, double at,
+                         double* CN, double* CT) const;
+
+private:
+  std::vector<MlpLayer> m_layers;
+  std::array<double, 5> m_in_shift{}, m_in_scale{};
+  std::array<double, 2> m_out_shift{}, m_out_scale{};
+  std::size_t m_max_width{0};
+
+  // Block driver: fill(i0, count, x) writes standardized features of samples i0.. as x[k * kBlock + s]
+  template <typename Fill>
+  void run_blocks(std::size_t n, Fill fill, double* CN, double* CT) const;
+};
+
+} // namespace fmx::gsi
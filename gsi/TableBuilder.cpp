@@ -0,0 +1,98 @@
+#include "gsi/TableBuilder.hpp"
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+
+namespace fmx::gsi {
+
+namespace {
+
+// Decode a flat node index (theta fastest) into per-axis indices
+inline void unflatten(std::size_t flat, const std::size_t dims[5], std::size_t idx[5]) {
+  for (int d = 0; d < 5; ++d) { idx[d] = flat % dims[d]; flat /= dims[d]; }
+}
+
+} // namespace
+
+std::vector<double> fill_grid(const GridAxes& ax, const GridModel& model) {
+  const std::size_t dims[5] = {ax[0].size(), ax[1].size(), ax[2].size(), ax[3].size(), ax[4].size()};
+  const std::size_t total = dims[0]*dims[1]*dims[2]*dims[3]*dims[4];
+  std::vector<double> cnct(2*total);
+#if defined(FMX_USE_OPENMP)
+  #pragma omp parallel for schedule(dynamic, 256)
+#endif
+  for (long long n = 0; n < static_cast<long long>(total); ++n) {
+    std::size_t idx[5]; unflatten(static_cast<std::size_t>(n), dims, idx);
+    const double x[5] = {ax[0][idx[0]], ax[1][idx[1]], ax[2][idx[2]], ax[3][idx[3]], ax[4][idx[4]]};
+    auto [CN, CT] = model(x);
+    cnct[2*n] = CN; cnct[2*n+1] = CT;
+  }
+  return cnct;
+}
+
+AxisError midpoint_error(const GridAxes& ax, int d, const KernelSet& ks, const GridModel& model) {
+  AxisError e;
+  const std::size_t nd = ax[d].size();
+  if (nd < 2) return e;
+  std::size_t dims[5] = {ax[0].size(), ax[1].size(), ax[2].size(), ax[3].size(), ax[4].size()};
+  dims[d] = nd - 1;
+  const std::size_t total = dims[0]*dims[1]*dims[2]*dims[3]*dims[4];
+  std::vector<double> err(total);
+#if defined(FMX_USE_OPENMP)
+  #pragma omp parallel for schedule(dynamic, 256)
+#endif
+  for (long long n = 0; n < static_cast<long long>(total); ++n) {
+    std::size_t idx[5]; unflatten(static_cast<std::size_t>(n), dims, idx);
+    double x[5];
+    for (int k = 0; k < 5; ++k) x[k] = ax[k][idx[k]];
+    x[d] = 0.5 * (ax[d][idx[d]] + ax[d][idx[d]+1]);
+    auto [CN, CT] = model(x);
+    auto [CNi, CTi] = ks.query(x[0], x[1], x[2], x[3], x[4]);
+    err[n] = std::max(std::abs(CN - CNi), std::abs(CT - CTi));
+  }
+  e.interval_max.assign(nd - 1, 0.0);
+  double sum2 = 0.0;
+  for (std::size_t n = 0; n < total; ++n) {
+    std::size_t idx[5]; unflatten(n, dims, idx);
+    e.interval_max[idx[d]] = std::max(e.interval_max[idx[d]], err[n]);
+    e.max = std::max(e.max, err[n]);
+    sum2 += err[n]*err[n];
+  }
+  e.rms = total ? std::sqrt(sum2 / static_cast<double>(total)) : 0.0;
+  return e;
+}
+
+bool build_table(GridAxes& ax, const GridModel& model, const RefineOptions& opt, KernelSet& ks,
+                 std::array<AxisError, 5>* errs, std::string* err, std::ostream* log) {
+  auto fail = [&](const std::string& msg) { if (err) *err = msg; return false; };
+  for (auto& a : ax) { std::sort(a.begin(), a.end()); a.erase(std::unique(a.begin(), a.end()), a.end()); }
+  if (!ks.set_grid(ax, fill_grid(ax, model))) return fail("grid rejected (empty axis or size mismatch)");
+  if (!opt.adaptive && !opt.report) return true;
+  std::array<AxisError, 5> e;
+  for (int iter = 0; ; ++iter) {
+    for (int d = 0; d < 5; ++d) e[d] = midpoint_error(ax, d, ks, model);
+    if (!opt.adaptive || iter >= opt.max_iter) break;
+    // Insert midpoints of every interval above tolerance (axes capped at max_nodes)
+    bool refined = false;
+    for (int d = 0; d < 5; ++d) {
+      std::vector<double> next;
+      next.reserve(2*ax[d].size());
+      for (std::size_t j = 0; j < ax[d].size(); ++j) {
+        next.push_back(ax[d][j]);
+        if (j+1 < ax[d].size() && e[d].interval_max[j] > opt.tol && next.size() + (ax[d].size() - j) < opt.max_nodes)
+          next.push_back(0.5 * (ax[d][j] + ax[d][j+1]));
+      }
+      if (next.size() != ax[d].size()) { ax[d].swap(next); refined = true; }
+    }
+    if (!refined) break;
+    if (!ks.set_grid(ax, fill_grid(ax, model))) return fail("refined grid rejected");
+    if (log) {
+      *log << "refine " << iter+1 << ": " << ax[0].size() << "x" << ax[1].size() << "x" << ax[2].size() << "x"
+           << ax[3].size() << "x" << ax[4].size() << "\n";
+    }
+  }
+  if (errs) *errs = e;
+  return true;
+}
+
+} // namespace fmx::gsi
@@ -0,0 +1,45 @@
+// Grid table builder: fills (theta, Ma, tau, alpha_n, alpha_t) grids from a coefficient model
+// and refines axes where multilinear interpolation misses the model (used by gen_gsi_table)
+#pragma once
+
+#include <array>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+#include "gsi/KernelSet.hpp"
+
+namespace fmx::gsi {
+
+using GridAxes = std::array<std::vector<double>, 5>;
+// (CN, CT) at x = {theta, Ma, tau, alpha_n, alpha_t}; called concurrently in OpenMP builds
+using GridModel = std::function<std::pair<double,double>(const double x[5])>;
+
+struct AxisError {
+  std::vector<double> interval_max; // max midpoint error per interval
+  double max{0.0}, rms{0.0};
+};
+
+struct RefineOptions {
+  bool adaptive{false};        // insert axis midpoints until every midpoint error is below tol
+  bool report{false};          // measure per-axis midpoint errors of the final table
+  double tol{1e-3};            // absolute, max of |dCN|, |dCT|
+  int max_iter{8};
+  std::size_t max_nodes{512};  // per axis
+};
+
+// Evaluate all grid nodes, CN/CT interleaved in KernelSet order (theta fastest)
+std::vector<double> fill_grid(const GridAxes& ax, const GridModel& model);
+
+// Interpolation error of ks at the midpoints of every interval of axis d, with the remaining
+// axes at their nodes
+AxisError midpoint_error(const GridAxes& ax, int d, const KernelSet& ks, const GridModel& model);
+
+// Fill ax (sorted and deduplicated in place), install it in ks and, with opt.adaptive, refine
+// it; errs receives the final per-axis errors when adaptive or report is set. Refinement
+// progress goes to log when given. Returns false (err set) when ks rejects a grid.
+bool build_table(GridAxes& ax, const GridModel& model, const RefineOptions& opt, KernelSet& ks,
+                 std::array<AxisError, 5>* errs = nullptr, std::string* err = nullptr, std::ostream* log = nullptr);
+
+} // namespace fmx::gsi
@@ -0,0 +1,158 @@
+#include "solver/Executor.hpp"
+#include <algorithm>
+#include "core/Trace.hpp"
+
+namespace fmx::solver {
+
+namespace {
+thread_local const Executor* t_inside = nullptr; // executor whose task this thread is running
+thread_local unsigned t_slot = 0;                 // participant index within t_inside
+
+// Sets the calling thread's task context for one scope and restores the previous one
+struct ContextGuard {
+  const Executor* outer{t_inside};
+  unsigned outer_slot{t_slot};
+  ContextGuard(const Executor* ex, unsigned slot) { t_inside = ex; t_slot = slot; }
+  ~ContextGuard() { t_inside = outer; t_slot = outer_slot; }
+  ContextGuard(const ContextGuard&) = delete;
+  ContextGuard& operator=(const ContextGuard&) = delete;
+};
+}
+
+Executor::Executor(unsigned threads) {
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  m_ranges = std::make_unique<Range[]>(threads);
+  m_workers.reserve(threads - 1);
+  for (unsigned w = 1; w < threads; ++w) m_workers.emplace_back([this, w] { worker_loop(w); });
+}
+
+Executor::~Executor() {
+  {
+    std::lock_guard<std::mutex> lk(m_mu);
+    m_stop = true;
+  }
+  m_wake.notify_all();
+  for (auto& t : m_workers) t.join();
+}
+
+bool Executor::pop_chunk(unsigned slot, std::size_t& b, std::size_t& e) {
+  Range& r = m_ranges[slot];
+  std::lock_guard<std::mutex> lk(r.mu);
+  if (r.begin >= r.end) return false;
+  b = r.begin;
+  e = std::min(r.end, r.begin + m_grain);
+  r.begin = e;
+  return true;
+}
+
+bool Executor::steal(unsigned slot) {
+  const unsigned T = threads();
+  for (;;) {
+    // Victim: the participant with the most remaining work
+    unsigned victim = slot;
+    std::size_t most = 0;
+    for (unsigned k = 1; k < T; ++k) {
+      const unsigned v = (slot + k) % T;
+      std::lock_guard<std::mutex> lk(m_ranges[v].mu);
+      const std::size_t left = m_ranges[v].end - m_ranges[v].begin;
+      if (left > most) { most = left; victim = v; }
+    }
+    if (victim == slot) return false;
+    std::size_t b, e;
+    {
+      Range& r = m_ranges[victim];
+      std::lock_guard<std::mutex> lk(r.mu);
+      const std::size_t left = r.end - r.begin;
+      if (left == 0) continue; // drained meanwhile: look again
+      // Take the back half (all of it if only one chunk is left)
+      const std::size_t take = left > m_grain ? left / 2 : left;
+      b = r.end - take; e = r.end;
+      r.end = b;
+    }
+    Range& own = m_ranges[slot];
+    std::lock_guard<std::mutex> lk(own.mu);
+    own.begin = b; own.end = e;
+    return true;
+  }
+}
+
+void Executor::participate(unsigned slot) {
+  FMX_TRACE_SCOPE("executor.participate", "executor");
+  const ContextGuard ctx(this, slot);
+  std::size_t b, e;
+  for (;;) {
+    while (pop_chunk(slot, b, e)) {
+      try {
+        (*m_fn)(b, e);
+      } catch (...) {
+        std::lock_guard<std::mutex> lk(m_mu);
+        if (!m_error) m_error = std::current_exception();
+      }
+    }
+    if (!steal(slot)) break;
+  }
+}
+
+bool Executor::inside() const { return t_inside == this; }
+
+unsigned Executor::slot() { return t_slot; }
+
+void Executor::worker_loop(unsigned slot) {
+  fmx::trace::set_thread_name("executor");
+  std::uint64_t seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lk(m_mu);
+      m_wake.wait(lk, [&] { return m_stop || m_generation != seen; });
+      if (m_stop) return;
+      seen = m_generation;
+    }
+    participate(slot);
+    {
+      std::lock_guard<std::mutex> lk(m_mu);
+      if (--m_active == 0) m_done.notify_one();
+    }
+  }
+}
+
+void Executor::parallel_for(std::size_t n, std::size_t grain, const RangeFn& fn) {
+  if (n == 0) return;
+  if (grain == 0) grain = n / (static_cast<std::size_t>(threads()) * kChunksPerThread);
+  grain = std::max<std::size_t>(grain, 1);
+  // Nested calls, single-thread executors and single-chunk loops run inline. Only a nested
+  // call is inside a task; otherwise the caller runs as participant 0 and calls made from fn
+  // may still use the workers.
+  const bool nested = t_inside == this;
+  if (nested || m_workers.empty() || n <= grain) {
+    const ContextGuard ctx(t_inside, nested ? t_slot : 0);
+    for (std::size_t b = 0; b < n; b += grain) fn(b, std::min(n, b + grain));
+    return;
+  }
+  std::lock_guard<std::mutex> job(m_job_mu);
+  const unsigned T = threads();
+  for (unsigned k = 0; k < T; ++k) {
+    std::lock_guard<std::mutex> lk(m_ranges[k].mu);
+    m_ranges[k].begin = n * k / T;
+    m_ranges[k].end = n * (k + 1) / T;
+  }
+  {
+    std::lock_guard<std::mutex> lk(m_mu);
+    m_fn = &fn;
+    m_grain = grain;
+    m_error = nullptr;
+    m_active = T - 1;
+    ++m_generation;
+  }
+  m_wake.notify_all();
+  participate(0);
+  std::exception_ptr err;
+  {
+    std::unique_lock<std::mutex> lk(m_mu);
+    m_done.wait(lk, [&] { return m_active == 0; });
+    m_fn = nullptr;
+    err = m_error;
+  }
+  if (err) std::rethrow_exception(err);
+}
+
+} // namespace fmx::solver
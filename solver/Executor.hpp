@@ -0,0 +1,74 @@
+// Work-stealing thread pool for independent index ranges (facet loops, batch cases, sample loops)
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "core/Parallel.hpp"
+
+namespace fmx::solver {
+
+// parallel_for splits [0, n) into one contiguous range per participant. Each participant
+// takes `grain`-sized chunks from the front of its own range; when it runs dry it steals the
+// back half of the largest remaining range. The calling thread participates, so an executor
+// with T threads runs T-1 background workers. Calls made from inside a task run inline
+// (no nested oversubscription); concurrent calls from other threads are serialized.
+// One executor is meant to be shared by every parallel stage of a run (solver::Input::executor,
+// batch cases, UQ samples), so nested stages reuse its threads instead of adding their own.
+class Executor : public fmx::ParallelFor {
+public:
+  using RangeFn = fmx::ParallelFor::RangeFn;
+
+  explicit Executor(unsigned threads = 0); // 0: std::thread::hardware_concurrency()
+  ~Executor();
+
+  Executor(const Executor&) = delete;
+  Executor& operator=(const Executor&) = delete;
+
+  unsigned threads() const { return static_cast<unsigned>(m_workers.size()) + 1; }
+
+  // Blocks until fn has covered [0, n); the first exception thrown by a task is rethrown.
+  // grain 0 picks about kChunksPerThread chunks per participant, enough for stealing to even
+  // out items of unequal cost without paying a lock per item.
+  void parallel_for(std::size_t n, std::size_t grain, const RangeFn& fn) override;
+
+  // True while the calling thread runs a task of this executor (its parallel_for runs inline)
+  bool inside() const;
+  // Participant index in [0, threads()) of the calling thread while it runs a task (0 outside
+  // tasks); usable to index per-participant accumulators. Inline nested calls keep the slot.
+  static unsigned slot();
+
+  static constexpr std::size_t kChunksPerThread = 8;
+
+private:
+  struct alignas(64) Range {
+    std::mutex mu;
+    std::size_t begin{0}, end{0};
+  };
+
+  void worker_loop(unsigned slot);
+  void participate(unsigned slot);
+  bool pop_chunk(unsigned slot, std::size_t& b, std::size_t& e);
+  bool steal(unsigned slot);
+
+  std::vector<std::thread> m_workers;
+  std::unique_ptr<Range[]> m_ranges;
+
+  std::mutex m_job_mu;               // one parallel_for at a time
+  std::mutex m_mu;
+  std::condition_variable m_wake, m_done;
+  const RangeFn* m_fn{nullptr};
+  std::size_t m_grain{1};
+  std::uint64_t m_generation{0};
+  unsigned m_active{0};              // background workers still in the current job
+  bool m_stop{false};
+  std::exception_ptr m_error;
+};
+
+} // namespace fmx::solver
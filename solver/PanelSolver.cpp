@@ -1,5 +1,9 @@
 #include "solver/PanelSolver.hpp"
+#include "core/Trace.hpp"
 #include "core/units.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
 #include <cmath>
 
 namespace fmx::solver {
@@ -10,128 +14,514 @@ static inline double clamp(double x, double lo, double hi) {
   return x < lo ? lo : (x > hi ? hi : x);
 }
 
-Output solve_serial(const Input& in) {
-  Output out{};
-  const Vec3 c = in.V_sat_ms - in.wind_ms; // relative velocity
-  const double c_norm = c.norm();
-  if (c_norm == 0.0) return out;
-  const Vec3 chat = c / c_norm;
+Input Input::view() const {
+  Input v;
+  v.facets_view = &facet_list();
+  v.materials = materials;
+  v.species = species;
+  v.T_K = T_K;
+  v.V_sat_ms = V_sat_ms;
+  v.wind_ms = wind_ms;
+  v.r_CG = r_CG;
+  v.occluder = occluder;
+  v.facet_tris = facet_tris;
+  v.occlusion_level = occlusion_level;
+  v.gsi_model = gsi_model;
+  v.cll_kernel = cll_kernel;
+  v.cll_surrogate = cll_surrogate;
+  v.cll_runtime = cll_runtime;
+  v.executor = executor;
+  v.reduction = reduction;
+  v.regime = regime;
+  v.regime_Kn = regime_Kn;
+  v.regime_beta = regime_beta;
+  return v;
+}
+
+namespace {
+
+// Per-(facet, species) CN/CT for tabulated or surrogate CLL kernels, evaluated in batches
+// before the facet loop: one theta batch per material and species for tables, one network
+// inference over all front-facing facets per species for the surrogate.
+struct BatchCoefficients {
+  std::size_t S{0};
+  std::vector<double> CN, CT; // index: facet * S + species
+  bool empty() const { return CN.empty(); }
+};
+
+bool uses_surrogate_batch(const Input& in) {
+  return in.gsi_model == GsiModel::CLL && !in.cll_runtime && in.cll_surrogate && in.cll_surrogate->valid();
+}
+
+bool uses_table_batch(const Input& in) {
+  return in.gsi_model == GsiModel::CLL && !in.cll_runtime && in.cll_kernel && in.cll_kernel->valid();
+}
+
+void surrogate_coefficients(const Input& in, const Vec3& chat, double c_norm, BatchCoefficients& bc, SolveStats* st) {
+  const auto& facets = in.facet_list();
+  const std::size_t N = facets.size(), S = bc.S;
+  std::vector<std::size_t> ids;
+  std::vector<double> theta, tau, an, at;
+  for (std::size_t i = 0; i < N; ++i) {
+    const auto& f = facets[i];
+    const double mu = -Vec3::dot(chat, f.n);
+    if (mu <= 0.0 || f.area <= 0.0) continue;
+    const Material mat = (f.material_id < in.materials.size()) ? in.materials[f.material_id] : Material{};
+    ids.push_back(i);
+    theta.push_back(std::acos(clamp(mu, 0.0, 1.0)));
+    tau.push_back((in.T_K > 0.0) ? (mat.Tw_K / in.T_K) : 1.0);
+    an.push_back(mat.alpha_n); at.push_back(mat.alpha_t);
+  }
+  const std::size_t n = ids.size();
+  if (st) st->gsi_surrogate += n * S;
+  std::vector<double> Ma(n), cn(n), ct(n);
+  for (std::size_t s = 0; s < S; ++s) {
+    std::fill(Ma.begin(), Ma.end(), c_norm / std::sqrt(fmx::units::k_B * in.T_K / in.species[s].mass));
+    in.cll_surrogate->evaluate(n, theta.data(), Ma.data(), tau.data(), an.data(), at.data(), cn.data(), ct.data());
+    for (std::size_t j = 0; j < n; ++j) { bc.CN[ids[j]*S + s] = cn[j]; bc.CT[ids[j]*S + s] = ct[j]; }
+  }
+}
+
+BatchCoefficients batch_coefficients(const Input& in, const Vec3& chat, double c_norm, SolveStats* st) {
+  BatchCoefficients bc;
+  const bool surrogate = uses_surrogate_batch(in);
+  if ((!surrogate && !uses_table_batch(in)) || in.species.empty()) return bc;
+  FMX_TRACE_SCOPE("gsi_prepass", "solver");
+  const auto& facets = in.facet_list();
+  const std::size_t N = facets.size(), S = in.species.size();
+  bc.S = S; bc.CN.assign(N*S, 0.0); bc.CT.assign(N*S, 0.0);
+  if (surrogate) { surrogate_coefficients(in, chat, c_norm, bc, st); return bc; }
+  // Group front-facing facets by material (ids outside the table share the default material)
+  const std::size_t NMat = in.materials.size();
+  std::vector<std::vector<std::size_t>> groups(NMat + 1);
+  for (std::size_t i = 0; i < N; ++i) {
+    const auto& f = facets[i];
+    if (-Vec3::dot(chat, f.n) <= 0.0 || f.area <= 0.0) continue;
+    groups[f.material_id < NMat ? f.material_id : NMat].push_back(i);
+  }
+  std::vector<double> theta, cn, ct;
+  for (std::size_t g = 0; g <= NMat; ++g) {
+    const auto& ids = groups[g];
+    if (ids.empty()) continue;
+    const Material mat = (g < NMat) ? in.materials[g] : Material{};
+    const double tau = (in.T_K > 0.0) ? (mat.Tw_K / in.T_K) : 1.0;
+    if (st) st->gsi_table += ids.size() * S;
+    theta.resize(ids.size()); cn.resize(ids.size()); ct.resize(ids.size());
+    for (std::size_t j = 0; j < ids.size(); ++j)
+      theta[j] = std::acos(clamp(-Vec3::dot(chat, facets[ids[j]].n), 0.0, 1.0));
+    for (std::size_t s = 0; s < S; ++s) {
+      const double Ma = c_norm / std::sqrt(fmx::units::k_B * in.T_K / in.species[s].mass);
+      in.cll_kernel->query_theta_batch(theta, Ma, tau, mat.alpha_n, mat.alpha_t, cn.data(), ct.data());
+      for (std::size_t j = 0; j < ids.size(); ++j) { bc.CN[ids[j]*S + s] = cn[j]; bc.CT[ids[j]*S + s] = ct[j]; }
+    }
+  }
+  return bc;
+}
+
+// Lit fraction of a front facet's triangle t: the sample points are the centroids of a uniform
+// k x k subdivision (k = 2^level), traced toward the free stream as one packet. Level 1 holds the
+// facet centroid; deeper levels are traced only while the points disagree. For a partly lit
+// facet r_lit receives the mean of the unblocked points.
+template <bool Count>
+double lit_fraction(const Input& in, const fmx::geom::Triangle& t, const Vec3& chat, Vec3& r_lit, SolveStats* st) {
+  const int max_level = std::min(in.occlusion_level, kMaxOcclusionLevel);
+  const Vec3 e1 = t.v1 - t.v0, e2 = t.v2 - t.v0;
+  fmx::geom::RayPacket p;
+  p.d = -chat;
+  for (int level = 1;; ++level) {
+    const int k = 1 << level;
+    const double inv_k = 1.0 / k;
+    p.n = 0;
+    for (int a = 0; a < k; ++a) {
+      for (int b = 0; a + b < k; ++b) {
+        p.o[p.n++] = t.v0 + e1 * ((a + 1.0 / 3.0) * inv_k) + e2 * ((b + 1.0 / 3.0) * inv_k);
+        if (a + b < k - 1) p.o[p.n++] = t.v0 + e1 * ((a + 2.0 / 3.0) * inv_k) + e2 * ((b + 2.0 / 3.0) * inv_k);
+      }
+    }
+    std::uint64_t hit;
+    if constexpr (Count) hit = in.occluder->any_hit_packet(p, 1e9, st->rays);
+    else hit = in.occluder->any_hit_packet(p, 1e9);
+    const int blocked = std::popcount(hit);
+    if (blocked != 0 && blocked != p.n && level < max_level) continue;
+    if (blocked == 0) return 1.0;
+    if (blocked == p.n) return 0.0;
+    Vec3 sum{0, 0, 0};
+    for (int i = 0; i < p.n; ++i) if (!(hit >> i & 1)) sum += p.o[i];
+    r_lit = sum / static_cast<double>(p.n - blocked);
+    return static_cast<double>(p.n - blocked) / p.n;
+  }
+}
 
-  for (const auto& f : in.facets) {
+// Total force on facet i and its point of action; false if the facet is back-facing,
+// degenerate or fully occluded. Shared by the serial and parallel facet loops; Count adds the
+// work to *st.
+template <bool Count>
+bool facet_force(const Input& in, std::size_t i, const Vec3& chat, double c_norm,
+                 const BatchCoefficients& bc, Vec3& Fi, Vec3& ri, SolveStats* st) {
+  const auto& facets = in.facet_list();
+  const auto& f = facets[i];
+  // Incidence cosine: mu = -c_hat · n; if <= 0, no flux on this facet (and no ray to cast)
+  double mu = -Vec3::dot(chat, f.n);
+  if (mu <= 0.0 || f.area <= 0.0) {
+    if constexpr (Count) ++st->back;
+    return false;
+  }
+  if constexpr (Count) ++st->front;
+  ri = f.r_center;
+  double lit = 1.0;
+  if (in.occluder && in.occlusion_level > 0 && in.facet_tris && in.facet_tris->size() == facets.size()) {
+    lit = lit_fraction<Count>(in, (*in.facet_tris)[i], chat, ri, st);
+    if (lit == 0.0) {
+      if constexpr (Count) ++st->occluded;
+      return false;
+    }
+    if constexpr (Count) st->partial += (lit < 1.0);
+  } else if (in.occluder) {
     // Occlusion test: cast along -chat from facet center
-    if (in.occluder) {
-      fmx::geom::Ray ray{f.r_center, (-chat)};
-      if (in.occluder->any_hit(ray, 1e9)) continue; // occluded -> no contribution
+    fmx::geom::Ray ray{f.r_center, (-chat)};
+    bool hit;
+    if constexpr (Count) hit = in.occluder->any_hit(ray, 1e9, st->rays);
+    else hit = in.occluder->any_hit(ray, 1e9);
+    if (hit) { // occluded -> no contribution
+      if constexpr (Count) ++st->occluded;
+      return false;
     }
-    // Incidence cosine: mu = -c_hat · n; if <= 0, no flux on this facet
-    double mu = -Vec3::dot(chat, f.n);
-    if (mu <= 0.0 || f.area <= 0.0) continue;
+  }
 
-    // Tangential direction: projection of -c_hat onto facet plane
-    Vec3 tvec = (-chat) - (mu) * f.n;
-    double tnorm = tvec.norm();
-    Vec3 that = (tnorm > 0.0) ? (tvec / tnorm) : Vec3{0,0,0};
+  // Tangential direction: projection of -c_hat onto facet plane
+  Vec3 tvec = (-chat) - (mu) * f.n;
+  double tnorm = tvec.norm();
+  Vec3 that = (tnorm > 0.0) ? (tvec / tnorm) : Vec3{0,0,0};
 
-    const auto& mat = (f.material_id < in.materials.size()) ? in.materials[f.material_id] : Material{};
-    const double tau = (in.T_K > 0.0) ? (mat.Tw_K / in.T_K) : 1.0;
+  const auto& mat = (f.material_id < in.materials.size()) ? in.materials[f.material_id] : Material{};
+  const double tau = (in.T_K > 0.0) ? (mat.Tw_K / in.T_K) : 1.0;
+  const double theta = std::acos(clamp(mu, 0.0, 1.0));
 
-    Vec3 Fi{0,0,0};
-    for (const auto& sp : in.species) {
-      const double Ma = c_norm / std::sqrt(fmx::units::k_B * in.T_K / sp.mass);
-      double theta = std::acos(clamp(mu, 0.0, 1.0));
-      double CN=0.0, CT=0.0;
-      if (in.gsi_model == GsiModel::Sentman) {
-        std::tie(CN, CT) = fmx::gsi::coefficients(theta, Ma, tau, fmx::gsi::SentmanParams{mat.alpha_E});
+  Fi = Vec3{0,0,0};
+  for (std::size_t s = 0; s < in.species.size(); ++s) {
+    const auto& sp = in.species[s];
+    const double Ma = c_norm / std::sqrt(fmx::units::k_B * in.T_K / sp.mass);
+    double CN=0.0, CT=0.0;
+    if (in.gsi_model == GsiModel::Sentman) {
+      if constexpr (Count) ++st->gsi_sentman;
+      std::tie(CN, CT) = fmx::gsi::coefficients(theta, Ma, tau, fmx::gsi::SentmanParams{mat.alpha_E});
+    } else {
+      if (in.cll_runtime) {
+        if constexpr (Count) ++st->gsi_runtime;
+        auto res = in.cll_runtime->query(theta, Ma, tau, mat.alpha_n, mat.alpha_t, Count ? &st->runtime : nullptr);
+        CN = res.first; CT = res.second;
+      } else if (!bc.empty()) {
+        CN = bc.CN[i*bc.S + s]; CT = bc.CT[i*bc.S + s]; // counted by the pre-pass
+      } else if (in.cll_kernel && in.cll_kernel->valid()) {
+        if constexpr (Count) ++st->gsi_table;
+        std::tie(CN, CT) = in.cll_kernel->query(theta, Ma, tau, mat.alpha_n, mat.alpha_t);
       } else {
-        if (in.cll_runtime) {
-          auto res = in.cll_runtime->query(theta, Ma, tau, mat.alpha_n, mat.alpha_t);
-          CN = res.first; CT = res.second;
-        } else if (in.cll_kernel && in.cll_kernel->valid()) {
-          std::tie(CN, CT) = in.cll_kernel->query(theta, Ma, tau, mat.alpha_n, mat.alpha_t);
-        } else {
-          std::tie(CN, CT) = fmx::gsi::coefficients(theta, Ma, tau, fmx::gsi::CLLParams{mat.alpha_n, mat.alpha_t});
-        }
+        if constexpr (Count) ++st->gsi_cll_closed_form;
+        std::tie(CN, CT) = fmx::gsi::coefficients(theta, Ma, tau, fmx::gsi::CLLParams{mat.alpha_n, mat.alpha_t});
       }
-      // Regime per-facet blending (optional)
-      if (in.regime && in.regime->enabled && in.regime->corr_mode == RegimeConfig::CorrMode::PerFacet) {
-        double theta = std::acos(clamp(mu, 0.0, 1.0));
-        double sN = 1.0 / (1.0 + in.regime->aN * std::pow(std::max(1e-12, in.regime_Kn), in.regime->bN) * std::sin(theta));
-        double sT = 1.0 / (1.0 + in.regime->aT * std::pow(std::max(1e-12, in.regime_Kn), in.regime->bT) * std::sin(theta));
-        double effN = (1.0 - in.regime_beta) + in.regime_beta * sN;
-        double effT = (1.0 - in.regime_beta) + in.regime_beta * sT;
-        CN *= effN; CT *= effT;
-      }
-      const double p_inf = sp.rho * c_norm * c_norm;
-      Vec3 dF = (f.n * (CN) + that * (CT)) * (p_inf * f.area);
-      Fi += dF;
     }
+    // Regime per-facet blending (optional)
+    if (in.regime && in.regime->enabled && in.regime->corr_mode == RegimeConfig::CorrMode::PerFacet) {
+      double sN = 1.0 / (1.0 + in.regime->aN * std::pow(std::max(1e-12, in.regime_Kn), in.regime->bN) * std::sin(theta));
+      double sT = 1.0 / (1.0 + in.regime->aT * std::pow(std::max(1e-12, in.regime_Kn), in.regime->bT) * std::sin(theta));
+      double effN = (1.0 - in.regime_beta) + in.regime_beta * sN;
+      double effT = (1.0 - in.regime_beta) + in.regime_beta * sT;
+      CN *= effN; CT *= effT;
+    }
+    const double p_inf = sp.rho * c_norm * c_norm;
+    Vec3 dF = (f.n * (CN) + that * (CT)) * (p_inf * f.area * lit);
+    Fi += dF;
+  }
+  return true;
+}
+
+// Front-facing facet ids in index order: the facets that cast a ray and evaluate the GSI
+std::vector<std::uint32_t> front_facets(const Input& in, const Vec3& chat) {
+  const auto& facets = in.facet_list();
+  std::vector<std::uint32_t> front;
+  front.reserve(facets.size());
+  for (std::size_t i = 0; i < facets.size(); ++i) {
+    if (-Vec3::dot(chat, facets[i].n) > 0.0 && facets[i].area > 0.0) front.push_back(static_cast<std::uint32_t>(i));
+  }
+  return front;
+}
 
+using Clock = std::chrono::steady_clock;
+
+inline double seconds_since(Clock::time_point t0) {
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+template <bool Count>
+Output solve_serial_impl(const Input& in, SolveStats* st) {
+  Output out{};
+  const Vec3 c = in.V_sat_ms - in.wind_ms; // relative velocity
+  const double c_norm = c.norm();
+  if (c_norm == 0.0) return out;
+  const Vec3 chat = c / c_norm;
+  const auto& facets = in.facet_list();
+  FMX_TRACE_SCOPE("solve_serial", "solver", static_cast<std::int64_t>(facets.size()));
+  Clock::time_point t0;
+  if constexpr (Count) t0 = Clock::now();
+  const BatchCoefficients bc = batch_coefficients(in, chat, c_norm, st);
+  if constexpr (Count) { st->prepass_s += seconds_since(t0); t0 = Clock::now(); }
+
+  for (std::size_t i = 0; i < facets.size(); ++i) {
+    Vec3 Fi, ri;
+    if (!facet_force<Count>(in, i, chat, c_norm, bc, Fi, ri, st)) continue;
     out.F += Fi;
-    Vec3 r = f.r_center - in.r_CG;
+    Vec3 r = ri - in.r_CG;
     out.M += Vec3::cross(r, Fi);
   }
+  if constexpr (Count) st->facets_s += seconds_since(t0);
 
   return out;
 }
 
-Output solve(const Input& in) {
+// Facet loop on a shared executor. Back-facing facets cost one dot product while front-facing
+// ones cast a ray and evaluate every species, so only the front-facing ids are scheduled:
+// chunks then carry comparable work and stealing absorbs the rest (occluded facets stop after
+// the ray). Each participant accumulates into its own slot.
+template <bool Count>
+Output solve_executor_impl(const Input& in, SolveStats* st) {
   const Vec3 c = in.V_sat_ms - in.wind_ms; // relative velocity
   const double c_norm = c.norm();
   if (c_norm == 0.0) return {};
   const Vec3 chat = c / c_norm;
+  const auto& facets = in.facet_list();
+  const std::size_t N = facets.size();
+  FMX_TRACE_SCOPE("solve", "solver", static_cast<std::int64_t>(N));
+  Clock::time_point t0;
+  if constexpr (Count) t0 = Clock::now();
+  const BatchCoefficients bc = batch_coefficients(in, chat, c_norm, st);
+  if constexpr (Count) { st->prepass_s += seconds_since(t0); t0 = Clock::now(); }
 
-#if defined(FMX_USE_OPENMP)
-  double Fx=0, Fy=0, Fz=0;
-  double Mx=0, My=0, Mz=0;
-  const std::size_t N = in.facets.size();
-  #pragma omp parallel for reduction(+:Fx,Fy,Fz,Mx,My,Mz)
-  for (long long i = 0; i < static_cast<long long>(N); ++i) {
-    const auto& f = in.facets[static_cast<std::size_t>(i)];
-    if (in.occluder) {
-      fmx::geom::Ray ray{f.r_center, (-chat)};
-      if (in.occluder->any_hit(ray, 1e9)) continue;
+  const std::vector<std::uint32_t> front = front_facets(in, chat);
+  if constexpr (Count) st->back += N - front.size();
+
+  struct alignas(64) Partial {
+    Vec3 F, M;
+    SolveStats stats;
+  };
+  Executor& ex = *in.executor;
+  std::vector<Partial> parts(ex.threads());
+  ex.parallel_for(front.size(), 0, [&](std::size_t b, std::size_t e) {
+    FMX_TRACE_SCOPE("facet_chunk", "solver", static_cast<std::int64_t>(e - b));
+    Partial& p = parts[Executor::slot()];
+    for (std::size_t k = b; k < e; ++k) {
+      const std::size_t i = front[k];
+      Vec3 Fi, ri;
+      if (!facet_force<Count>(in, i, chat, c_norm, bc, Fi, ri, &p.stats)) continue;
+      p.F += Fi;
+      p.M += Vec3::cross(ri - in.r_CG, Fi);
     }
+  });
+  Output out{};
+  for (const auto& p : parts) {
+    out.F += p.F; out.M += p.M;
+    if constexpr (Count) st->merge(p.stats);
+  }
+  if constexpr (Count) st->facets_s += seconds_since(t0);
+  return out;
+}
 
-    double mu = -Vec3::dot(chat, f.n);
-    if (mu <= 0.0 || f.area <= 0.0) continue;
+// Deterministic reduction. Every block of kReductionBlock front-facing facets is summed in
+// index order into its own cache-line slot; the slots are then combined pairwise in a fixed
+// tree. Which thread ran a block changes nothing, so the sum is the same for every loop.
+struct alignas(64) BlockSum {
+  double s[6]{}, c[6]{}; // F, M components and their Neumaier compensation terms
+};
 
-    Vec3 tvec = (-chat) - (mu) * f.n;
-    double tnorm = tvec.norm();
-    Vec3 that = (tnorm > 0.0) ? (tvec / tnorm) : Vec3{0,0,0};
+inline void neumaier_add(double& s, double& c, double x) {
+  const double t = s + x;
+  c += (std::abs(s) >= std::abs(x)) ? (s - t) + x : (x - t) + s;
+  s = t;
+}
 
-    const auto& mat = (f.material_id < in.materials.size()) ? in.materials[f.material_id] : Material{};
-    const double tau = (in.T_K > 0.0) ? (mat.Tw_K / in.T_K) : 1.0;
+template <bool Count>
+BlockSum sum_block(const Input& in, const std::vector<std::uint32_t>& front, std::size_t blk, const Vec3& chat,
+                   double c_norm, const BatchCoefficients& bc, SolveStats* st) {
+  const bool comp = in.reduction == Reduction::Compensated;
+  const std::size_t b = blk * kReductionBlock, e = std::min(front.size(), b + kReductionBlock);
+  BlockSum acc;
+  for (std::size_t k = b; k < e; ++k) {
+    const std::size_t i = front[k];
+    Vec3 Fi, ri;
+    if (!facet_force<Count>(in, i, chat, c_norm, bc, Fi, ri, st)) continue;
+    const Vec3 Mi = Vec3::cross(ri - in.r_CG, Fi);
+    const double v[6] = {Fi.x, Fi.y, Fi.z, Mi.x, Mi.y, Mi.z};
+    for (int j = 0; j < 6; ++j) {
+      if (comp) neumaier_add(acc.s[j], acc.c[j], v[j]);
+      else acc.s[j] += v[j];
+    }
+  }
+  return acc;
+}
 
-    double dFx=0, dFy=0, dFz=0;
-    for (const auto& sp : in.species) {
-      const double Ma = c_norm / std::sqrt(fmx::units::k_B * in.T_K / sp.mass);
-      double theta = std::acos(clamp(mu, 0.0, 1.0));
-      double CN=0.0, CT=0.0;
-      if (in.gsi_model == GsiModel::Sentman) {
-        std::tie(CN, CT) = fmx::gsi::coefficients(theta, Ma, tau, fmx::gsi::SentmanParams{mat.alpha_E});
-      } else {
-        if (in.cll_runtime) {
-          auto res = in.cll_runtime->query(theta, Ma, tau, mat.alpha_n, mat.alpha_t);
-          CN = res.first; CT = res.second;
-        } else if (in.cll_kernel && in.cll_kernel->valid()) {
-          std::tie(CN, CT) = in.cll_kernel->query(theta, Ma, tau, mat.alpha_n, mat.alpha_t);
-        } else {
-          std::tie(CN, CT) = fmx::gsi::coefficients(theta, Ma, tau, fmx::gsi::CLLParams{mat.alpha_n, mat.alpha_t});
+Output combine_blocks(std::vector<BlockSum>& blocks, bool comp) {
+  const std::size_t n = blocks.size();
+  if (n == 0) return {};
+  for (std::size_t stride = 1; stride < n; stride *= 2) {
+    for (std::size_t i = 0; i + stride < n; i += 2 * stride) {
+      BlockSum& a = blocks[i];
+      const BlockSum& b = blocks[i + stride];
+      for (int j = 0; j < 6; ++j) {
+        if (comp) { neumaier_add(a.s[j], a.c[j], b.s[j]); a.c[j] += b.c[j]; }
+        else a.s[j] += b.s[j];
+      }
+    }
+  }
+  const BlockSum& r = blocks[0];
+  return { {r.s[0] + r.c[0], r.s[1] + r.c[1], r.s[2] + r.c[2]}, {r.s[3] + r.c[3], r.s[4] + r.c[4], r.s[5] + r.c[5]} };
+}
+
+enum class Loop { Serial, Executor, OpenMP };
+
+template <bool Count, Loop L>
+Output solve_blocked_impl(const Input& in, SolveStats* st) {
+  const Vec3 c = in.V_sat_ms - in.wind_ms; // relative velocity
+  const double c_norm = c.norm();
+  if (c_norm == 0.0) return {};
+  const Vec3 chat = c / c_norm;
+  const std::size_t N = in.facet_list().size();
+  FMX_TRACE_SCOPE(L == Loop::Serial ? "solve_serial" : "solve", "solver", static_cast<std::int64_t>(N));
+  Clock::time_point t0;
+  if constexpr (Count) t0 = Clock::now();
+  const BatchCoefficients bc = batch_coefficients(in, chat, c_norm, st);
+  if constexpr (Count) { st->prepass_s += seconds_since(t0); t0 = Clock::now(); }
+
+  const std::vector<std::uint32_t> front = front_facets(in, chat);
+  if constexpr (Count) st->back += N - front.size();
+  const std::size_t nb = (front.size() + kReductionBlock - 1) / kReductionBlock;
+  std::vector<BlockSum> blocks(nb);
+  if constexpr (L == Loop::Serial) {
+    for (std::size_t blk = 0; blk < nb; ++blk) blocks[blk] = sum_block<Count>(in, front, blk, chat, c_norm, bc, st);
+  } else if constexpr (L == Loop::Executor) {
+    struct alignas(64) Local { SolveStats stats; };
+    Executor& ex = *in.executor;
+    std::vector<Local> local(Count ? ex.threads() : 0);
+    ex.parallel_for(nb, 0, [&](std::size_t b, std::size_t e) {
+      FMX_TRACE_SCOPE("facet_chunk", "solver", static_cast<std::int64_t>(e - b));
+      SolveStats* ls = Count ? &local[Executor::slot()].stats : nullptr;
+      for (std::size_t blk = b; blk < e; ++blk) blocks[blk] = sum_block<Count>(in, front, blk, chat, c_norm, bc, ls);
+    });
+    if constexpr (Count) for (const auto& l : local) st->merge(l.stats);
+  } else {
+#if defined(FMX_USE_OPENMP)
+    #pragma omp parallel
+    {
+      SolveStats local;
+      {
+        FMX_TRACE_SCOPE("facet_loop", "solver");
+        #pragma omp for schedule(dynamic) nowait
+        for (long long blk = 0; blk < static_cast<long long>(nb); ++blk) {
+          blocks[static_cast<std::size_t>(blk)] =
+              sum_block<Count>(in, front, static_cast<std::size_t>(blk), chat, c_norm, bc, &local);
         }
       }
-      const double p_inf = sp.rho * c_norm * c_norm;
-      Vec3 dF = (f.n * (CN) + that * (CT)) * (p_inf * f.area);
-      dFx += dF.x; dFy += dF.y; dFz += dF.z;
+      if constexpr (Count) {
+        #pragma omp critical(fmx_solve_stats)
+        st->merge(local);
+      }
     }
+#endif
+  }
+  const Output out = combine_blocks(blocks, in.reduction == Reduction::Compensated);
+  if constexpr (Count) st->facets_s += seconds_since(t0);
+  return out;
+}
+
+#if defined(FMX_USE_OPENMP)
+template <bool Count>
+Output solve_parallel_impl(const Input& in, SolveStats* st) {
+  const Vec3 c = in.V_sat_ms - in.wind_ms; // relative velocity
+  const double c_norm = c.norm();
+  if (c_norm == 0.0) return {};
+  const Vec3 chat = c / c_norm;
+  const auto& facets = in.facet_list();
+  const std::size_t N = facets.size();
+  FMX_TRACE_SCOPE("solve", "solver", static_cast<std::int64_t>(N));
+  Clock::time_point t0;
+  if constexpr (Count) t0 = Clock::now();
+  const BatchCoefficients bc = batch_coefficients(in, chat, c_norm, st);
+  if constexpr (Count) { st->prepass_s += seconds_since(t0); t0 = Clock::now(); }
 
-    Fx += dFx; Fy += dFy; Fz += dFz;
-    Vec3 r = f.r_center - in.r_CG;
-    Vec3 Mi = Vec3::cross(r, {dFx, dFy, dFz});
-    Mx += Mi.x; My += Mi.y; Mz += Mi.z;
+  double Fx=0, Fy=0, Fz=0;
+  double Mx=0, My=0, Mz=0;
+  #pragma omp parallel
+  {
+    // Per-thread counters, merged once at the end of the loop
+    SolveStats local;
+    {
+      // One span per thread, ending before the region's barrier so imbalance shows as a gap
+      FMX_TRACE_SCOPE("facet_loop", "solver");
+      #pragma omp for reduction(+:Fx,Fy,Fz,Mx,My,Mz) nowait
+      for (long long i = 0; i < static_cast<long long>(N); ++i) {
+        Vec3 Fi, ri;
+        if (!facet_force<Count>(in, static_cast<std::size_t>(i), chat, c_norm, bc, Fi, ri, &local)) continue;
+        Fx += Fi.x; Fy += Fi.y; Fz += Fi.z;
+        Vec3 r = ri - in.r_CG;
+        Vec3 Mi = Vec3::cross(r, Fi);
+        Mx += Mi.x; My += Mi.y; Mz += Mi.z;
+      }
+    }
+    if constexpr (Count) {
+      #pragma omp critical(fmx_solve_stats)
+      st->merge(local);
+    }
   }
+  if constexpr (Count) st->facets_s += seconds_since(t0);
   return { {Fx,Fy,Fz}, {Mx,My,Mz} };
+}
+#endif
+
+// Runs the uncounted implementation, or the counted one and adds the call's totals
+Output run(const Input& in, SolveStats* stats, Output (*plain)(const Input&, SolveStats*),
+           Output (*counted)(const Input&, SolveStats*)) {
+  if (!stats) return plain(in, nullptr);
+  const auto t0 = Clock::now();
+  const Output out = counted(in, stats);
+  ++stats->solves;
+  stats->facets += in.facet_list().size();
+  stats->total_s += seconds_since(t0);
+  return out;
+}
+
+} // namespace
+
+void SolveStats::merge(const SolveStats& o) {
+  solves += o.solves;
+  facets += o.facets; front += o.front; back += o.back; occluded += o.occluded; partial += o.partial;
+  rays.merge(o.rays);
+  gsi_sentman += o.gsi_sentman; gsi_cll_closed_form += o.gsi_cll_closed_form; gsi_table += o.gsi_table;
+  gsi_surrogate += o.gsi_surrogate; gsi_runtime += o.gsi_runtime;
+  runtime.merge(o.runtime);
+  prepass_s += o.prepass_s; facets_s += o.facets_s; total_s += o.total_s;
+}
+
+Output solve_serial(const Input& in, SolveStats* stats) {
+  if (in.reduction != Reduction::Fast) {
+    return run(in, stats, solve_blocked_impl<false, Loop::Serial>, solve_blocked_impl<true, Loop::Serial>);
+  }
+  return run(in, stats, solve_serial_impl<false>, solve_serial_impl<true>);
+}
+
+Output solve(const Input& in, SolveStats* stats) {
+  // Small meshes stay on the calling thread: handing out work costs more than a few dozen
+  // facets. Calls from the executor's own tasks are already parallel one level up.
+  constexpr std::size_t kParallelMinFacets = 64;
+  if (in.facet_list().size() < kParallelMinFacets) return solve_serial(in, stats);
+  const bool blocked = in.reduction != Reduction::Fast;
+  if (in.executor) {
+    if (in.executor->threads() == 1 || in.executor->inside()) return solve_serial(in, stats);
+    if (blocked) return run(in, stats, solve_blocked_impl<false, Loop::Executor>, solve_blocked_impl<true, Loop::Executor>);
+    return run(in, stats, solve_executor_impl<false>, solve_executor_impl<true>);
+  }
+#if defined(FMX_USE_OPENMP)
+  if (blocked) return run(in, stats, solve_blocked_impl<false, Loop::OpenMP>, solve_blocked_impl<true, Loop::OpenMP>);
+  return run(in, stats, solve_parallel_impl<false>, solve_parallel_impl<true>);
 #else
-  return solve_serial(in);
+  return solve_serial(in, stats);
 #endif
 }
 
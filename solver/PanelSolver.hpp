@@ -1,12 +1,15 @@
 // Serial panel solver (no occlusion) computing forces and moments
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include "core/types.hpp"
 #include "gsi/Sentman.hpp"
 #include "gsi/CLL.hpp"
 #include "gsi/KernelSet.hpp"
+#include "gsi/SurrogateKernel.hpp"
 #include "gsi/CLLRuntime.hpp"
+#include "solver/Executor.hpp"
 #include "solver/RegimeAdapter.hpp"
 #include "geom/Occluder.hpp"
 
@@ -14,6 +17,14 @@ namespace fmx::solver {
 
 enum class GsiModel { Sentman, CLL };
 
+// How facet loads are summed. Fast: per thread in scheduling order (the last bits change with
+// the thread count). Deterministic: front-facing facets in fixed blocks of kReductionBlock,
+// block sums combined in a fixed pairwise tree, so serial, OpenMP and executor runs agree
+// bit for bit at any thread count. Compensated: as Deterministic with Neumaier summation.
+enum class Reduction { Fast, Deterministic, Compensated };
+constexpr std::size_t kReductionBlock = 256;
+constexpr int kMaxOcclusionLevel = 3; // 64 points, one full RayPacket
+
 struct Material {
   double alpha_n{1.0};
   double alpha_t{1.0};
@@ -28,6 +39,7 @@ struct Species {
 
 struct Input {
   std::vector<fmx::Facet> facets;
+  const std::vector<fmx::Facet>* facets_view{nullptr}; // optional shared storage used instead of `facets`
   std::vector<Material> materials; // indexed by facet.material_id
   std::vector<Species> species;    // species list (e.g., O, N2, O2, He, H)
   double T_K{800.0};               // ambient temperature [K]
@@ -35,13 +47,28 @@ struct Input {
   fmx::Vec3 wind_ms{0,0,0};        // atmospheric wind in same frame
   fmx::Vec3 r_CG{0,0,0};           // center of gravity for moments
   const fmx::geom::Occluder* occluder{nullptr}; // optional occlusion
+  // Sub-facet occlusion: with facet_tris (the triangle of each facet, in facet order, e.g.
+  // Mesh::tris beside Mesh::to_facets) and occlusion_level L in 1..kMaxOcclusionLevel, a front
+  // facet is loaded in proportion to its unshadowed part instead of by one centroid ray.
+  // 4 stratified points are traced first as one packet; only facets whose points disagree are
+  // refined, to 4^2 .. 4^L points. Moments act at the centroid of the lit points.
+  const std::vector<fmx::geom::Triangle>* facet_tris{nullptr};
+  int occlusion_level{0};
   GsiModel gsi_model{GsiModel::Sentman};
   const fmx::gsi::KernelSet* cll_kernel{nullptr}; // optional CLL table
+  const fmx::gsi::SurrogateKernel* cll_surrogate{nullptr}; // optional CLL network (preferred over the table)
   fmx::gsi::CLLRuntime* cll_runtime{nullptr};     // optional CLL runtime service
+  Executor* executor{nullptr};     // optional shared pool for solve()'s facet loop (used instead of OpenMP)
+  Reduction reduction{Reduction::Fast};
   // Regime adapter (optional, per-facet blending)
   const RegimeConfig* regime{nullptr};
   double regime_Kn{0.0};
   double regime_beta{0.0};
+
+  const std::vector<fmx::Facet>& facet_list() const { return facets_view ? *facets_view : facets; }
+  // Copy of every setting except the owned facet vector; the copy views facet_list(), which
+  // must outlive it. Per-worker inputs start from this instead of a deep copy.
+  Input view() const;
 };
 
 struct Output {
@@ -49,7 +76,25 @@ struct Output {
   fmx::Vec3 M;  // total moment about CG [N*m]
 };
 
-Output solve_serial(const Input& in);
-Output solve(const Input& in);
+// Work done by solve calls; each call adds to the struct, so one instance can total a run.
+// Facet counts are per facet, gsi_* counts per facet and species (batch pre-passes included).
+// BVH node/triangle counts and CLL runtime wait times need a build with FMX_USE_STATS.
+struct SolveStats {
+  std::uint64_t solves{0};
+  std::uint64_t facets{0}, front{0}, back{0}, occluded{0}; // back includes zero-area facets; occluded are front
+  std::uint64_t partial{0};        // front facets partly shadowed (sub-facet occlusion only)
+  fmx::geom::RayStats rays;
+  std::uint64_t gsi_sentman{0}, gsi_cll_closed_form{0}, gsi_table{0}, gsi_surrogate{0}, gsi_runtime{0};
+  fmx::gsi::CLLRuntime::QueryStats runtime;
+  double prepass_s{0.0}, facets_s{0.0}, total_s{0.0}; // batch GSI pre-pass, facet loop, whole call
+
+  void merge(const SolveStats& o);
+};
+
+// stats (optional) receives the counters; without it no counting is done.
+// solve() runs the facet loop on in.executor when set (inline when called from one of its
+// tasks), else on OpenMP threads in builds with FMX_USE_OPENMP, else serially.
+Output solve_serial(const Input& in, SolveStats* stats = nullptr);
+Output solve(const Input& in, SolveStats* stats = nullptr);
 
 } // namespace fmx::solver
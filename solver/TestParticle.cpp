@@ -0,0 +1,309 @@
+#include "solver/TestParticle.hpp"
+#include "core/Trace.hpp"
+#include "core/units.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace fmx::solver {
+
+using fmx::Vec3;
+
+namespace {
+
+constexpr double kSqrtPi = 1.7724538509055160273;
+constexpr double kFar = 1e30;
+// Batches in flight between ordered facet reductions (one facet buffer each)
+constexpr std::size_t kFacetGroup = 64;
+
+using Rng = std::mt19937_64;
+
+// Uniform on (0, 1], so logarithms stay finite
+inline double uniform(Rng& rng) { return (static_cast<double>(rng() >> 11) + 1.0) * 0x1.0p-53; }
+
+// Standard normal (Box-Muller); spelled out so streams are the same with every standard library
+inline double gaussian(Rng& rng) {
+  return std::sqrt(-2.0 * std::log(uniform(rng))) * std::cos(2.0 * M_PI * uniform(rng));
+}
+
+std::uint64_t splitmix64(std::uint64_t x) {
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+// One-sided number flux through a plane per unit area, density and thermal speed
+// s = sqrt(2kT/m), for a drift speed ratio a along the plane's inward normal
+double flux_factor(double a) {
+  return (std::exp(-a * a) + kSqrtPi * a * (1.0 + std::erf(a))) / (2.0 * kSqrtPi);
+}
+
+// Inward normal speed ratio z > 0 of a molecule crossing the plane, density z e^{-(z-a)^2}.
+// Rejection from h(z) = (|z-a| + max(a,0)) e^{-(z-a)^2} >= z e^{-(z-a)^2}: a mixture of
+// |w| e^{-w^2} and a Gaussian in w = z - a, both sampled exactly on w > -a.
+double sample_inflow(double a, Rng& rng) {
+  const double ap = std::max(a, 0.0), ea = std::exp(-a * a);
+  const double w_pos = (a >= 0.0) ? 0.5 : 0.5 * ea;           // |w| e^{-w^2}, w > max(0, -a)
+  const double w_neg = (a >= 0.0) ? 0.5 * (1.0 - ea) : 0.0;    // |w| e^{-w^2}, -a < w < 0
+  const double w_gauss = ap * 0.5 * kSqrtPi * (1.0 + std::erf(a));
+  for (;;) {
+    const double pick = uniform(rng) * (w_pos + w_neg + w_gauss);
+    double w;
+    if (pick <= w_pos) {
+      const double w0 = std::max(0.0, -a);
+      w = std::sqrt(w0 * w0 - std::log(uniform(rng)));
+    } else if (pick <= w_pos + w_neg) {
+      w = -std::sqrt(-std::log(1.0 - uniform(rng) * (1.0 - ea)));
+    } else {
+      do w = gaussian(rng) * M_SQRT1_2; while (w <= -a);
+    }
+    const double z = a + w;
+    if (z > 0.0 && uniform(rng) * (std::abs(w) + ap) <= z) return z;
+  }
+}
+
+// Orthonormal tangents (t1, t2) of unit normal n; t1 along `along` when it has a tangential part
+void tangents(const Vec3& n, const Vec3& along, Vec3& t1, Vec3& t2) {
+  Vec3 t = along - n * Vec3::dot(along, n);
+  double tn = t.norm();
+  if (tn < 1e-12 * along.norm() || tn == 0.0) {
+    t = (std::abs(n.x) < 0.9) ? Vec3::cross(n, {1, 0, 0}) : Vec3::cross(n, {0, 1, 0});
+    tn = t.norm();
+  }
+  t1 = t / tn;
+  t2 = Vec3::cross(n, t1);
+}
+
+// Re-emitted velocity of a molecule of mass m arriving with velocity v at a wall with unit
+// normal n pointing back toward it
+Vec3 reflect(const Input& in, const Material& mat, double m, const Vec3& v, const Vec3& n, Rng& rng) {
+  Vec3 t1, t2;
+  tangents(n, v, t1, t2);
+  if (in.gsi_model == GsiModel::CLL) {
+    // Lord's sampling of the CLL kernel in units of the wall thermal speed; the tangential
+    // energy accommodation is alpha_t (2 - alpha_t) for momentum accommodation alpha_t
+    const double sw = std::sqrt(2.0 * fmx::units::k_B * mat.Tw_K / m);
+    const double an = std::clamp(mat.alpha_n, 0.0, 1.0);
+    const double sig = std::clamp(mat.alpha_t, 0.0, 1.0), at = sig * (2.0 - sig);
+    const double un = -Vec3::dot(v, n) / sw, ut = Vec3::dot(v, t1) / sw;
+    double r = std::sqrt(-an * std::log(uniform(rng))), phi = 2.0 * M_PI * uniform(rng);
+    const double um = std::sqrt(1.0 - an) * un;
+    const double on = std::sqrt(r * r + um * um + 2.0 * r * um * std::cos(phi));
+    r = std::sqrt(-at * std::log(uniform(rng)));
+    phi = 2.0 * M_PI * uniform(rng);
+    const double o1 = std::sqrt(1.0 - at) * ut + r * std::cos(phi), o2 = r * std::sin(phi);
+    return (n * on + t1 * o1 + t2 * o2) * sw;
+  }
+  // Diffuse at the temperature left by energy accommodation of this molecule
+  const double Tr = mat.alpha_E * mat.Tw_K + (1.0 - mat.alpha_E) * m * Vec3::dot(v, v) / (4.0 * fmx::units::k_B);
+  const double sr = std::sqrt(2.0 * fmx::units::k_B * std::max(Tr, 0.0) / m);
+  return (n * std::sqrt(-std::log(uniform(rng))) + (t1 * gaussian(rng) + t2 * gaussian(rng)) * M_SQRT1_2) * sr;
+}
+
+// Where molecules enter: one entry per (species, face of the box around the body)
+struct Source {
+  std::size_t species{0};
+  int axis{0};             // face normal axis
+  bool hi{false};          // face at box.hi (inward normal -axis) or box.lo (+axis)
+  double a{0.0};           // drift speed ratio along the inward normal
+  double flux{0.0};        // molecules per second through the face
+  double cum{0.0};         // running total for selection
+};
+
+inline double& comp(Vec3& v, int k) { return k == 0 ? v.x : (k == 1 ? v.y : v.z); }
+inline double comp(const Vec3& v, int k) { return k == 0 ? v.x : (k == 1 ? v.y : v.z); }
+
+struct Walker {
+  Vec3 o, v;
+  std::uint32_t species{0};
+  std::uint32_t hits{0};
+};
+
+struct BatchTotals {
+  double s[6]{};
+  std::uint64_t particles{0}, struck{0}, multi{0}, hits{0}, dropped{0};
+};
+
+struct Setup {
+  const Input* in{nullptr};
+  const fmx::geom::BVHOccluder* bvh{nullptr};
+  const TpmcOptions* opt{nullptr};
+  fmx::geom::Aabb box;
+  std::vector<Source> sources;
+  std::vector<double> speed;  // per species sqrt(2kT/m)
+  Vec3 U;                     // free-stream bulk velocity in the body frame
+  double weight{0.0};         // real molecules per second per test particle
+};
+
+// Traces one batch as a wavefront: all live molecules are traced back to back through the BVH,
+// then interact, and the survivors form the next wave.
+void run_batch(const Setup& su, std::size_t b, std::vector<Vec3>& facet_F, BatchTotals& tot) {
+  const Input& in = *su.in;
+  const auto& facets = in.facet_list();
+  const TpmcOptions& opt = *su.opt;
+  const std::uint64_t first = static_cast<std::uint64_t>(b) * opt.batch;
+  const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(opt.batch, opt.particles - first));
+  Rng rng(splitmix64(opt.seed ^ splitmix64(b)));
+  const double total = su.sources.back().cum;
+
+  std::vector<Walker> live(n);
+  for (auto& w : live) {
+    const double pick = uniform(rng) * total;
+    const Source& src = *std::find_if(su.sources.begin(), su.sources.end() - 1, [&](const Source& s) { return pick <= s.cum; });
+    const double sp = su.speed[src.species];
+    const int k1 = (src.axis + 1) % 3, k2 = (src.axis + 2) % 3;
+    comp(w.o, src.axis) = src.hi ? comp(su.box.hi, src.axis) : comp(su.box.lo, src.axis);
+    comp(w.o, k1) = comp(su.box.lo, k1) + uniform(rng) * (comp(su.box.hi, k1) - comp(su.box.lo, k1));
+    comp(w.o, k2) = comp(su.box.lo, k2) + uniform(rng) * (comp(su.box.hi, k2) - comp(su.box.lo, k2));
+    const double vn = sp * sample_inflow(src.a, rng);
+    comp(w.v, src.axis) = src.hi ? -vn : vn;
+    comp(w.v, k1) = comp(su.U, k1) + sp * M_SQRT1_2 * gaussian(rng);
+    comp(w.v, k2) = comp(su.U, k2) + sp * M_SQRT1_2 * gaussian(rng);
+    w.species = static_cast<std::uint32_t>(src.species);
+  }
+  tot.particles += n;
+
+  std::vector<fmx::geom::RayHit> hit(n);
+  std::vector<char> got(n);
+  while (!live.empty()) {
+    for (std::size_t k = 0; k < live.size(); ++k) {
+      got[k] = su.bvh->closest_hit(fmx::geom::Ray{live[k].o, live[k].v.normalized()}, kFar, hit[k]);
+    }
+    std::size_t keep = 0;
+    for (std::size_t k = 0; k < live.size(); ++k) {
+      if (!got[k]) continue;
+      Walker w = live[k];
+      const std::size_t fi = hit[k].tri;
+      const auto& f = facets[fi];
+      const Vec3 x = w.o + w.v.normalized() * hit[k].t;
+      // A facet struck from behind re-emits to that side
+      const Vec3 n = (Vec3::dot(w.v, f.n) > 0.0) ? -f.n : f.n;
+      const Material mat = (f.material_id < in.materials.size()) ? in.materials[f.material_id] : Material{};
+      const double m = in.species[w.species].mass;
+      const Vec3 v_out = reflect(in, mat, m, w.v, n, rng);
+      const Vec3 dF = (w.v - v_out) * (m * su.weight);
+      const Vec3 dM = Vec3::cross(x - in.r_CG, dF);
+      facet_F[fi] += dF;
+      const double d[6] = {dF.x, dF.y, dF.z, dM.x, dM.y, dM.z};
+      for (int j = 0; j < 6; ++j) tot.s[j] += d[j];
+      ++tot.hits;
+      if (++w.hits == 1) ++tot.struck;
+      else if (w.hits == 2) ++tot.multi;
+      if (static_cast<int>(w.hits) >= opt.max_hits) { ++tot.dropped; continue; }
+      w.o = x;
+      w.v = v_out;
+      live[keep++] = w;
+    }
+    live.resize(keep);
+  }
+}
+
+} // namespace
+
+std::optional<TpmcResult> solve_tpmc(const Input& in, const fmx::geom::BVHOccluder& bvh, const TpmcOptions& opt,
+                                     std::string* err) {
+  const auto& facets = in.facet_list();
+  auto fail = [&](const std::string& msg) -> std::optional<TpmcResult> { if (err) *err = msg; return std::nullopt; };
+  if (bvh.triangles().size() != facets.size()) return fail("TPMC: BVH and facet list differ in size");
+  if (facets.empty()) return fail("TPMC: empty geometry");
+  if (in.species.empty() || !(in.T_K > 0.0)) return fail("TPMC: needs species and a positive temperature");
+  if (opt.particles == 0 || opt.batch == 0 || opt.max_hits < 1) return fail("TPMC: particles, batch and max_hits must be positive");
+  FMX_TRACE_SCOPE("tpmc", "solver", static_cast<std::int64_t>(opt.particles));
+  const auto t0 = std::chrono::steady_clock::now();
+
+  Setup su;
+  su.in = &in; su.bvh = &bvh; su.opt = &opt;
+  su.U = in.wind_ms - in.V_sat_ms;
+  // Inject just outside the body so no molecule starts on a surface
+  su.box = bvh.bounds();
+  const Vec3 e = su.box.extent();
+  const double margin = 1e-3 * (e.norm() + 1.0);
+  su.box.lo = su.box.lo - Vec3{margin, margin, margin};
+  su.box.hi = su.box.hi + Vec3{margin, margin, margin};
+  const Vec3 E = su.box.extent();
+  double total = 0.0;
+  for (std::size_t s = 0; s < in.species.size(); ++s) {
+    const auto& sp = in.species[s];
+    const double speed = (sp.mass > 0.0) ? std::sqrt(2.0 * fmx::units::k_B * in.T_K / sp.mass) : 0.0;
+    su.speed.push_back(speed);
+    if (!(sp.rho > 0.0) || !(speed > 0.0)) continue;
+    for (int f = 0; f < 6; ++f) {
+      Source src;
+      src.species = s;
+      src.axis = f / 2;
+      src.hi = (f % 2) == 1;
+      src.a = (src.hi ? -comp(su.U, src.axis) : comp(su.U, src.axis)) / speed;
+      const double area = comp(E, (src.axis + 1) % 3) * comp(E, (src.axis + 2) % 3);
+      src.flux = (sp.rho / sp.mass) * speed * flux_factor(src.a) * area;
+      total += src.flux;
+      src.cum = total;
+      su.sources.push_back(src);
+    }
+  }
+  if (su.sources.empty() || !(total > 0.0)) return fail("TPMC: no molecule flux (zero densities)");
+  su.weight = total / static_cast<double>(opt.particles);
+
+  const std::size_t nb = static_cast<std::size_t>((opt.particles + opt.batch - 1) / opt.batch);
+  std::vector<BatchTotals> batches(nb);
+  TpmcResult res;
+  res.facet_F.assign(facets.size(), Vec3{0, 0, 0});
+  // Batches run in groups, each into its own zeroed facet buffer; the buffers are then added
+  // in batch order, so facet_F does not depend on the thread count either
+  std::vector<std::vector<Vec3>> group(std::min(nb, kFacetGroup), std::vector<Vec3>(facets.size()));
+  for (std::size_t g0 = 0; g0 < nb; g0 += kFacetGroup) {
+    const std::size_t gn = std::min(kFacetGroup, nb - g0);
+    auto one = [&](std::size_t k) {
+      std::fill(group[k].begin(), group[k].end(), Vec3{0, 0, 0});
+      run_batch(su, g0 + k, group[k], batches[g0 + k]);
+    };
+    if (in.executor) {
+      in.executor->parallel_for(gn, 1, [&](std::size_t b, std::size_t e) {
+        FMX_TRACE_SCOPE("tpmc_batch", "solver", static_cast<std::int64_t>(e - b));
+        for (std::size_t k = b; k < e; ++k) one(k);
+      });
+    } else {
+#if defined(FMX_USE_OPENMP)
+      #pragma omp parallel for schedule(dynamic)
+#endif
+      for (long long k = 0; k < static_cast<long long>(gn); ++k) {
+        FMX_TRACE_SCOPE("tpmc_batch", "solver", 1);
+        one(static_cast<std::size_t>(k));
+      }
+    }
+    for (std::size_t k = 0; k < gn; ++k)
+      for (std::size_t i = 0; i < facets.size(); ++i) res.facet_F[i] += group[k][i];
+  }
+
+  // Totals in batch order (independent of the thread count), errors from the batch scatter
+  double sum[6] = {0, 0, 0, 0, 0, 0};
+  for (const auto& bt : batches) {
+    for (int j = 0; j < 6; ++j) sum[j] += bt.s[j];
+    res.particles += bt.particles; res.struck += bt.struck; res.multi += bt.multi;
+    res.hits += bt.hits; res.dropped += bt.dropped;
+  }
+  res.out = { {sum[0], sum[1], sum[2]}, {sum[3], sum[4], sum[5]} };
+  if (nb < 2) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    res.F_stderr = res.M_stderr = {nan, nan, nan};
+  } else {
+    double var[6] = {0, 0, 0, 0, 0, 0};
+    const double N = static_cast<double>(opt.particles);
+    for (const auto& bt : batches) {
+      const double nbp = static_cast<double>(bt.particles);
+      for (int j = 0; j < 6; ++j) {
+        const double d = bt.s[j] * N / nbp - sum[j];
+        var[j] += nbp * d * d;
+      }
+    }
+    for (double& v : var) v = std::sqrt(v / ((static_cast<double>(nb) - 1.0) * N));
+    res.F_stderr = {var[0], var[1], var[2]};
+    res.M_stderr = {var[3], var[4], var[5]};
+  }
+  res.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  return res;
+}
+
+} // namespace fmx::solver
@@ -0,0 +1,48 @@
+// Test-particle Monte Carlo (TPMC) solver: multiple reflections on concave bodies
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "core/types.hpp"
+#include "geom/BVH.hpp"
+#include "solver/PanelSolver.hpp"
+
+namespace fmx::solver {
+
+struct TpmcOptions {
+  std::uint64_t particles{1000000}; // test particles injected, all species together
+  int max_hits{100};                // surface interactions traced per particle (1: panel-method physics)
+  std::uint64_t seed{1};
+  std::size_t batch{8192};          // particles per RNG stream and scheduling unit
+};
+
+struct TpmcResult {
+  Output out;                       // F, M [N, N*m]
+  fmx::Vec3 F_stderr, M_stderr;     // one-sigma statistical error from the batch-to-batch scatter
+                                    // (NaN when all particles fit in one batch)
+  std::vector<fmx::Vec3> facet_F;   // momentum exchange per facet [N]
+  std::uint64_t particles{0};
+  std::uint64_t struck{0};          // particles that hit the body
+  std::uint64_t multi{0};           // particles that hit it more than once
+  std::uint64_t hits{0};            // surface interactions
+  std::uint64_t dropped{0};         // particles still on the body after max_hits
+  double seconds{0.0};
+};
+
+// Molecules of each species enter the bounding box of the body from the drifting Maxwellian
+// of the free stream (bulk velocity wind - V_sat in the body frame, temperature T_K) with the
+// one-sided flux through each box face, and are traced with closest-hit queries through bvh,
+// whose triangles() must be the facets of `in` in order (Mesh::tris beside Mesh::to_facets).
+// At every hit the molecule is re-emitted by the facet's kernel: GsiModel::Sentman is diffuse
+// at T_r = alpha_E*Tw + (1 - alpha_E)*m|v|^2/(4k) per molecule, GsiModel::CLL samples the
+// Cercignani-Lampis-Lord kernel at Tw with alpha_n and the tangential momentum accommodation
+// alpha_t. The momentum exchanged is accumulated per facet and in F, M about r_CG.
+// Batches run on in.executor, else OpenMP threads in OpenMP builds, else serially. Every batch
+// draws from its own RNG stream seeded by (seed, batch index) and all sums are taken in batch
+// order, so F, M and facet_F do not depend on the thread count. Returns nullopt (err set) for inputs it cannot sample.
+std::optional<TpmcResult> solve_tpmc(const Input& in, const fmx::geom::BVHOccluder& bvh, const TpmcOptions& opt,
+                                     std::string* err = nullptr);
+
+} // namespace fmx::solver
@@ -0,0 +1,35 @@
+// Shared test fixtures: a reference free-stream from the stub atmosphere and unit plates
+#pragma once
+
+#include "atm/Atmosphere.hpp"
+#include "geom/Mesh.hpp"
+#include "solver/PanelSolver.hpp"
+
+namespace fmx::test {
+
+// Stub atmosphere at 400 km, 2025-09-12T12:00:00Z, F10.7 120, Kp 3, with one fully
+// accommodating material at 300 K; facets and geometry are left to the caller
+inline solver::Input stub_input(const Vec3& V_sat_ms = {7500.0, 0.0, 0.0}) {
+  solver::Input in;
+  in.materials = { {1.0, 1.0, 1.0, 300.0} };
+  atm::StubAtmosphere atm;
+  const auto st = atm.evaluate(400.0, 0.0, 0.0, "2025-09-12T12:00:00Z", {120.0, 3});
+  for (const auto& sp : st.species) in.species.push_back({sp.rho, sp.mass});
+  in.T_K = st.T_K;
+  in.V_sat_ms = V_sat_ms;
+  return in;
+}
+
+// Unit square plate in the plane x = x0, normal -x (facing a +x velocity), as two triangles
+inline void add_unit_plate(geom::Mesh& m, double x0 = 0.0) {
+  m.tris.push_back({Vec3{x0, 0.5, 0.5}, Vec3{x0, 0.5, -0.5}, Vec3{x0, -0.5, -0.5}});
+  m.tris.push_back({Vec3{x0, -0.5, 0.5}, Vec3{x0, 0.5, 0.5}, Vec3{x0, -0.5, -0.5}});
+}
+
+inline geom::Mesh unit_plate(double x0 = 0.0) {
+  geom::Mesh m;
+  add_unit_plate(m, x0);
+  return m;
+}
+
+} // namespace fmx::test
@@ -0,0 +1,95 @@
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "atm/Atmosphere.hpp"
+#include "atm/AtmosphereSession.hpp"
+#include "atm/Combined.hpp"
+#include "atm/Epoch.hpp"
+
+using namespace fmx::atm;
+
+// Batch results must equal the single-point path at every point
+static bool check_model(const Atmosphere& atm, const char* name, const PointBatch& pts, const Indices& idx) {
+  StateBatch b;
+  atm.evaluate_batch(pts, idx, b);
+  if (b.n != pts.n || b.T_K.size() != pts.n || b.rho.size() != pts.n * b.species_count()) {
+    std::cerr << name << ": batch output has wrong shape\n"; return false;
+  }
+  for (size_t i = 0; i < pts.n; ++i) {
+    const AtmosphereState st = atm.evaluate(pts.alt_km[i], pts.lat_deg[i], pts.lon_deg[i], format_iso_utc(pts.epoch_s[i]), idx);
+    const AtmosphereState bs = b.state(i);
+    bool same = st.T_K == bs.T_K && st.wind_ms.x == bs.wind_ms.x && st.wind_ms.y == bs.wind_ms.y
+             && st.wind_ms.z == bs.wind_ms.z && st.species.size() == bs.species.size();
+    for (size_t s = 0; same && s < st.species.size(); ++s)
+      same = st.species[s].rho == bs.species[s].rho && st.species[s].mass == bs.species[s].mass;
+    if (!same) { std::cerr << name << ": batch differs from evaluate() at point " << i << "\n"; return false; }
+  }
+  return true;
+}
+
+int main() {
+  // Epoch parsing/formatting and calendar split
+  double t = 0.0;
+  if (!parse_iso_utc("2024-03-01T06:30:15.250Z", t) || std::abs(t - 1709274615.25) > 1e-6) {
+    std::cerr << "parse_iso_utc wrong: " << t << "\n"; return 1;
+  }
+  DayTime dt = day_time(t);
+  if (dt.year != 2024 || dt.doy != 61 || std::abs(dt.utsec - (6*3600 + 30*60 + 15.25)) > 1e-6) {
+    std::cerr << "day_time wrong: " << dt.year << " " << dt.doy << " " << dt.utsec << "\n"; return 1;
+  }
+  if (format_iso_utc(t) != "2024-03-01T06:30:15.250Z") { std::cerr << "format_iso_utc wrong: " << format_iso_utc(t) << "\n"; return 1; }
+  if (!parse_iso_utc("1999-12-31T23:59:59Z", t) || day_time(t).doy != 365) { std::cerr << "year-end doy wrong\n"; return 1; }
+  if (parse_iso_utc("not-a-date", t) || parse_iso_utc("2024-13-01T00:00:00Z", t)) { std::cerr << "Malformed epoch accepted\n"; return 1; }
+
+  // Random trajectory-like points
+  const size_t n = 777;
+  std::mt19937_64 rng(11);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  std::vector<double> alt(n), lat(n), lon(n), ep(n);
+  for (size_t i = 0; i < n; ++i) {
+    alt[i] = 120.0 + 600.0 * u(rng); lat[i] = -80.0 + 160.0 * u(rng); lon[i] = 360.0 * u(rng);
+    ep[i] = 1.726e9 + std::floor(86400.0 * 30.0 * u(rng));
+  }
+  const PointBatch pts{n, alt.data(), lat.data(), lon.data(), ep.data()};
+  Indices idx; idx.F10_7 = 150.0; idx.F10_7A = 140.0; idx.Kp = 5;
+  if (!check_model(StubAtmosphere{}, "Stub", pts, idx)) return 1;
+  if (!check_model(NRLMSIS2Atmosphere{}, "NRLMSIS2", pts, idx)) return 1;
+  if (!check_model(CombinedAtmosphere{}, "Combined", pts, idx)) return 1;
+
+  // Default implementation (per-point fallback) for models without an array kernel
+  struct PointOnly : Atmosphere {
+    AtmosphereState evaluate(double alt_km, double lat_deg, double lon_deg, const std::string& utc, const Indices& i) const override {
+      return StubAtmosphere{}.evaluate(alt_km, lat_deg, lon_deg, utc, i);
+    }
+  };
+  if (!check_model(PointOnly{}, "default evaluate_batch", pts, idx)) return 1;
+
+  // Sessions: numeric-epoch evaluation equals the string path; drivers follow index changes
+  for (const char* model : {"Stub", "NRLMSIS2", "NRLMSIS2+HWM14"}) {
+    SessionConfig cfg; cfg.model = model;
+    std::string err;
+    auto session = AtmosphereSession::open(cfg, &err);
+    if (!session) { std::cerr << "Session " << model << " failed: " << err << "\n"; return 1; }
+    Indices quiet; quiet.Kp = 2;
+    for (const Indices* ix : {&idx, &idx, &quiet, &idx}) {
+      for (size_t i = 0; i < 50; ++i) {
+        const AtmosphereState a = session->evaluate(alt[i], lat[i], lon[i], ep[i], *ix);
+        const AtmosphereState b = session->model().evaluate(alt[i], lat[i], lon[i], format_iso_utc(ep[i]), *ix);
+        bool same = a.T_K == b.T_K && a.wind_ms.y == b.wind_ms.y && a.species.size() == b.species.size();
+        for (size_t s = 0; same && s < a.species.size(); ++s) same = a.species[s].rho == b.species[s].rho;
+        if (!same) { std::cerr << "Session " << model << " differs from evaluate() at point " << i << "\n"; return 1; }
+      }
+    }
+  }
+  {
+    SessionConfig cfg; cfg.model = "NoSuchModel";
+    std::string err;
+    if (AtmosphereSession::open(cfg, &err) || err.empty()) { std::cerr << "Unknown model accepted\n"; return 1; }
+  }
+
+  StateBatch empty;
+  StubAtmosphere{}.evaluate_batch(PointBatch{}, idx, empty);
+  if (empty.n != 0 || !empty.rho.empty()) { std::cerr << "Empty batch not empty\n"; return 1; }
+  return 0;
+}
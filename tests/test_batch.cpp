@@ -0,0 +1,240 @@
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "cli/Batch.hpp"
+#include "geom/BVH.hpp"
+#include "geom/Mesh.hpp"
+#include "solver/Executor.hpp"
+#include "tests/Fixtures.hpp"
+
+using namespace fmx;
+
+static bool close_rel(double a, double b, double tol = 1e-12) {
+  return std::fabs(a - b) <= tol * std::max(1e-30, std::max(std::fabs(a), std::fabs(b)));
+}
+
+static int test_executor() {
+  solver::Executor ex(4);
+  if (ex.threads() != 4) { std::cerr << "executor threads\n"; return 1; }
+  // Every index exactly once, for uneven work and chunk sizes
+  for (std::size_t grain : {1u, 3u, 64u}) {
+    const std::size_t n = 10007;
+    std::vector<std::atomic<int>> hits(n);
+    ex.parallel_for(n, grain, [&](std::size_t b, std::size_t e) {
+      for (std::size_t i = b; i < e; ++i) {
+        double x = 0.0;
+        for (std::size_t k = 0; k < (i % 97) * 20; ++k) x += std::sqrt(static_cast<double>(k));
+        hits[i].fetch_add(x >= 0.0 ? 1 : 2);
+      }
+    });
+    for (std::size_t i = 0; i < n; ++i) {
+      if (hits[i].load() != 1) { std::cerr << "executor index " << i << " ran " << hits[i].load() << " times (grain " << grain << ")\n"; return 1; }
+    }
+  }
+  // Nested calls run inline on the calling worker
+  std::atomic<std::size_t> inner{0};
+  ex.parallel_for(16, 1, [&](std::size_t, std::size_t) {
+    ex.parallel_for(10, 2, [&](std::size_t b, std::size_t e) { inner += e - b; });
+  });
+  if (inner.load() != 160) { std::cerr << "nested parallel_for covered " << inner.load() << "\n"; return 1; }
+  // The first task exception reaches the caller and the executor stays usable
+  bool thrown = false;
+  try {
+    ex.parallel_for(1000, 10, [&](std::size_t b, std::size_t) { if (b == 500) throw std::runtime_error("task"); });
+  } catch (const std::runtime_error&) { thrown = true; }
+  if (!thrown) { std::cerr << "task exception lost\n"; return 1; }
+  std::atomic<std::size_t> after{0};
+  ex.parallel_for(100, 7, [&](std::size_t b, std::size_t e) { after += e - b; });
+  if (after.load() != 100) { std::cerr << "executor unusable after exception\n"; return 1; }
+  return 0;
+}
+
+int main() {
+  if (test_executor()) return 1;
+
+  // Case lines on top of defaults
+  cli::BatchCase defaults;
+  defaults.epoch_s = 1757678400.0;
+  cli::BatchCase c;
+  std::string err;
+  if (!cli::parse_batch_case(R"({"id":5, "alt_km":350, "V_sat_mps":[7600, 10, -2.5], "theta_deg":15, "alpha_E":0.5, "F10_7":180})", defaults, c, &err)
+      || c.id != 5 || c.alt_km != 350.0 || c.lat_deg != 0.0 || c.V_sat_ms.y != 10.0 || c.V_sat_ms.z != -2.5
+      || c.theta_deg != 15.0 || c.material.alpha_E != 0.5 || c.material.alpha_n != 1.0
+      || !c.has_indices || c.idx.F10_7 != 180.0 || c.epoch_s != defaults.epoch_s) {
+    std::cerr << "case parse failed: " << err << "\n"; return 1;
+  }
+  if (!cli::parse_batch_case(R"({"utc":"2025-09-12T12:00:00Z"})", defaults, c) || c.epoch_s != 1757678400.0 || c.has_indices) {
+    std::cerr << "utc case parse failed\n"; return 1;
+  }
+  // Integer fields take exact, in-range integers only
+  for (const char* line : {R"({"id":-1})", R"({"id":2.5})", R"({"id":1e30})", R"({"id":18446744073709551616})",
+                           R"({"Kp":3.5})", R"({"Kp":1e12})", R"({"Kp":-1e300})"}) {
+    err.clear();
+    if (cli::parse_batch_case(line, defaults, c, &err) || err.find("bad number for") == std::string::npos) {
+      std::cerr << "out-of-range integer accepted: " << line << "\n"; return 1;
+    }
+  }
+  if (!cli::parse_batch_case(R"({"id":18446744073709551615, "Kp":4})", defaults, c) || c.id != UINT64_MAX || c.idx.Kp != 4) {
+    std::cerr << "integer fields not parsed exactly\n"; return 1;
+  }
+  if (cli::parse_batch_case(R"({"alt_km":350, "altitude":1})", defaults, c, &err) || err.find("altitude") == std::string::npos) {
+    std::cerr << "unknown key accepted\n"; return 1;
+  }
+  if (cli::parse_batch_case(R"({"alt_km":"high"})", defaults, c) || cli::parse_batch_case(R"({"alt_km":350)", defaults, c)
+      || cli::parse_batch_case(R"({"alpha_E":1.5})", defaults, c) || cli::parse_batch_case(R"({"V_sat_mps":[1,2]})", defaults, c)) {
+    std::cerr << "malformed case accepted\n"; return 1;
+  }
+
+  // Base scene: two plates in a row (the rear one shadowed at zero theta), offset CG
+  geom::Mesh mesh = test::unit_plate(0.0);
+  test::add_unit_plate(mesh, 0.2);
+  geom::BVHOccluder occ(mesh.tris);
+  solver::Input base;
+  base.facets = mesh.to_facets(0);
+  base.materials = {{1.0, 1.0, 1.0, 300.0}};
+  base.occluder = &occ;
+  base.r_CG = {0.05, 0.1, 0.0};
+  auto session = atm::AtmosphereSession::open(atm::SessionConfig{});
+  if (!session) { std::cerr << "session failed\n"; return 1; }
+  atm::SpaceWeatherTable no_sw;
+  atm::Indices idx;
+  defaults.idx = idx;
+
+  const char* obj = "test_batch_plates.obj";
+  {
+    std::ofstream f(obj);
+    for (const auto& t : mesh.tris) {
+      for (const Vec3& v : {t.v0, t.v1, t.v2}) f << "v " << v.x << " " << v.y << " " << v.z << "\n";
+    }
+    f << "f 1 2 3\nf 4 5 6\nf 7 8 9\nf 10 11 12\n";
+  }
+  const char* cases_path = "test_batch_cases.jsonl";
+  {
+    std::ofstream f(cases_path);
+    f << "{\"id\":10}\n";
+    f << "# comment lines are skipped\n";
+    f << "{\"id\":11, \"theta_deg\":30, \"alt_km\":300, \"lat_deg\":20}\n";
+    f << "{\"id\":12, \"geometry\":\"" << obj << "\"}\n";
+    f << "{\"id\":13, \"alt_km\":\n";
+    f << "{\"id\":14, \"geometry\":\"missing_mesh.obj\"}\n";
+    f << "{\"id\":15, \"F10_7\":200}\n";
+    f << "{\"id\":16, \"alpha_E\":0.2, \"Tw_K\":500, \"V_sat_mps\":[7000,500,0]}\n";
+  }
+  cli::BatchOptions opt;
+  opt.cases_path = cases_path;
+  opt.threads = 3;
+  opt.grain = 1;
+  std::vector<std::vector<double>> csv_rows, bin_cols;
+
+  // CSV
+  opt.out_path = "test_batch_out.csv";
+  cli::BatchStats bs;
+  if (!cli::run_batch(opt, defaults, *session, no_sw, idx, base, &bs, &err)) { std::cerr << "batch failed: " << err << "\n"; return 1; }
+  if (bs.cases != 7 || bs.errors != 2 || bs.geometries != 3 || bs.atm_groups != 2 || bs.threads != 3) {
+    std::cerr << "batch stats: cases=" << bs.cases << " errors=" << bs.errors << " geometries=" << bs.geometries
+              << " atm_groups=" << bs.atm_groups << "\n";
+    return 1;
+  }
+  {
+    std::ifstream f(opt.out_path);
+    std::string line;
+    std::getline(f, line);
+    if (line != "id,status,Fx,Fy,Fz,Mx,My,Mz,rho_kgm3,T_K") { std::cerr << "csv header: " << line << "\n"; return 1; }
+    while (std::getline(f, line)) {
+      std::vector<double> r;
+      std::size_t p = 0;
+      while (p <= line.size()) {
+        const std::size_t q = std::min(line.find(',', p), line.size());
+        r.push_back(std::strtod(line.substr(p, q - p).c_str(), nullptr));
+        p = q + 1;
+      }
+      csv_rows.push_back(r);
+    }
+  }
+
+  // Binary
+  opt.out_path = "test_batch_out.bin";
+  opt.binary = true;
+  if (!cli::run_batch(opt, defaults, *session, no_sw, idx, base, &bs, &err)) { std::cerr << "binary batch failed: " << err << "\n"; return 1; }
+  {
+    std::ifstream f(opt.out_path, std::ios::binary);
+    char head[64];
+    f.read(head, sizeof(head));
+    std::uint32_t n_cols = 0;
+    std::uint64_t n_rows = 0;
+    std::memcpy(&n_cols, head + 12, 4);
+    std::memcpy(&n_rows, head + 16, 8);
+    if (std::strcmp(head, "FMXBAT1") != 0 || n_cols != 10 || n_rows != 7) { std::cerr << "binary header\n"; return 1; }
+    char names[10][16];
+    f.read(&names[0][0], sizeof(names));
+    if (std::strcmp(names[2], "Fx") != 0 || std::strcmp(names[9], "T_K") != 0) { std::cerr << "binary column names\n"; return 1; }
+    bin_cols.assign(n_cols, std::vector<double>(n_rows));
+    for (auto& col : bin_cols) f.read(reinterpret_cast<char*>(col.data()), static_cast<std::streamsize>(n_rows * sizeof(double)));
+    if (!f) { std::cerr << "binary truncated\n"; return 1; }
+  }
+  std::remove(obj);
+  std::remove(cases_path);
+  std::remove("test_batch_out.csv");
+  std::remove("test_batch_out.bin");
+
+  if (csv_rows.size() != 7) { std::cerr << "csv rows " << csv_rows.size() << "\n"; return 1; }
+  for (std::size_t i = 0; i < 7; ++i) {
+    for (std::size_t k = 0; k < 10; ++k) {
+      const double a = csv_rows[i][k], b = bin_cols[k][i];
+      if (!(std::isnan(a) && std::isnan(b)) && !close_rel(a, b, 1e-8)) { std::cerr << "csv/binary mismatch row " << i << "\n"; return 1; }
+    }
+  }
+  auto col = [&](std::size_t k, std::size_t row) { return bin_cols[k][row]; };
+  // Input order, ids and status (an unparseable line keeps its position as id)
+  const double ids[7] = {10, 11, 12, 3, 14, 15, 16};
+  const double status[7] = {0, 0, 0, 1, 2, 0, 0};
+  for (std::size_t i = 0; i < 7; ++i) {
+    if (col(0, i) != ids[i] || col(1, i) != status[i]) { std::cerr << "row " << i << " id/status\n"; return 1; }
+    if ((status[i] != 0) != std::isnan(col(2, i))) { std::cerr << "row " << i << " NaN for failures only\n"; return 1; }
+  }
+
+  // Each case equals a direct solve of its single-state configuration
+  auto reference = [&](const cli::BatchCase& bc, double theta_deg) {
+    solver::Input in = base;
+    const atm::AtmosphereState st = session->evaluate(bc.alt_km, bc.lat_deg, bc.lon_deg, bc.epoch_s, bc.has_indices ? bc.idx : idx);
+    for (const auto& sp : st.species) in.species.push_back({sp.rho, sp.mass});
+    in.T_K = st.T_K;
+    in.V_sat_ms = bc.V_sat_ms;
+    in.wind_ms = st.wind_ms;
+    in.materials = {bc.material};
+    std::vector<geom::Triangle> tris = mesh.tris;
+    const double th = theta_deg * M_PI / 180.0, cs = std::cos(th), sn = std::sin(th);
+    auto rot = [&](Vec3 v) { return Vec3{v.x*cs - v.y*sn, v.x*sn + v.y*cs, v.z}; };
+    for (auto& t : tris) { t.v0 = rot(t.v0); t.v1 = rot(t.v1); t.v2 = rot(t.v2); }
+    geom::BVHOccluder rocc(tris);
+    in.facets = geom::Mesh{tris}.to_facets(0);
+    in.occluder = &rocc;
+    return solver::solve_serial(in);
+  };
+  const std::pair<const char*, std::size_t> checks[] = {
+    {R"({"id":10})", 0}, {R"({"theta_deg":30, "alt_km":300, "lat_deg":20})", 1}, {R"({})", 2},
+    {R"({"F10_7":200})", 5}, {R"({"alpha_E":0.2, "Tw_K":500, "V_sat_mps":[7000,500,0]})", 6}};
+  for (const auto& [line, row] : checks) {
+    if (!cli::parse_batch_case(line, defaults, c)) { std::cerr << "reference parse\n"; return 1; }
+    const solver::Output o = reference(c, c.theta_deg);
+    const double got[6] = {col(2, row), col(3, row), col(4, row), col(5, row), col(6, row), col(7, row)};
+    const double want[6] = {o.F.x, o.F.y, o.F.z, o.M.x, o.M.y, o.M.z};
+    const double scale = o.F.norm();
+    for (int k = 0; k < 6; ++k) {
+      if (std::fabs(got[k] - want[k]) > 1e-10 * scale) {
+        std::cerr << "row " << row << " component " << k << ": " << got[k] << " vs " << want[k] << "\n"; return 1;
+      }
+    }
+  }
+  if (!(col(9, 5) > col(9, 0))) { std::cerr << "F10.7 override did not change T\n"; return 1; }
+
+  std::cout << "OK: batch runner\n";
+  return 0;
+}
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include "geom/BVH.hpp"
+#include "geom/SyntheticMesh.hpp"
+#include "solver/Executor.hpp"
+
+using fmx::Vec3;
+using fmx::geom::Triangle;
+
+// Counts heap allocations so the refit path can be checked allocation-free
+static std::atomic<long> g_allocs{0};
+void* operator new(std::size_t n) {
+  ++g_allocs;
+  if (void* p = std::malloc(n ? n : 1)) return p;
+  std::abort();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Panels flex about the bus: displacement grows with the square of the span
+static std::vector<Triangle> bend(const std::vector<Triangle>& tris, double k) {
+  std::vector<Triangle> out = tris;
+  for (auto& t : out) for (Vec3* v : {&t.v0, &t.v1, &t.v2}) v->z += k * v->y * v->y;
+  return out;
+}
+
+int main() {
+  fmx::geom::SatelliteSpec spec;
+  spec.target_triangles = 6000;
+  const auto sat = fmx::geom::make_satellite(spec);
+  fmx::geom::BVHOccluder bvh(sat.tris);
+  if (!(bvh.sah_cost() > 1.0) || bvh.sah_cost() != bvh.build_sah_cost()) {
+    std::cerr << "build SAH " << bvh.sah_cost() << "\n"; return 1;
+  }
+
+  // Refit to a bent pose answers every query like a fresh build of that pose
+  const auto bent = bend(sat.tris, 0.02);
+  if (!bvh.refit(bent)) { std::cerr << "refit failed\n"; return 1; }
+  const fmx::geom::BVHOccluder fresh(bent);
+  std::mt19937_64 rng(7);
+  std::uniform_real_distribution<double> u(-1.0, 1.0);
+  const Vec3 lo = fresh.bounds().lo, hi = fresh.bounds().hi;
+  int hits = 0;
+  for (int i = 0; i < 20000; ++i) {
+    const Vec3 o{lo.x + (hi.x - lo.x) * 0.5 * (u(rng) + 1.0), lo.y + (hi.y - lo.y) * 0.5 * (u(rng) + 1.0),
+                 lo.z + (hi.z - lo.z) * 0.5 * (u(rng) + 1.0)};
+    const fmx::geom::Ray r{o, Vec3{u(rng), u(rng), u(rng)}.normalized()};
+    const bool h = bvh.any_hit(r, 1e9);
+    if (h != fresh.any_hit(r, 1e9)) { std::cerr << "refit and rebuild disagree on ray " << i << "\n"; return 1; }
+    hits += h;
+  }
+  if (hits == 0 || hits == 20000) { std::cerr << "degenerate ray set: " << hits << " hits\n"; return 1; }
+  const fmx::geom::Aabb b = bvh.bounds(), f = fresh.bounds();
+  if (b.lo.x != f.lo.x || b.hi.y != f.hi.y || b.hi.z != f.hi.z || b.lo.z != f.lo.z) { std::cerr << "root bounds differ\n"; return 1; }
+
+  // On an executor the subtrees refit on its threads to the same bounds and SAH bit for bit
+  {
+    fmx::solver::Executor ex(3);
+    fmx::geom::BVHOccluder par(sat.tris);
+    if (!par.refit(bent, nullptr, &ex) || par.sah_cost() != bvh.sah_cost()) {
+      std::cerr << "executor refit SAH " << par.sah_cost() << " vs " << bvh.sah_cost() << "\n"; return 1;
+    }
+    const fmx::geom::Aabb p = par.bounds();
+    if (p.lo.x != b.lo.x || p.lo.y != b.lo.y || p.hi.z != b.hi.z) { std::cerr << "executor refit bounds differ\n"; return 1; }
+  }
+
+  // Small motion keeps the tree; the step is allocation-free
+  bool rebuilt = true;
+  if (!bvh.update(sat.tris, 1.3, &rebuilt) || rebuilt || bvh.sah_cost() != bvh.build_sah_cost()) {
+    std::cerr << "small motion: rebuilt=" << rebuilt << " SAH " << bvh.sah_cost() << "/" << bvh.build_sah_cost() << "\n"; return 1;
+  }
+  const long before = g_allocs.load();
+  for (int step = 0; step < 10; ++step) bvh.update(step % 2 ? sat.tris : bent, 1.3, &rebuilt);
+  if (g_allocs.load() != before) { std::cerr << "refit allocated " << g_allocs.load() - before << " times\n"; return 1; }
+
+  // Scrambling which triangle sits where wrecks the old tree; update rebuilds in place
+  std::vector<Triangle> scrambled = sat.tris;
+  std::shuffle(scrambled.begin(), scrambled.end(), rng);
+  if (!bvh.refit(scrambled) || !(bvh.sah_cost() > 1.3 * bvh.build_sah_cost())) {
+    std::cerr << "scrambled SAH " << bvh.sah_cost() << " vs " << bvh.build_sah_cost() << "\n"; return 1;
+  }
+  const long before_rebuild = g_allocs.load();
+  if (!bvh.update(scrambled, 1.3, &rebuilt) || !rebuilt || g_allocs.load() != before_rebuild) {
+    std::cerr << "scrambled update: rebuilt=" << rebuilt << " allocs " << g_allocs.load() - before_rebuild << "\n"; return 1;
+  }
+  const fmx::geom::BVHOccluder fresh2(scrambled);
+  if (bvh.sah_cost() != fresh2.sah_cost() || bvh.build_sah_cost() != bvh.sah_cost()) {
+    std::cerr << "rebuild SAH " << bvh.sah_cost() << " vs fresh " << fresh2.sah_cost() << "\n"; return 1;
+  }
+
+  // A different triangle count is rejected and leaves the tree alone
+  std::string err;
+  std::vector<Triangle> fewer(sat.tris.begin(), sat.tris.end() - 1);
+  if (bvh.refit(fewer, &err) || err.empty() || bvh.triangles().size() != sat.tris.size()) {
+    std::cerr << "count mismatch not rejected\n"; return 1;
+  }
+  return 0;
+}
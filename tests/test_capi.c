@@ -0,0 +1,133 @@
+/* C API: scene creation, solve, errors and concurrent solves on one scene (plain C) */
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include "fmx.h"
+
+#define CHECK(cond, msg) do { if (!(cond)) { fprintf(stderr, "%s (%s)\n", msg, fmx_last_error()); return 1; } } while (0)
+
+/* Unit plate in the y-z plane at x = x0, normal -x (facing a +x velocity) */
+static void plate(double x0, double* v, uint32_t* ix, uint32_t base) {
+  const double p[4][3] = {{x0, 0.5, 0.5}, {x0, 0.5, -0.5}, {x0, -0.5, -0.5}, {x0, -0.5, 0.5}};
+  memcpy(v, p, sizeof(p));
+  const uint32_t t[6] = {0, 1, 2, 3, 0, 2};
+  for (int k = 0; k < 6; ++k) ix[k] = base + t[k];
+}
+
+static const double kRho[1] = {1e-12};
+static const double kMass[1] = {2.6567e-26}; /* atomic oxygen */
+
+static fmx_state make_state(double V) {
+  fmx_state s;
+  memset(&s, 0, sizeof(s));
+  s.rho_kgm3 = kRho; s.mass_kg = kMass; s.n_species = 1;
+  s.T_K = 1000.0;
+  s.V_sat_ms[0] = V;
+  return s;
+}
+
+typedef struct { const fmx_scene* scene; double V; double Fx_ref; int failures; } Worker;
+
+static void* run_worker(void* arg) {
+  Worker* w = (Worker*)arg;
+  const fmx_state st = make_state(w->V);
+  for (int i = 0; i < 2000; ++i) {
+    double F[3], M[3];
+    if (fmx_solve(w->scene, &st, F, M) != FMX_OK || F[0] != w->Fx_ref) ++w->failures;
+  }
+  return NULL;
+}
+
+int main(void) {
+  CHECK(fmx_api_version() == FMX_API_VERSION, "api version");
+
+  double v[24];
+  uint32_t ix[12];
+  plate(0.0, v, ix, 0);
+  fmx_scene* scene = NULL;
+  CHECK(fmx_scene_from_arrays(v, 4, ix, 2, NULL, &scene) == FMX_OK && scene, "from_arrays failed");
+  CHECK(fmx_scene_facet_count(scene) == 2, "facet count");
+
+  /* Normal incidence: pure drag along -x, linear in density */
+  const fmx_state st = make_state(7500.0);
+  double F[3], M[3];
+  CHECK(fmx_solve(scene, &st, F, M) == FMX_OK, "solve failed");
+  CHECK(F[0] < 0.0 && fabs(F[1]) < 1e-12 * -F[0] && fabs(F[2]) < 1e-12 * -F[0], "plate drag wrong");
+  const double rho2[1] = {2e-12};
+  fmx_state dense = st;
+  dense.rho_kgm3 = rho2;
+  double F2[3], M2[3];
+  CHECK(fmx_solve(scene, &dense, F2, M2) == FMX_OK && fabs(F2[0] - 2.0 * F[0]) < 1e-12 * fabs(F[0]), "drag not linear in density");
+
+  /* CG offset: M = r x F about the CG */
+  const double cg[3] = {0.0, 0.1, 0.0};
+  CHECK(fmx_scene_set_cg(scene, cg) == FMX_OK, "set_cg failed");
+  CHECK(fmx_solve(scene, &st, F2, M2) == FMX_OK && F2[0] == F[0], "solve after set_cg");
+  CHECK(fabs(M2[2] - 0.1 * F[0]) < 1e-12 * fabs(F[0]), "moment about CG wrong");
+
+  /* Same plate from an OBJ file gives the identical force */
+  const char* obj = "test_capi_plate.obj";
+  FILE* f = fopen(obj, "w");
+  CHECK(f != NULL, "cannot write OBJ");
+  for (int k = 0; k < 4; ++k) fprintf(f, "v %.17g %.17g %.17g\n", v[3*k], v[3*k+1], v[3*k+2]);
+  fprintf(f, "f 1 2 3\nf 4 1 3\n");
+  fclose(f);
+  fmx_scene* loaded = NULL;
+  CHECK(fmx_scene_load(obj, &loaded) == FMX_OK, "scene_load failed");
+  remove(obj);
+  CHECK(fmx_solve(loaded, &st, F2, M2) == FMX_OK && F2[0] == F[0], "OBJ scene differs");
+  fmx_scene_destroy(loaded);
+
+  /* Per-triangle materials: material 1 (alpha_E = 0) applies once set */
+  const uint32_t mats[2] = {1, 1};
+  fmx_scene* coated = NULL;
+  CHECK(fmx_scene_from_arrays(v, 4, ix, 2, mats, &coated) == FMX_OK, "from_arrays with materials");
+  CHECK(fmx_solve(coated, &st, F2, M2) == FMX_OK && F2[0] == F[0], "unset material should use defaults");
+  const fmx_material m1 = {1.0, 1.0, 0.0, 300.0};
+  CHECK(fmx_scene_set_material(coated, 1, &m1) == FMX_OK, "set_material failed");
+  CHECK(fmx_solve(coated, &st, F2, M2) == FMX_OK && F2[0] != F[0], "material not applied");
+  fmx_scene_destroy(coated);
+
+  /* Two plates in a row: the downstream one is shadowed unless occlusion is off */
+  plate(0.0, v, ix, 0);
+  plate(1.0, v + 12, ix + 6, 4);
+  fmx_scene* pair = NULL;
+  CHECK(fmx_scene_from_arrays(v, 8, ix, 4, NULL, &pair) == FMX_OK, "two-plate scene");
+  CHECK(fmx_solve(pair, &st, F2, M2) == FMX_OK && fabs(F2[0] - F[0]) < 1e-12 * fabs(F[0]), "occlusion wrong");
+  CHECK(fmx_scene_set_occlusion(pair, 0) == FMX_OK, "set_occlusion");
+  CHECK(fmx_solve(pair, &st, F2, M2) == FMX_OK && fabs(F2[0] - 2.0 * F[0]) < 1e-12 * fabs(F[0]), "occlusion off wrong");
+  fmx_scene_destroy(pair);
+
+  /* Errors are reported, not thrown */
+  const uint32_t bad[3] = {0, 1, 9};
+  fmx_scene* none = NULL;
+  CHECK(fmx_scene_from_arrays(v, 4, bad, 1, NULL, &none) == FMX_E_INVALID_ARG && none == NULL, "bad index accepted");
+  CHECK(strstr(fmx_last_error(), "triangle 0") != NULL, "error message missing");
+  CHECK(fmx_scene_load("missing_mesh.obj", &none) == FMX_E_IO, "missing mesh accepted");
+  CHECK(fmx_solve(scene, NULL, F, M) == FMX_E_INVALID_ARG, "null state accepted");
+  fmx_state neg = st;
+  neg.T_K = -1.0;
+  CHECK(fmx_solve(scene, &neg, F, M) == FMX_E_INVALID_ARG, "negative temperature accepted");
+  const fmx_material bad_m = {1.5, 1.0, 1.0, 300.0};
+  CHECK(fmx_scene_set_material(scene, 0, &bad_m) == FMX_E_INVALID_ARG, "bad material accepted");
+
+  /* Concurrent solves on one scene, with setters running alongside */
+  Worker w[4];
+  pthread_t th[4];
+  for (int k = 0; k < 4; ++k) {
+    const fmx_state sk = make_state(7000.0 + 200.0 * k);
+    w[k].scene = scene; w[k].V = 7000.0 + 200.0 * k; w[k].failures = 0;
+    CHECK(fmx_solve(scene, &sk, F2, M2) == FMX_OK, "reference solve");
+    w[k].Fx_ref = F2[0];
+  }
+  for (int k = 0; k < 4; ++k) pthread_create(&th[k], NULL, run_worker, &w[k]);
+  for (int i = 0; i < 200; ++i) fmx_scene_set_cg(scene, cg);
+  for (int k = 0; k < 4; ++k) pthread_join(th[k], NULL);
+  for (int k = 0; k < 4; ++k) CHECK(w[k].failures == 0, "concurrent solve differs");
+
+  fmx_scene_destroy(scene);
+  fmx_scene_destroy(NULL);
+  printf("OK: C API\n");
+  return 0;
+}
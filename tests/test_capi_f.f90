@@ -0,0 +1,31 @@
+! Fortran bindings: every interface in capi/fmx.f90 links and calls through to libfmx
+program test_capi_f
+  use fmx_capi
+  implicit none
+  real(c_double) :: v(3, 4), F(3), M(3), Fs(3)
+  integer(c_int32_t) :: ix(3, 2)
+  real(c_double), target :: rho(1), mass(1)
+  type(c_ptr) :: scene
+  type(fmx_state) :: st
+
+  if (fmx_api_version() < 1) stop 1
+  ! Unit plate in the y-z plane facing a +x velocity
+  v = reshape([0d0, 0.5d0, 0.5d0, 0d0, 0.5d0, -0.5d0, 0d0, -0.5d0, -0.5d0, 0d0, -0.5d0, 0.5d0], [3, 4])
+  ix = reshape([0, 1, 2, 3, 0, 2], [3, 2])
+  if (fmx_scene_from_arrays(v, 4_c_size_t, ix, 2_c_size_t, c_null_ptr, scene) /= FMX_OK) stop 2
+  if (fmx_scene_facet_count(scene) /= 2) stop 3
+
+  rho = 1d-12; mass = 2.6567d-26
+  st%rho_kgm3 = c_loc(rho); st%mass_kg = c_loc(mass); st%n_species = 1
+  st%T_K = 1000d0; st%V_sat_ms = [7500d0, 0d0, 0d0]
+  if (fmx_solve(scene, st, Fs, M) /= FMX_OK .or. .not. (Fs(1) < 0d0)) stop 4
+
+  ! Analytic CLL, then a missing table is reported with a message
+  if (fmx_scene_set_gsi_f(scene, FMX_GSI_CLL) /= FMX_OK) stop 5
+  if (fmx_solve(scene, st, F, M) /= FMX_OK .or. .not. (F(1) < 0d0)) stop 6
+  if (fmx_scene_set_gsi_f(scene, FMX_GSI_CLL, 'missing_cll_table.bin') /= FMX_E_IO) stop 7
+  if (len(fmx_last_error()) == 0) stop 8
+  if (fmx_scene_set_gsi(scene, FMX_GSI_SENTMAN, c_null_ptr) /= FMX_OK) stop 9
+  if (fmx_solve(scene, st, F, M) /= FMX_OK .or. F(1) /= Fs(1)) stop 10
+  call fmx_scene_destroy(scene)
+end program
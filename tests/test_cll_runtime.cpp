@@ -24,6 +24,14 @@ int main() {
   if (!(std::abs(rg16.second) < std::abs(rg8.second))) {
     std::cerr << "CLL grazing CT did not decrease with Ma: CT8="<<rg8.second<<" CT16="<<rg16.second<<"\n"; return 1;
   }
+  // Query stats: the first query of a key is a miss that waits for the worker, later ones hit
+  CLLRuntime::QueryStats qs;
+  rt.query(0.3, 4.0, 0.5, 0.5, 0.5, &qs);
+  rt.query(0.3, 4.0, 0.5, 0.5, 0.5, &qs);
+  rt.query(0.3001, 4.0, 0.5, 0.5, 0.5, &qs); // same quantized key
+  if (qs.misses != 1 || qs.hits != 2 || qs.waits > 1) {
+    std::cerr << "CLLRuntime stats: hits=" << qs.hits << " misses=" << qs.misses << " waits=" << qs.waits << "\n"; return 1;
+  }
   return 0;
 }
 
@@ -0,0 +1,101 @@
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "geom/BVH.hpp"
+#include "geom/SyntheticMesh.hpp"
+#include "gsi/CLLRuntime.hpp"
+#include "solver/Executor.hpp"
+#include "solver/PanelSolver.hpp"
+#include "tests/Fixtures.hpp"
+
+using fmx::Vec3;
+
+int main() {
+  fmx::solver::Executor ex(4);
+
+  // Automatic grain covers every index once; slots stay within the participant count
+  {
+    const std::size_t n = 100003;
+    std::vector<int> seen(n, 0);
+    std::atomic<bool> bad_slot{false};
+    ex.parallel_for(n, 0, [&](std::size_t b, std::size_t e) {
+      if (fmx::solver::Executor::slot() >= ex.threads() || !ex.inside()) bad_slot = true;
+      for (std::size_t i = b; i < e; ++i) ++seen[i];
+    });
+    for (std::size_t i = 0; i < n; ++i) {
+      if (seen[i] != 1) { std::cerr << "index " << i << " visited " << seen[i] << " times\n"; return 1; }
+    }
+    if (bad_slot || ex.inside()) { std::cerr << "slot or inside() wrong\n"; return 1; }
+  }
+  // Nested calls run inline on the calling participant and keep its slot
+  {
+    std::atomic<int> mismatched{0}, items{0};
+    ex.parallel_for(64, 1, [&](std::size_t, std::size_t) {
+      const unsigned outer = fmx::solver::Executor::slot();
+      ex.parallel_for(100, 0, [&](std::size_t b, std::size_t e) {
+        if (fmx::solver::Executor::slot() != outer) ++mismatched;
+        items += static_cast<int>(e - b);
+      });
+    });
+    if (mismatched != 0 || items != 6400) { std::cerr << "nested parallel_for wrong\n"; return 1; }
+  }
+  // A single-chunk loop runs inline without entering a task: loops it starts still use the
+  // workers, and the caller's context is restored even when fn throws
+  {
+    std::atomic<int> inner_inside{0}, outer_inside{0};
+    ex.parallel_for(1, 0, [&](std::size_t, std::size_t) {
+      if (ex.inside()) ++outer_inside;
+      ex.parallel_for(1000, 10, [&](std::size_t, std::size_t) { if (ex.inside()) ++inner_inside; });
+    });
+    if (outer_inside != 0 || inner_inside == 0 || ex.inside()) { std::cerr << "inline single-chunk loop entered a task\n"; return 1; }
+    bool thrown = false;
+    try {
+      ex.parallel_for(64, 1, [&](std::size_t b, std::size_t) {
+        ex.parallel_for(1, 0, [&](std::size_t, std::size_t) { if (b == 5) throw 1; });
+      });
+    } catch (int) { thrown = true; }
+    if (!thrown || ex.inside() || fmx::solver::Executor::slot() != 0) { std::cerr << "context not restored after throw\n"; return 1; }
+  }
+
+  // Solver on the executor matches the serial loop; counters agree
+  fmx::geom::SatelliteSpec spec;
+  spec.target_triangles = 6000;
+  const auto sat = fmx::geom::make_satellite(spec);
+  fmx::geom::BVHOccluder occ(sat.tris);
+  fmx::solver::Input in = fmx::test::stub_input({7500.0, 300.0, -200.0});
+  in.facets = sat.to_facets(0);
+  in.r_CG = {0.1, 0.0, 0.0};
+  in.occluder = &occ;
+  fmx::solver::SolveStats ss, se;
+  const auto o_ser = fmx::solver::solve_serial(in, &ss);
+  in.executor = &ex;
+  const auto o_ex = fmx::solver::solve(in, &se);
+  const auto o_ex_plain = fmx::solver::solve(in);
+  auto close = [](const Vec3& a, const Vec3& b) {
+    return (a - b).norm() <= 1e-12 * std::max(1.0, b.norm());
+  };
+  if (!close(o_ex.F, o_ser.F) || !close(o_ex.M, o_ser.M) || !close(o_ex_plain.F, o_ser.F)) {
+    std::cerr << "executor solve differs: F.x " << o_ex.F.x << " vs " << o_ser.F.x << "\n"; return 1;
+  }
+  if (se.front != ss.front || se.back != ss.back || se.occluded != ss.occluded || se.rays.rays != ss.rays.rays ||
+      se.gsi_sentman != ss.gsi_sentman || se.solves != 1 || se.facets != sat.tris.size()) {
+    std::cerr << "executor stats differ: front " << se.front << "/" << ss.front << " back " << se.back << "/" << ss.back << "\n";
+    return 1;
+  }
+
+  // CLL runtime without workers: the solver threads compute misses themselves
+  fmx::gsi::CLLQuantization q;
+  q.workers = 0;
+  fmx::gsi::CLLRuntime rt(q);
+  in.gsi_model = fmx::solver::GsiModel::CLL;
+  in.cll_runtime = &rt;
+  fmx::solver::SolveStats sr;
+  const auto o_rt = fmx::solver::solve(in, &sr);
+  in.executor = nullptr;
+  const auto o_rt_ser = fmx::solver::solve_serial(in);
+  if (!close(o_rt.F, o_rt_ser.F) || sr.runtime.misses == 0 || sr.runtime.hits + sr.runtime.misses != sr.gsi_runtime) {
+    std::cerr << "inline CLL runtime wrong: misses=" << sr.runtime.misses << " hits=" << sr.runtime.hits << "\n"; return 1;
+  }
+  return 0;
+}
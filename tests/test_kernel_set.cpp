@@ -0,0 +1,176 @@
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+#include "gsi/KernelSet.hpp"
+#include "gsi/KernelTT.hpp"
+#include "gsi/CLL.hpp"
+
+using fmx::gsi::KernelSet;
+using fmx::gsi::AxisSpacing;
+
+// Small analytic grid: theta uniform, Ma log-uniform, tau irregular
+static std::array<std::vector<double>, 5> make_axes() {
+  std::vector<double> th; for (int i=0;i<=45;i++) th.push_back(i * 2.0 * M_PI/180.0);
+  return { th, {0.5, 1.0, 2.0, 4.0, 8.0, 16.0}, {0.3, 0.5, 1.0, 1.5, 2.0}, {0.0, 0.5, 1.0}, {0.0, 0.5, 1.0} };
+}
+
+static std::vector<double> eval_nodes(const std::array<std::vector<double>, 5>& ax) {
+  std::vector<double> cnct;
+  for (double at : ax[4]) for (double an : ax[3]) for (double tau : ax[2]) for (double Ma : ax[1]) for (double th : ax[0]) {
+    auto [CN, CT] = fmx::gsi::coefficients(th, Ma, tau, fmx::gsi::CLLParams{an, at});
+    cnct.push_back(CN); cnct.push_back(CT);
+  }
+  return cnct;
+}
+
+int main() {
+  const auto ax = make_axes();
+  KernelSet mem;
+  if (!mem.set_grid(ax, eval_nodes(ax))) { std::cerr << "set_grid failed\n"; return 1; }
+  if (mem.grid_axis(0).spacing != AxisSpacing::Uniform || mem.grid_axis(1).spacing != AxisSpacing::LogUniform
+      || mem.grid_axis(2).spacing != AxisSpacing::Irregular) {
+    std::cerr << "Axis spacing not detected (theta uniform, Ma log-uniform, tau irregular)\n"; return 1;
+  }
+
+  // Nodes are reproduced exactly
+  {
+    auto [CN, CT] = mem.query(ax[0][10], ax[1][3], ax[2][2], ax[3][1], ax[4][2]);
+    auto [CNr, CTr] = fmx::gsi::coefficients(ax[0][10], ax[1][3], ax[2][2], fmx::gsi::CLLParams{ax[3][1], ax[4][2]});
+    if (std::abs(CN - CNr) > 1e-12 || std::abs(CT - CTr) > 1e-12) {
+      std::cerr << "Grid node mismatch: CN="<<CN<<" ref="<<CNr<<" CT="<<CT<<" ref="<<CTr<<"\n"; return 1;
+    }
+  }
+
+  // Binary round trip: float64 must match bit-for-bit, float32 to single precision
+  const char* p64 = "test_kernel_set_f64.bin";
+  const char* p32 = "test_kernel_set_f32.bin";
+  if (!mem.save_binary(p64, false) || !mem.save_binary(p32, true)) { std::cerr << "save_binary failed\n"; return 1; }
+  KernelSet b64, b32;
+  if (!b64.load(p64) || !b32.load(p32) || !b64.is_grid_table() || !b32.is_grid_table()) {
+    std::cerr << "load of binary table failed\n"; return 1;
+  }
+  if (b64.grid_axis(1).spacing != AxisSpacing::LogUniform) { std::cerr << "Spacing lost in binary table\n"; return 1; }
+  const double qs[][5] = {
+    {0.0, 8.0, 1.0, 1.0, 1.0}, {0.7, 3.1, 0.8, 0.3, 0.9}, {1.5, 12.0, 1.7, 0.6, 0.2},
+    {-0.1, 0.2, 5.0, 1.2, -0.3}, {1.2345, 5.5, 0.42, 0.75, 0.05}
+  };
+  for (const auto& q : qs) {
+    auto [CN, CT] = mem.query(q[0], q[1], q[2], q[3], q[4]);
+    auto [CN64, CT64] = b64.query(q[0], q[1], q[2], q[3], q[4]);
+    auto [CN32, CT32] = b32.query(q[0], q[1], q[2], q[3], q[4]);
+    if (CN != CN64 || CT != CT64) { std::cerr << "float64 binary table differs from in-memory grid\n"; return 1; }
+    double tol = 1e-6 * (1.0 + std::abs(CN) + std::abs(CT));
+    if (std::abs(CN - CN32) > tol || std::abs(CT - CT32) > tol) {
+      std::cerr << "float32 binary table off: CN="<<CN<<" vs "<<CN32<<" CT="<<CT<<" vs "<<CT32<<"\n"; return 1;
+    }
+  }
+  // Theta batches agree with point queries for double and float storage
+  {
+    std::vector<double> th; for (int i = 0; i < 200; ++i) th.push_back(-0.05 + i * (M_PI/2 + 0.1) / 199.0);
+    std::vector<double> cn(th.size()), ct(th.size());
+    for (const KernelSet* ks : {&mem, &b32}) {
+      ks->query_theta_batch(th, 5.5, 0.42, 0.75, 0.05, cn.data(), ct.data());
+      for (size_t i = 0; i < th.size(); ++i) {
+        auto [CN, CT] = ks->query(th[i], 5.5, 0.42, 0.75, 0.05);
+        if (std::abs(CN - cn[i]) > 1e-12 * (1.0 + std::abs(CN)) || std::abs(CT - ct[i]) > 1e-12 * (1.0 + std::abs(CT))) {
+          std::cerr << "Batch theta query differs at theta=" << th[i] << ": CN " << cn[i] << " vs " << CN << "\n"; return 1;
+        }
+      }
+    }
+  }
+  // Copies keep referring to valid node storage
+  KernelSet copy = b64;
+  b64 = KernelSet{};
+  {
+    auto [CN, CT] = copy.query(0.7, 3.1, 0.8, 0.3, 0.9);
+    auto [CNr, CTr] = mem.query(0.7, 3.1, 0.8, 0.3, 0.9);
+    if (CN != CNr || CT != CTr) { std::cerr << "Copied KernelSet lost its mapping\n"; return 1; }
+  }
+  std::remove(p64); std::remove(p32);
+
+  // Tensor-train compression: error follows the tolerance, file round trip, batch == point queries
+  {
+    auto tt = fmx::gsi::KernelTT::fit(mem, 1e-8);
+    const char* ptt = "test_kernel_set.tt";
+    if (!tt || !tt->save(ptt)) { std::cerr << "TT fit/save failed\n"; return 1; }
+    if (!(tt->fit_error() <= 1e-8)) { std::cerr << "TT fit error " << tt->fit_error() << " above tolerance\n"; return 1; }
+    KernelSet comp;
+    if (!comp.load(ptt) || !comp.is_compressed() || !comp.valid()) { std::cerr << "TT table did not load\n"; return 1; }
+    std::remove(ptt);
+    if (tt->bytes() >= 2 * 46 * 6 * 5 * 3 * 3 * sizeof(double)) { std::cerr << "TT not smaller than dense grid\n"; return 1; }
+    for (const auto& q : qs) {
+      auto [CN, CT] = mem.query(q[0], q[1], q[2], q[3], q[4]);
+      auto [CNt, CTt] = comp.query(q[0], q[1], q[2], q[3], q[4]);
+      if (std::abs(CN - CNt) > 1e-6 || std::abs(CT - CTt) > 1e-6) {
+        std::cerr << "TT query off: CN="<<CN<<" vs "<<CNt<<" CT="<<CT<<" vs "<<CTt<<"\n"; return 1;
+      }
+    }
+    std::vector<double> th{0.0, 0.3, 0.77, 1.2, 1.57}, cn(th.size()), ct(th.size());
+    comp.query_theta_batch(th, 3.1, 0.8, 0.3, 0.9, cn.data(), ct.data());
+    for (size_t i = 0; i < th.size(); ++i) {
+      auto [CN, CT] = comp.query(th[i], 3.1, 0.8, 0.3, 0.9);
+      if (std::abs(CN - cn[i]) > 1e-12 || std::abs(CT - ct[i]) > 1e-12) { std::cerr << "TT batch differs from point query\n"; return 1; }
+    }
+    auto coarse = fmx::gsi::KernelTT::fit(mem, 1e-2);
+    if (!coarse || coarse->ranks()[1] > tt->ranks()[1]) { std::cerr << "Looser tolerance did not reduce TT rank\n"; return 1; }
+    // A rank cap that cannot reach the tolerance fails and reports the achieved error
+    std::string err;
+    if (fmx::gsi::KernelTT::fit(mem, 1e-8, &err, 1) || err.find("rank cap") == std::string::npos) {
+      std::cerr << "Capped TT fit did not report the missed tolerance\n"; return 1;
+    }
+    if (fmx::gsi::KernelTT::fit(KernelSet{}, 1e-3)) { std::cerr << "TT fit accepted an empty table\n"; return 1; }
+  }
+
+  // Point list: k-d tree nearest neighbour agrees with a brute-force scan
+  {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<fmx::gsi::KernelRow> rows;
+    const char* pts_path = "test_kernel_set_points.csv";
+    {
+      std::ofstream out(pts_path);
+      out.precision(17);
+      for (int i = 0; i < 5000; ++i) {
+        fmx::gsi::KernelRow r{u(rng)*M_PI/2, 0.5 + 15.5*u(rng), 0.3 + 1.7*u(rng), u(rng), u(rng), 0.0, 0.0};
+        std::tie(r.CN, r.CT) = fmx::gsi::coefficients(r.theta, r.Ma, r.tau, fmx::gsi::CLLParams{r.alpha_n, r.alpha_t});
+        rows.push_back(r);
+        out << r.theta << "," << r.Ma << "," << r.tau << "," << r.alpha_n << "," << r.alpha_t << "," << r.CN << "," << r.CT << "\n";
+      }
+    }
+    KernelSet pts;
+    if (!pts.load(pts_path) || pts.is_grid_table()) { std::cerr << "Point-list load failed\n"; return 1; }
+    std::remove(pts_path);
+    double Ma_lo = std::numeric_limits<double>::infinity(), Ma_hi = 0.0, tau_lo = Ma_lo, tau_hi = 0.0;
+    for (const auto& r : rows) { Ma_lo=std::min(Ma_lo,r.Ma); Ma_hi=std::max(Ma_hi,r.Ma); tau_lo=std::min(tau_lo,r.tau); tau_hi=std::max(tau_hi,r.tau); }
+    for (int i = 0; i < 300; ++i) {
+      const double q[5] = {u(rng)*M_PI/2, 0.5 + 15.5*u(rng), 0.3 + 1.7*u(rng), u(rng), u(rng)};
+      double bestd = std::numeric_limits<double>::infinity(); const fmx::gsi::KernelRow* best = nullptr;
+      for (const auto& r : rows) {
+        double a = (q[0]-r.theta)/(M_PI/2), b = (q[1]-r.Ma)/(Ma_hi-Ma_lo), c = (q[2]-r.tau)/(tau_hi-tau_lo);
+        double d = a*a + b*b + c*c + (q[3]-r.alpha_n)*(q[3]-r.alpha_n) + (q[4]-r.alpha_t)*(q[4]-r.alpha_t);
+        if (d < bestd) { bestd = d; best = &r; }
+      }
+      auto [CN, CT] = pts.query(q[0], q[1], q[2], q[3], q[4]);
+      if (std::abs(CN - best->CN) > 1e-12 || std::abs(CT - best->CT) > 1e-12) {
+        std::cerr << "k-d nearest neighbour differs from brute force at query " << i << "\n"; return 1;
+      }
+    }
+    // Inverse-distance weighting: exact at a sample, bounded by neighbours elsewhere
+    pts.set_point_interpolation(fmx::gsi::PointInterp::InverseDistance, 8);
+    {
+      const auto& r = rows[123];
+      auto [CN, CT] = pts.query(r.theta, r.Ma, r.tau, r.alpha_n, r.alpha_t);
+      if (std::abs(CN - r.CN) > 1e-12 || std::abs(CT - r.CT) > 1e-12) { std::cerr << "IDW not exact at a sample\n"; return 1; }
+      auto [CNi, CTi] = pts.query(0.6, 7.0, 1.0, 0.5, 0.5);
+      auto [CNr, CTr] = fmx::gsi::coefficients(0.6, 7.0, 1.0, fmx::gsi::CLLParams{0.5, 0.5});
+      if (!std::isfinite(CNi) || std::abs(CNi - CNr) > 0.25 * std::abs(CNr) || std::abs(CTi - CTr) > 0.25 * std::abs(CTr) + 0.05) {
+        std::cerr << "IDW far from model: CN="<<CNi<<" ref="<<CNr<<" CT="<<CTi<<" ref="<<CTr<<"\n"; return 1;
+      }
+    }
+  }
+  return 0;
+}
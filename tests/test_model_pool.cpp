@@ -0,0 +1,102 @@
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "atm/ModelPool.hpp"
+
+using fmx::atm::ModelPool;
+
+// Stand-in for a Fortran model with module-level state: a global scratch array and a
+// "last input" cache that make concurrent in-process calls unsafe
+static double g_scratch[64];
+static double g_last_x = -1.0;
+static long g_calls = 0;
+
+static double model(double x) {
+  ++g_calls;
+  if (x != g_last_x) {
+    for (int k = 0; k < 64; ++k) g_scratch[k] = std::sin(x * (k + 1)) / (k + 1);
+    g_last_x = x;
+  }
+  double s = 0.0;
+  for (int k = 0; k < 64; ++k) s += g_scratch[k] * std::cos(0.1 * k * x);
+  return s;
+}
+
+// in = {x}, out = {model(x), pid}
+static void model_kernel(std::size_t m, const double* const* in, double* const* out, const double*) {
+  for (std::size_t i = 0; i < m; ++i) { out[0][i] = model(in[0][i]); out[1][i] = static_cast<double>(::getpid()); }
+}
+
+static void throwing_kernel(std::size_t, const double* const*, double* const*, const double*) {
+  throw std::runtime_error("model failure");
+}
+
+static void dying_kernel(std::size_t, const double* const*, double* const*, const double*) { ::_exit(3); }
+
+// Runs the pooled model over x; returns the worker pids seen (empty on failure)
+static std::set<int> pooled(ModelPool& pool, const std::vector<double>& x, std::vector<double>& y) {
+  std::vector<double> pid(x.size());
+  if (!pool.run(model_kernel, x.size(), {x.data()}, {{y.data(), 1}, {pid.data(), 1}})) return {};
+  return std::set<int>(pid.begin(), pid.end());
+}
+
+int main() {
+  const std::size_t n = 20000;
+  std::vector<double> x(n), serial(n);
+  for (std::size_t i = 0; i < n; ++i) x[i] = 0.001 * static_cast<double>(i % 3000) + 0.5 * static_cast<double>(i / 3000);
+  for (std::size_t i = 0; i < n; ++i) serial[i] = model(x[i]);
+  const long calls_before = g_calls;
+  const double last_before = g_last_x;
+  const int self = static_cast<int>(::getpid());
+
+  // Slab of 8000 points (3 doubles each): the batch goes through in three slices
+  if (!ModelPool::can_fork()) { std::cerr << "Single-threaded test reported as threaded\n"; return 1; }
+  ModelPool pool(4, 1000, 3 * 8000);
+  if (!pool.running()) { std::cerr << "Pool did not start\n"; return 1; }
+  std::vector<double> y(n);
+  const auto first = pooled(pool, x, y);
+  if (first.empty()) { std::cerr << "Pool run failed\n"; return 1; }
+  if (std::memcmp(y.data(), serial.data(), n * sizeof(double)) != 0) { std::cerr << "Pool results not bitwise identical\n"; return 1; }
+  // Work ran in separate processes with private copies of the global state
+  if (first.size() != 4 || first.count(self)) { std::cerr << "Expected 4 worker processes, got " << first.size() << "\n"; return 1; }
+  if (g_calls != calls_before || g_last_x != last_before) { std::cerr << "Worker state leaked into the parent\n"; return 1; }
+
+  // Threads started after the pool (an OpenMP team, an Executor) do not stop it: the second
+  // batch still runs in the same workers
+  std::atomic<bool> stop{false};
+  std::thread other([&] { while (!stop.load()) std::this_thread::yield(); });
+  double acc = 0.0;
+#if defined(FMX_USE_OPENMP)
+  #pragma omp parallel for reduction(+:acc)
+#endif
+  for (int i = 0; i < 1000; ++i) acc += std::sqrt(static_cast<double>(i));
+  std::fill(y.begin(), y.end(), 0.0);
+  const auto second = pooled(pool, x, y);
+  if (second != first || !(acc > 0.0)) { std::cerr << "Second pooled batch did not run in the workers\n"; return 1; }
+  if (std::memcmp(y.data(), serial.data(), n * sizeof(double)) != 0) { std::cerr << "Second batch results differ\n"; return 1; }
+
+  // A pool constructed while other threads run does not fork
+  {
+    ModelPool late(2);
+    std::vector<double> z(n);
+    if (late.running() || !pooled(late, x, z).empty()) { std::cerr << "Pool forked while other threads were running\n"; return 1; }
+  }
+  stop = true;
+  other.join();
+
+  // A throwing kernel fails the run but keeps the workers; a dying worker stops the pool
+  std::vector<double> z(n);
+  if (pool.run(throwing_kernel, n, {x.data()}, {{z.data(), 1}})) { std::cerr << "Kernel failure not reported\n"; return 1; }
+  if (pooled(pool, x, y) != first) { std::cerr << "Pool lost after a kernel failure\n"; return 1; }
+  if (pool.run(dying_kernel, n, {x.data()}, {{z.data(), 1}}) || pool.running()) {
+    std::cerr << "Worker exit not reported\n"; return 1;
+  }
+  if (!pooled(pool, x, y).empty()) { std::cerr << "Stopped pool accepted a batch\n"; return 1; }
+  return 0;
+}
@@ -4,6 +4,7 @@
 #include "core/types.hpp"
 #include "geom/Mesh.hpp"
 #include "geom/BVH.hpp"
+#include "geom/SyntheticMesh.hpp"
 #include "atm/Atmosphere.hpp"
 #include "solver/PanelSolver.hpp"
 
@@ -64,6 +65,42 @@ int main() {
     return 1;
   }
 
+  // Solver stats: counts match a direct classification, forces are unchanged, and the
+  // serial and parallel loops agree (the satellite is large enough for the parallel path)
+  fmx::solver::SolveStats s2;
+  auto out2_stats = fmx::solver::solve(in2_occ, &s2);
+  if (out2_stats.F.x != out2_occ.F.x || s2.solves != 1 || s2.facets != 4 || s2.front != 4 || s2.back != 0 ||
+      s2.occluded != 2 || s2.rays.rays != 4 || s2.gsi_sentman != 2 * in2_occ.species.size()) {
+    std::cerr << "two-plate stats wrong: front=" << s2.front << " occluded=" << s2.occluded << " rays=" << s2.rays.rays << "\n";
+    return 1;
+  }
+  fmx::geom::SatelliteSpec spec;
+  spec.target_triangles = 5000;
+  const auto sat = fmx::geom::make_satellite(spec);
+  auto in3 = make_input_with_mesh(sat);
+  fmx::geom::BVHOccluder occ3(sat.tris);
+  in3.occluder = &occ3;
+  std::uint64_t front = 0, occluded = 0;
+  for (const auto& f : in3.facets) {
+    if (Vec3::dot(in3.V_sat_ms - in3.wind_ms, f.n) >= 0.0 || f.area <= 0.0) continue;
+    ++front;
+    occluded += occ3.any_hit(fmx::geom::Ray{f.r_center, -(in3.V_sat_ms - in3.wind_ms).normalized()}, 1e9);
+  }
+  fmx::solver::SolveStats sp, ss;
+  const auto o_par = fmx::solver::solve(in3, &sp);
+  fmx::solver::solve_serial(in3, &ss);
+  const auto o_plain = fmx::solver::solve(in3);
+  if (o_par.F.x != o_plain.F.x || sp.front != front || sp.occluded != occluded || sp.rays.rays != front ||
+      sp.front + sp.back != sat.tris.size() || sp.gsi_sentman != (front - occluded) * in3.species.size() ||
+      ss.front != sp.front || ss.occluded != sp.occluded || ss.rays.nodes != sp.rays.nodes || ss.rays.tris != sp.rays.tris) {
+    std::cerr << "satellite stats wrong: front=" << sp.front << "/" << front << " occluded=" << sp.occluded << "/" << occluded << "\n";
+    return 1;
+  }
+#if defined(FMX_USE_STATS)
+  if (sp.rays.nodes < sp.rays.rays || sp.rays.tris == 0) { std::cerr << "BVH traversal not counted\n"; return 1; }
+#endif
+  if (!(sp.total_s >= sp.facets_s && sp.facets_s > 0.0)) { std::cerr << "stage times not recorded\n"; return 1; }
+
   return 0;
 }
 
@@ -0,0 +1,83 @@
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "geom/BVH.hpp"
+#include "geom/SyntheticMesh.hpp"
+#include "solver/Executor.hpp"
+#include "solver/PanelSolver.hpp"
+#include "tests/Fixtures.hpp"
+
+using fmx::Vec3;
+using fmx::solver::Reduction;
+
+static bool same(const fmx::solver::Output& a, const fmx::solver::Output& b) {
+  return a.F.x == b.F.x && a.F.y == b.F.y && a.F.z == b.F.z && a.M.x == b.M.x && a.M.y == b.M.y && a.M.z == b.M.z;
+}
+
+int main() {
+  fmx::geom::SatelliteSpec spec;
+  spec.target_triangles = 8000;
+  const auto sat = fmx::geom::make_satellite(spec);
+  fmx::geom::BVHOccluder occ(sat.tris);
+  fmx::solver::Input in = fmx::test::stub_input({7500.0, 450.0, -300.0});
+  in.facets = sat.to_facets(0);
+  in.materials = { {0.9, 0.8, 0.95, 300.0} };
+  in.r_CG = {0.05, -0.02, 0.01};
+  in.occluder = &occ;
+
+  fmx::solver::SolveStats s_fast;
+  const auto fast = fmx::solver::solve_serial(in, &s_fast);
+  fmx::solver::Output det_ref{}, comp_ref{};
+  for (Reduction red : {Reduction::Deterministic, Reduction::Compensated}) {
+    in.reduction = red;
+    in.executor = nullptr;
+    fmx::solver::SolveStats s_ser;
+    const auto ref = fmx::solver::solve_serial(in, &s_ser);
+    (red == Reduction::Deterministic ? det_ref : comp_ref) = ref;
+    if (s_ser.front != s_fast.front || s_ser.back != s_fast.back || s_ser.occluded != s_fast.occluded) {
+      std::cerr << "blocked reduction counts differ\n"; return 1;
+    }
+    // Default parallel loop (OpenMP in OpenMP builds)
+    if (!same(fmx::solver::solve(in), ref)) { std::cerr << "parallel blocked reduction not bit-identical\n"; return 1; }
+    for (unsigned t : {1u, 2u, 3u, 5u}) {
+      fmx::solver::Executor ex(t);
+      in.executor = &ex;
+      fmx::solver::SolveStats s_ex;
+      for (int rep = 0; rep < 3; ++rep) {
+        const auto o = fmx::solver::solve(in, rep == 0 ? &s_ex : nullptr);
+        if (!same(o, ref)) {
+          std::cerr << "executor(" << t << ") blocked reduction differs: F.y " << o.F.y << " vs " << ref.F.y << "\n"; return 1;
+        }
+      }
+      if (s_ex.front != s_fast.front || s_ex.occluded != s_fast.occluded || s_ex.gsi_sentman != s_fast.gsi_sentman) {
+        std::cerr << "executor(" << t << ") counts differ\n"; return 1;
+      }
+    }
+  }
+  in.executor = nullptr;
+  in.reduction = Reduction::Fast;
+
+  // Accuracy against an extended-precision sum of the per-facet loads
+  long double ref[6] = {0, 0, 0, 0, 0, 0};
+  double mag = 0.0;
+  fmx::solver::Input one = in;
+  one.facets.resize(1);
+  for (const auto& f : in.facets) {
+    one.facets[0] = f;
+    const auto o = fmx::solver::solve_serial(one);
+    const double v[6] = {o.F.x, o.F.y, o.F.z, o.M.x, o.M.y, o.M.z};
+    for (int j = 0; j < 6; ++j) { ref[j] += v[j]; mag += std::abs(v[j]); }
+  }
+  auto err = [&](const fmx::solver::Output& o) {
+    const double v[6] = {o.F.x, o.F.y, o.F.z, o.M.x, o.M.y, o.M.z};
+    double e = 0.0;
+    for (int j = 0; j < 6; ++j) e += std::abs(static_cast<double>(v[j] - ref[j]));
+    return e;
+  };
+  const double e_fast = err(fast), e_det = err(det_ref), e_comp = err(comp_ref);
+  if (!(e_det <= 1e-12 * mag && e_comp <= e_det && e_comp <= 1e-15 * mag)) {
+    std::cerr << "reduction error fast/det/comp = " << e_fast << "/" << e_det << "/" << e_comp << " (sum |terms| " << mag << ")\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,107 @@
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "geom/BVH.hpp"
+#include "geom/Scene.hpp"
+#include "geom/SyntheticMesh.hpp"
+#include "solver/PanelSolver.hpp"
+#include "tests/Fixtures.hpp"
+
+using fmx::Vec3;
+using fmx::geom::Transform;
+
+static fmx::solver::Input make_input(const std::vector<fmx::Facet>* facets, const fmx::geom::Occluder* occ) {
+  fmx::solver::Input in = fmx::test::stub_input();
+  in.facets_view = facets;
+  in.occluder = occ;
+  return in;
+}
+
+static bool close(const Vec3& a, const Vec3& b, double rel) {
+  return (a - b).norm() <= rel * std::max(b.norm(), 1e-300);
+}
+
+int main() {
+  // Transforms: rotation about an axis through a pivot, composition and inverse
+  {
+    const Transform r = Transform::rotation({0, 0, 1}, M_PI / 2, {1, 0, 0});
+    const Vec3 p = r.point({2, 0, 0});
+    const Transform c = Transform::translation({0, 0, 3}) * r;
+    const Vec3 q = c.point({2, 0, 0});
+    if (!close(p, {1, 1, 0}, 1e-15) || !close(q, {1, 1, 3}, 1e-15) || !close(c.inverse_point(q), {2, 0, 0}, 1e-15)) {
+      std::cerr << "transform wrong: p=" << p.x << "," << p.y << "," << p.z << "\n"; return 1;
+    }
+  }
+
+  // Satellite scene: panels share one geometry and match the flat mesh
+  fmx::geom::SatelliteSpec spec;
+  spec.target_triangles = 6000;
+  fmx::geom::SatelliteParts pm, ps;
+  std::vector<std::size_t> panels;
+  const auto flat = fmx::geom::make_satellite(spec, &pm);
+  auto scene = fmx::geom::make_satellite_scene(spec, &ps, &panels);
+  const std::size_t n_panels = static_cast<std::size_t>(spec.wings * spec.panels_per_wing);
+  if (scene.geometries() != 2 || panels.size() != n_panels || scene.instances() != n_panels + 1 ||
+      ps.arrays != pm.arrays || scene.facets().size() != flat.tris.size() || !scene.committed()) {
+    std::cerr << "satellite scene layout wrong: instances=" << scene.instances() << " facets=" << scene.facets().size()
+              << "/" << flat.tris.size() << "\n"; return 1;
+  }
+  {
+    const auto flat_f = flat.to_facets(0);
+    const fmx::geom::BVHOccluder flat_occ(flat.tris);
+    fmx::solver::SolveStats sf, ss;
+    const auto of = fmx::solver::solve_serial(make_input(&flat_f, &flat_occ), &sf);
+    const auto os = fmx::solver::solve_serial(make_input(&scene.facets(), &scene), &ss);
+    if (!close(os.F, of.F, 1e-12) || !close(os.M, of.M, 1e-10) || ss.front != sf.front || ss.occluded != sf.occluded) {
+      std::cerr << "scene solve differs: F.x " << os.F.x << " vs " << of.F.x << ", occluded " << ss.occluded << "/" << sf.occluded << "\n";
+      return 1;
+    }
+    if (ss.occluded == 0) { std::cerr << "satellite scene has no occlusion\n"; return 1; }
+  }
+
+  // Articulation: turning every panel 25 deg about its wing axis == a mesh built at that cant
+  for (std::size_t id : panels) scene.set_transform(id, scene.transform(id) * Transform::rotation({0, 1, 0}, 25.0 * M_PI / 180.0));
+  if (scene.committed()) { std::cerr << "set_transform did not mark the scene\n"; return 1; }
+  scene.commit();
+  {
+    auto spec2 = spec;
+    spec2.panel_cant_deg += 25.0;
+    const auto flat2 = fmx::geom::make_satellite(spec2);
+    const auto flat2_f = flat2.to_facets(0);
+    const fmx::geom::BVHOccluder flat2_occ(flat2.tris);
+    fmx::solver::SolveStats sf, ss;
+    const auto of = fmx::solver::solve_serial(make_input(&flat2_f, &flat2_occ), &sf);
+    const auto os = fmx::solver::solve_serial(make_input(&scene.facets(), &scene), &ss);
+    if (!close(os.F, of.F, 1e-9) || !close(os.M, of.M, 1e-8) || ss.front != sf.front ||
+        (ss.occluded > sf.occluded ? ss.occluded - sf.occluded : sf.occluded - ss.occluded) > 2) {
+      std::cerr << "articulated scene differs: F.x " << os.F.x << " vs " << of.F.x << ", occluded " << ss.occluded
+                << "/" << sf.occluded << "\n";
+      return 1;
+    }
+  }
+
+  // Two bodies: a plate upstream shades an identical plate, until it is moved aside
+  {
+    const fmx::geom::Mesh plate = fmx::test::unit_plate();
+    fmx::geom::Scene two;
+    const std::size_t g = two.add_geometry(plate);
+    const std::size_t lead = *two.add_instance(g);
+    two.add_instance(g, Transform::translation({0.5, 0.0, 0.0}));
+    two.commit();
+    // Unknown ids are rejected without touching the scene
+    if (two.add_instance(g + 1) || two.set_transform(two.instances(), Transform{}) || two.instances() != 2 ||
+        two.facets().size() != 4 || !two.committed()) {
+      std::cerr << "bad scene ids accepted\n"; return 1;
+    }
+    const auto one_f = plate.to_facets(0);
+    const auto F1 = fmx::solver::solve_serial(make_input(&one_f, nullptr)).F;
+    const auto F_shaded = fmx::solver::solve_serial(make_input(&two.facets(), &two)).F;
+    two.set_transform(lead, Transform::translation({0.0, 2.0, 0.0}));
+    two.commit();
+    const auto F_apart = fmx::solver::solve_serial(make_input(&two.facets(), &two)).F;
+    if (!close(F_shaded, F1, 1e-12) || !close(F_apart, F1 * 2.0, 1e-12)) {
+      std::cerr << "two-body shading wrong: " << F_shaded.x << " / " << F_apart.x << " vs " << F1.x << "\n"; return 1;
+    }
+  }
+  return 0;
+}
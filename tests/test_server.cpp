@@ -0,0 +1,183 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "cli/Server.hpp"
+#include "geom/BVH.hpp"
+#include "geom/Mesh.hpp"
+#include "tests/Fixtures.hpp"
+
+using namespace fmx;
+
+static bool read_all(int fd, void* p, std::size_t n) {
+  char* d = static_cast<char*>(p);
+  while (n > 0) { const ssize_t k = ::read(fd, d, n); if (k <= 0) return false; d += k; n -= static_cast<std::size_t>(k); }
+  return true;
+}
+
+static std::string read_to_end(int fd) {
+  std::string s; char buf[4096]; ssize_t k;
+  while ((k = ::read(fd, buf, sizeof(buf))) > 0) s.append(buf, static_cast<std::size_t>(k));
+  return s;
+}
+
+static cli::ServeBinRequest orbit_request(std::uint64_t id) {
+  cli::ServeBinRequest b{};
+  b.id = id;
+  b.epoch_s = 1757635200.0 + static_cast<double>(id);
+  b.r_ecef_m[0] = 6778137.0;
+  b.v_ecef_ms[1] = 7670.0;
+  return b;
+}
+
+int main() {
+  const geom::Mesh mesh = test::unit_plate();
+  geom::BVHOccluder occ(mesh.tris);
+  solver::Input base;
+  base.facets = mesh.to_facets(0);
+  base.materials = {{1.0, 1.0, 1.0, 300.0}};
+  base.occluder = &occ;
+  base.r_CG = {0.0, 0.1, 0.0};
+  auto session = atm::AtmosphereSession::open(atm::SessionConfig{});
+  if (!session) { std::cerr << "session failed\n"; return 1; }
+  atm::SpaceWeatherTable no_sw;
+  atm::Indices idx;
+  cli::Server server(*session, no_sw, idx, base);
+
+  // Geodetic form matches the single-state CLI path (model wind used as-is)
+  cli::ServeRequest rq;
+  bool shutdown = false;
+  std::string err;
+  if (!cli::parse_request_json(R"({"id":7,"utc":"2025-09-12T12:00:00Z","alt_km":400,"lat_deg":10,"lon_deg":20,"V_sat_mps":[7500,0,0]})", rq, shutdown, &err)
+      || rq.ecef || rq.id != 7 || shutdown) { std::cerr << "geodetic request parse failed: " << err << "\n"; return 1; }
+  const cli::ServeReply r1 = server.handle(rq);
+  {
+    const atm::AtmosphereState st = session->evaluate(400.0, 10.0, 20.0, rq.row.epoch_s, idx);
+    solver::Input in = base;
+    for (const auto& sp : st.species) in.species.push_back({sp.rho, sp.mass});
+    in.T_K = st.T_K;
+    in.V_sat_ms = {7500.0, 0, 0};
+    in.wind_ms = st.wind_ms;
+    const solver::Output o = solver::solve(in);
+    if (r1.status != cli::kServeOk || r1.id != 7 || (r1.F - o.F).norm() > 1e-12 * o.F.norm() || (r1.M - o.M).norm() > 1e-12 * o.M.norm()
+        || !(r1.F.x < 0.0) || !(std::abs(r1.M.z) > 0.0)) {
+      std::cerr << "geodetic reply wrong: " << r1.F.x << " vs " << o.F.x << "\n"; return 1;
+    }
+  }
+  // Malformed and control lines
+  if (cli::parse_request_json(R"({"id":3,"alt_km":400})", rq, shutdown, &err) || rq.id != 3) { std::cerr << "incomplete request accepted\n"; return 1; }
+  if (cli::parse_request_json(R"({"cmd":"reload"})", rq, shutdown, &err)) { std::cerr << "unknown cmd accepted\n"; return 1; }
+  // Ids are exact unsigned 64-bit integers; anything else is a bad request, not a cast
+  for (const char* id : {"-1", "7.5", "1e30", "18446744073709551616", "NaN"}) {
+    const std::string line = std::string(R"({"id":)") + id + R"(,"epoch_s":0,"r_ecef_m":[6778137,0,0],"v_ecef_ms":[0,7670,0]})";
+    if (cli::parse_request_json(line, rq, shutdown, &err)) { std::cerr << "id " << id << " accepted\n"; return 1; }
+  }
+  if (!cli::parse_request_json(R"({"id": 18446744073709551615 ,"epoch_s":0,"r_ecef_m":[6778137,0,0],"v_ecef_ms":[0,7670,0]})", rq, shutdown, &err)
+      || rq.id != UINT64_MAX) { std::cerr << "largest id not parsed exactly\n"; return 1; }
+  if (!cli::parse_request_json(R"({"cmd":"shutdown"})", rq, shutdown, &err) || !shutdown) { std::cerr << "shutdown not parsed\n"; return 1; }
+
+  // ECEF binary request == JSON ECEF request; ram frame puts the drag on -x body
+  const cli::ServeReply rb = server.handle(cli::from_binary(orbit_request(5)));
+  if (!cli::parse_request_json(R"({"id":5,"epoch_s":1757635205,"r_ecef_m":[6778137,0,0],"v_ecef_ms":[0,7670,0]})", rq, shutdown, &err)) {
+    std::cerr << "ecef request parse failed: " << err << "\n"; return 1;
+  }
+  const cli::ServeReply rj = server.handle(rq);
+  if (rb.status != cli::kServeOk || rb.F.x != rj.F.x || rb.M.z != rj.M.z || !(rb.F.x < 0.0)
+      || std::abs(rb.F.y) > 1e-9 * std::abs(rb.F.x) || !(rb.rho_kgm3 > 0.0)) {
+    std::cerr << "binary/json ecef replies differ\n"; return 1;
+  }
+
+  // JSON lines over pipes: two requests, one malformed, shutdown, then ignored input
+  {
+    int pin[2], pout[2];
+    if (::pipe(pin) != 0 || ::pipe(pout) != 0) { std::cerr << "pipe failed\n"; return 1; }
+    const std::string text =
+        "{\"id\":1,\"epoch_s\":1757635201,\"r_ecef_m\":[6778137,0,0],\"v_ecef_ms\":[0,7670,0]}\r\n"
+        "\n"
+        "{\"id\":2,\"alt_km\":400}\n"
+        "{\"id\":5,\"epoch_s\":1757635205,\"r_ecef_m\":[6778137,0,0],\"v_ecef_ms\":[0,7670,0],\"q_body_to_ecef\":[0,0,0,0]}\n"
+        "{\"cmd\":\"shutdown\"}\n"
+        "{\"id\":9,\"epoch_s\":0,\"r_ecef_m\":[6778137,0,0],\"v_ecef_ms\":[0,7670,0]}\n";
+    if (::write(pin[1], text.data(), text.size()) != static_cast<ssize_t>(text.size())) { std::cerr << "pipe write failed\n"; return 1; }
+    ::close(pin[1]);
+    if (!server.serve_fd(pin[0], pout[1], cli::ServeFormat::Json, &err)) { std::cerr << "serve_fd json failed: " << err << "\n"; return 1; }
+    ::close(pin[0]); ::close(pout[1]);
+    const std::string out = read_to_end(pout[0]);
+    ::close(pout[0]);
+    const auto l1 = out.find('\n'), l2 = out.find('\n', l1 + 1), l3 = out.find('\n', l2 + 1);
+    if (l3 == std::string::npos || out.find('\n', l3 + 1) != std::string::npos
+        || out.compare(0, 7, "{\"id\":1") != 0 || out.find("\"id\":2,\"error\"") != l1 + 2
+        || out.find("{\"id\":5,\"F\":[") != l2 + 1) {
+      std::cerr << "json stream replies wrong:\n" << out; return 1;
+    }
+    // Full-precision numbers: id 5 reply reproduces the binary reply exactly
+    double fx = 0.0;
+    if (std::sscanf(out.c_str() + l2 + 1, "{\"id\":5,\"F\":[%lf", &fx) != 1 || fx != rb.F.x) { std::cerr << "json precision lost\n"; return 1; }
+  }
+
+  // Binary frames over a socket pair: good, wrong-length, good, shutdown
+  {
+    int sv[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) { std::cerr << "socketpair failed\n"; return 1; }
+    bool served = false;
+    std::thread th([&]{ served = server.serve_fd(sv[1], sv[1], cli::ServeFormat::Binary, nullptr); });
+    std::string frames;
+    auto add = [&](const void* p, std::uint32_t len) { frames.append(reinterpret_cast<const char*>(&len), 4); frames.append(static_cast<const char*>(p), len); };
+    const cli::ServeBinRequest a = orbit_request(5), b = orbit_request(6);
+    const char junk[10] = {};
+    add(&a, sizeof(a)); add(junk, sizeof(junk)); add(&b, sizeof(b)); add(nullptr, 0);
+    if (::write(sv[0], frames.data(), frames.size()) != static_cast<ssize_t>(frames.size())) { std::cerr << "frame write failed\n"; return 1; }
+    cli::ServeBinReply rep[3];
+    for (auto& r : rep) {
+      std::uint32_t len = 0;
+      if (!read_all(sv[0], &len, 4) || len != sizeof(r) || !read_all(sv[0], &r, sizeof(r))) { std::cerr << "binary reply read failed\n"; return 1; }
+    }
+    th.join();
+    ::close(sv[0]); ::close(sv[1]);
+    if (!served || rep[0].id != 5 || rep[0].status != cli::kServeOk || rep[0].F[0] != rb.F.x
+        || rep[1].status != cli::kServeBadRequest || rep[2].id != 6 || rep[2].status != cli::kServeOk) {
+      std::cerr << "binary stream replies wrong\n"; return 1;
+    }
+  }
+
+  // Unix socket: one client, then shutdown removes the socket file
+  {
+    const std::string path = "/tmp/fmx_test_server_" + std::to_string(::getpid()) + ".sock";
+    bool served = false;
+    std::string serr;
+    std::thread th([&]{ served = server.serve_unix(path, cli::ServeFormat::Json, &serr); });
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    int fd = -1;
+    for (int attempt = 0; attempt < 200; ++attempt) {
+      fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+      if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0) break;
+      ::close(fd); fd = -1;
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    if (fd < 0) { std::cerr << "connect failed\n"; th.join(); return 1; }
+    const std::string req = "{\"id\":11,\"epoch_s\":1757635205,\"r_ecef_m\":[6778137,0,0],\"v_ecef_ms\":[0,7670,0]}\n{\"cmd\":\"shutdown\"}\n";
+    if (::write(fd, req.data(), req.size()) != static_cast<ssize_t>(req.size())) { std::cerr << "socket write failed\n"; return 1; }
+    const std::string out = read_to_end(fd);
+    ::close(fd);
+    th.join();
+    struct stat sb;
+    if (!served || out.compare(0, 14, "{\"id\":11,\"F\":[") != 0 || ::stat(path.c_str(), &sb) == 0) {
+      std::cerr << "unix socket serve wrong: " << serr << " " << out << "\n"; return 1;
+    }
+  }
+
+  if (server.stats().requests != 10 || server.stats().errors != 2) {
+    std::cerr << "stats wrong: " << server.stats().requests << " " << server.stats().errors << "\n"; return 1;
+  }
+  std::cout << "OK: solver server\n";
+  return 0;
+}
@@ -0,0 +1,107 @@
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+#include "atm/AtmosphereSession.hpp"
+#include "atm/Epoch.hpp"
+#include "atm/SpaceWeather.hpp"
+
+using namespace fmx::atm;
+
+// CelesTrak SW-All.csv layout; day d of 2024-01-01.. has ap = 10 d + k, Kp = k + d/10 in slot k
+static std::string make_csv() {
+  std::ostringstream s;
+  s << "DATE,BSRT,ND,KP1,KP2,KP3,KP4,KP5,KP6,KP7,KP8,KP_SUM,AP1,AP2,AP3,AP4,AP5,AP6,AP7,AP8,AP_AVG,"
+       "CP,C9,ISN,F10.7_OBS,F10.7_ADJ,F10.7_DATA_TYPE,F10.7_OBS_CENTER81,F10.7_OBS_LAST81,F10.7_ADJ_CENTER81,F10.7_ADJ_LAST81\r\n";
+  for (int d = 0; d < 5; ++d) {
+    if (d == 2) continue; // gap: 2024-01-03 repeats 2024-01-02
+    s << "2024-01-0" << d + 1 << ",2596," << d;
+    for (int k = 0; k < 8; ++k) s << "," << 10 * k + d;
+    s << ",0";
+    for (int k = 0; k < 8; ++k) s << "," << 10 * d + k;
+    s << "," << 7 * d << ",0.5,2,100," << 100 + d << "," << 99 + d << ",OBS," << 150 + d << ",0,0,0\r\n";
+  }
+  s << "2024-01-06,2596,5,,,,,,,,,,,,,,,,,,,,,,120,,PRD,,,,\r\n"; // incomplete: skipped
+  return s.str();
+}
+
+int main() {
+  SpaceWeatherTable sw;
+  std::string err;
+  {
+    std::istringstream in(make_csv());
+    if (!sw.load_csv(in, &err)) { std::cerr << "load_csv failed: " << err << "\n"; return 1; }
+  }
+  double t0 = 0.0;
+  parse_iso_utc("2024-01-01T00:00:00Z", t0);
+  if (sw.days() != 5 || sw.first_epoch() != t0 || !sw.covers(t0 + 5 * 86400.0 - 1.0) || sw.covers(t0 + 5 * 86400.0)) {
+    std::cerr << "Wrong coverage: " << sw.days() << " days\n"; return 1;
+  }
+
+  // 2024-01-05T22:00Z: day 4, slot 7
+  double t = 0.0;
+  parse_iso_utc("2024-01-05T22:00:00Z", t);
+  Indices idx = sw.indices(t);
+  const double ap_exp[7] = {28, 47, 46, 45, 44, (40+41+42+43+34+35+36+37) / 8.0, (30+31+32+33+14+15+16+17) / 8.0};
+  bool ok = idx.has_ap_array && idx.F10_7 == 103.0 && idx.F10_7A == 154.0 && idx.Kp == 7
+         && idx.Ap_daily == 28.0 && idx.Ap_now == 47.0;
+  for (int k = 0; ok && k < 7; ++k) ok = std::abs(idx.Ap[k] - ap_exp[k]) < 1e-12;
+  if (!ok) {
+    std::cerr << "indices wrong: F10.7 " << idx.F10_7 << " F10.7A " << idx.F10_7A << " Kp " << idx.Kp << " Ap";
+    for (double a : idx.Ap) std::cerr << " " << a;
+    std::cerr << "\n"; return 1;
+  }
+  // Gap day repeats the previous record; the previous-day F10.7 of 2024-01-04 is the gap day's
+  parse_iso_utc("2024-01-03T04:00:00Z", t);
+  idx = sw.indices(t);
+  if (idx.Ap[1] != 11.0 || idx.F10_7A != 151.0 || idx.Kp != 1) { std::cerr << "gap day wrong\n"; return 1; }
+  parse_iso_utc("2024-01-04T00:00:00Z", t);
+  if (sw.indices(t).F10_7 != 101.0) { std::cerr << "previous-day F10.7 wrong\n"; return 1; }
+  // Outside the table: clamped to the first/last slot, history clamped at the start
+  idx = sw.indices(t0 - 86400.0 * 30);
+  if (idx.Ap[1] != 0.0 || idx.Ap[6] != 0.0 || idx.F10_7 != 100.0) { std::cerr << "early clamp wrong\n"; return 1; }
+  if (!same_indices(sw.indices(t0 + 86400.0 * 400), sw.indices(t0 + 5 * 86400.0 - 1.0))) { std::cerr << "late clamp wrong\n"; return 1; }
+  // Constant within a 3-hour slot
+  if (!same_indices(sw.indices(t0 + 3 * 3600.0), sw.indices(t0 + 6 * 3600.0 - 1.0))
+      || same_indices(sw.indices(t0 + 3 * 3600.0), sw.indices(t0 + 6 * 3600.0))) {
+    std::cerr << "slot boundaries wrong\n"; return 1;
+  }
+
+  // Malformed input
+  {
+    std::istringstream in("DATE,F10.7_OBS\n2024-01-01,100\n");
+    SpaceWeatherTable bad;
+    if (bad.load_csv(in, &err) || bad.valid()) { std::cerr << "Missing columns accepted\n"; return 1; }
+    if (bad.load("missing_sw.csv", &err)) { std::cerr << "Missing file accepted\n"; return 1; }
+  }
+
+  // Batched evaluation spanning all days equals per-point evaluation with per-epoch indices
+  auto session = AtmosphereSession::open(SessionConfig{});
+  if (!session) { std::cerr << "session failed\n"; return 1; }
+  const size_t n = 500;
+  std::mt19937_64 rng(3);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  std::vector<double> alt(n), lat(n), lon(n), ep(n);
+  for (size_t i = 0; i < n; ++i) {
+    alt[i] = 150.0 + 500.0 * u(rng); lat[i] = -80.0 + 160.0 * u(rng); lon[i] = 360.0 * u(rng);
+    ep[i] = t0 + 5.0 * 86400.0 * u(rng);
+  }
+  StateBatch b;
+  session->evaluate_batch(PointBatch{n, alt.data(), lat.data(), lon.data(), ep.data()}, sw, b);
+  if (b.n != n || b.species_count() != 3) { std::cerr << "batch shape wrong\n"; return 1; }
+  bool varies = false;
+  for (size_t i = 0; i < n; ++i) {
+    const AtmosphereState ref = session->model().evaluate(alt[i], lat[i], lon[i], format_iso_utc(ep[i]), sw.indices(ep[i]));
+    const AtmosphereState s = session->evaluate(alt[i], lat[i], lon[i], ep[i], sw);
+    const AtmosphereState bs = b.state(i);
+    if (bs.T_K != ref.T_K || s.T_K != ref.T_K) { std::cerr << "T differs at " << i << "\n"; return 1; }
+    for (size_t k = 0; k < 3; ++k)
+      if (bs.species[k].rho != ref.species[k].rho || s.species[k].rho != ref.species[k].rho) { std::cerr << "rho differs at " << i << "\n"; return 1; }
+    varies = varies || bs.T_K != b.state(0).T_K;
+  }
+  if (!varies) { std::cerr << "Indices did not vary across the batch\n"; return 1; }
+
+  std::cout << "OK: space-weather table\n";
+  return 0;
+}
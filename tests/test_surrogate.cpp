@@ -0,0 +1,120 @@
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "core/types.hpp"
+#include "core/units.hpp"
+#include "geom/Mesh.hpp"
+#include "gsi/SurrogateKernel.hpp"
+#include "solver/PanelSolver.hpp"
+
+using fmx::Vec3;
+using fmx::gsi::SurrogateKernel;
+
+// Double-precision reference forward pass of the same network
+static void reference(const std::vector<fmx::gsi::MlpLayer>& net, const std::array<double,5>& is, const std::array<double,5>& ic,
+                      const std::array<double,2>& os, const std::array<double,2>& oc, const double q[5], double& CN, double& CT) {
+  auto f = SurrogateKernel::features(q[0], q[1], q[2], q[3], q[4]);
+  std::vector<double> a(f.begin(), f.end());
+  for (int k = 0; k < 5; ++k) a[k] = (a[k] - is[k]) * ic[k];
+  for (size_t l = 0; l < net.size(); ++l) {
+    std::vector<double> b(net[l].out);
+    for (size_t o = 0; o < net[l].out; ++o) {
+      double s = net[l].b[o];
+      for (size_t k = 0; k < net[l].in; ++k) s += double(net[l].W[o*net[l].in + k]) * a[k];
+      b[o] = (l + 1 < net.size()) ? fmx::gsi::mlp_activation(s) : s;
+    }
+    a.swap(b);
+  }
+  CN = a[0] * oc[0] + os[0]; CT = a[1] * oc[1] + os[1];
+}
+
+int main() {
+  std::mt19937_64 rng(3);
+  std::uniform_real_distribution<double> u(-1.0, 1.0);
+  const unsigned widths[] = {5, 16, 12, 2};
+  std::vector<fmx::gsi::MlpLayer> net(3);
+  for (size_t l = 0; l < net.size(); ++l) {
+    net[l].in = widths[l]; net[l].out = widths[l+1];
+    for (unsigned i = 0; i < widths[l]*widths[l+1]; ++i) net[l].W.push_back(static_cast<float>(u(rng)));
+    for (unsigned i = 0; i < widths[l+1]; ++i) net[l].b.push_back(static_cast<float>(0.1 * u(rng)));
+  }
+  const std::array<double,5> is{0.8, 1.0, 1.0, 0.5, 0.5}, ic{2.0, 1.0, 2.0, 3.0, 3.0};
+  const std::array<double,2> os{1.5, 0.3}, oc{0.7, 0.2};
+  SurrogateKernel sk;
+  {
+    auto bad = net; bad[1].in = 7;
+    if (sk.set_network(bad, is, ic, os, oc) || sk.valid()) { std::cerr << "Inconsistent layer widths accepted\n"; return 1; }
+  }
+  if (!sk.set_network(net, is, ic, os, oc)) { std::cerr << "set_network failed\n"; return 1; }
+
+  // Batched (blocked, float) inference agrees with a double reference; tail blocks are handled
+  const size_t n = 150;
+  std::vector<double> x[5], CN(n), CT(n);
+  for (size_t i = 0; i < n; ++i) {
+    x[0].push_back(0.75 * (1.0 + u(rng))); x[1].push_back(0.5 + 8.0 * (1.0 + u(rng)));
+    x[2].push_back(1.0 + 0.5 * u(rng)); x[3].push_back(0.5 + 0.5 * u(rng)); x[4].push_back(0.5 + 0.5 * u(rng));
+  }
+  sk.evaluate(n, x[0].data(), x[1].data(), x[2].data(), x[3].data(), x[4].data(), CN.data(), CT.data());
+  for (size_t i = 0; i < n; ++i) {
+    const double q[5] = {x[0][i], x[1][i], x[2][i], x[3][i], x[4][i]};
+    double rN, rT; reference(net, is, ic, os, oc, q, rN, rT);
+    if (std::abs(CN[i] - rN) > 1e-4 || std::abs(CT[i] - rT) > 1e-4) {
+      std::cerr << "Surrogate inference off at " << i << ": CN " << CN[i] << " vs " << rN << "\n"; return 1;
+    }
+    auto [qN, qT] = sk.query(q[0], q[1], q[2], q[3], q[4]);
+    if (qN != CN[i] || qT != CT[i]) { std::cerr << "Scalar query differs from batch\n"; return 1; }
+  }
+  {
+    std::vector<double> cn(n), ct(n);
+    sk.query_theta_batch(x[0], 3.0, 0.9, 0.4, 0.6, cn.data(), ct.data());
+    for (size_t i = 0; i < n; ++i) {
+      auto [qN, qT] = sk.query(x[0][i], 3.0, 0.9, 0.4, 0.6);
+      if (qN != cn[i] || qT != ct[i]) { std::cerr << "Theta batch differs from scalar query\n"; return 1; }
+    }
+  }
+
+  // Weight file round trip
+  const char* path = "test_surrogate.mlp";
+  SurrogateKernel loaded;
+  if (!sk.save(path) || !loaded.load(path) || loaded.parameter_count() != sk.parameter_count()) {
+    std::cerr << "Surrogate save/load failed\n"; return 1;
+  }
+  std::remove(path);
+  for (size_t i = 0; i < n; ++i) {
+    auto [a, b] = loaded.query(x[0][i], x[1][i], x[2][i], x[3][i], x[4][i]);
+    if (a != CN[i] || b != CT[i]) { std::cerr << "Loaded surrogate differs\n"; return 1; }
+  }
+
+  // Solver: batched surrogate coefficients equal the per-facet sum with scalar queries
+  fmx::geom::Mesh m;
+  m.tris.push_back({Vec3{0, 0.5, 0.5}, Vec3{0, 0.5, -0.5}, Vec3{0, -0.5, -0.5}});
+  m.tris.push_back({Vec3{0, -0.5, 0.5}, Vec3{0, 0.5, 0.5}, Vec3{0, -0.5, -0.5}});
+  fmx::solver::Input in;
+  in.facets = m.to_facets(0);
+  in.materials = { {0.6, 0.8, 1.0, 300.0} };
+  in.species = { {1e-12, 2.66e-26}, {3e-13, 4.65e-26} };
+  in.T_K = 900.0;
+  in.V_sat_ms = {7000.0, 3000.0, 1000.0};
+  in.gsi_model = fmx::solver::GsiModel::CLL;
+  in.cll_surrogate = &sk;
+  auto out = fmx::solver::solve(in);
+  const Vec3 c = in.V_sat_ms, chat = c / c.norm();
+  Vec3 F{0,0,0};
+  for (const auto& f : in.facets) {
+    const double mu = -Vec3::dot(chat, f.n);
+    if (mu <= 0.0) continue;
+    Vec3 t = (-chat) - mu * f.n; t = t / t.norm();
+    for (const auto& sp : in.species) {
+      const double Ma = c.norm() / std::sqrt(fmx::units::k_B * in.T_K / sp.mass);
+      auto [cn, ct] = sk.query(std::acos(mu), Ma, 300.0 / in.T_K, 0.6, 0.8);
+      F += (f.n * cn + t * ct) * (sp.rho * c.norm() * c.norm() * f.area);
+    }
+  }
+  if ((out.F - F).norm() > 1e-9 * (1.0 + F.norm())) {
+    std::cerr << "Solver surrogate batch differs: F=(" << out.F.x << "," << out.F.y << "," << out.F.z << ")\n"; return 1;
+  }
+  if (F.norm() == 0.0) { std::cerr << "Plate received no load\n"; return 1; }
+  return 0;
+}
@@ -0,0 +1,156 @@
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "geom/BVH.hpp"
+#include "geom/Mesh.hpp"
+#include "geom/SyntheticMesh.hpp"
+#include "solver/PanelSolver.hpp"
+
+using namespace fmx;
+
+// Reference any-hit: every triangle, same tolerances and origin offset as BVHOccluder
+static bool brute_any_hit(const std::vector<geom::Triangle>& tris, Vec3 o, Vec3 d, double t_max) {
+  o = o + d * 1e-6;
+  for (const auto& t : tris) {
+    const Vec3 e1 = t.v1 - t.v0, e2 = t.v2 - t.v0, p = Vec3::cross(d, e2);
+    const double det = Vec3::dot(e1, p);
+    if (std::abs(det) < 1e-7) continue;
+    const Vec3 s = o - t.v0;
+    const double u = Vec3::dot(s, p) / det;
+    if (u < 0.0 || u > 1.0) continue;
+    const Vec3 q = Vec3::cross(s, e1);
+    const double v = Vec3::dot(d, q) / det;
+    if (v < 0.0 || u + v > 1.0) continue;
+    const double tp = Vec3::dot(e2, q) / det;
+    if (tp > 1e-5 && tp < t_max) return true;
+  }
+  return false;
+}
+
+static solver::Input make_input(const std::vector<Facet>& facets, const geom::Occluder* occ) {
+  solver::Input in;
+  in.facets_view = &facets;
+  in.materials = {{1.0, 1.0, 0.9, 300.0}};
+  in.species = {{2.5e-12, 2.6567e-26}, {4.0e-13, 4.6518e-26}};
+  in.T_K = 900.0;
+  in.V_sat_ms = {7600.0, 150.0, -80.0};
+  in.occluder = occ;
+  return in;
+}
+
+int main() {
+  // Triangle budget is met for small and large targets
+  for (std::size_t target : {2000u, 20000u, 200000u}) {
+    geom::SatelliteSpec spec;
+    spec.target_triangles = target;
+    geom::SatelliteParts parts;
+    const auto m = geom::make_satellite(spec, &parts);
+    const double n = static_cast<double>(m.tris.size());
+    if (n > static_cast<double>(target) || n < 0.85 * static_cast<double>(target)) {
+      std::cerr << "target " << target << " gave " << m.tris.size() << " triangles\n"; return 1;
+    }
+    if (parts.bus + parts.arrays + parts.antenna + parts.instrument + parts.boom != m.tris.size() ||
+        parts.bus == 0 || parts.arrays == 0 || parts.antenna == 0 || parts.instrument == 0 || parts.boom == 0) {
+      std::cerr << "part counts do not add up for target " << target << "\n"; return 1;
+    }
+  }
+
+  geom::SatelliteSpec spec;
+  spec.target_triangles = 30000;
+  const auto mesh = geom::make_satellite(spec);
+  const auto facets = mesh.to_facets(0);
+
+  // No degenerate facets; every part is closed, so the area-weighted normals cancel
+  Vec3 nsum{0, 0, 0};
+  double area = 0.0;
+  for (const auto& f : facets) {
+    if (!(f.area > 1e-10)) { std::cerr << "degenerate facet\n"; return 1; }
+    nsum += f.n * f.area;
+    area += f.area;
+  }
+  if (nsum.norm() > 1e-9 * area) { std::cerr << "open or inconsistently wound surface: |sum n dA| = " << nsum.norm() << "\n"; return 1; }
+
+  // BVH agrees with brute force on random rays and on the solver's facet rays
+  const geom::BVHOccluder occ(mesh.tris);
+  std::mt19937_64 rng(7);
+  std::uniform_real_distribution<double> u(-1.0, 1.0);
+  std::size_t hits = 0;
+  for (int i = 0; i < 400; ++i) {
+    const Vec3 o{4.0 * u(rng), 4.0 * u(rng), 4.0 * u(rng)};
+    const Vec3 d = Vec3{u(rng), u(rng), u(rng)}.normalized();
+    const bool a = occ.any_hit(geom::Ray{o, d}, 1e9), b = brute_any_hit(mesh.tris, o, d, 1e9);
+    if (a != b) { std::cerr << "BVH and brute force disagree on random ray " << i << "\n"; return 1; }
+    hits += a;
+  }
+  if (hits == 0 || hits == 400) { std::cerr << "random rays not informative: " << hits << " hits\n"; return 1; }
+  const Vec3 chat = Vec3{7600.0, 150.0, -80.0}.normalized();
+  std::size_t front = 0, shadowed = 0;
+  for (std::size_t i = 0; i < facets.size(); i += 7) {
+    const auto& f = facets[i];
+    if (Vec3::dot(chat, f.n) >= 0.0) continue;
+    ++front;
+    const bool a = occ.any_hit(geom::Ray{f.r_center, -chat}, 1e9);
+    if (a != brute_any_hit(mesh.tris, f.r_center, -chat, 1e9)) { std::cerr << "BVH and brute force disagree on facet " << i << "\n"; return 1; }
+    shadowed += a;
+  }
+  // The dish shades the bus front and the instrument shades the boom root
+  if (shadowed == 0 || shadowed == front) { std::cerr << "no self-shadowing: " << shadowed << " of " << front << "\n"; return 1; }
+
+  auto in = make_input(facets, &occ);
+  const auto F_occ = solver::solve(in);
+  const auto F_ser = solver::solve_serial(in);
+  if ((F_occ.F - F_ser.F).norm() > 1e-9 * F_occ.F.norm() || (F_occ.M - F_ser.M).norm() > 1e-9 * F_occ.M.norm() + 1e-15) {
+    std::cerr << "solve and solve_serial differ\n"; return 1;
+  }
+  in.occluder = nullptr;
+  const auto F_open = solver::solve(in);
+  // Drag acts along -x for a +x velocity
+  const double D_occ = -F_occ.F.x, D_open = -F_open.F.x;
+  if (!(D_occ < D_open && D_occ > 0.3 * D_open)) {
+    std::cerr << "occlusion should reduce drag: " << D_occ << " vs " << D_open << "\n"; return 1;
+  }
+
+  // Round trips: OBJ is exact, binary STL single precision
+  const auto dir = std::filesystem::temp_directory_path();
+  const std::string obj = (dir / "fmx_test_sat.obj").string(), stl = (dir / "fmx_test_sat.stl").string();
+  std::string err;
+  if (!mesh.save(obj, &err) || !mesh.save(stl, &err)) { std::cerr << "save failed: " << err << "\n"; return 1; }
+  const auto mo = geom::Mesh::load(obj, &err), ms = geom::Mesh::load(stl, &err);
+  std::filesystem::remove(obj);
+  std::filesystem::remove(stl);
+  if (!mo || !ms || mo->tris.size() != mesh.tris.size() || ms->tris.size() != mesh.tris.size()) {
+    std::cerr << "reload failed: " << err << "\n"; return 1;
+  }
+  for (std::size_t i = 0; i < mesh.tris.size(); ++i) {
+    const auto& a = mesh.tris[i];
+    const auto& b = mo->tris[i];
+    const auto& c = ms->tris[i];
+    for (int k = 0; k < 3; ++k) {
+      const Vec3 va = k == 0 ? a.v0 : k == 1 ? a.v1 : a.v2;
+      const Vec3 vb = k == 0 ? b.v0 : k == 1 ? b.v1 : b.v2;
+      const Vec3 vc = k == 0 ? c.v0 : k == 1 ? c.v1 : c.v2;
+      if (va.x != vb.x || va.y != vb.y || va.z != vb.z) { std::cerr << "OBJ round trip not exact at " << i << "\n"; return 1; }
+      if ((va - vc).norm() > 1e-6 * (1.0 + va.norm())) { std::cerr << "STL round trip error at " << i << "\n"; return 1; }
+    }
+  }
+
+  // OBJ faces referring to missing vertices are rejected
+  {
+    const std::string bad = (dir / "fmx_test_bad.obj").string();
+    std::FILE* f = std::fopen(bad.c_str(), "w");
+    std::fputs("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\nf -1 -2 -3\nf 1 2 4\n", f);
+    std::fclose(f);
+    err.clear();
+    const auto m = geom::Mesh::load(bad, &err);
+    std::filesystem::remove(bad);
+    if (m || err.find("line 6") == std::string::npos) { std::cerr << "out-of-range OBJ index accepted\n"; return 1; }
+  }
+
+  std::cout << "synthetic mesh: " << mesh.tris.size() << " triangles, " << shadowed << "/" << front
+            << " sampled front facets shadowed, drag " << D_occ << " N (open " << D_open << " N)\n";
+  return 0;
+}
@@ -0,0 +1,56 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include "gsi/KernelSet.hpp"
+#include "gsi/TableBuilder.hpp"
+
+int main() {
+  // A steep step in theta at 0.43 on an otherwise multilinear model: refinement must pile nodes
+  // onto the step, leave the rest of theta and every other axis alone, and meet the tolerance
+  const double step = 0.43;
+  const fmx::gsi::GridModel model = [&](const double x[5]) {
+    return std::pair<double,double>{std::tanh((x[0] - step) / 0.01) + 0.1 * x[1], 0.5 * x[2] * x[3]};
+  };
+  fmx::gsi::GridAxes ax{{{0.0, 0.25, 0.5, 0.75, 1.0}, {1.0, 2.0}, {0.5, 1.0}, {0.0, 1.0}, {0.0, 1.0}}};
+  fmx::gsi::RefineOptions opt;
+  opt.adaptive = true;
+  opt.tol = 1e-3;
+  opt.max_iter = 14;
+  fmx::gsi::KernelSet ks;
+  std::array<fmx::gsi::AxisError, 5> errs;
+  std::string err;
+  if (!fmx::gsi::build_table(ax, model, opt, ks, &errs, &err)) { std::cerr << "build failed: " << err << "\n"; return 1; }
+  if (!(errs[0].max <= opt.tol)) { std::cerr << "theta error " << errs[0].max << " above tol\n"; return 1; }
+  for (int d = 1; d < 5; ++d) {
+    if (ax[d].size() != 2 || errs[d].max > 1e-12) { std::cerr << "axis " << d << " refined or inexact\n"; return 1; }
+  }
+  const auto& th = ax[0];
+  if (th.size() < 20 || th.size() > 200) { std::cerr << "theta nodes: " << th.size() << "\n"; return 1; }
+  std::size_t finest = 0;
+  for (std::size_t j = 0; j + 1 < th.size(); ++j) {
+    if (th[j+1] - th[j] < th[finest+1] - th[finest]) finest = j;
+    // Only the interval holding the step is refined
+    if ((th[j] < 0.25 || th[j] > 0.5) && th[j] != 0.0 && th[j] != 0.75 && th[j] != 1.0) {
+      std::cerr << "node inserted away from the step: " << th[j] << "\n"; return 1;
+    }
+  }
+  if (std::abs(0.5 * (th[finest] + th[finest+1]) - step) > 0.02 || th[finest+1] - th[finest] > 0.01) {
+    std::cerr << "finest interval [" << th[finest] << ", " << th[finest+1] << "] not at the step\n"; return 1;
+  }
+  // The installed table reproduces the model at a point inside the step
+  const double x[5] = {step + 0.003, 1.5, 0.75, 0.5, 0.5};
+  const auto [CN, CT] = ks.query(x[0], x[1], x[2], x[3], x[4]);
+  const auto ref = model(x);
+  if (std::abs(CN - ref.first) > 2.0 * opt.tol || std::abs(CT - ref.second) > 1e-12) {
+    std::cerr << "query " << CN << " vs " << ref.first << "\n"; return 1;
+  }
+
+  // Empty axes are rejected with a message rather than written out
+  fmx::gsi::GridAxes bad{{{0.0, 1.0}, {}, {1.0}, {0.0}, {0.0}}};
+  err.clear();
+  if (fmx::gsi::build_table(bad, model, opt, ks, nullptr, &err) || err.empty()) {
+    std::cerr << "empty axis not rejected\n"; return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,158 @@
+#include <cmath>
+#include <iostream>
+#include <string>
+#include "core/units.hpp"
+#include "geom/BVH.hpp"
+#include "geom/Mesh.hpp"
+#include "solver/Executor.hpp"
+#include "solver/PanelSolver.hpp"
+#include "solver/TestParticle.hpp"
+#include "tests/Fixtures.hpp"
+
+using fmx::Vec3;
+
+// Unit cube; without the +X face it is a cup open toward the oncoming flow
+static fmx::geom::Mesh make_box(bool open) {
+  fmx::geom::Mesh m;
+  const double h = 0.5;
+  auto add_quad = [&](Vec3 a, Vec3 b, Vec3 c, Vec3 d) { m.tris.push_back({a, b, c}); m.tris.push_back({d, a, c}); };
+  if (!open) add_quad({h, -h, -h}, {h, h, -h}, {h, h, h}, {h, -h, h});
+  add_quad({-h, h, h}, {-h, h, -h}, {-h, -h, -h}, {-h, -h, h});
+  add_quad({-h, h, h}, {h, h, h}, {h, h, -h}, {-h, h, -h});
+  add_quad({-h, -h, -h}, {h, -h, -h}, {h, -h, h}, {-h, -h, h});
+  add_quad({-h, -h, h}, {h, -h, h}, {h, h, h}, {-h, h, h});
+  add_quad({-h, h, -h}, {h, h, -h}, {h, -h, -h}, {-h, -h, -h});
+  return m;
+}
+
+static fmx::solver::Input make_input(const fmx::geom::Mesh& m, const Vec3& V) {
+  fmx::solver::Input in = fmx::test::stub_input(V);
+  in.facets = m.to_facets(0);
+  return in;
+}
+
+// Exact free-molecular force on a convex body of flat faces, diffuse re-emission at Tw: per
+// species, incident momentum flux plus the recoil of a half-Maxwellian at Tw, acting at the
+// face centroid (uniform over a flat face)
+static fmx::solver::Output analytic_diffuse(const fmx::solver::Input& in, const fmx::geom::Mesh& m) {
+  const double sqrt_pi = std::sqrt(M_PI), k_B = fmx::units::k_B;
+  const double Tw = in.materials[0].Tw_K;
+  const Vec3 U = in.wind_ms - in.V_sat_ms;
+  fmx::solver::Output out{};
+  for (const auto& t : m.tris) {
+    Vec3 n = Vec3::cross(t.v1 - t.v0, t.v2 - t.v0);
+    const double area = 0.5 * n.norm();
+    n = n / n.norm();
+    const Vec3 c = (t.v0 + t.v1 + t.v2) / 3.0;
+    const Vec3 Ut = U - n * Vec3::dot(U, n);
+    Vec3 F;
+    for (const auto& sp : in.species) {
+      const double s = std::sqrt(2.0 * k_B * in.T_K / sp.mass), sw = std::sqrt(2.0 * k_B * Tw / sp.mass);
+      const double n0 = sp.rho / sp.mass, a = -Vec3::dot(U, n) / s, e = std::exp(-a * a), g = 1.0 + std::erf(a);
+      const double flux = n0 * s * (e + sqrt_pi * a * g) / (2.0 * sqrt_pi);
+      const double p_in = sp.rho * s * s * (a * e / (2.0 * sqrt_pi) + 0.5 * g * (a * a + 0.5));
+      F += (-n * (p_in + flux * sp.mass * sw * 0.5 * sqrt_pi) + Ut * (flux * sp.mass)) * area;
+    }
+    out.F += F;
+    out.M += Vec3::cross(c - in.r_CG, F);
+  }
+  return out;
+}
+
+static bool within(const Vec3& a, const Vec3& b, const Vec3& sigma, double k, double rel, const char* what) {
+  const double tol_rel = rel * b.norm();
+  const double d[3] = {a.x - b.x, a.y - b.y, a.z - b.z}, s[3] = {sigma.x, sigma.y, sigma.z};
+  for (int j = 0; j < 3; ++j) {
+    if (std::abs(d[j]) > k * s[j] + tol_rel) {
+      std::cerr << what << ": (" << a.x << ", " << a.y << ", " << a.z << ") vs (" << b.x << ", " << b.y << ", " << b.z
+                << "), sigma (" << s[0] << ", " << s[1] << ", " << s[2] << ")\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  fmx::solver::TpmcOptions opt;
+  opt.particles = 200000;
+  opt.batch = 4096;
+
+  // Convex cube in oblique flow: no molecule comes back, so TPMC samples the closed-form answer
+  {
+    const auto cube = make_box(false);
+    const fmx::geom::BVHOccluder bvh(cube.tris);
+    auto in = make_input(cube, Vec3{7500.0, 3750.0, 2250.0});
+    in.r_CG = {0.1, -0.2, 0.05};
+    const auto exact = analytic_diffuse(in, cube);
+    std::string err;
+    const auto r = fmx::solver::solve_tpmc(in, bvh, opt, &err);
+    if (!r) { std::cerr << "tpmc failed: " << err << "\n"; return 1; }
+    if (r->multi != 0 || r->dropped != 0 || r->struck == 0 || r->hits != r->struck || r->particles != opt.particles) {
+      std::cerr << "convex cube: struck " << r->struck << " multi " << r->multi << " dropped " << r->dropped << "\n"; return 1;
+    }
+    if (!within(r->out.F, exact.F, r->F_stderr, 4.0, 0.001, "cube F vs closed form")) return 1;
+    if (!within(r->out.M, exact.M, r->M_stderr, 4.0, 0.001, "cube M vs closed form")) return 1;
+    Vec3 sum;
+    for (const auto& f : r->facet_F) sum += f;
+    if ((sum - r->out.F).norm() > 1e-9 * r->out.F.norm()) { std::cerr << "facet forces do not add up to F\n"; return 1; }
+
+    // CLL with full accommodation is the diffuse kernel at Tw
+    in.gsi_model = fmx::solver::GsiModel::CLL;
+    const auto cll = fmx::solver::solve_tpmc(in, bvh, opt);
+    if (!cll || !within(cll->out.F, r->out.F, r->F_stderr * std::sqrt(2.0), 4.0, 0.0, "CLL(1,1) vs diffuse")) return 1;
+
+    // Batches own their RNG streams: the thread count does not change a bit of the answer
+    in.gsi_model = fmx::solver::GsiModel::Sentman;
+    for (unsigned threads : {1u, 3u}) {
+      fmx::solver::Executor ex(threads);
+      in.executor = &ex;
+      const auto e = fmx::solver::solve_tpmc(in, bvh, opt);
+      if (!e || e->out.F.x != r->out.F.x || e->out.F.y != r->out.F.y || e->out.F.z != r->out.F.z ||
+          e->out.M.x != r->out.M.x || e->out.M.y != r->out.M.y || e->out.M.z != r->out.M.z || e->hits != r->hits ||
+          e->facet_F.size() != r->facet_F.size()) {
+        std::cerr << "executor(" << threads << ") run differs\n"; return 1;
+      }
+      for (std::size_t i = 0; i < r->facet_F.size(); ++i) {
+        const Vec3 a = e->facet_F[i], b = r->facet_F[i];
+        if (a.x != b.x || a.y != b.y || a.z != b.z) { std::cerr << "executor(" << threads << ") facet " << i << " differs\n"; return 1; }
+      }
+    }
+    in.executor = nullptr;
+
+    // One batch has no scatter to estimate an error from
+    auto single = opt;
+    single.particles = 2000;
+    const auto s1 = fmx::solver::solve_tpmc(in, bvh, single);
+    if (!s1 || !std::isnan(s1->F_stderr.x) || !std::isnan(s1->M_stderr.z)) { std::cerr << "single batch stderr not NaN\n"; return 1; }
+  }
+
+  // Cup facing the flow: molecules bounce around inside, and cutting the trace after the first
+  // hit loses momentum they still carry out of the cup
+  {
+    const auto cup = make_box(true);
+    const fmx::geom::BVHOccluder bvh(cup.tris);
+    const auto in = make_input(cup, Vec3{7500.0, 0.0, 0.0});
+    const auto full = fmx::solver::solve_tpmc(in, bvh, opt);
+    auto one = opt;
+    one.max_hits = 1;
+    const auto first = fmx::solver::solve_tpmc(in, bvh, one);
+    if (!full || !first || full->multi == 0 || full->dropped != 0 || first->dropped == 0) {
+      std::cerr << "cup: multi " << (full ? full->multi : 0) << "\n"; return 1;
+    }
+    const double sig = std::hypot(full->F_stderr.x, first->F_stderr.x);
+    if (!(std::abs(full->out.F.x - first->out.F.x) > 4.0 * sig)) {
+      std::cerr << "cup: multiple reflections change F.x by " << full->out.F.x - first->out.F.x << " (sigma " << sig << ")\n"; return 1;
+    }
+  }
+
+  // Mismatched geometry is rejected
+  {
+    const auto cube = make_box(false), cup = make_box(true);
+    const fmx::geom::BVHOccluder bvh(cup.tris);
+    std::string err;
+    if (fmx::solver::solve_tpmc(make_input(cube, Vec3{7500.0, 0.0, 0.0}), bvh, opt, &err) || err.empty()) {
+      std::cerr << "size mismatch not rejected\n"; return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,79 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/Trace.hpp"
+#include "solver/Executor.hpp"
+
+static std::size_t count_of(const std::string& s, const std::string& what) {
+  std::size_t n = 0;
+  for (auto p = s.find(what); p != std::string::npos; p = s.find(what, p + 1)) ++n;
+  return n;
+}
+
+int main() {
+  auto& rec = fmx::trace::Recorder::instance();
+  // Off by default: spans cost a flag check and record nothing
+  { FMX_TRACE_SCOPE("off", "test"); }
+  if (rec.enabled() || rec.event_count() != 0) { std::cerr << "trace recorded while disabled\n"; return 1; }
+
+  rec.start();
+  fmx::trace::set_thread_name("main");
+  {
+    FMX_TRACE_SCOPE("outer", "test", 42);
+    std::vector<std::thread> ts;
+    for (int k = 0; k < 3; ++k) {
+      ts.emplace_back([] {
+        fmx::trace::set_thread_name("worker");
+        for (int i = 0; i < 10; ++i) { FMX_TRACE_SCOPE("inner", "test"); }
+      });
+    }
+    for (auto& t : ts) t.join();
+    // Executor participants record one span each per parallel_for
+    fmx::solver::Executor ex(2);
+    ex.parallel_for(1000, 10, [](std::size_t, std::size_t) {});
+    fmx::trace::Scope early("early", "test");
+    early.end();
+    early.end(); // a closed span is not recorded twice
+  }
+  rec.stop();
+  { FMX_TRACE_SCOPE("after", "test"); }
+
+  const auto path = (std::filesystem::temp_directory_path() / "fmx_test_trace.json").string();
+  std::string err;
+  if (!rec.write(path, &err)) { std::cerr << err << "\n"; return 1; }
+  std::stringstream ss;
+  ss << std::ifstream(path).rdbuf();
+  std::filesystem::remove(path);
+  const std::string s = ss.str();
+  if (count_of(s, "\"name\":\"inner\"") != 30 || count_of(s, "\"name\":\"outer\"") != 1 ||
+      count_of(s, "\"name\":\"early\"") != 1 || count_of(s, "\"name\":\"after\"") != 0 ||
+      count_of(s, "\"name\":\"off\"") != 0 || count_of(s, "\"name\":\"executor.participate\"") != 2) {
+    std::cerr << "unexpected span counts in trace:\n" << s << "\n"; return 1;
+  }
+  // Thread tracks: main, three workers, one executor thread
+  if (count_of(s, "\"name\":\"thread_name\"") != 5 || count_of(s, "\"args\":{\"n\":42}") != 1) {
+    std::cerr << "thread names or span argument missing\n"; return 1;
+  }
+  if (s.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) != 0 || s.find("\n]}") == std::string::npos ||
+      count_of(s, "{") != count_of(s, "}")) {
+    std::cerr << "malformed trace JSON\n"; return 1;
+  }
+
+  // Full per-thread buffers drop further spans and count them; start() resets the count
+  rec.set_capacity(4);
+  rec.start();
+  for (int i = 0; i < 10; ++i) { FMX_TRACE_SCOPE("capped", "test"); }
+  rec.stop();
+  if (rec.event_count() != 4 || rec.dropped() != 6) {
+    std::cerr << "capacity not enforced: " << rec.event_count() << " kept, " << rec.dropped() << " dropped\n"; return 1;
+  }
+  rec.set_capacity(fmx::trace::Recorder::kDefaultCapacity);
+  rec.start();
+  rec.stop();
+  if (rec.dropped() != 0) { std::cerr << "dropped count not reset\n"; return 1; }
+  return 0;
+}
@@ -0,0 +1,136 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "cli/Trajectory.hpp"
+#include "core/BoundedQueue.hpp"
+#include "core/Frames.hpp"
+#include "geom/Mesh.hpp"
+#include "tests/Fixtures.hpp"
+
+using namespace fmx;
+
+static bool near(const Vec3& a, const Vec3& b, double tol) { return (a - b).norm() <= tol; }
+
+int main() {
+  // Bounded queue: order preserved across threads, close() drains then ends
+  {
+    BoundedQueue<int> q(2);
+    std::thread prod([&]{ for (int i = 0; i < 10000; ++i) q.push(i); q.close(); });
+    int expect = 0;
+    while (auto v = q.pop()) { if (*v != expect++) { std::cerr << "queue order wrong\n"; return 1; } }
+    prod.join();
+    if (expect != 10000 || q.push(1)) { std::cerr << "queue close wrong\n"; return 1; }
+  }
+
+  // Geodetic round trip (equator, mid-latitude, near pole, southern hemisphere)
+  const Geodetic gs[4] = {{0.0, 0.0, 400.0}, {51.6, -120.0, 550.0}, {89.99, 45.0, 300.0}, {-33.0, 170.0, 180.0}};
+  for (const auto& g : gs) {
+    const Geodetic r = ecef_to_geodetic(geodetic_to_ecef(g));
+    if (std::abs(r.lat_deg - g.lat_deg) > 1e-9 || std::abs(r.lon_deg - g.lon_deg) > 1e-9 || std::abs(r.alt_km - g.alt_km) > 1e-6) {
+      std::cerr << "geodetic round trip wrong: " << r.lat_deg << " " << r.lon_deg << " " << r.alt_km << "\n"; return 1;
+    }
+  }
+  // Local axes: up at (0,0) is +x ECEF, east is +y, north is +z
+  if (!near(enu_to_ecef(0.0, 0.0, {1, 2, 3}), {3, 1, 2}, 1e-12)) { std::cerr << "ENU axes wrong\n"; return 1; }
+  // 90 deg about z maps x to y
+  const Quat qz{std::cos(M_PI / 4), 0, 0, std::sin(M_PI / 4)};
+  if (!near(qz.rotate({1, 0, 0}), {0, 1, 0}, 1e-12) || !near(qz.conj().rotate({0, 1, 0}), {1, 0, 0}, 1e-12)) {
+    std::cerr << "quaternion rotation wrong\n"; return 1;
+  }
+
+  // Row parsing
+  cli::EphemerisRow row;
+  if (cli::parse_ephemeris_row("epoch,x,y,z,vx,vy,vz", row) || cli::parse_ephemeris_row("# comment", row)
+      || cli::parse_ephemeris_row("1,2,3", row)) { std::cerr << "non-row accepted\n"; return 1; }
+  if (!cli::parse_ephemeris_row("2025-09-12T00:00:10Z, 6778137, 0, 0, 0, 7660, 0\r", row)
+      || row.epoch_s != 1757635210.0 || row.has_attitude || row.v_ecef_ms.y != 7660.0) { std::cerr << "ISO row wrong\n"; return 1; }
+  if (!cli::parse_ephemeris_row("1757635210.5,6778137,0,0,0,7660,0,0,0,0,2", row)
+      || row.epoch_s != 1757635210.5 || !row.has_attitude || std::abs(row.q_body_to_ecef.z - 1.0) > 1e-15) {
+    std::cerr << "attitude row wrong\n"; return 1;
+  }
+  // Ram frame: velocity along +x body, nadir along +z body
+  row.has_attitude = false;
+  if (!near(cli::ecef_to_body(row, row.v_ecef_ms), {7660, 0, 0}, 1e-9) || !near(cli::ecef_to_body(row, {-1, 0, 0}), {0, 0, 1}, 1e-12)) {
+    std::cerr << "ram frame wrong\n"; return 1;
+  }
+
+  // End to end: 1000 s of a circular equatorial orbit at 1 Hz, plate facing the flow
+  const char* ephem = "test_trajectory_ephem.csv";
+  {
+    std::ofstream f(ephem);
+    f << "epoch,x,y,z,vx,vy,vz\n";
+    const double R = 6778137.0, w = 7670.0 / R;
+    for (int i = 0; i < 1000; ++i) {
+      const double t = i, c = std::cos(w * t), s = std::sin(w * t);
+      char buf[200];
+      std::snprintf(buf, sizeof(buf), "%.1f,%.6f,%.6f,0,%.9f,%.9f,0\n", 1757635200.0 + t, R * c, R * s, -7670.0 * s, 7670.0 * c);
+      f << buf;
+    }
+  }
+  const geom::Mesh mesh = test::unit_plate();
+  solver::Input base;
+  base.facets = mesh.to_facets(0); // normal -x: faces the ram direction (+x body)
+  base.materials = {{1.0, 1.0, 1.0, 300.0}};
+  auto session = atm::AtmosphereSession::open(atm::SessionConfig{});
+  if (!session) { std::cerr << "session failed\n"; return 1; }
+  atm::SpaceWeatherTable no_sw;
+  atm::Indices idx;
+
+  cli::TrajectoryOptions opt;
+  opt.ephemeris_path = ephem;
+  opt.block_rows = 64;
+  opt.queue_blocks = 2;
+  cli::TrajectoryStats st;
+  std::string err;
+  opt.out_path = "test_trajectory_out.bin"; opt.binary = true;
+  if (!cli::run_trajectory(opt, *session, no_sw, idx, base, &st, &err)) { std::cerr << "binary run failed: " << err << "\n"; return 1; }
+  if (st.rows != 1000 || st.skipped != 1) { std::cerr << "rows " << st.rows << " skipped " << st.skipped << "\n"; return 1; }
+  opt.out_path = "test_trajectory_out.csv"; opt.binary = false; opt.block_rows = 7;
+  if (!cli::run_trajectory(opt, *session, no_sw, idx, base, &st, &err)) { std::cerr << "csv run failed: " << err << "\n"; return 1; }
+
+  std::ifstream bin("test_trajectory_out.bin", std::ios::binary);
+  char magic[8]; bin.read(magic, 8);
+  bin.seekg(64);
+  std::vector<double> rec(1000 * 12);
+  bin.read(reinterpret_cast<char*>(rec.data()), static_cast<std::streamsize>(rec.size() * sizeof(double)));
+  if (std::strcmp(magic, "FMXTRJ1") != 0 || !bin) { std::cerr << "binary output wrong\n"; return 1; }
+  std::ifstream csv("test_trajectory_out.csv");
+  std::string line;
+  std::getline(csv, line);
+  for (int i = 0; i < 1000; ++i) {
+    if (!std::getline(csv, line)) { std::cerr << "csv short\n"; return 1; }
+    std::istringstream ls(line);
+    double v[12]; char comma;
+    for (int k = 0; k < 12; ++k) { ls >> v[k]; if (k < 11) ls >> comma; }
+    for (int k = 0; k < 12; ++k) {
+      if (std::abs(v[k] - rec[12*i + k]) > 1e-6 * std::abs(rec[12*i + k]) + 1e-3 * (k == 0)) { std::cerr << "csv/bin differ at row " << i << "\n"; return 1; }
+    }
+  }
+  // Row 500 against a direct solve: drag on the ram plate only, along -x body
+  {
+    const double* f = rec.data() + 12 * 500;
+    if (std::abs(f[0] - 1757635700.0) > 1e-6 || std::abs(f[7] - 400.0) > 1.0 || std::abs(f[8]) > 1e-6) {
+      std::cerr << "row geodetic wrong: " << f[7] << " " << f[8] << "\n"; return 1;
+    }
+    const atm::AtmosphereState s = session->evaluate(f[7], f[8], f[9], f[0], idx);
+    solver::Input in = base;
+    for (const auto& sp : s.species) in.species.push_back({sp.rho, sp.mass});
+    in.T_K = s.T_K;
+    in.V_sat_ms = {7670.0, 0, 0};
+    const solver::Output o = solver::solve(in);
+    if (std::abs(f[1] - o.F.x) > 1e-6 * std::abs(o.F.x) || !(f[1] < 0.0) || std::abs(f[2]) > 1e-9 * std::abs(f[1])) {
+      std::cerr << "row force wrong: " << f[1] << " vs " << o.F.x << "\n"; return 1;
+    }
+  }
+  std::remove(ephem); std::remove("test_trajectory_out.bin"); std::remove("test_trajectory_out.csv");
+  opt.ephemeris_path = "missing_ephem.csv";
+  if (cli::run_trajectory(opt, *session, no_sw, idx, base, &st, &err)) { std::cerr << "missing ephemeris accepted\n"; return 1; }
+
+  std::cout << "OK: trajectory pipeline\n";
+  return 0;
+}
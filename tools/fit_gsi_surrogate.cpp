@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#include "gsi/Sentman.hpp"
+#include "gsi/CLL.hpp"
+#include "gsi/SurrogateKernel.hpp"
+
+static void usage() {
+  std::cout << "Usage: fit_gsi_surrogate --model Sentman|CLL --out kernel.mlp\n"
+               "       [--hidden 32,32] [--samples 20000] [--val 4000] [--epochs 60] [--batch 32]\n"
+               "       [--lr 2e-3] [--seed 1] [--theta_deg_max 90] [--Ma 0.5,16] [--tau 0.3,2]\n"
+               "       [--alpha_n 0,1] [--alpha_t 0,1]\n"
+               "  Samples (theta, Ma, tau, alpha_n, alpha_t) uniformly (Ma log-uniform) in the given\n"
+               "  ranges, evaluates the GSI model and fits a tanh-type MLP with Adam on the CPU.\n"
+               "  Prints the validation error of the written (float32) network.\n";
+}
+
+static std::vector<double> parse_list(const std::string& s) {
+  std::vector<double> v; std::string tok; for (size_t i=0,j=0; i<=s.size(); ++i) {
+    if (i==s.size() || s[i]==',') { tok = s.substr(j, i-j); try{ v.push_back(std::stod(tok)); }catch(...){} j=i+1; }
+  } return v;
+}
+
+namespace {
+
+using fmx::gsi::SurrogateKernel;
+
+struct Sample { double x[5]; double y[2]; }; // raw inputs (theta, Ma, tau, an, at), (CN, CT)
+
+struct Layer {
+  size_t in, out;
+  std::vector<double> W, b;    // parameters
+  std::vector<double> gW, gb;  // gradients of the current minibatch
+  std::vector<double> mW, vW, mb, vb; // Adam moments
+};
+
+std::vector<Sample> draw_samples(size_t n, std::mt19937_64& rng, bool sentman, const double th_max,
+                                 const std::vector<double>& Ma, const std::vector<double>& tau,
+                                 const std::vector<double>& an, const std::vector<double>& at) {
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  std::vector<Sample> s(n);
+  for (auto& p : s) {
+    p.x[0] = th_max * u(rng);
+    p.x[1] = std::exp(std::log(Ma[0]) + (std::log(Ma[1]) - std::log(Ma[0])) * u(rng));
+    p.x[2] = tau[0] + (tau[1] - tau[0]) * u(rng);
+    p.x[3] = an[0] + (an[1] - an[0]) * u(rng);
+    p.x[4] = at[0] + (at[1] - at[0]) * u(rng);
+  }
+#if defined(FMX_USE_OPENMP)
+  #pragma omp parallel for schedule(dynamic, 64)
+#endif
+  for (long long i = 0; i < static_cast<long long>(n); ++i) {
+    auto& p = s[static_cast<size_t>(i)];
+    if (sentman) std::tie(p.y[0], p.y[1]) = fmx::gsi::coefficients(p.x[0], p.x[1], p.x[2], fmx::gsi::SentmanParams{1.0});
+    else std::tie(p.y[0], p.y[1]) = fmx::gsi::coefficients(p.x[0], p.x[1], p.x[2], fmx::gsi::CLLParams{p.x[3], p.x[4]});
+  }
+  return s;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::string model = "CLL", out_path;
+  std::vector<double> hidden{32, 32};
+  size_t n_train = 20000, n_val = 4000, batch = 32;
+  int epochs = 60;
+  double lr = 2e-3, th_deg_max = 90.0;
+  unsigned long long seed = 1;
+  std::vector<double> r_Ma{0.5, 16.0}, r_tau{0.3, 2.0}, r_an{0.0, 1.0}, r_at{0.0, 1.0};
+  for (int i=1;i<argc;++i) {
+    std::string a=argv[i];
+    if (a=="--model" && i+1<argc) model=argv[++i];
+    else if (a=="--out" && i+1<argc) out_path=argv[++i];
+    else if (a=="--hidden" && i+1<argc) hidden=parse_list(argv[++i]);
+    else if (a=="--samples" && i+1<argc) n_train=static_cast<size_t>(std::stoul(argv[++i]));
+    else if (a=="--val" && i+1<argc) n_val=static_cast<size_t>(std::stoul(argv[++i]));
+    else if (a=="--epochs" && i+1<argc) epochs=std::stoi(argv[++i]);
+    else if (a=="--batch" && i+1<argc) batch=static_cast<size_t>(std::stoul(argv[++i]));
+    else if (a=="--lr" && i+1<argc) lr=std::stod(argv[++i]);
+    else if (a=="--seed" && i+1<argc) seed=std::stoull(argv[++i]);
+    else if (a=="--theta_deg_max" && i+1<argc) th_deg_max=std::stod(argv[++i]);
+    else if (a=="--Ma" && i+1<argc) r_Ma=parse_list(argv[++i]);
+    else if (a=="--tau" && i+1<argc) r_tau=parse_list(argv[++i]);
+    else if (a=="--alpha_n" && i+1<argc) r_an=parse_list(argv[++i]);
+    else if (a=="--alpha_t" && i+1<argc) r_at=parse_list(argv[++i]);
+    else if (a=="--help") { usage(); return 0; }
+  }
+  if (out_path.empty()) { usage(); std::cerr << "--out is required\n"; return 1; }
+  if (r_Ma.size()!=2 || r_tau.size()!=2 || r_an.size()!=2 || r_at.size()!=2 || !(r_Ma[0] > 0.0)) {
+    std::cerr << "Ranges must be given as lo,hi (Ma > 0)\n"; return 1;
+  }
+  if (hidden.empty() || hidden.size() + 1 > SurrogateKernel::kMaxLayers || n_train == 0 || batch == 0) {
+    std::cerr << "Invalid network/training configuration\n"; return 1;
+  }
+
+  std::mt19937_64 rng(seed);
+  const bool sentman = (model == "Sentman");
+  const double th_max = th_deg_max * M_PI / 180.0;
+  std::vector<Sample> train = draw_samples(n_train, rng, sentman, th_max, r_Ma, r_tau, r_an, r_at);
+  std::vector<Sample> val = draw_samples(n_val, rng, sentman, th_max, r_Ma, r_tau, r_an, r_at);
+
+  // Standardize features and targets over the training set
+  std::array<double,5> in_shift{}, in_scale{};
+  std::array<double,2> out_shift{}, out_scale{};
+  std::vector<std::array<double,5>> feats(n_train);
+  for (size_t i = 0; i < n_train; ++i) {
+    const auto& p = train[i];
+    feats[i] = SurrogateKernel::features(p.x[0], p.x[1], p.x[2], p.x[3], p.x[4]);
+  }
+  for (int k = 0; k < 5; ++k) {
+    double m = 0.0, m2 = 0.0;
+    for (const auto& f : feats) { m += f[k]; m2 += f[k]*f[k]; }
+    m /= n_train; const double sd = std::sqrt(std::max(0.0, m2 / n_train - m*m));
+    in_shift[k] = m; in_scale[k] = sd > 1e-12 ? 1.0 / sd : 1.0;
+  }
+  for (int k = 0; k < 2; ++k) {
+    double m = 0.0, m2 = 0.0;
+    for (const auto& p : train) { m += p.y[k]; m2 += p.y[k]*p.y[k]; }
+    m /= n_train; const double sd = std::sqrt(std::max(0.0, m2 / n_train - m*m));
+    out_shift[k] = m; out_scale[k] = sd > 1e-12 ? sd : 1.0;
+  }
+
+  // Network (Xavier-uniform init)
+  std::vector<size_t> widths{SurrogateKernel::kInputs};
+  for (double h : hidden) widths.push_back(static_cast<size_t>(std::max(1.0, h)));
+  widths.push_back(SurrogateKernel::kOutputs);
+  std::vector<Layer> net(widths.size() - 1);
+  for (size_t l = 0; l < net.size(); ++l) {
+    auto& L = net[l];
+    L.in = widths[l]; L.out = widths[l+1];
+    const double lim = std::sqrt(6.0 / static_cast<double>(L.in + L.out));
+    std::uniform_real_distribution<double> u(-lim, lim);
+    L.W.resize(L.in * L.out); for (auto& w : L.W) w = u(rng);
+    L.b.assign(L.out, 0.0);
+    L.gW.assign(L.W.size(), 0.0); L.gb.assign(L.out, 0.0);
+    L.mW.assign(L.W.size(), 0.0); L.vW.assign(L.W.size(), 0.0);
+    L.mb.assign(L.out, 0.0); L.vb.assign(L.out, 0.0);
+  }
+
+  // Adam on mean squared error of standardized targets, cosine learning-rate decay
+  const double beta1 = 0.9, beta2 = 0.999, eps = 1e-8;
+  std::vector<std::vector<double>> z(net.size()), act(net.size() + 1), delta(net.size());
+  for (size_t l = 0; l < net.size(); ++l) { z[l].resize(net[l].out); delta[l].resize(net[l].out); act[l+1].resize(net[l].out); }
+  act[0].resize(SurrogateKernel::kInputs);
+  std::vector<size_t> order(n_train);
+  std::iota(order.begin(), order.end(), 0);
+  const size_t steps_per_epoch = (n_train + batch - 1) / batch;
+  const size_t total_steps = steps_per_epoch * static_cast<size_t>(std::max(1, epochs));
+  size_t step = 0;
+  for (int ep = 0; ep < epochs; ++ep) {
+    std::shuffle(order.begin(), order.end(), rng);
+    double loss = 0.0;
+    for (size_t b0 = 0; b0 < n_train; b0 += batch) {
+      const size_t b1 = std::min(n_train, b0 + batch);
+      for (auto& L : net) { std::fill(L.gW.begin(), L.gW.end(), 0.0); std::fill(L.gb.begin(), L.gb.end(), 0.0); }
+      for (size_t j = b0; j < b1; ++j) {
+        const size_t i = order[j];
+        for (int k = 0; k < 5; ++k) act[0][k] = (feats[i][k] - in_shift[k]) * in_scale[k];
+        for (size_t l = 0; l < net.size(); ++l) {
+          const auto& L = net[l];
+          const bool hid = l + 1 < net.size();
+          for (size_t o = 0; o < L.out; ++o) {
+            double s = L.b[o];
+            for (size_t k = 0; k < L.in; ++k) s += L.W[o*L.in + k] * act[l][k];
+            z[l][o] = s;
+            act[l+1][o] = hid ? fmx::gsi::mlp_activation(s) : s;
+          }
+        }
+        auto& dl = delta.back();
+        for (int k = 0; k < 2; ++k) {
+          const double e = act.back()[k] - (train[i].y[k] - out_shift[k]) / out_scale[k];
+          dl[k] = e; loss += e*e;
+        }
+        for (size_t l = net.size(); l-- > 0; ) {
+          auto& L = net[l];
+          for (size_t o = 0; o < L.out; ++o) {
+            const double d = delta[l][o];
+            L.gb[o] += d;
+            for (size_t k = 0; k < L.in; ++k) L.gW[o*L.in + k] += d * act[l][k];
+          }
+          if (l == 0) break;
+          for (size_t k = 0; k < L.in; ++k) {
+            double s = 0.0;
+            for (size_t o = 0; o < L.out; ++o) s += L.W[o*L.in + k] * delta[l][o];
+            delta[l-1][k] = s * fmx::gsi::mlp_activation_grad(z[l-1][k]);
+          }
+        }
+      }
+      ++step;
+      const double inv_n = 1.0 / static_cast<double>(b1 - b0);
+      const double lr_t = 0.5 * lr * (1.0 + std::cos(M_PI * static_cast<double>(step) / static_cast<double>(total_steps)));
+      const double c1 = 1.0 - std::pow(beta1, static_cast<double>(step));
+      const double c2 = 1.0 - std::pow(beta2, static_cast<double>(step));
+      auto adam = [&](std::vector<double>& p, const std::vector<double>& g, std::vector<double>& m, std::vector<double>& v) {
+        for (size_t k = 0; k < p.size(); ++k) {
+          const double gk = g[k] * inv_n;
+          m[k] = beta1 * m[k] + (1.0 - beta1) * gk;
+          v[k] = beta2 * v[k] + (1.0 - beta2) * gk * gk;
+          p[k] -= lr_t * (m[k] / c1) / (std::sqrt(v[k] / c2) + eps);
+        }
+      };
+      for (auto& L : net) { adam(L.W, L.gW, L.mW, L.vW); adam(L.b, L.gb, L.mb, L.vb); }
+    }
+    if (ep == 0 || (ep + 1) % 10 == 0 || ep + 1 == epochs)
+      std::cerr << "epoch " << ep+1 << ": train mse (standardized) " << loss / (2.0 * n_train) << "\n";
+  }
+
+  // Export float32 network and validate the inference path on held-out samples
+  std::vector<fmx::gsi::MlpLayer> layers(net.size());
+  for (size_t l = 0; l < net.size(); ++l) {
+    layers[l].in = static_cast<std::uint32_t>(net[l].in); layers[l].out = static_cast<std::uint32_t>(net[l].out);
+    layers[l].W.assign(net[l].W.begin(), net[l].W.end());
+    layers[l].b.assign(net[l].b.begin(), net[l].b.end());
+  }
+  SurrogateKernel sk;
+  if (!sk.set_network(std::move(layers), in_shift, in_scale, out_shift, out_scale) || !sk.save(out_path)) {
+    std::cerr << "Failed to write surrogate: " << out_path << "\n"; return 1;
+  }
+  if (n_val > 0) {
+    std::vector<double> c[5], CN(n_val), CT(n_val);
+    for (int k = 0; k < 5; ++k) { c[k].resize(n_val); for (size_t i = 0; i < n_val; ++i) c[k][i] = val[i].x[k]; }
+    sk.evaluate(n_val, c[0].data(), c[1].data(), c[2].data(), c[3].data(), c[4].data(), CN.data(), CT.data());
+    double mx[2] = {0.0, 0.0}, s2[2] = {0.0, 0.0};
+    for (size_t i = 0; i < n_val; ++i) {
+      const double e[2] = {std::abs(CN[i] - val[i].y[0]), std::abs(CT[i] - val[i].y[1])};
+      for (int k = 0; k < 2; ++k) { mx[k] = std::max(mx[k], e[k]); s2[k] += e[k]*e[k]; }
+    }
+    std::cerr << "Validation (" << n_val << " samples): CN max " << mx[0] << " rms " << std::sqrt(s2[0]/n_val)
+              << ", CT max " << mx[1] << " rms " << std::sqrt(s2[1]/n_val) << "\n";
+  }
+  std::cerr << "Wrote surrogate: " << sk.parameter_count() << " parameters ("
+            << sk.parameter_count() * sizeof(float) << " B) to " << out_path << "\n";
+  return 0;
+}
@@ -0,0 +1,474 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(FMX_USE_OPENMP)
+#include <omp.h>
+#endif
+#include "atm/AtmosphereSession.hpp"
+#include "geom/BVH.hpp"
+#include "geom/Mesh.hpp"
+#include "geom/SyntheticMesh.hpp"
+#include "gsi/CLL.hpp"
+#include "gsi/KernelSet.hpp"
+#include "gsi/Sentman.hpp"
+#include "solver/Executor.hpp"
+#include "solver/PanelSolver.hpp"
+#include "solver/TestParticle.hpp"
+
+static void usage() {
+  std::cout << "Usage: fmx_bench [--out fmx_bench.json] [--filter substring] [--quick]\n"
+               "       [--reps 15] [--warmup_s 0.05] [--min_sample_s 0.002] [--facets 20000]\n"
+               "       [--mesh path] [--threads_max N] [--atm_model Stub|NRLMSIS2|NRLMSIS2+HWM14|Grid]\n"
+               "  Runs geometry, GSI kernel, solver and atmosphere benchmarks plus a thread-scaling\n"
+               "  sweep. Each benchmark is warmed up, then timed over --reps samples (each sample\n"
+               "  repeats the call until --min_sample_s has elapsed); the JSON report holds the\n"
+               "  per-call min/median/p90/p99/max/mean/stddev in nanoseconds.\n";
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using fmx::Vec3;
+
+struct Options {
+  std::string out_path{"fmx_bench.json"};
+  std::string filter;
+  std::string mesh_path;
+  std::string atm_model{"Stub"};
+  int reps{15};
+  double warmup_s{0.05};
+  double min_sample_s{0.002};
+  std::size_t facets{20000};
+  unsigned threads_max{0};
+};
+
+struct Result {
+  std::string group, name;
+  unsigned threads{1};
+  double items_per_call{1.0};   // work items per call (facets, rays, points, ...)
+  std::size_t calls_per_sample{1};
+  std::vector<double> ns;        // per-call time of each sample, sorted
+  double min{0}, median{0}, p90{0}, p99{0}, max{0}, mean{0}, stddev{0};
+};
+
+double quantile(const std::vector<double>& sorted, double q) {
+  if (sorted.empty()) return 0.0;
+  const double x = q * static_cast<double>(sorted.size() - 1);
+  const std::size_t i = static_cast<std::size_t>(x);
+  const double f = x - static_cast<double>(i);
+  return (i + 1 < sorted.size()) ? sorted[i] * (1.0 - f) + sorted[i + 1] * f : sorted[i];
+}
+
+class Harness {
+public:
+  explicit Harness(const Options& o) : m_opt(o) {}
+
+  bool wanted(const std::string& group, const std::string& name) const {
+    return m_opt.filter.empty() || (group + "/" + name).find(m_opt.filter) != std::string::npos;
+  }
+
+  // Warmup for warmup_s (at least one call), then reps samples of enough calls to cover
+  // min_sample_s each; a sample's value is its mean time per call
+  void run(const std::string& group, const std::string& name, double items, const std::function<void()>& fn,
+           unsigned threads = 1) {
+    if (!wanted(group, name)) return;
+    const auto w0 = Clock::now();
+    std::size_t calls = 0;
+    do { fn(); ++calls; } while (seconds(w0) < m_opt.warmup_s);
+    const double per_call = seconds(w0) / static_cast<double>(calls);
+    Result r;
+    r.group = group; r.name = name; r.threads = threads; r.items_per_call = items;
+    r.calls_per_sample = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(m_opt.min_sample_s / std::max(per_call, 1e-9))));
+    for (int s = 0; s < m_opt.reps; ++s) {
+      const auto t0 = Clock::now();
+      for (std::size_t k = 0; k < r.calls_per_sample; ++k) fn();
+      r.ns.push_back(1e9 * seconds(t0) / static_cast<double>(r.calls_per_sample));
+    }
+    std::sort(r.ns.begin(), r.ns.end());
+    r.min = r.ns.front(); r.max = r.ns.back();
+    r.median = quantile(r.ns, 0.5); r.p90 = quantile(r.ns, 0.9); r.p99 = quantile(r.ns, 0.99);
+    double sum = 0.0, sq = 0.0;
+    for (double v : r.ns) sum += v;
+    r.mean = sum / static_cast<double>(r.ns.size());
+    for (double v : r.ns) sq += (v - r.mean) * (v - r.mean);
+    r.stddev = r.ns.size() > 1 ? std::sqrt(sq / static_cast<double>(r.ns.size() - 1)) : 0.0;
+    std::printf("%-10s %-34s %3u thr  median %12.1f ns  p90 %12.1f ns  %10.3g items/s\n", group.c_str(), name.c_str(),
+                threads, r.median, r.p90, r.median > 0 ? items * 1e9 / r.median : 0.0);
+    std::fflush(stdout);
+    m_results.push_back(std::move(r));
+  }
+
+  const std::vector<Result>& results() const { return m_results; }
+
+private:
+  static double seconds(Clock::time_point t) { return std::chrono::duration<double>(Clock::now() - t).count(); }
+  const Options& m_opt;
+  std::vector<Result> m_results;
+};
+
+// Two parallel plates along the flow (rear plate shadowed), as in --validate two-plates
+fmx::geom::Mesh make_two_plates() {
+  fmx::geom::Mesh m;
+  for (double x : {0.0, 0.2}) {
+    m.tris.push_back({Vec3{x, 0.5, 0.5}, Vec3{x, 0.5, -0.5}, Vec3{x, -0.5, -0.5}});
+    m.tris.push_back({Vec3{x, -0.5, 0.5}, Vec3{x, 0.5, 0.5}, Vec3{x, -0.5, -0.5}});
+  }
+  return m;
+}
+
+fmx::geom::Mesh make_cube() {
+  fmx::geom::Mesh m;
+  const double h = 0.5;
+  auto quad = [&](Vec3 a, Vec3 b, Vec3 c, Vec3 d) { m.tris.push_back({a, b, c}); m.tris.push_back({d, a, c}); };
+  quad({ h,-h,-h},{ h, h,-h},{ h, h, h},{ h,-h, h});
+  quad({-h, h, h},{-h, h,-h},{-h,-h,-h},{-h,-h, h});
+  quad({-h, h, h},{ h, h, h},{ h, h,-h},{-h, h,-h});
+  quad({-h,-h,-h},{ h,-h,-h},{ h,-h, h},{-h,-h, h});
+  quad({-h,-h, h},{ h,-h, h},{ h, h, h},{-h, h, h});
+  quad({-h, h,-h},{ h, h,-h},{ h,-h,-h},{-h,-h,-h});
+  return m;
+}
+
+// Four-species (O, N2, O2, He) input at roughly 400 km conditions
+fmx::solver::Input make_input(const std::vector<fmx::Facet>& facets, const fmx::geom::Occluder* occ) {
+  fmx::solver::Input in;
+  in.facets_view = &facets;
+  in.materials = {{1.0, 1.0, 0.9, 300.0}};
+  in.species = {{2.5e-12, 2.6567e-26}, {4.0e-13, 4.6518e-26}, {2.0e-14, 5.3134e-26}, {5.0e-14, 6.6465e-27}};
+  in.T_K = 900.0;
+  in.V_sat_ms = {7600.0, 150.0, -80.0};
+  in.occluder = occ;
+  return in;
+}
+
+// CLL table over a small grid, filled from the closed form
+fmx::gsi::KernelSet make_cll_table() {
+  std::array<std::vector<double>, 5> ax;
+  for (int i = 0; i <= 45; ++i) ax[0].push_back(i * (M_PI / 2) / 45);
+  ax[1] = {0.5, 1.0, 2.0, 4.0, 8.0, 12.0, 16.0};
+  ax[2] = {0.2, 0.3, 0.5, 1.0, 1.5, 2.0};
+  ax[3] = {0.0, 0.5, 1.0};
+  ax[4] = {0.0, 0.5, 1.0};
+  std::vector<double> v;
+  for (double th : ax[0]) for (double Ma : ax[1]) for (double tau : ax[2]) for (double an : ax[3]) for (double at : ax[4]) {
+    const auto [cn, ct] = fmx::gsi::coefficients(th, Ma, tau, fmx::gsi::CLLParams{an, at});
+    v.push_back(cn); v.push_back(ct);
+  }
+  fmx::gsi::KernelSet ks;
+  ks.set_grid(ax, std::move(v));
+  return ks;
+}
+
+void json_string(std::ostream& o, const std::string& s) {
+  o << '"';
+  for (char c : s) { if (c == '"' || c == '\\') o << '\\'; o << c; }
+  o << '"';
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  bool quick = false;
+  for (int i=1;i<argc;++i) {
+    std::string a=argv[i];
+    if (a=="--out" && i+1<argc) opt.out_path=argv[++i];
+    else if (a=="--filter" && i+1<argc) opt.filter=argv[++i];
+    else if (a=="--mesh" && i+1<argc) opt.mesh_path=argv[++i];
+    else if (a=="--atm_model" && i+1<argc) opt.atm_model=argv[++i];
+    else if (a=="--reps" && i+1<argc) opt.reps=std::stoi(argv[++i]);
+    else if (a=="--warmup_s" && i+1<argc) opt.warmup_s=std::stod(argv[++i]);
+    else if (a=="--min_sample_s" && i+1<argc) opt.min_sample_s=std::stod(argv[++i]);
+    else if (a=="--facets" && i+1<argc) opt.facets=static_cast<std::size_t>(std::stoul(argv[++i]));
+    else if (a=="--threads_max" && i+1<argc) opt.threads_max=static_cast<unsigned>(std::stoul(argv[++i]));
+    else if (a=="--quick") quick=true;
+    else if (a=="--help") { usage(); return 0; }
+    else { usage(); std::cerr << "Unknown argument: " << a << "\n"; return 1; }
+  }
+  if (quick) {
+    // Smoke run: small mesh, few short samples
+    opt.reps = std::min(opt.reps, 3);
+    opt.warmup_s = std::min(opt.warmup_s, 0.002);
+    opt.min_sample_s = std::min(opt.min_sample_s, 0.0005);
+    opt.facets = std::min<std::size_t>(opt.facets, 2000);
+  }
+  if (opt.reps < 1) { std::cerr << "--reps must be positive\n"; return 1; }
+  const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+  if (opt.threads_max == 0) opt.threads_max = hw;
+  Harness h(opt);
+
+  // Geometry: mesh I/O, BVH build, facet extraction and occlusion rays
+  fmx::geom::Mesh mesh;
+  if (!opt.mesh_path.empty()) {
+    std::string err;
+    auto m = fmx::geom::Mesh::load(opt.mesh_path, &err);
+    if (!m) { std::cerr << "Failed to load mesh: " << err << "\n"; return 1; }
+    mesh = std::move(*m);
+  } else {
+    fmx::geom::SatelliteSpec spec;
+    spec.target_triangles = opt.facets;
+    mesh = fmx::geom::make_satellite(spec);
+  }
+  const std::string tag = opt.mesh_path.empty() ? "satellite" : "mesh";
+  const double ntris = static_cast<double>(mesh.tris.size());
+  const auto tmp = std::filesystem::temp_directory_path();
+  const std::string obj = (tmp / "fmx_bench_mesh.obj").string(), stl = (tmp / "fmx_bench_mesh.stl").string();
+  if (h.wanted("geom", "mesh_load_obj")) {
+    if (!mesh.save(obj)) std::abort();
+    h.run("geom", "mesh_load_obj", ntris, [&] { if (!fmx::geom::Mesh::load(obj)) std::abort(); });
+    std::filesystem::remove(obj);
+  }
+  if (h.wanted("geom", "mesh_load_stl")) {
+    if (!mesh.save(stl)) std::abort();
+    h.run("geom", "mesh_load_stl", ntris, [&] { if (!fmx::geom::Mesh::load(stl)) std::abort(); });
+    std::filesystem::remove(stl);
+  }
+  std::vector<fmx::Facet> facets;
+  h.run("geom", "to_facets", ntris, [&] { facets = mesh.to_facets(0); });
+  if (facets.empty()) facets = mesh.to_facets(0);
+  h.run("geom", "bvh_build", ntris, [&] { fmx::geom::BVHOccluder b(mesh.tris); });
+  // Flexible geometry: alternate between two slightly bent poses, refit against bvh_build
+  if (h.wanted("geom", "bvh_refit")) {
+    fmx::geom::BVHOccluder flex(mesh.tris);
+    std::vector<fmx::geom::Triangle> bent = mesh.tris;
+    for (auto& t : bent) for (Vec3* v : {&t.v0, &t.v1, &t.v2}) v->z += 1e-3 * v->y * v->y;
+    bool even = false;
+    h.run("geom", "bvh_refit", ntris, [&] {
+      even = !even;
+      if (!flex.refit(even ? bent : mesh.tris)) std::abort();
+    });
+  }
+  const fmx::geom::BVHOccluder occ(mesh.tris);
+  const Vec3 chat = Vec3{7600.0, 150.0, -80.0}.normalized();
+  std::size_t sink = 0;
+  // The solver's occlusion pass: one any-hit ray per facet along -c_hat
+  h.run("geom", "occlusion_rays/" + tag, ntris, [&] {
+    for (const auto& f : facets) sink += occ.any_hit(fmx::geom::Ray{f.r_center, -chat}, 1e9);
+  });
+  h.run("geom", "occlusion_rays_front/" + tag, ntris, [&] {
+    for (const auto& f : facets) if (Vec3::dot(chat, f.n) < 0.0) sink += occ.any_hit(fmx::geom::Ray{f.r_center, -chat}, 1e9);
+  });
+  // Two-level scene of the procedural satellite: re-posing every solar panel re-places the
+  // panel facets and rebuilds the top level only (compare to_facets + bvh_build), and the
+  // occlusion pass through the instance hierarchy
+  if (opt.mesh_path.empty() && (h.wanted("geom", "scene_articulate/" + tag) || h.wanted("geom", "occlusion_rays_scene/" + tag))) {
+    fmx::geom::SatelliteSpec spec;
+    spec.target_triangles = opt.facets;
+    std::vector<std::size_t> panels;
+    auto scene = fmx::geom::make_satellite_scene(spec, nullptr, &panels);
+    const auto step = fmx::geom::Transform::rotation({0, 1, 0}, 1e-3);
+    h.run("geom", "scene_articulate/" + tag, ntris, [&] {
+      for (std::size_t id : panels) scene.set_transform(id, scene.transform(id) * step);
+      scene.commit();
+    });
+    h.run("geom", "occlusion_rays_scene/" + tag, ntris, [&] {
+      for (const auto& f : scene.facets()) sink += scene.any_hit(fmx::geom::Ray{f.r_center, -chat}, 1e9);
+    });
+  }
+
+  // GSI kernels in isolation over a fixed random sample set
+  constexpr std::size_t kQ = 4096;
+  std::vector<double> th(kQ), Ma(kQ), tau(kQ);
+  {
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    for (std::size_t i = 0; i < kQ; ++i) { th[i] = u(rng) * M_PI / 2; Ma[i] = 0.5 + 15.0 * u(rng); tau[i] = 0.2 + 1.8 * u(rng); }
+  }
+  double acc = 0.0;
+  h.run("gsi", "sentman", kQ, [&] {
+    for (std::size_t i = 0; i < kQ; ++i) acc += std::get<0>(fmx::gsi::coefficients(th[i], Ma[i], tau[i], fmx::gsi::SentmanParams{0.9}));
+  });
+  h.run("gsi", "cll_closed_form", kQ, [&] {
+    for (std::size_t i = 0; i < kQ; ++i) acc += std::get<0>(fmx::gsi::coefficients(th[i], Ma[i], tau[i], fmx::gsi::CLLParams{0.8, 0.9}));
+  });
+  const fmx::gsi::KernelSet table = make_cll_table();
+  h.run("gsi", "cll_table_query", kQ, [&] {
+    for (std::size_t i = 0; i < kQ; ++i) acc += std::get<0>(table.query(th[i], Ma[i], tau[i], 0.8, 0.9));
+  });
+  std::vector<double> cn(kQ), ct(kQ);
+  h.run("gsi", "cll_table_theta_batch", kQ, [&] {
+    table.query_theta_batch(th, 7.5, 0.4, 0.8, 0.9, cn.data(), ct.data());
+    acc += cn[0];
+  });
+
+  // Full solves
+  const fmx::geom::Mesh plates = make_two_plates(), cube = make_cube();
+  const auto plates_f = plates.to_facets(0), cube_f = cube.to_facets(0);
+  const fmx::geom::BVHOccluder plates_occ(plates.tris), cube_occ(cube.tris);
+  fmx::solver::Output out{};
+  {
+    const auto in = make_input(plates_f, &plates_occ);
+    h.run("solve", "two_plates", static_cast<double>(plates_f.size()), [&] { out = fmx::solver::solve(in); });
+  }
+  const auto cube_in = make_input(cube_f, &cube_occ);
+  h.run("solve", "cube", static_cast<double>(cube_f.size()), [&] { out = fmx::solver::solve(cube_in); });
+  auto big_in = make_input(facets, &occ);
+  h.run("solve", "sentman/" + tag, ntris, [&] { out = fmx::solver::solve(big_in); });
+  h.run("solve", "sentman_serial/" + tag, ntris, [&] { out = fmx::solver::solve_serial(big_in); });
+  {
+    // Same solve with the instrumentation counters on (overhead of SolveStats)
+    fmx::solver::SolveStats st;
+    h.run("solve", "sentman_stats/" + tag, ntris, [&] { out = fmx::solver::solve(big_in, &st); });
+  }
+  {
+    // Bit-reproducible block reductions (plain and Neumaier-compensated)
+    auto in = big_in;
+    in.reduction = fmx::solver::Reduction::Deterministic;
+    h.run("solve", "sentman_deterministic/" + tag, ntris, [&] { out = fmx::solver::solve(in); });
+    in.reduction = fmx::solver::Reduction::Compensated;
+    h.run("solve", "sentman_compensated/" + tag, ntris, [&] { out = fmx::solver::solve(in); });
+  }
+  {
+    // Sub-facet occlusion at the deepest level: 4 sample rays per front facet as one packet,
+    // refined up to 64 on shadow edges. _single_rays traces the same points one by one.
+    struct SingleRays : fmx::geom::Occluder {
+      const fmx::geom::Occluder* base{nullptr};
+      bool any_hit(const fmx::geom::Ray& r, double t_max) const override { return base->any_hit(r, t_max); }
+    } single;
+    single.base = &occ;
+    auto in = big_in;
+    in.facet_tris = &mesh.tris;
+    in.occlusion_level = fmx::solver::kMaxOcclusionLevel;
+    h.run("solve", "sentman_subfacet/" + tag, ntris, [&] { out = fmx::solver::solve(in); });
+    in.occluder = &single;
+    h.run("solve", "sentman_subfacet_single_rays/" + tag, ntris, [&] { out = fmx::solver::solve(in); });
+  }
+  {
+    auto in = big_in;
+    in.occluder = nullptr;
+    h.run("solve", "sentman_no_occlusion/" + tag, ntris, [&] { out = fmx::solver::solve(in); });
+    in.occluder = &occ;
+    in.gsi_model = fmx::solver::GsiModel::CLL;
+    in.cll_kernel = &table;
+    h.run("solve", "cll_table/" + tag, ntris, [&] { out = fmx::solver::solve(in); });
+  }
+  {
+    // Test-particle Monte Carlo with multiple reflections; items are injected particles
+    fmx::solver::TpmcOptions topt;
+    topt.particles = quick ? 20000 : 200000;
+    h.run("solve", "tpmc/" + tag, static_cast<double>(topt.particles), [&] {
+      if (!fmx::solver::solve_tpmc(big_in, occ, topt)) std::abort();
+    });
+  }
+
+  // Atmosphere: single points through the session and a 1024-point batch
+  fmx::atm::SessionConfig scfg;
+  scfg.model = opt.atm_model;
+  std::string aerr;
+  auto session = fmx::atm::AtmosphereSession::open(scfg, &aerr);
+  if (!session) { std::cerr << "Atmosphere '" << opt.atm_model << "' unavailable: " << aerr << "\n"; return 1; }
+  const fmx::atm::Indices idx;
+  constexpr std::size_t kP = 1024;
+  std::vector<double> alt(kP), lat(kP), lon(kP), ep(kP);
+  for (std::size_t i = 0; i < kP; ++i) {
+    alt[i] = 200.0 + 400.0 * i / kP; lat[i] = -80.0 + 160.0 * ((i * 37) % kP) / kP;
+    lon[i] = -180.0 + 360.0 * ((i * 101) % kP) / kP; ep[i] = 1757678400.0 + 60.0 * i;
+  }
+  std::size_t k = 0;
+  h.run("atm", "session_point/" + opt.atm_model, 1.0, [&] {
+    const auto s = session->evaluate(alt[k], lat[k], lon[k], ep[k], idx);
+    acc += s.T_K;
+    k = (k + 1) % kP;
+  });
+  fmx::atm::StateBatch sb;
+  const fmx::atm::PointBatch pts{kP, alt.data(), lat.data(), lon.data(), ep.data()};
+  h.run("atm", "session_batch/" + opt.atm_model, kP, [&] { session->evaluate_batch(pts, idx, sb); });
+
+  // Thread scaling: one large solve over OpenMP threads and over the executor (front-facing
+  // facets only, stolen in chunks), and many small independent solves on the executor (as in
+  // batch mode)
+  std::vector<unsigned> sweep;
+  for (unsigned t = 1; t < opt.threads_max; t *= 2) sweep.push_back(t);
+  sweep.push_back(opt.threads_max);
+  constexpr std::size_t kCases = 4096;
+#if defined(FMX_USE_OPENMP)
+  const int omp_default = omp_get_max_threads();
+  for (unsigned t : sweep) {
+    omp_set_num_threads(static_cast<int>(t));
+    h.run("scaling", "solve_openmp/" + tag, ntris, [&] { out = fmx::solver::solve(big_in); }, t);
+  }
+  omp_set_num_threads(omp_default);
+#endif
+  for (unsigned t : sweep) {
+    if (!h.wanted("scaling", "solve_executor/" + tag)) break;
+    fmx::solver::Executor ex(t);
+    auto in = big_in;
+    in.executor = &ex;
+    h.run("scaling", "solve_executor/" + tag, ntris, [&] { out = fmx::solver::solve(in); }, t);
+  }
+  for (unsigned t : sweep) {
+    if (!h.wanted("scaling", "executor_cases/cube")) break;
+    fmx::solver::Executor ex(t);
+    h.run("scaling", "executor_cases/cube", kCases, [&] {
+      ex.parallel_for(kCases, 64, [&](std::size_t b, std::size_t e) {
+        auto in = cube_in;
+        for (std::size_t i = b; i < e; ++i) {
+          in.V_sat_ms = {7600.0, 20.0 * static_cast<double>(i % 50), 0.0};
+          const auto o = fmx::solver::solve_serial(in);
+          if (!std::isfinite(o.F.x)) std::abort();
+        }
+      });
+    }, t);
+  }
+  if (!std::isfinite(acc) || sink == static_cast<std::size_t>(-1)) std::cerr << "unexpected\n";
+
+  // Report
+  std::ofstream f(opt.out_path);
+  if (!f) { std::cerr << "Failed to open report: " << opt.out_path << "\n"; return 1; }
+  char ts[32];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(ts, sizeof(ts), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+  f.precision(6);
+  f << "{\n  \"schema\": \"fmx_bench/1\",\n  \"timestamp_utc\": \"" << ts << "\",\n";
+  f << "  \"build\": {\"compiler\": "; json_string(f, __VERSION__);
+#if defined(NDEBUG)
+  f << ", \"ndebug\": true";
+#else
+  f << ", \"ndebug\": false";
+#endif
+#if defined(FMX_USE_OPENMP)
+  f << ", \"openmp\": true},\n";
+#else
+  f << ", \"openmp\": false},\n";
+#endif
+  f << "  \"host\": {\"hardware_threads\": " << hw << "},\n";
+  f << "  \"options\": {\"reps\": " << opt.reps << ", \"warmup_s\": " << opt.warmup_s << ", \"min_sample_s\": " << opt.min_sample_s
+    << ", \"mesh\": "; json_string(f, opt.mesh_path.empty() ? "satellite" : opt.mesh_path);
+  f << ", \"triangles\": " << mesh.tris.size() << ", \"atm_model\": "; json_string(f, opt.atm_model);
+  f << ", \"threads_max\": " << opt.threads_max << "},\n  \"results\": [";
+  const auto& rs = h.results();
+  for (std::size_t i = 0; i < rs.size(); ++i) {
+    const Result& r = rs[i];
+    f << (i ? ",\n" : "\n") << "    {\"group\": "; json_string(f, r.group);
+    f << ", \"name\": "; json_string(f, r.name);
+    f << ", \"threads\": " << r.threads << ", \"items_per_call\": " << r.items_per_call
+      << ", \"calls_per_sample\": " << r.calls_per_sample << ", \"reps\": " << r.ns.size()
+      << ", \"ns_per_call\": {\"min\": " << r.min << ", \"median\": " << r.median << ", \"p90\": " << r.p90
+      << ", \"p99\": " << r.p99 << ", \"max\": " << r.max << ", \"mean\": " << r.mean << ", \"stddev\": " << r.stddev
+      << "}, \"items_per_s\": " << (r.median > 0 ? r.items_per_call * 1e9 / r.median : 0.0);
+    // Scaling entries: speedup over the one-thread run of the same benchmark
+    if (r.group == "scaling") {
+      const auto base = std::find_if(rs.begin(), rs.end(), [&](const Result& x) { return x.group == r.group && x.name == r.name && x.threads == 1; });
+      if (base != rs.end() && r.median > 0) {
+        const double sp = base->median / r.median;
+        f << ", \"speedup\": " << sp << ", \"efficiency\": " << sp / r.threads;
+      }
+    }
+    f << "}";
+  }
+  f << "\n  ]\n}\n";
+  if (!f) { std::cerr << "Failed to write report: " << opt.out_path << "\n"; return 1; }
+  std::cout << "report: " << opt.out_path << " (" << rs.size() << " benchmarks)\n";
+  return 0;
+}
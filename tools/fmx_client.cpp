@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "cli/ServeProtocol.hpp"
+
+static void usage() {
+  std::cout << "Usage: fmx_client --socket path [--format binary|json] [--n 10000] [--warmup 100]\n"
+               "       [--alt_km 400] [--epoch_s 1757678400] [--shutdown]\n"
+               "  Sends circular-orbit states to fmx_cli --serve one request at a time and reports\n"
+               "  round-trip latency percentiles, the server-side solve time and the request rate.\n";
+}
+
+namespace {
+
+using fmx::cli::ServeBinReply;
+using fmx::cli::ServeBinRequest;
+
+bool write_all(int fd, const void* data, std::size_t n) {
+  const char* p = static_cast<const char*>(data);
+  while (n > 0) {
+    const ssize_t k = ::send(fd, p, n, MSG_NOSIGNAL);
+    if (k < 0) { if (errno == EINTR) continue; return false; }
+    p += k; n -= static_cast<std::size_t>(k);
+  }
+  return true;
+}
+
+bool read_all(int fd, void* data, std::size_t n) {
+  char* p = static_cast<char*>(data);
+  while (n > 0) {
+    const ssize_t k = ::read(fd, p, n);
+    if (k == 0) return false;
+    if (k < 0) { if (errno == EINTR) continue; return false; }
+    p += k; n -= static_cast<std::size_t>(k);
+  }
+  return true;
+}
+
+// Reply lines through a small read buffer (one syscall per reply, not per byte)
+struct LineReader {
+  int fd;
+  std::string buf;
+  bool line(std::string& out) {
+    for (;;) {
+      const auto nl = buf.find('\n');
+      if (nl != std::string::npos) { out.assign(buf, 0, nl); buf.erase(0, nl + 1); return true; }
+      char tmp[4096];
+      const ssize_t k = ::read(fd, tmp, sizeof(tmp));
+      if (k == 0) return false;
+      if (k < 0) { if (errno == EINTR) continue; return false; }
+      buf.append(tmp, static_cast<std::size_t>(k));
+    }
+  }
+};
+
+// Circular equatorial orbit state at step i (1 s apart)
+ServeBinRequest orbit_state(std::uint64_t i, double alt_km, double epoch_s) {
+  const double R = 6378137.0 + alt_km * 1e3, v = 7670.0, w = v / R;
+  const double t = static_cast<double>(i), c = std::cos(w * t), s = std::sin(w * t);
+  ServeBinRequest rq{};
+  rq.id = i;
+  rq.epoch_s = epoch_s + t;
+  rq.r_ecef_m[0] = R * c; rq.r_ecef_m[1] = R * s;
+  rq.v_ecef_ms[0] = -v * s; rq.v_ecef_ms[1] = v * c;
+  return rq;
+}
+
+double pct(std::vector<double>& v, double p) {
+  if (v.empty()) return 0.0;
+  std::sort(v.begin(), v.end());
+  return v[static_cast<std::size_t>(p * static_cast<double>(v.size() - 1))];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::string socket_path, format = "binary";
+  std::size_t n = 10000, warmup = 100;
+  double alt_km = 400.0, epoch_s = 1757678400.0;
+  bool shutdown = false;
+  for (int i=1;i<argc;++i) {
+    std::string a=argv[i];
+    if (a=="--socket" && i+1<argc) socket_path=argv[++i];
+    else if (a=="--format" && i+1<argc) format=argv[++i];
+    else if (a=="--n" && i+1<argc) n=static_cast<std::size_t>(std::stoul(argv[++i]));
+    else if (a=="--warmup" && i+1<argc) warmup=static_cast<std::size_t>(std::stoul(argv[++i]));
+    else if (a=="--alt_km" && i+1<argc) alt_km=std::stod(argv[++i]);
+    else if (a=="--epoch_s" && i+1<argc) epoch_s=std::stod(argv[++i]);
+    else if (a=="--shutdown") shutdown=true;
+    else if (a=="--help") { usage(); return 0; }
+  }
+  if (socket_path.empty() || (format != "binary" && format != "json")) { usage(); return 1; }
+
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(addr.sun_path)) { std::cerr << "Socket path too long\n"; return 1; }
+  std::memcpy(addr.sun_path, socket_path.c_str(), socket_path.size() + 1);
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+    std::cerr << "Failed to connect to " << socket_path << ": " << std::strerror(errno) << "\n"; return 1;
+  }
+
+  const bool binary = (format == "binary");
+  std::vector<double> rtt_us, solve_us;
+  rtt_us.reserve(n); solve_us.reserve(n);
+  std::size_t errors = 0;
+  std::string line;
+  LineReader lines{fd, {}};
+  char buf[512];
+  const auto t_start = std::chrono::steady_clock::now();
+  auto t_measure = t_start;
+  for (std::size_t i = 0; i < warmup + n; ++i) {
+    if (i == warmup) t_measure = std::chrono::steady_clock::now();
+    const ServeBinRequest rq = orbit_state(i, alt_km, epoch_s);
+    const auto t0 = std::chrono::steady_clock::now();
+    double server_us = 0.0;
+    if (binary) {
+      const std::uint32_t len = sizeof(rq);
+      char frame[sizeof(len) + sizeof(rq)];
+      std::memcpy(frame, &len, sizeof(len));
+      std::memcpy(frame + sizeof(len), &rq, sizeof(rq));
+      std::uint32_t rlen = 0;
+      ServeBinReply rp{};
+      if (!write_all(fd, frame, sizeof(frame)) || !read_all(fd, &rlen, sizeof(rlen))
+          || rlen != sizeof(rp) || !read_all(fd, &rp, sizeof(rp))) {
+        std::cerr << "Connection failed at request " << i << "\n"; return 1;
+      }
+      if (rp.status != fmx::cli::kServeOk || rp.id != rq.id) ++errors;
+      server_us = rp.solve_us;
+    } else {
+      const int len = std::snprintf(buf, sizeof(buf),
+          "{\"id\":%llu,\"epoch_s\":%.3f,\"r_ecef_m\":[%.17g,%.17g,%.17g],\"v_ecef_ms\":[%.17g,%.17g,%.17g]}\n",
+          static_cast<unsigned long long>(rq.id), rq.epoch_s, rq.r_ecef_m[0], rq.r_ecef_m[1], rq.r_ecef_m[2],
+          rq.v_ecef_ms[0], rq.v_ecef_ms[1], rq.v_ecef_ms[2]);
+      if (!write_all(fd, buf, static_cast<std::size_t>(len)) || !lines.line(line)) {
+        std::cerr << "Connection failed at request " << i << "\n"; return 1;
+      }
+      const auto pos = line.find("\"us\":");
+      if (line.find("\"error\"") != std::string::npos || pos == std::string::npos) ++errors;
+      else server_us = std::atof(line.c_str() + pos + 5);
+    }
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    if (i >= warmup) { rtt_us.push_back(us); solve_us.push_back(server_us); }
+  }
+  const double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_measure).count();
+  if (shutdown) {
+    if (binary) { const std::uint32_t zero = 0; write_all(fd, &zero, sizeof(zero)); }
+    else write_all(fd, "{\"cmd\":\"shutdown\"}\n", 19);
+  }
+  ::close(fd);
+
+  double solve_mean = 0.0;
+  for (double s : solve_us) solve_mean += s;
+  if (!solve_us.empty()) solve_mean /= static_cast<double>(solve_us.size());
+  std::cout << "requests=" << n << " (" << format << "), errors=" << errors << "\n";
+  std::cout << "round_trip_us p50/p90/p99/max = " << pct(rtt_us, 0.5) << " / " << pct(rtt_us, 0.9) << " / "
+            << pct(rtt_us, 0.99) << " / " << pct(rtt_us, 1.0) << "\n";
+  std::cout << "server_solve_us mean=" << solve_mean << ", requests_per_s=" << (wall_s > 0 ? n / wall_s : 0.0) << "\n";
+  return errors == 0 ? 0 : 1;
+}
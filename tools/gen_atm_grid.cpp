@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "atm/AtmosphereGrid.hpp"
+#include "atm/AtmosphereSession.hpp"
+#include "atm/Epoch.hpp"
+
+static void usage() {
+  std::cout << "Usage: gen_atm_grid --out atm_grid.bin --epoch_start ISO [--epoch_end ISO] [--epoch_step_h 3]\n"
+               "       [--model NRLMSIS2+HWM14|NRLMSIS2|Stub] [--workers 1]\n"
+               "       [--msis_parm_dir DIR] [--hwm_data_dir DIR]\n"
+               "       [--alt 100,800,10] [--lat -90,90,5] [--lst_n 24]   (start,end,step; LST nodes over 24 h)\n"
+               "       [--F10_7 120] [--F10_7A 120] [--Kp 3] [--Ap_daily 0] [--Ap_now 0]\n"
+               "       [--check 5000]\n"
+               "  Samples the model on an (altitude, latitude, local solar time, epoch) grid with\n"
+               "  fixed indices and writes an mmap-able grid (atm::AtmosphereGrid). --check compares\n"
+               "  the grid with direct model evaluation at random points (error budget and timing).\n";
+}
+
+static std::vector<double> parse_list(const std::string& s) {
+  std::vector<double> v; std::string tok; for (size_t i=0,j=0; i<=s.size(); ++i) {
+    if (i==s.size() || s[i]==',') { tok = s.substr(j, i-j); try{ v.push_back(std::stod(tok)); }catch(...){} j=i+1; }
+  } return v;
+}
+
+// start,end,step -> uniform axis (end rounded to whole steps)
+static bool parse_axis(const std::string& s, fmx::atm::GridAxisSpec& a) {
+  auto v = parse_list(s);
+  if (v.size() != 3 || !(v[2] > 0.0) || v[1] < v[0]) return false;
+  a.start = v[0]; a.step = v[2];
+  a.n = static_cast<std::uint32_t>(std::floor((v[1] - v[0]) / v[2] + 1e-9)) + 1;
+  return true;
+}
+
+namespace {
+
+struct ErrorStats {
+  double max{0.0}, sum2{0.0};
+  std::size_t n{0};
+  void add(double e) { max = std::max(max, e); sum2 += e*e; ++n; }
+  double rms() const { return n ? std::sqrt(sum2 / static_cast<double>(n)) : 0.0; }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  fmx::atm::SessionConfig scfg;
+  scfg.model = "NRLMSIS2+HWM14";
+  std::string out_path, ep0_s, ep1_s;
+  double ep_step_h = 3.0;
+  fmx::atm::GridSpec spec{};
+  parse_axis("100,800,10", spec[fmx::atm::kGridAlt]);
+  parse_axis("-90,90,5", spec[fmx::atm::kGridLat]);
+  spec[fmx::atm::kGridLst].n = 24;
+  fmx::atm::Indices idx;
+  size_t n_check = 5000;
+
+  for (int i=1;i<argc;++i) {
+    std::string a=argv[i];
+    if (a=="--out" && i+1<argc) out_path=argv[++i];
+    else if (a=="--model" && i+1<argc) scfg.model=argv[++i];
+    else if (a=="--workers" && i+1<argc) scfg.model_workers=std::stoi(argv[++i]);
+    else if (a=="--msis_parm_dir" && i+1<argc) scfg.msis_parm_dir=argv[++i];
+    else if (a=="--hwm_data_dir" && i+1<argc) scfg.hwm_data_dir=argv[++i];
+    else if (a=="--epoch_start" && i+1<argc) ep0_s=argv[++i];
+    else if (a=="--epoch_end" && i+1<argc) ep1_s=argv[++i];
+    else if (a=="--epoch_step_h" && i+1<argc) ep_step_h=std::stod(argv[++i]);
+    else if (a=="--alt" && i+1<argc) { if (!parse_axis(argv[++i], spec[fmx::atm::kGridAlt])) { std::cerr << "Invalid --alt\n"; return 1; } }
+    else if (a=="--lat" && i+1<argc) { if (!parse_axis(argv[++i], spec[fmx::atm::kGridLat])) { std::cerr << "Invalid --lat\n"; return 1; } }
+    else if (a=="--lst_n" && i+1<argc) spec[fmx::atm::kGridLst].n=static_cast<std::uint32_t>(std::stoul(argv[++i]));
+    else if (a=="--F10_7" && i+1<argc) idx.F10_7=std::stod(argv[++i]);
+    else if (a=="--F10_7A" && i+1<argc) idx.F10_7A=std::stod(argv[++i]);
+    else if (a=="--Kp" && i+1<argc) idx.Kp=std::stoi(argv[++i]);
+    else if (a=="--Ap_daily" && i+1<argc) idx.Ap_daily=std::stod(argv[++i]);
+    else if (a=="--Ap_now" && i+1<argc) idx.Ap_now=std::stod(argv[++i]);
+    else if (a=="--check" && i+1<argc) n_check=static_cast<size_t>(std::stoul(argv[++i]));
+    else if (a=="--help") { usage(); return 0; }
+  }
+  if (out_path.empty() || ep0_s.empty()) { usage(); std::cerr << "--out and --epoch_start are required\n"; return 1; }
+  double ep0 = 0.0, ep1 = 0.0;
+  if (!fmx::atm::parse_iso_utc(ep0_s, ep0)) { std::cerr << "Invalid --epoch_start: " << ep0_s << "\n"; return 1; }
+  if (ep1_s.empty()) ep1 = ep0;
+  else if (!fmx::atm::parse_iso_utc(ep1_s, ep1) || ep1 < ep0) { std::cerr << "Invalid --epoch_end: " << ep1_s << "\n"; return 1; }
+  if (!(ep_step_h > 0.0) || spec[fmx::atm::kGridLst].n == 0) { std::cerr << "Invalid epoch step or LST node count\n"; return 1; }
+  auto& ax_ep = spec[fmx::atm::kGridEpoch];
+  ax_ep.start = ep0; ax_ep.step = 3600.0 * ep_step_h;
+  ax_ep.n = static_cast<std::uint32_t>(std::floor((ep1 - ep0) / ax_ep.step + 1e-9)) + 1;
+
+  std::string err;
+  auto session = fmx::atm::AtmosphereSession::open(scfg, &err);
+  if (!session) { std::cerr << "Atmosphere initialization failed: " << err << "\n"; return 1; }
+
+  auto t0 = std::chrono::steady_clock::now();
+  auto grid = fmx::atm::AtmosphereGrid::sample(session->model(), spec, idx, &err);
+  auto t1 = std::chrono::steady_clock::now();
+  if (!grid) { std::cerr << "Grid sampling failed: " << err << "\n"; return 1; }
+  if (!grid->save(out_path)) { std::cerr << "Failed to write grid: " << out_path << "\n"; return 1; }
+  const auto& s = grid->spec();
+  std::cerr << "Wrote grid: " << s[0].n << "x" << s[1].n << "x" << s[2].n << "x" << s[3].n
+            << " (alt x lat x LST x epoch), " << grid->species_mass().size() << " species, "
+            << grid->bytes() / (1024.0*1024.0) << " MiB, sampled in "
+            << std::chrono::duration<double>(t1 - t0).count() << " s to " << out_path << "\n";
+  if (n_check == 0) return 0;
+
+  // Error budget: random points inside the grid box, direct model vs interpolation
+  fmx::atm::AtmosphereGrid mapped;
+  if (!mapped.load(out_path, &err)) { std::cerr << "Failed to reload grid: " << err << "\n"; return 1; }
+  std::mt19937_64 rng(2024);
+  auto uni = [&](double a, double b) { return std::uniform_real_distribution<double>(a, b)(rng); };
+  std::vector<double> alt(n_check), lat(n_check), lon(n_check), ep(n_check);
+  for (size_t i = 0; i < n_check; ++i) {
+    alt[i] = uni(s[0].start, s[0].end()); lat[i] = uni(s[1].start, s[1].end());
+    lon[i] = uni(-180.0, 180.0); ep[i] = uni(s[3].start, s[3].end());
+  }
+  const fmx::atm::Drivers drv = fmx::atm::resolve_drivers(idx);
+  std::vector<fmx::atm::AtmosphereState> ref(n_check), approx(n_check);
+  auto a = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n_check; ++i) ref[i] = session->model().evaluate_epoch(alt[i], lat[i], lon[i], ep[i], drv);
+  auto b = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n_check; ++i) approx[i] = mapped.evaluate_epoch(alt[i], lat[i], lon[i], ep[i], drv);
+  auto c = std::chrono::steady_clock::now();
+  // Spatially coherent queries (51.6 deg inclined circular orbit, 10 s steps) stay in cache
+  double orbit_T = 0.0;
+  for (size_t i = 0; i < n_check; ++i) {
+    const double t = 10.0 * static_cast<double>(i), u = 2.0 * M_PI * t / 5554.0;
+    const double ep_i = std::min(s[3].start + t, s[3].end());
+    orbit_T += mapped.evaluate_epoch(std::clamp(420.0, s[0].start, s[0].end()), 51.6 * std::sin(u),
+                                     std::fmod(t * (360.0 / 5554.0 - 360.0 / 86164.0), 360.0), ep_i, drv).T_K;
+  }
+  auto d = std::chrono::steady_clock::now();
+
+  const size_t ns = mapped.species_mass().size();
+  std::vector<ErrorStats> e_rho(ns);
+  ErrorStats e_tot, e_T, e_wind;
+  for (size_t i = 0; i < n_check; ++i) {
+    double tot = 0.0, tot_i = 0.0;
+    for (size_t k = 0; k < ns && k < ref[i].species.size(); ++k) {
+      const double r = ref[i].species[k].rho, ri = approx[i].species[k].rho;
+      if (r > 0.0) e_rho[k].add(std::abs(ri - r) / r);
+      tot += r; tot_i += ri;
+    }
+    if (tot > 0.0) e_tot.add(std::abs(tot_i - tot) / tot);
+    e_T.add(std::abs(approx[i].T_K - ref[i].T_K));
+    const fmx::Vec3 dw = approx[i].wind_ms - ref[i].wind_ms;
+    e_wind.add(std::sqrt(dw.x*dw.x + dw.y*dw.y + dw.z*dw.z));
+  }
+  std::cerr << "Error budget over " << n_check << " random points (max / rms):\n";
+  for (size_t k = 0; k < ns; ++k)
+    std::cerr << "  rho[" << k << "] (m=" << mapped.species_mass()[k] << " kg): rel " << e_rho[k].max << " / " << e_rho[k].rms() << "\n";
+  std::cerr << "  rho total: rel " << e_tot.max << " / " << e_tot.rms() << "\n"
+            << "  T: abs " << e_T.max << " / " << e_T.rms() << " K\n"
+            << "  wind: abs " << e_wind.max << " / " << e_wind.rms() << " m/s\n"
+            << "Per point: model " << std::chrono::duration<double, std::nano>(b - a).count() / n_check
+            << " ns, grid " << std::chrono::duration<double, std::nano>(c - b).count() / n_check
+            << " ns (random points), " << std::chrono::duration<double, std::nano>(d - c).count() / n_check
+            << " ns (orbit track, mean T " << orbit_T / n_check << " K)\n";
+  return 0;
+}
@@ -5,14 +5,22 @@
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <algorithm>
 #include "gsi/Sentman.hpp"
 #include "gsi/CLL.hpp"
+#include "gsi/KernelSet.hpp"
+#include "gsi/TableBuilder.hpp"
 
 static void usage() {
-  std::cout << "Usage: gen_gsi_table --model Sentman|CLL --out table.csv\n"
+  std::cout << "Usage: gen_gsi_table --model Sentman|CLL --out table.csv|table.bin\n"
+               "       [--format csv|bin] [--f32]  (binary if --out ends in .bin)\n"
                "       [--theta_deg_start 0] [--theta_deg_end 90] [--theta_deg_step 2]\n"
                "       [--Ma 0.5,1,2,4,8,12,16] [--tau 0.3,0.5,1,1.5,2]\n"
-               "       [--alpha_n 0,0.25,0.5,0.75,1] [--alpha_t 0,0.25,0.5,0.75,1]\n";
+               "       [--alpha_n 0,0.25,0.5,0.75,1] [--alpha_t 0,0.25,0.5,0.75,1]\n"
+               "       [--adaptive] [--tol 1e-3] [--max_iter 8] [--max_nodes 512] [--report]\n"
+               "  --adaptive inserts axis midpoints until the interpolation error at every\n"
+               "  midpoint is below --tol (absolute, max of |dCN|,|dCT|); --report prints the\n"
+               "  per-axis midpoint error of the final table.\n";
 }
 
 static std::vector<double> parse_list(const std::string& s) {
@@ -21,9 +29,31 @@ static std::vector<double> parse_list(const std::string& s) {
   } return v;
 }
 
+namespace {
+
+const char* kAxisNames[5] = {"theta", "Ma", "tau", "alpha_n", "alpha_t"};
+
+struct Model {
+  bool sentman{false};
+  std::pair<double,double> operator()(const double x[5]) const {
+    double CN=0.0, CT=0.0;
+    if (sentman) std::tie(CN, CT) = fmx::gsi::coefficients(x[0], x[1], x[2], fmx::gsi::SentmanParams{1.0});
+    else std::tie(CN, CT) = fmx::gsi::coefficients(x[0], x[1], x[2], fmx::gsi::CLLParams{x[3], x[4]});
+    return {CN, CT};
+  }
+};
+
+} // namespace
+
 int main(int argc, char** argv) {
   std::string model = "CLL";
   std::string out_path;
+  std::string format;
+  bool f32 = false;
+  bool adaptive = false, report = false;
+  double tol = 1e-3;
+  int max_iter = 8;
+  size_t max_nodes = 512;
   double th0=0.0, th1=90.0, thstep=2.0;
   std::vector<double> ax_Ma{0.5,1,2,4,8,12,16};
   std::vector<double> ax_tau{0.3,0.5,1.0,1.5,2.0};
@@ -34,6 +64,13 @@ int main(int argc, char** argv) {
     std::string a=argv[i];
     if (a=="--model" && i+1<argc) model=argv[++i];
     else if (a=="--out" && i+1<argc) out_path=argv[++i];
+    else if (a=="--format" && i+1<argc) format=argv[++i];
+    else if (a=="--f32") f32=true;
+    else if (a=="--adaptive") adaptive=true;
+    else if (a=="--report") report=true;
+    else if (a=="--tol" && i+1<argc) tol=std::stod(argv[++i]);
+    else if (a=="--max_iter" && i+1<argc) max_iter=std::stoi(argv[++i]);
+    else if (a=="--max_nodes" && i+1<argc) max_nodes=static_cast<size_t>(std::stoul(argv[++i]));
     else if (a=="--theta_deg_start" && i+1<argc) th0=std::stod(argv[++i]);
     else if (a=="--theta_deg_end" && i+1<argc) th1=std::stod(argv[++i]);
     else if (a=="--theta_deg_step" && i+1<argc) thstep=std::stod(argv[++i]);
@@ -45,45 +82,49 @@ int main(int argc, char** argv) {
   }
   if (out_path.empty()) { usage(); std::cerr << "--out is required\n"; return 1; }
   if (thstep<=0 || th1<th0) { std::cerr << "Invalid theta range/step\n"; return 1; }
+  if (adaptive && !(tol > 0.0)) { std::cerr << "--tol must be positive\n"; return 1; }
+  if (format.empty()) format = (out_path.size() >= 4 && out_path.substr(out_path.size()-4) == ".bin") ? "bin" : "csv";
+  const bool binary = (format == "bin");
 
   // Build theta axis
   std::vector<double> ax_th; for (double d=th0; d<=th1+1e-9; d+=thstep) ax_th.push_back(d * M_PI/180.0);
-  size_t NT=ax_th.size(), NM=ax_Ma.size(), NK=ax_tau.size(), NA=ax_an.size(), NB=ax_at.size();
-  std::ofstream out(out_path);
-  if (!out) { std::cerr << "Failed to open output: "<<out_path<<"\n"; return 1; }
+  fmx::gsi::GridAxes ax{ax_th, ax_Ma, ax_tau, ax_an, ax_at};
+  fmx::gsi::RefineOptions ropt;
+  ropt.adaptive = adaptive; ropt.report = report;
+  ropt.tol = tol; ropt.max_iter = max_iter; ropt.max_nodes = max_nodes;
+  fmx::gsi::KernelSet ks;
+  std::array<fmx::gsi::AxisError, 5> errs;
+  std::string err;
+  if (!fmx::gsi::build_table(ax, Model{model == "Sentman"}, ropt, ks, &errs, &err, &std::cerr)) {
+    std::cerr << "Failed to build table: " << err << "\n"; return 1;
+  }
+  const std::vector<double> cnct = ks.grid_values();
+  const size_t NT=ax[0].size(), NM=ax[1].size(), NK=ax[2].size(), NA=ax[3].size(), NB=ax[4].size();
 
-  // Header
-  out << "dims:" << NT << "," << NM << "," << NK << "," << NA << "," << NB << "\n";
-  out << "theta:"; for (size_t i=0;i<NT;i++) { if(i) out<<","; out<<ax_th[i]; } out<<"\n";
-  out << "Ma:";    for (size_t i=0;i<NM;i++) { if(i) out<<","; out<<ax_Ma[i]; } out<<"\n";
-  out << "tau:";   for (size_t i=0;i<NK;i++) { if(i) out<<","; out<<ax_tau[i]; } out<<"\n";
-  out << "alpha_n:";for (size_t i=0;i<NA;i++) { if(i) out<<","; out<<ax_an[i]; } out<<"\n";
-  out << "alpha_t:";for (size_t i=0;i<NB;i++) { if(i) out<<","; out<<ax_at[i]; } out<<"\n";
+  if (binary) {
+    if (!ks.save_binary(out_path, f32)) {
+      std::cerr << "Failed to write binary table: "<<out_path<<"\n"; return 1;
+    }
+  } else {
+    std::ofstream out(out_path);
+    if (!out) { std::cerr << "Failed to open output: "<<out_path<<"\n"; return 1; }
 
-  // Loop grid and write CN,CT rows
-  for (size_t ib=0; ib<NB; ++ib) {
-    for (size_t ia=0; ia<NA; ++ia) {
-      for (size_t ik=0; ik<NK; ++ik) {
-        for (size_t im=0; im<NM; ++im) {
-          for (size_t it=0; it<NT; ++it) {
-            double theta = ax_th[it];
-            double Ma    = ax_Ma[im];
-            double tau   = ax_tau[ik];
-            double an    = ax_an[ia];
-            double at    = ax_at[ib];
-            double CN=0.0, CT=0.0;
-            if (model == "Sentman") {
-              std::tie(CN, CT) = fmx::gsi::coefficients(theta, Ma, tau, fmx::gsi::SentmanParams{1.0});
-            } else {
-              std::tie(CN, CT) = fmx::gsi::coefficients(theta, Ma, tau, fmx::gsi::CLLParams{an, at});
-            }
-            out << CN << "," << CT << "\n";
-          }
-        }
-      }
+    // Header
+    out << "dims:" << NT << "," << NM << "," << NK << "," << NA << "," << NB << "\n";
+    out << "theta:"; for (size_t i=0;i<NT;i++) { if(i) out<<","; out<<ax[0][i]; } out<<"\n";
+    out << "Ma:";    for (size_t i=0;i<NM;i++) { if(i) out<<","; out<<ax[1][i]; } out<<"\n";
+    out << "tau:";   for (size_t i=0;i<NK;i++) { if(i) out<<","; out<<ax[2][i]; } out<<"\n";
+    out << "alpha_n:";for (size_t i=0;i<NA;i++) { if(i) out<<","; out<<ax[3][i]; } out<<"\n";
+    out << "alpha_t:";for (size_t i=0;i<NB;i++) { if(i) out<<","; out<<ax[4][i]; } out<<"\n";
+    for (size_t i=0; i<cnct.size(); i+=2) out << cnct[i] << "," << cnct[i+1] << "\n";
+  }
+  if (adaptive || report) {
+    std::cerr << "Midpoint interpolation error per axis (max |dCN|,|dCT|):\n";
+    for (int d = 0; d < 5; ++d) {
+      std::cerr << "  " << kAxisNames[d] << ": nodes=" << ax[d].size() << ", max=" << errs[d].max << ", rms=" << errs[d].rms
+                << ((adaptive && errs[d].max > tol) ? "  (above tol)" : "") << "\n";
     }
   }
   std::cerr << "Wrote grid: "<< NT<<"x"<<NM<<"x"<<NK<<"x"<<NA<<"x"<<NB<<" to "<<out_path<<"\n";
   return 0;
 }
-
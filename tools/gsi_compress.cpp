@@ -0,0 +1,84 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "gsi/KernelSet.hpp"
+#include "gsi/KernelTT.hpp"
+
+static void usage() {
+  std::cout << "Usage: gsi_compress --in table.csv|table.bin [--out table.tt] [--tol 1e-4] [--queries 200000]\n"
+               "  Fits a tensor-train (TT) representation of a dense GSI grid with relative\n"
+               "  Frobenius error <= --tol, writes it next to the dense table (default <in>.tt)\n"
+               "  and compares memory footprint, query latency and error against the dense grid.\n";
+}
+
+int main(int argc, char** argv) {
+  std::string in_path, out_path;
+  double tol = 1e-4;
+  size_t nq = 200000;
+  for (int i=1;i<argc;++i) {
+    std::string a=argv[i];
+    if (a=="--in" && i+1<argc) in_path=argv[++i];
+    else if (a=="--out" && i+1<argc) out_path=argv[++i];
+    else if (a=="--tol" && i+1<argc) tol=std::stod(argv[++i]);
+    else if (a=="--queries" && i+1<argc) nq=static_cast<size_t>(std::stoul(argv[++i]));
+    else if (a=="--help") { usage(); return 0; }
+  }
+  if (in_path.empty()) { usage(); std::cerr << "--in is required\n"; return 1; }
+  if (out_path.empty()) out_path = in_path + ".tt";
+  if (!(tol > 0.0)) { std::cerr << "--tol must be positive\n"; return 1; }
+
+  fmx::gsi::KernelSet dense;
+  if (!dense.load(in_path) || !dense.is_grid_table()) { std::cerr << "Failed to load dense grid table: "<<in_path<<"\n"; return 1; }
+  std::string err;
+  auto t0 = std::chrono::steady_clock::now();
+  auto tt = fmx::gsi::KernelTT::fit(dense, tol, &err);
+  auto t1 = std::chrono::steady_clock::now();
+  if (!tt) { std::cerr << "TT fit failed: "<<err<<"\n"; return 1; }
+  if (!tt->save(out_path)) { std::cerr << "Failed to write TT table: "<<out_path<<"\n"; return 1; }
+  fmx::gsi::KernelSet comp;
+  if (!comp.load(out_path) || !comp.is_compressed()) { std::cerr << "Failed to reload TT table: "<<out_path<<"\n"; return 1; }
+
+  // Memory footprint (node values + axes)
+  size_t nodes = 1, axes_bytes = 0;
+  for (int d = 0; d < 5; ++d) { nodes *= dense.grid_axis(d).v.size(); axes_bytes += dense.grid_axis(d).v.size() * sizeof(double); }
+  const size_t dense_bytes = 2 * nodes * sizeof(double) + axes_bytes;
+  const auto& r = tt->ranks();
+
+  // Random queries inside the grid box
+  std::mt19937_64 rng(12345);
+  std::vector<std::array<double,5>> q(nq);
+  for (auto& x : q) for (int d = 0; d < 5; ++d) {
+    const auto& v = dense.grid_axis(d).v;
+    x[d] = std::uniform_real_distribution<double>(v.front(), v.back())(rng);
+  }
+  auto time_ns = [&](const fmx::gsi::KernelSet& ks, std::vector<double>& out) {
+    out.resize(2*nq);
+    auto a = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < nq; ++i) std::tie(out[2*i], out[2*i+1]) = ks.query(q[i][0], q[i][1], q[i][2], q[i][3], q[i][4]);
+    auto b = std::chrono::steady_clock::now();
+    return nq ? std::chrono::duration<double, std::nano>(b - a).count() / static_cast<double>(nq) : 0.0;
+  };
+  std::vector<double> ref, approx;
+  const double ns_dense = time_ns(dense, ref);
+  const double ns_tt = time_ns(comp, approx);
+  double max_err = 0.0, sum2 = 0.0, ref2 = 0.0;
+  for (size_t i = 0; i < ref.size(); ++i) {
+    const double e = std::abs(ref[i] - approx[i]);
+    max_err = std::max(max_err, e); sum2 += e*e; ref2 += ref[i]*ref[i];
+  }
+
+  std::cout << "TT ranks: "; for (size_t k = 0; k < r.size(); ++k) std::cout << (k ? "," : "") << r[k]; std::cout << "\n";
+  std::cout << "fit time: " << std::chrono::duration<double>(t1 - t0).count() << " s\n";
+  std::cout << "fit error bound (relative Frobenius): " << tt->fit_error() << "\n";
+  std::cout << "memory: dense " << dense_bytes << " B, TT " << tt->bytes() << " B (ratio "
+            << static_cast<double>(dense_bytes) / static_cast<double>(std::max<size_t>(1, tt->bytes())) << "x)\n";
+  std::cout << "query latency: dense " << ns_dense << " ns, TT " << ns_tt << " ns\n";
+  std::cout << "error vs dense (" << nq << " random queries): max " << max_err << ", rms "
+            << (nq ? std::sqrt(sum2 / static_cast<double>(ref.size())) : 0.0)
+            << ", rel " << (ref2 > 0.0 ? std::sqrt(sum2 / ref2) : 0.0) << "\n";
+  std::cerr << "Wrote TT table to " << out_path << "\n";
+  return 0;
+}